@@ -2,13 +2,50 @@
 #include "ui_mainwindowclientconsultationbooker.h"
 #include <QInputDialog>
 #include <QMessageBox>
+#include <QEventLoop>
 #include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <memory>
+#include <mutex>
 #include "../util/name.h"
 using namespace std;
 
 static const char *SERVER_IP = "127.0.0.1";
 static const int SERVER_PORT = 12345;
 
+/**
+ * Connexion en cours, partagée entre la fenêtre et le thread de connexion
+ */
+struct PendingConnection {
+    mutex lock;
+    QEventLoop *loop = nullptr; // Boucle à réveiller (nullptr si la fenêtre a abandonné)
+    bool done = false;
+    int socket = -1;
+    int error = 0;
+};
+
+/**
+ * Fin de la connexion (thread de la librairie) : réveille la fenêtre, ou
+ * ferme le socket si elle n'attend plus
+ */
+static void onServerConnected(int sSocket, int error, void *userData)
+{
+    shared_ptr<PendingConnection> *pending = static_cast<shared_ptr<PendingConnection> *>(userData);
+    {
+        lock_guard<mutex> guard((*pending)->lock);
+        (*pending)->done = true;
+        (*pending)->socket = sSocket;
+        (*pending)->error = error;
+        if ((*pending)->loop) {
+            QMetaObject::invokeMethod((*pending)->loop, "quit", Qt::QueuedConnection);
+        } else if (sSocket >= 0) {
+            closeSocket(sSocket);
+        }
+    }
+    delete pending;
+}
+
 MainWindowClientConsultationBooker::MainWindowClientConsultationBooker(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindowClientConsultationBooker)
@@ -332,13 +369,9 @@ void MainWindowClientConsultationBooker::on_pushButtonRechercher_clicked()
     // Construire le message de recherche
     string message = string(SEARCH) + specialty + ";" + doctor + ";" + startDate + ";" + endDate;
     
-    // Envoyer la requête
+    // Envoyer la requête puis recevoir la réponse (éventuellement découpée)
     if (sendToServer(message)) {
-        // Recevoir la réponse
-        string response = receiveFromServer();
-        if (!response.empty()) {
-            handleSearchResponse(response);
-        }
+        receiveSearchResponse();
     }
 }
 
@@ -378,12 +411,44 @@ bool MainWindowClientConsultationBooker::connectToServer()
     if (C_connectToServer){
         return true;
     }
-    C_clientSocket = ClientSocket(SERVER_IP, SERVER_PORT);
-    if (C_clientSocket < 0)
-    {
+    if (C_connecting) {
+        return false;
+    }
+
+    // Connexion dans un thread de la librairie (échéance et nouvelles
+    // tentatives) : la fenêtre continue d'être redessinée pendant l'attente
+    shared_ptr<PendingConnection> pending = make_shared<PendingConnection>();
+    QEventLoop loop;
+    pending->loop = &loop;
+    ConnectOptions options;
+    ConnectOptionsInit(&options);
+    shared_ptr<PendingConnection> *ref = new shared_ptr<PendingConnection>(pending);
+    if (ClientSocketAsync(SERVER_IP, SERVER_PORT, &options, onServerConnected, ref) < 0) {
+        delete ref;
         dialogError("Connexion", "Impossible de se connecter au serveur");
         return false;
     }
+    C_connecting = true;
+    setEnabled(false);
+    loop.exec();
+    setEnabled(true);
+    C_connecting = false;
+
+    bool done;
+    {
+        lock_guard<mutex> guard(pending->lock);
+        pending->loop = nullptr;
+        done = pending->done;
+        C_clientSocket = pending->socket;
+    }
+    if (!done || C_clientSocket < 0)
+    {
+        C_clientSocket = -1;
+        dialogError("Connexion", string("Impossible de se connecter au serveur: ") +
+                    strerror(done ? pending->error : ETIMEDOUT));
+        return false;
+    }
+    FrameReaderInit(&C_reader, C_clientSocket);
     C_connectToServer = true;
     return true;
 }
@@ -410,16 +475,31 @@ string MainWindowClientConsultationBooker::receiveFromServer()
         return "";
     }
     
-    char buffer[1024];
-    int result = Receive(C_clientSocket, buffer);
+    // Lecteur de trames : les trames arrivées d'un bloc ne sont pas perdues
+    char *frame = NULL;
+    int result = ReceiveFrame(&C_reader, &frame);
     if (result <= 0) {
+        // Connexion perdue ou coupée par le serveur (réponse interrompue) :
+        // la prochaine commande ouvre une nouvelle connexion
         dialogError("Erreur", "Impossible de recevoir la réponse du serveur");
+        closeSocket(C_clientSocket);
+        C_clientSocket = -1;
+        C_connectToServer = false;
         return "";
     }
     
-    buffer[result] = '\0';
-    string response(buffer);
+    string response(frame, result);
     printf("Message reçu: %s\n", response.c_str());
+
+    // Serveur surchargé : la connexion est abandonnée, l'utilisateur réessaie
+    if (response.find(BUSY) == 0) {
+        string retryMs = response.substr(strlen(BUSY));
+        dialogError("Serveur occupé", "Le serveur est surchargé, réessayez dans " + retryMs + " ms");
+        closeSocket(C_clientSocket);
+        C_clientSocket = -1;
+        C_connectToServer = false;
+        return "";
+    }
     return response;
 }
 
@@ -479,21 +559,7 @@ bool MainWindowClientConsultationBooker::handleSearchResponse(const string& resp
                 pos = nextPos + 1;
             }
             
-            // Parser chaque consultation: ID;SPECIALTY;DOCTOR;DATE;HOUR
-            size_t pos1 = consultation.find(';');
-            size_t pos2 = consultation.find(';', pos1 + 1);
-            size_t pos3 = consultation.find(';', pos2 + 1);
-            size_t pos4 = consultation.find(';', pos3 + 1);
-            
-            if (pos1 != string::npos && pos2 != string::npos && pos3 != string::npos && pos4 != string::npos) {
-                int id = stoi(consultation.substr(0, pos1));
-                string specialty = consultation.substr(pos1 + 1, pos2 - pos1 - 1);
-                string doctor = consultation.substr(pos2 + 1, pos3 - pos2 - 1);
-                string date = consultation.substr(pos3 + 1, pos4 - pos3 - 1);
-                string hour = consultation.substr(pos4 + 1);
-                
-                addTupleTableConsultations(id, specialty, doctor, date, hour);
-            }
+            addConsultationRow(consultation);
         }
         
         dialogMessage("Recherche", "Recherche terminée - " + to_string(ui->tableWidgetConsultations->rowCount()) + " consultation(s) trouvée(s)");
@@ -512,6 +578,80 @@ bool MainWindowClientConsultationBooker::handleSearchResponse(const string& resp
     return false;
 }
 
+bool MainWindowClientConsultationBooker::receiveSearchResponse()
+{
+    string response = receiveFromServer();
+    if (response.empty()) {
+        return false;
+    }
+    
+    // Réponse en une seule trame : traitement habituel
+    if (response[0] != MARQUE_SUITE) {
+        return handleSearchResponse(response);
+    }
+    
+    // Réponse découpée : les consultations sont ajoutées au fil des trames,
+    // seule la consultation coupée entre deux trames est conservée
+    if (response.compare(1, strlen(SEARCH_OK), SEARCH_OK) != 0) {
+        dialogError("Erreur", "Réponse inattendue du serveur: " + response);
+        return false;
+    }
+    clearTableConsultations();
+    string pending = response.substr(1 + strlen(SEARCH_OK));
+    
+    bool last = false;
+    while (true) {
+        // Ajouter les consultations complètes (suivies d'un '|')
+        size_t pos = 0;
+        size_t nextPos;
+        while ((nextPos = pending.find('|', pos)) != string::npos) {
+            addConsultationRow(pending.substr(pos, nextPos - pos));
+            pos = nextPos + 1;
+        }
+        pending.erase(0, pos);
+        if (last) {
+            break;
+        }
+        
+        // Trame suivante : la dernière ne porte pas la marque de suite. Le
+        // serveur coupe la connexion si la recherche échoue en cours de
+        // route : la liste reçue jusque-là est incomplète et retirée
+        string frame = receiveFromServer();
+        if (frame.empty()) {
+            clearTableConsultations();
+            dialogError("Erreur Recherche", "Recherche interrompue, résultats incomplets");
+            return false;
+        }
+        last = frame[0] != MARQUE_SUITE;
+        pending.append(frame, last ? 0 : 1, string::npos);
+        if (last) {
+            pending += '|'; // Terminer la dernière consultation
+        }
+    }
+    
+    dialogMessage("Recherche", "Recherche terminée - " + to_string(ui->tableWidgetConsultations->rowCount()) + " consultation(s) trouvée(s)");
+    return true;
+}
+
+void MainWindowClientConsultationBooker::addConsultationRow(const string& consultation)
+{
+    // Parser la consultation: ID;SPECIALTY;DOCTOR;DATE;HOUR
+    size_t pos1 = consultation.find(';');
+    size_t pos2 = consultation.find(';', pos1 + 1);
+    size_t pos3 = consultation.find(';', pos2 + 1);
+    size_t pos4 = consultation.find(';', pos3 + 1);
+    
+    if (pos1 != string::npos && pos2 != string::npos && pos3 != string::npos && pos4 != string::npos) {
+        int id = stoi(consultation.substr(0, pos1));
+        string specialty = consultation.substr(pos1 + 1, pos2 - pos1 - 1);
+        string doctor = consultation.substr(pos2 + 1, pos3 - pos2 - 1);
+        string date = consultation.substr(pos3 + 1, pos4 - pos3 - 1);
+        string hour = consultation.substr(pos4 + 1);
+        
+        addTupleTableConsultations(id, specialty, doctor, date, hour);
+    }
+}
+
 void MainWindowClientConsultationBooker::loadSpecialties()
 {
     if (!connectToServer()) return;
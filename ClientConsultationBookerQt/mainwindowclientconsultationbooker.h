@@ -51,7 +51,9 @@ public:
     string dialogInputText(const string& title,const string& question);
     int dialogInputInt(const string& title,const string& question);
     bool C_connectToServer = false; // Indicateur de connexion au serveur
+    bool C_connecting = false; // Connexion au serveur en cours (fenêtre désactivée)
     int C_clientSocket = -1; // Socket client pour la communication avec le serveur
+    FrameReader C_reader; // Trames reçues du serveur et pas encore lues
     bool connectToServer();
     
     // Fonctions de communication avec le serveur
@@ -61,6 +63,8 @@ public:
     
     // Fonctions de recherche
     bool handleSearchResponse(const string& response);
+    bool receiveSearchResponse();
+    void addConsultationRow(const string& consultation);
     void loadSpecialties();
     void loadDoctors();
     void loadAllDoctors();
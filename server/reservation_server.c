@@ -2,6 +2,7 @@
 #include <signal.h>
 #include <unistd.h>
 #include <errno.h>
+#include <sys/socket.h>
 
 // Variable globale pour le serveur (pour gestion des signaux)
 static ReservationServer* g_server = NULL;
@@ -24,26 +25,31 @@ ReservationServer* create_reservation_server(const char* config_file) {
     
     // Initialiser les valeurs par défaut
     server->server_socket = NULL;
-    server->db_connection = NULL;
     server->thread_pool = NULL;
+    server->thread_data = NULL;
     server->thread_pool_size = 0;
     server->server_running = 0;
     server->connected_patients = NULL;
     server->max_patients = 100;
     server->current_patients = 0;
+    server->queue_head = 0;
+    server->queue_count = 0;
+    server->queue_closed = 0;
     
-    // Initialiser le mutex
+    // Initialiser les mutex et conditions
     if (pthread_mutex_init(&server->patients_mutex, NULL) != 0) {
         printf("Erreur: Impossible d'initialiser le mutex\n");
         free(server);
         return NULL;
     }
+    pthread_mutex_init(&server->queue_mutex, NULL);
+    pthread_cond_init(&server->queue_not_empty, NULL);
+    pthread_cond_init(&server->queue_not_full, NULL);
     
     // Charger la configuration
     if (load_config(config_file, &server->config) != 0) {
         printf("Erreur: Impossible de charger la configuration\n");
-        pthread_mutex_destroy(&server->patients_mutex);
-        free(server);
+        destroy_reservation_server(server);
         return NULL;
     }
     
@@ -51,21 +57,15 @@ ReservationServer* create_reservation_server(const char* config_file) {
     server->connected_patients = (ConnectedPatient*)calloc(server->max_patients, sizeof(ConnectedPatient));
     if (!server->connected_patients) {
         printf("Erreur: Impossible d'allouer la mémoire pour les patients connectés\n");
-        pthread_mutex_destroy(&server->patients_mutex);
-        free(server);
+        destroy_reservation_server(server);
         return NULL;
     }
     
-    // Se connecter à la base de données
-    server->db_connection = connect_database(server->config.db_host, 
-                                           server->config.db_user, 
-                                           server->config.db_password, 
-                                           server->config.db_name);
-    if (!server->db_connection) {
-        printf("Erreur: Impossible de se connecter à la base de données\n");
-        free(server->connected_patients);
-        pthread_mutex_destroy(&server->patients_mutex);
-        free(server);
+    // Initialiser la librairie MySQL avant de créer des threads
+    // (chaque thread ouvrira ensuite sa propre connexion)
+    if (mysql_library_init(0, NULL, NULL) != 0) {
+        printf("Erreur: Impossible d'initialiser la librairie MySQL\n");
+        destroy_reservation_server(server);
         return NULL;
     }
     
@@ -73,31 +73,20 @@ ReservationServer* create_reservation_server(const char* config_file) {
     server->server_socket = create_socket();
     if (!server->server_socket) {
         printf("Erreur: Impossible de créer le socket serveur\n");
-        disconnect_database(server->db_connection);
-        free(server->connected_patients);
-        pthread_mutex_destroy(&server->patients_mutex);
-        free(server);
+        destroy_reservation_server(server);
         return NULL;
     }
     
     // Configurer le serveur
     if (bind_socket(server->server_socket, server->config.port_reservation) != 0) {
         printf("Erreur: Impossible de lier le socket au port %d\n", server->config.port_reservation);
-        destroy_socket(server->server_socket);
-        disconnect_database(server->db_connection);
-        free(server->connected_patients);
-        pthread_mutex_destroy(&server->patients_mutex);
-        free(server);
+        destroy_reservation_server(server);
         return NULL;
     }
     
     if (listen_socket(server->server_socket, 10) != 0) {
         printf("Erreur: Impossible de mettre le socket en mode écoute\n");
-        destroy_socket(server->server_socket);
-        disconnect_database(server->db_connection);
-        free(server->connected_patients);
-        pthread_mutex_destroy(&server->patients_mutex);
-        free(server);
+        destroy_reservation_server(server);
         return NULL;
     }
     
@@ -107,18 +96,74 @@ ReservationServer* create_reservation_server(const char* config_file) {
     return server;
 }
 
+// Fermer la file des clients et réveiller tous les threads
+static void close_client_queue(ReservationServer* server) {
+    pthread_mutex_lock(&server->queue_mutex);
+    server->queue_closed = 1;
+    pthread_cond_broadcast(&server->queue_not_empty);
+    pthread_cond_broadcast(&server->queue_not_full);
+    pthread_mutex_unlock(&server->queue_mutex);
+}
+
+// Arrêter les threads du pool et fermer leurs connexions MySQL
+static void join_thread_pool(ReservationServer* server, int started) {
+    close_client_queue(server);
+    
+    // Débloquer les threads en attente d'un message de leur client
+    pthread_mutex_lock(&server->queue_mutex);
+    for (int i = 0; i < started; i++) {
+        if (server->thread_data[i].client_socket) {
+            shutdown(get_socket_fd(server->thread_data[i].client_socket), SHUT_RDWR);
+        }
+    }
+    pthread_mutex_unlock(&server->queue_mutex);
+    
+    for (int i = 0; i < started; i++) {
+        pthread_join(server->thread_pool[i], NULL);
+    }
+    for (int i = 0; i < server->thread_pool_size; i++) {
+        disconnect_database(server->thread_data[i].db_connection);
+        server->thread_data[i].db_connection = NULL;
+    }
+}
+
 // Démarrer le serveur
 int start_reservation_server(ReservationServer* server) {
     if (!server) return -1;
     
     // Allouer la mémoire pour le pool de threads
     server->thread_pool_size = server->config.thread_pool_size;
+    if (server->thread_pool_size <= 0) {
+        printf("Erreur: Taille du pool de threads invalide (%d)\n", server->thread_pool_size);
+        return -1;
+    }
     server->thread_pool = (pthread_t*)malloc(server->thread_pool_size * sizeof(pthread_t));
-    if (!server->thread_pool) {
+    server->thread_data = (ThreadData*)calloc(server->thread_pool_size, sizeof(ThreadData));
+    if (!server->thread_pool || !server->thread_data) {
         printf("Erreur: Impossible d'allouer la mémoire pour le pool de threads\n");
         return -1;
     }
     
+    // Une connexion MySQL par thread : une connexion ne doit jamais être
+    // utilisée par deux threads à la fois
+    for (int i = 0; i < server->thread_pool_size; i++) {
+        server->thread_data[i].server = server;
+        server->thread_data[i].thread_id = i;
+        server->thread_data[i].client_socket = NULL;
+        server->thread_data[i].db_connection = connect_database(server->config.db_host,
+                                                                server->config.db_user,
+                                                                server->config.db_password,
+                                                                server->config.db_name);
+        if (!server->thread_data[i].db_connection) {
+            printf("Erreur: Impossible de se connecter à la base de données (thread %d)\n", i);
+            join_thread_pool(server, 0);
+            return -1;
+        }
+    }
+    
+    // Marquer le serveur actif avant les signaux et les threads
+    server->server_running = 1;
+    
     // Configurer le gestionnaire de signaux
     g_server = server;
     signal(SIGINT, signal_handler);
@@ -126,19 +171,14 @@ int start_reservation_server(ReservationServer* server) {
     
     // Créer les threads du pool
     for (int i = 0; i < server->thread_pool_size; i++) {
-        ThreadData* thread_data = (ThreadData*)malloc(sizeof(ThreadData));
-        thread_data->server = server;
-        thread_data->thread_id = i;
-        thread_data->client_socket = NULL;
-        
-        if (pthread_create(&server->thread_pool[i], NULL, thread_worker, thread_data) != 0) {
+        if (pthread_create(&server->thread_pool[i], NULL, thread_worker, &server->thread_data[i]) != 0) {
             printf("Erreur: Impossible de créer le thread %d\n", i);
             server->server_running = 0;
+            join_thread_pool(server, i);
             return -1;
         }
     }
     
-    server->server_running = 1;
     printf("Serveur démarré sur le port %d avec %d threads\n", 
            server->config.port_reservation, server->thread_pool_size);
     
@@ -149,30 +189,33 @@ int start_reservation_server(ReservationServer* server) {
             printf("Nouvelle connexion acceptée de %s:%d\n", 
                    client_socket->address.ip, client_socket->address.port);
             
-            // Trouver un thread libre pour traiter cette connexion
-            // Pour simplifier, on utilise le premier thread disponible
-            // Dans une implémentation plus avancée, on utiliserait une queue de tâches
-            handle_client_connection(server, client_socket);
+            // Confier la connexion au pool (attend si la file est pleine)
+            if (enqueue_client(server, client_socket) != 0) {
+                close_socket(client_socket);
+                destroy_socket(client_socket);
+            }
         } else if (server->server_running) {
             printf("Erreur lors de l'acceptation de la connexion\n");
         }
     }
     
+    // Attendre que tous les threads se terminent
+    join_thread_pool(server, server->thread_pool_size);
+    printf("Serveur arrêté\n");
+    
     return 0;
 }
 
-// Arrêter le serveur
+// Arrêter le serveur (appelable depuis un gestionnaire de signal)
 void stop_reservation_server(ReservationServer* server) {
     if (!server) return;
     
     server->server_running = 0;
     
-    // Attendre que tous les threads se terminent
-    for (int i = 0; i < server->thread_pool_size; i++) {
-        pthread_join(server->thread_pool[i], NULL);
+    // Débloquer accept() : la boucle principale termine alors les threads
+    if (server->server_socket) {
+        shutdown(get_socket_fd(server->server_socket), SHUT_RDWR);
     }
-    
-    printf("Serveur arrêté\n");
 }
 
 // Détruire le serveur
@@ -181,7 +224,7 @@ void destroy_reservation_server(ReservationServer* server) {
     
     // Fermer toutes les connexions clients
     pthread_mutex_lock(&server->patients_mutex);
-    for (int i = 0; i < server->max_patients; i++) {
+    for (int i = 0; server->connected_patients && i < server->max_patients; i++) {
         if (server->connected_patients[i].socket) {
             close_socket(server->connected_patients[i].socket);
             destroy_socket(server->connected_patients[i].socket);
@@ -189,47 +232,114 @@ void destroy_reservation_server(ReservationServer* server) {
     }
     pthread_mutex_unlock(&server->patients_mutex);
     
+    // Fermer les connexions restées dans la file
+    for (int i = 0; i < server->queue_count; i++) {
+        Socket* client_socket = server->client_queue[(server->queue_head + i) % CLIENT_QUEUE_CAPACITY];
+        close_socket(client_socket);
+        destroy_socket(client_socket);
+    }
+    
     // Nettoyer les ressources
     if (server->server_socket) {
         destroy_socket(server->server_socket);
     }
     
-    if (server->db_connection) {
-        disconnect_database(server->db_connection);
-    }
-    
     if (server->thread_pool) {
         free(server->thread_pool);
     }
     
+    if (server->thread_data) {
+        for (int i = 0; i < server->thread_pool_size; i++) {
+            disconnect_database(server->thread_data[i].db_connection);
+        }
+        free(server->thread_data);
+    }
+    
     if (server->connected_patients) {
         free(server->connected_patients);
     }
     
+    mysql_library_end();
+    
+    pthread_cond_destroy(&server->queue_not_full);
+    pthread_cond_destroy(&server->queue_not_empty);
+    pthread_mutex_destroy(&server->queue_mutex);
     pthread_mutex_destroy(&server->patients_mutex);
     free(server);
 }
 
+// Ajouter une connexion acceptée à la file (attend une place si elle est pleine)
+// Retourne 0 en cas de succès, -1 si le serveur s'arrête
+int enqueue_client(ReservationServer* server, Socket* client_socket) {
+    pthread_mutex_lock(&server->queue_mutex);
+    while (server->queue_count == CLIENT_QUEUE_CAPACITY && !server->queue_closed) {
+        pthread_cond_wait(&server->queue_not_full, &server->queue_mutex);
+    }
+    if (server->queue_closed) {
+        pthread_mutex_unlock(&server->queue_mutex);
+        return -1;
+    }
+    
+    int tail = (server->queue_head + server->queue_count) % CLIENT_QUEUE_CAPACITY;
+    server->client_queue[tail] = client_socket;
+    server->queue_count++;
+    pthread_cond_signal(&server->queue_not_empty);
+    pthread_mutex_unlock(&server->queue_mutex);
+    return 0;
+}
+
+// Retirer la prochaine connexion de la file (attend tant qu'elle est vide)
+// et l'enregistrer comme client courant du thread
+// Retourne NULL quand la file est fermée et vide
+Socket* dequeue_client(ReservationServer* server, ThreadData* data) {
+    pthread_mutex_lock(&server->queue_mutex);
+    while (server->queue_count == 0 && !server->queue_closed) {
+        pthread_cond_wait(&server->queue_not_empty, &server->queue_mutex);
+    }
+    if (server->queue_count == 0) {
+        pthread_mutex_unlock(&server->queue_mutex);
+        return NULL;
+    }
+    
+    Socket* client_socket = server->client_queue[server->queue_head];
+    server->queue_head = (server->queue_head + 1) % CLIENT_QUEUE_CAPACITY;
+    server->queue_count--;
+    data->client_socket = client_socket;
+    pthread_cond_signal(&server->queue_not_full);
+    pthread_mutex_unlock(&server->queue_mutex);
+    return client_socket;
+}
+
 // Fonction de travail des threads
 void* thread_worker(void* arg) {
     ThreadData* data = (ThreadData*)arg;
     ReservationServer* server = data->server;
     
+    mysql_thread_init();
     printf("Thread %d démarré\n", data->thread_id);
     
-    // Dans cette implémentation simplifiée, les threads attendent
-    // Dans une version plus avancée, ils traiteraient une queue de tâches
-    while (server->server_running) {
-        usleep(100000); // 100ms
+    // Traiter les connexions de la file jusqu'à sa fermeture
+    Socket* client_socket;
+    while ((client_socket = dequeue_client(server, data)) != NULL) {
+        handle_client_connection(server, data->db_connection, client_socket);
+        
+        // Oublier le client avant de libérer son socket
+        pthread_mutex_lock(&server->queue_mutex);
+        data->client_socket = NULL;
+        pthread_mutex_unlock(&server->queue_mutex);
+        
+        remove_socket_patients(server, client_socket);
+        close_socket(client_socket);
+        destroy_socket(client_socket);
     }
     
     printf("Thread %d terminé\n", data->thread_id);
-    free(data);
+    mysql_thread_end();
     return NULL;
 }
 
-// Gérer une connexion client
-void handle_client_connection(ReservationServer* server, Socket* client_socket) {
+// Gérer une connexion client (le socket est fermé par l'appelant)
+void handle_client_connection(ReservationServer* server, MYSQL* db_connection, Socket* client_socket) {
     char buffer[CBP_MAX_MESSAGE_SIZE];
     CBPMessage message;
     
@@ -255,22 +365,22 @@ void handle_client_connection(ReservationServer* server, Socket* client_socket)
         // Traiter la commande
         switch (message.command) {
             case CBP_LOGIN:
-                process_login_command(server, client_socket, &message);
+                process_login_command(server, db_connection, client_socket, &message);
                 break;
             case CBP_LOGOUT:
                 process_logout_command(server, client_socket, &message);
                 break;
             case CBP_GET_SPECIALTIES:
-                process_get_specialties_command(server, client_socket, &message);
+                process_get_specialties_command(server, db_connection, client_socket, &message);
                 break;
             case CBP_GET_DOCTORS:
-                process_get_doctors_command(server, client_socket, &message);
+                process_get_doctors_command(server, db_connection, client_socket, &message);
                 break;
             case CBP_SEARCH_CONSULTATIONS:
-                process_search_consultations_command(server, client_socket, &message);
+                process_search_consultations_command(server, db_connection, client_socket, &message);
                 break;
             case CBP_BOOK_CONSULTATION:
-                process_book_consultation_command(server, client_socket, &message);
+                process_book_consultation_command(server, db_connection, client_socket, &message);
                 break;
             default:
                 printf("Commande inconnue: %d\n", message.command);
@@ -278,14 +388,10 @@ void handle_client_connection(ReservationServer* server, Socket* client_socket)
                 break;
         }
     }
-    
-    // Fermer la connexion
-    close_socket(client_socket);
-    destroy_socket(client_socket);
 }
 
 // Traiter la commande LOGIN
-void process_login_command(ReservationServer* server, Socket* client_socket, const CBPMessage* msg) {
+void process_login_command(ReservationServer* server, MYSQL* db_connection, Socket* client_socket, const CBPMessage* msg) {
     CBPLoginData login_data;
     CBPResponse response;
     
@@ -300,7 +406,7 @@ void process_login_command(ReservationServer* server, Socket* client_socket, con
     
     if (login_data.is_new_patient) {
         // Créer un nouveau patient
-        int new_patient_id = create_patient(server->db_connection, 
+        int new_patient_id = create_patient(db_connection, 
                                           login_data.last_name, 
                                           login_data.first_name, 
                                           "1990-01-01"); // Date par défaut
@@ -323,7 +429,7 @@ void process_login_command(ReservationServer* server, Socket* client_socket, con
         }
     } else {
         // Authentifier le patient existant
-        if (authenticate_patient(server->db_connection, 
+        if (authenticate_patient(db_connection, 
                                login_data.last_name, 
                                login_data.first_name, 
                                login_data.patient_id)) {
@@ -400,9 +506,9 @@ void process_logout_command(ReservationServer* server, Socket* client_socket, co
 }
 
 // Traiter la commande GET_SPECIALTIES
-void process_get_specialties_command(ReservationServer* server, Socket* client_socket, const CBPMessage* msg) {
+void process_get_specialties_command(ReservationServer* server, MYSQL* db_connection, Socket* client_socket, const CBPMessage* msg) {
     int count;
-    Specialty* specialties = get_specialties(server->db_connection, &count);
+    Specialty* specialties = get_specialties(db_connection, &count);
     
     if (!specialties) {
         send_error_response(client_socket, "Erreur lors de la récupération des spécialités");
@@ -436,9 +542,9 @@ void process_get_specialties_command(ReservationServer* server, Socket* client_s
 }
 
 // Traiter la commande GET_DOCTORS
-void process_get_doctors_command(ReservationServer* server, Socket* client_socket, const CBPMessage* msg) {
+void process_get_doctors_command(ReservationServer* server, MYSQL* db_connection, Socket* client_socket, const CBPMessage* msg) {
     int count;
-    Doctor* doctors = get_doctors(server->db_connection, &count);
+    Doctor* doctors = get_doctors(db_connection, &count);
     
     if (!doctors) {
         send_error_response(client_socket, "Erreur lors de la récupération des médecins");
@@ -473,7 +579,7 @@ void process_get_doctors_command(ReservationServer* server, Socket* client_socke
 }
 
 // Traiter la commande SEARCH_CONSULTATIONS
-void process_search_consultations_command(ReservationServer* server, Socket* client_socket, const CBPMessage* msg) {
+void process_search_consultations_command(ReservationServer* server, MYSQL* db_connection, Socket* client_socket, const CBPMessage* msg) {
     CBPSearchData search_data;
     
     if (deserialize_search_data(msg->data, msg->data_length, &search_data) <= 0) {
@@ -486,7 +592,7 @@ void process_search_consultations_command(ReservationServer* server, Socket* cli
            search_data.start_date, search_data.end_date);
     
     int count;
-    ConsultationDetails* consultations = search_consultations(server->db_connection,
+    ConsultationDetails* consultations = search_consultations(db_connection,
                                                             search_data.specialty_id,
                                                             search_data.doctor_id,
                                                             search_data.start_date,
@@ -528,7 +634,7 @@ void process_search_consultations_command(ReservationServer* server, Socket* cli
 }
 
 // Traiter la commande BOOK_CONSULTATION
-void process_book_consultation_command(ReservationServer* server, Socket* client_socket, const CBPMessage* msg) {
+void process_book_consultation_command(ReservationServer* server, MYSQL* db_connection, Socket* client_socket, const CBPMessage* msg) {
     CBPBookData book_data;
     CBPResponse response;
     
@@ -557,7 +663,7 @@ void process_book_consultation_command(ReservationServer* server, Socket* client
         strcpy(response.message, "Patient non connecté");
     } else {
         // Effectuer la réservation
-        if (book_consultation(server->db_connection, book_data.consultation_id, patient_id, book_data.reason)) {
+        if (book_consultation(db_connection, book_data.consultation_id, patient_id, book_data.reason)) {
             response.success = 1;
             response.patient_id = patient_id;
             strcpy(response.message, "Réservation effectuée avec succès");
@@ -628,6 +734,22 @@ void remove_connected_patient(ReservationServer* server, int patient_id) {
     pthread_mutex_unlock(&server->patients_mutex);
 }
 
+// Supprimer les patients associés à une connexion qui se ferme
+void remove_socket_patients(ReservationServer* server, Socket* socket) {
+    pthread_mutex_lock(&server->patients_mutex);
+    
+    for (int i = 0; i < server->max_patients; i++) {
+        if (server->connected_patients[i].patient_id != 0 &&
+            server->connected_patients[i].socket == socket) {
+            server->connected_patients[i].patient_id = 0;
+            server->connected_patients[i].socket = NULL;
+            server->current_patients--;
+        }
+    }
+    
+    pthread_mutex_unlock(&server->patients_mutex);
+}
+
 // Trouver un patient connecté
 ConnectedPatient* find_connected_patient(ReservationServer* server, int patient_id) {
     pthread_mutex_lock(&server->patients_mutex);
@@ -6,8 +6,11 @@
 #include "database.h"
 #include "cbp_protocol.h"
 #include <pthread.h>
+#include <signal.h>
 #include <sys/time.h>
 
+#define CLIENT_QUEUE_CAPACITY 64   // Connexions acceptées en attente d'un thread
+
 // Structure pour représenter un patient connecté
 typedef struct {
     int patient_id;
@@ -18,26 +21,38 @@ typedef struct {
     Socket* socket;
 } ConnectedPatient;
 
-// Structure pour le serveur
+typedef struct ReservationServer ReservationServer;
+
+// Structure pour passer des données aux threads
 typedef struct {
+    ReservationServer* server;
+    Socket* client_socket;      // Client en cours de traitement (protégé par queue_mutex)
+    MYSQL* db_connection;       // Connexion MySQL propre au thread
+    int thread_id;
+} ThreadData;
+
+// Structure pour le serveur
+struct ReservationServer {
     Socket* server_socket;
     ServerConfig config;
-    MYSQL* db_connection;
     pthread_t* thread_pool;
+    ThreadData* thread_data;
     int thread_pool_size;
-    int server_running;
+    volatile sig_atomic_t server_running;
     pthread_mutex_t patients_mutex;
     ConnectedPatient* connected_patients;
     int max_patients;
     int current_patients;
-} ReservationServer;
 
-// Structure pour passer des données aux threads
-typedef struct {
-    ReservationServer* server;
-    Socket* client_socket;
-    int thread_id;
-} ThreadData;
+    // File des connexions acceptées (tampon circulaire borné)
+    Socket* client_queue[CLIENT_QUEUE_CAPACITY];
+    int queue_head;
+    int queue_count;
+    int queue_closed;
+    pthread_mutex_t queue_mutex;
+    pthread_cond_t queue_not_empty;
+    pthread_cond_t queue_not_full;
+};
 
 // Fonctions principales du serveur
 ReservationServer* create_reservation_server(const char* config_file);
@@ -47,22 +62,25 @@ void destroy_reservation_server(ReservationServer* server);
 
 // Fonctions de gestion des threads
 void* thread_worker(void* arg);
-void handle_client_connection(ReservationServer* server, Socket* client_socket);
+int enqueue_client(ReservationServer* server, Socket* client_socket);
+Socket* dequeue_client(ReservationServer* server, ThreadData* data);
+void handle_client_connection(ReservationServer* server, MYSQL* db_connection, Socket* client_socket);
 
 // Fonctions de gestion des patients connectés
 int add_connected_patient(ReservationServer* server, int patient_id, const char* last_name, 
                          const char* first_name, const char* ip_address, Socket* socket);
 void remove_connected_patient(ReservationServer* server, int patient_id);
 ConnectedPatient* find_connected_patient(ReservationServer* server, int patient_id);
+void remove_socket_patients(ReservationServer* server, Socket* socket);
 void print_connected_patients(ReservationServer* server);
 
 // Fonctions de traitement des commandes CBP
-void process_login_command(ReservationServer* server, Socket* client_socket, const CBPMessage* msg);
+void process_login_command(ReservationServer* server, MYSQL* db_connection, Socket* client_socket, const CBPMessage* msg);
 void process_logout_command(ReservationServer* server, Socket* client_socket, const CBPMessage* msg);
-void process_get_specialties_command(ReservationServer* server, Socket* client_socket, const CBPMessage* msg);
-void process_get_doctors_command(ReservationServer* server, Socket* client_socket, const CBPMessage* msg);
-void process_search_consultations_command(ReservationServer* server, Socket* client_socket, const CBPMessage* msg);
-void process_book_consultation_command(ReservationServer* server, Socket* client_socket, const CBPMessage* msg);
+void process_get_specialties_command(ReservationServer* server, MYSQL* db_connection, Socket* client_socket, const CBPMessage* msg);
+void process_get_doctors_command(ReservationServer* server, MYSQL* db_connection, Socket* client_socket, const CBPMessage* msg);
+void process_search_consultations_command(ReservationServer* server, MYSQL* db_connection, Socket* client_socket, const CBPMessage* msg);
+void process_book_consultation_command(ReservationServer* server, MYSQL* db_connection, Socket* client_socket, const CBPMessage* msg);
 
 // Fonctions utilitaires
 void send_error_response(Socket* client_socket, const char* error_message);
@@ -0,0 +1,311 @@
+/**
+ * Implémentation du contrôle d'admission
+ *
+ * Le thread de mesure calcule une pression : le plus grand des rapports
+ * file / profondeur tolérée et attente / budget de latence. Le niveau de
+ * charge monte dès que la pression dépasse 1 (délestage) ou 2 (surcharge),
+ * mais ne redescend que sous la moitié de ces seuils, pour ne pas osciller
+ * d'une mesure à l'autre. AdmissionCheck ne lit que ce niveau (atomique).
+ * Entre deux mesures, les connexions admises s'ajoutent à la dernière file
+ * mesurée : une rafale de connexions ne passe pas en entier avant la mesure
+ * suivante. Les commandes n'y sont pas comptées, la plupart étant servies
+ * dans la même période.
+ *
+ * L'attente en file est celle des tâches commencées pendant la période ;
+ * une file non vide dont aucune tâche n'a commencé voit son attente grandir
+ * d'une période entière. S'y ajoute l'attente moyenne d'une connexion MySQL.
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "admission.h"
+#include <pthread.h>
+#include <errno.h>
+#include <stdio.h>
+#include <time.h>
+#include <atomic>
+
+using namespace std;
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+const double SHEDDING_PRESSURE = 1.0;   // Pression de passage en délestage
+const double OVERLOAD_PRESSURE = 2.0;   // Pression de passage en surcharge
+const double EXIT_RATIO = 0.5;          // Fraction du seuil sous laquelle le niveau redescend
+const int RETRY_MAX_FACTOR = 10;        // Délai conseillé au plus 10 fois retryMs
+
+static const char *levelNames[] = {"normal", "délestage", "surcharge"};
+static const char *classNames[ADMISSION_NB_CLASSES] = {"connexions", "SEARCH", "autres", "BOOK"};
+
+// Niveau à partir duquel chaque classe est refusée (BOOK : jamais)
+static const int rejectFrom[ADMISSION_NB_CLASSES] = {
+    ADMISSION_SHEDDING, ADMISSION_SHEDDING, ADMISSION_OVERLOAD, ADMISSION_OVERLOAD + 1
+};
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+struct Admission {
+    AdmissionConfig config;
+    Executor *executor;
+    DbPool *pool;
+    atomic<int> level{ADMISSION_NORMAL}; // Niveau courant (AdmissionLevel)
+    atomic<int> retryMs{0};         // Délai conseillé aux clients refusés
+    atomic<size_t> sampledQueued{0};    // File à la dernière mesure
+    atomic<size_t> admittedSince{0};    // Connexions admises depuis la dernière mesure
+    atomic<unsigned long long> admitted[ADMISSION_NB_CLASSES];
+    atomic<unsigned long long> rejected[ADMISSION_NB_CLASSES];
+    pthread_t thread;               // Thread de mesure
+    pthread_mutex_t mutex;          // Protège stopping, queued et waitMs
+    pthread_cond_t stopCond;        // Réveil du thread de mesure à l'arrêt
+    bool stopping;
+    size_t queued;                  // Dernière mesure de la file
+    double waitMs;                  // Dernière mesure de l'attente
+};
+
+// ============================================================================
+// FONCTIONS INTERNES
+// ============================================================================
+
+/**
+ * Échéance absolue sur l'horloge monotone, dans delayMs millisecondes
+ */
+static struct timespec deadlineIn(int delayMs) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_sec += delayMs / 1000;
+    ts.tv_nsec += (long)(delayMs % 1000) * 1000000;
+    if (ts.tv_nsec >= 1000000000) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+    }
+    return ts;
+}
+
+/**
+ * Niveau de charge suivant, avec hystérésis
+ * @param level Niveau courant
+ * @param pressure Pression mesurée
+ * @return Nouveau niveau
+ */
+static AdmissionLevel nextLevel(AdmissionLevel level, double pressure) {
+    if (pressure > OVERLOAD_PRESSURE ||
+        (level == ADMISSION_OVERLOAD && pressure > OVERLOAD_PRESSURE * EXIT_RATIO)) {
+        return ADMISSION_OVERLOAD;
+    }
+    if (pressure > SHEDDING_PRESSURE ||
+        (level != ADMISSION_NORMAL && pressure > SHEDDING_PRESSURE * EXIT_RATIO)) {
+        return ADMISSION_SHEDDING;
+    }
+    return ADMISSION_NORMAL;
+}
+
+/**
+ * Thread de mesure : met à jour le niveau de charge à chaque période
+ * @param arg Contrôle d'admission
+ * @return NULL
+ */
+static void *measureThread(void *arg) {
+    Admission *admission = (Admission *)arg;
+    const AdmissionConfig &config = admission->config;
+    ExecutorStats previous, current;
+    DbPoolStats previousDb = {}, currentDb = {};
+    double queueWaitMs = 0.0;
+    ExecutorGetStats(admission->executor, &previous);
+    if (admission->pool) {
+        DbPoolGetStats(admission->pool, &previousDb);
+    }
+
+    pthread_mutex_lock(&admission->mutex);
+    while (!admission->stopping) {
+        struct timespec deadline = deadlineIn(config.intervalMs);
+        pthread_cond_timedwait(&admission->stopCond, &admission->mutex, &deadline);
+        if (admission->stopping) {
+            break;
+        }
+        pthread_mutex_unlock(&admission->mutex);
+
+        ExecutorGetStats(admission->executor, &current);
+        unsigned long long started = current.started - previous.started;
+        if (started) {
+            queueWaitMs = (current.waitTotalUs - previous.waitTotalUs) / 1000.0 / started;
+        } else {
+            queueWaitMs = current.queued > 0 ? queueWaitMs + config.intervalMs : 0.0;
+        }
+        size_t queued = current.queued;
+        double poolWaitMs = 0.0;
+        if (admission->pool) {
+            DbPoolGetStats(admission->pool, &currentDb);
+            unsigned long long acquired = currentDb.acquired - previousDb.acquired;
+            if (acquired) {
+                poolWaitMs = (currentDb.waitTotalUs - previousDb.waitTotalUs) / 1000.0 / acquired;
+            }
+            queued += currentDb.waiting;
+            previousDb = currentDb;
+        }
+        previous = current;
+        double waitMs = queueWaitMs + poolWaitMs;
+
+        double pressure = 0.0;
+        if (config.maxQueueDepth > 0) {
+            pressure = (double)queued / config.maxQueueDepth;
+        }
+        if (config.latencyBudgetMs > 0 && waitMs / config.latencyBudgetMs > pressure) {
+            pressure = waitMs / config.latencyBudgetMs;
+        }
+        AdmissionLevel level = (AdmissionLevel)admission->level.load(memory_order_relaxed);
+        AdmissionLevel next = nextLevel(level, pressure);
+
+        // Revenir quand la file actuelle aura eu le temps de s'écouler
+        int retryMs = waitMs > config.retryMs ? (int)waitMs : config.retryMs;
+        if (retryMs > config.retryMs * RETRY_MAX_FACTOR) {
+            retryMs = config.retryMs * RETRY_MAX_FACTOR;
+        }
+        admission->retryMs.store(retryMs, memory_order_relaxed);
+        admission->level.store(next, memory_order_relaxed);
+        admission->sampledQueued.store(queued, memory_order_relaxed);
+        admission->admittedSince.store(0, memory_order_relaxed);
+        if (next != level) {
+            printf("Admission: %s -> %s (file %zu, attente %.1f ms, réessai conseillé %d ms)\n",
+                   levelNames[level], levelNames[next], queued, waitMs, retryMs);
+        }
+
+        pthread_mutex_lock(&admission->mutex);
+        admission->queued = queued;
+        admission->waitMs = waitMs;
+    }
+    pthread_mutex_unlock(&admission->mutex);
+    return NULL;
+}
+
+// ============================================================================
+// FONCTIONS PUBLIQUES
+// ============================================================================
+
+/**
+ * Démarre la mesure de la charge
+ * @param config Paramètres
+ * @param executor Exécuteur observé
+ * @param pool Pool MySQL observé (ou NULL)
+ * @return Contrôle d'admission créé ou NULL en cas d'erreur
+ */
+Admission *AdmissionCreate(const AdmissionConfig *config, Executor *executor, DbPool *pool) {
+    if (!executor || config->intervalMs <= 0 || config->retryMs <= 0 ||
+        (config->maxQueueDepth <= 0 && config->latencyBudgetMs <= 0)) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    Admission *admission = new Admission();
+    admission->config = *config;
+    admission->executor = executor;
+    admission->pool = pool;
+    admission->retryMs.store(config->retryMs, memory_order_relaxed);
+    for (int i = 0; i < ADMISSION_NB_CLASSES; i++) {
+        admission->admitted[i].store(0, memory_order_relaxed);
+        admission->rejected[i].store(0, memory_order_relaxed);
+    }
+    admission->stopping = false;
+    admission->queued = 0;
+    admission->waitMs = 0.0;
+
+    pthread_mutex_init(&admission->mutex, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&admission->stopCond, &attr);
+    pthread_condattr_destroy(&attr);
+    if (pthread_create(&admission->thread, NULL, measureThread, admission) != 0) {
+        pthread_cond_destroy(&admission->stopCond);
+        pthread_mutex_destroy(&admission->mutex);
+        delete admission;
+        return NULL;
+    }
+    return admission;
+}
+
+/**
+ * Arrête la mesure et libère le contrôle d'admission
+ * @param admission Contrôle d'admission
+ */
+void AdmissionDestroy(Admission *admission) {
+    if (!admission) {
+        return;
+    }
+
+    pthread_mutex_lock(&admission->mutex);
+    admission->stopping = true;
+    pthread_cond_signal(&admission->stopCond);
+    pthread_mutex_unlock(&admission->mutex);
+    pthread_join(admission->thread, NULL);
+
+    pthread_cond_destroy(&admission->stopCond);
+    pthread_mutex_destroy(&admission->mutex);
+    delete admission;
+}
+
+/**
+ * Décide d'admettre un travail (voir admission.h)
+ * @param admission Contrôle d'admission
+ * @param workClass Classe du travail
+ * @return 0 si admis, sinon délai conseillé avant de réessayer (ms)
+ */
+int AdmissionCheck(Admission *admission, AdmissionClass workClass) {
+    int level = admission->level.load(memory_order_relaxed);
+    size_t maxQueueDepth = admission->config.maxQueueDepth;
+    if (workClass == ADMISSION_SESSION && maxQueueDepth > 0) {
+        // File estimée depuis la dernière mesure
+        size_t queued = admission->sampledQueued.load(memory_order_relaxed) +
+                        admission->admittedSince.load(memory_order_relaxed);
+        if (queued > maxQueueDepth * OVERLOAD_PRESSURE) {
+            level = ADMISSION_OVERLOAD;
+        } else if (queued > maxQueueDepth * SHEDDING_PRESSURE && level < ADMISSION_SHEDDING) {
+            level = ADMISSION_SHEDDING;
+        }
+    }
+    if (level >= rejectFrom[workClass]) {
+        admission->rejected[workClass].fetch_add(1, memory_order_relaxed);
+        return admission->retryMs.load(memory_order_relaxed);
+    }
+    admission->admitted[workClass].fetch_add(1, memory_order_relaxed);
+    if (workClass == ADMISSION_SESSION) {
+        admission->admittedSince.fetch_add(1, memory_order_relaxed);
+    }
+    return 0;
+}
+
+/**
+ * Copie les métriques courantes du contrôle d'admission
+ * @param admission Contrôle d'admission
+ * @param stats Métriques à remplir
+ */
+void AdmissionGetStats(Admission *admission, AdmissionStats *stats) {
+    stats->level = (AdmissionLevel)admission->level.load(memory_order_relaxed);
+    pthread_mutex_lock(&admission->mutex);
+    stats->queued = admission->queued;
+    stats->waitMs = admission->waitMs;
+    pthread_mutex_unlock(&admission->mutex);
+    for (int i = 0; i < ADMISSION_NB_CLASSES; i++) {
+        stats->admitted[i] = admission->admitted[i].load(memory_order_relaxed);
+        stats->rejected[i] = admission->rejected[i].load(memory_order_relaxed);
+    }
+}
+
+/**
+ * Affiche les métriques du contrôle d'admission sur une ligne
+ * @param admission Contrôle d'admission
+ */
+void AdmissionReport(Admission *admission) {
+    AdmissionStats stats;
+    AdmissionGetStats(admission, &stats);
+    printf("Admission: niveau %s (file %zu, attente %.1f ms)", levelNames[stats.level],
+           stats.queued, stats.waitMs);
+    for (int i = 0; i < ADMISSION_NB_CLASSES; i++) {
+        printf(", %s %llu admis / %llu refusés", classNames[i], stats.admitted[i],
+               stats.rejected[i]);
+    }
+    printf("\n");
+}
@@ -0,0 +1,112 @@
+/**
+ * Contrôle d'admission
+ *
+ * Un thread de mesure observe périodiquement la file de l'exécuteur qui
+ * attend MySQL et la file d'attente du pool de connexions. Au-delà d'une
+ * profondeur de file ou d'un budget de latence, les nouvelles connexions et
+ * commandes sont refusées aussitôt (réponse BUSY;retry_ms) au lieu d'attendre
+ * en file jusqu'à l'abandon du client. Le délestage suit des priorités : les
+ * nouvelles connexions et les recherches sont refusées les premières, les
+ * autres commandes seulement en forte surcharge, les réservations jamais.
+ */
+
+#ifndef ADMISSION_H
+#define ADMISSION_H
+
+#include "executor.h"
+#include "dbpool.h"
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Classes de travail, de la première refusée à la dernière
+ */
+typedef enum {
+    ADMISSION_SESSION,              // Nouvelle connexion
+    ADMISSION_SEARCH,               // Recherche de consultations
+    ADMISSION_QUERY,                // Autres commandes (login, listes)
+    ADMISSION_BOOK,                 // Réservation (jamais refusée)
+    ADMISSION_NB_CLASSES
+} AdmissionClass;
+
+/**
+ * Niveaux de charge
+ */
+typedef enum {
+    ADMISSION_NORMAL,               // Tout est admis
+    ADMISSION_SHEDDING,             // Connexions et recherches refusées
+    ADMISSION_OVERLOAD              // Seules les réservations sont admises
+} AdmissionLevel;
+
+/**
+ * Paramètres du contrôle d'admission
+ */
+typedef struct {
+    int maxQueueDepth;              // Tâches et emprunts en attente tolérés (0 = ignoré)
+    int latencyBudgetMs;            // Attente en file tolérée (0 = ignorée)
+    int retryMs;                    // Délai minimal conseillé aux clients refusés
+    int intervalMs;                 // Période de mesure
+} AdmissionConfig;
+
+/**
+ * Métriques du contrôle d'admission
+ */
+typedef struct {
+    AdmissionLevel level;           // Niveau de charge courant
+    size_t queued;                  // Tâches et emprunts en attente (dernière mesure)
+    double waitMs;                  // Attente moyenne en file (dernière mesure)
+    unsigned long long admitted[ADMISSION_NB_CLASSES]; // Admissions par classe
+    unsigned long long rejected[ADMISSION_NB_CLASSES]; // Refus par classe
+} AdmissionStats;
+
+/**
+ * Contrôle d'admission (structure opaque, thread-safe)
+ */
+typedef struct Admission Admission;
+
+// ============================================================================
+// FONCTIONS
+// ============================================================================
+
+/**
+ * Démarre la mesure de la charge
+ * @param config Paramètres
+ * @param executor Exécuteur dont la file est observée
+ * @param pool Pool MySQL dont la file d'attente est observée (NULL = ignoré)
+ * @return Contrôle d'admission créé ou NULL en cas d'erreur
+ */
+Admission *AdmissionCreate(const AdmissionConfig *config, Executor *executor, DbPool *pool);
+
+/**
+ * Arrête la mesure et libère le contrôle d'admission
+ * @param admission Contrôle d'admission
+ */
+void AdmissionDestroy(Admission *admission);
+
+/**
+ * Décide d'admettre un travail selon le niveau de charge courant (et, pour
+ * une connexion, la file estimée depuis la dernière mesure), sans verrou ni
+ * appel système
+ * @param admission Contrôle d'admission
+ * @param workClass Classe du travail
+ * @return 0 si le travail est admis, sinon le délai conseillé avant de
+ *         réessayer (ms)
+ */
+int AdmissionCheck(Admission *admission, AdmissionClass workClass);
+
+/**
+ * Copie les métriques courantes du contrôle d'admission
+ * @param admission Contrôle d'admission
+ * @param stats Métriques à remplir
+ */
+void AdmissionGetStats(Admission *admission, AdmissionStats *stats);
+
+/**
+ * Affiche les métriques du contrôle d'admission sur une ligne
+ * @param admission Contrôle d'admission
+ */
+void AdmissionReport(Admission *admission);
+
+#endif // ADMISSION_H
@@ -0,0 +1,275 @@
+/**
+ * Banc d'essai : requêtes texte contre requêtes préparées (couche dal.h)
+ *
+ * Chaque thread ouvre sa propre connexion MySQL et exécute le mélange de
+ * lectures du serveur : les quatre combinaisons de filtres de SEARCH, la
+ * vérification d'un patient (LOGIN_EXIST) et la liste des médecins d'une
+ * spécialité (GET_DOCTORS). Deux variantes :
+ * - texte : SQL construit par concaténation puis analysé par MySQL à chaque
+ *   appel (mysql_query, mysql_store_result), comme avant la couche dal.h ;
+ * - mysql_stmt : DalSelect, requêtes préparées une fois par connexion.
+ * On mesure le nombre de requêtes par seconde et la latence d'une requête.
+ * Aucune donnée n'est modifiée : le banc peut tourner sur la base réelle
+ * (données de BD_Hospital/CreationBD).
+ *
+ * Usage : bench_dal [nbRequetes] [hote] [utilisateur] [motDePasse] [base]
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "dal.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+#define NB_REQUETES_DEFAUT 20000
+
+static const int nbThreadsMesures[] = {1, 8};
+
+// Paramètres des requêtes (présents dans les données de CreationBD)
+static const std::string SPECIALITE = "Cardiologie";
+static const std::string MEDECIN = "Alice Dupont";
+static const std::string DEBUT = "2025-10-01";
+static const std::string FIN = "2025-12-31";
+static const std::string NOM = "Durand";
+static const std::string PRENOM = "Jean";
+static const int ID_PATIENT = 1;
+static const int NB_SORTES = 6;     // Sortes de requêtes du mélange
+
+// ============================================================================
+// CONNEXION
+// ============================================================================
+
+static const char *hote = "localhost";
+static const char *utilisateur = "Student";
+static const char *motDePasse = "PassStudent1_";
+static const char *base = "PourStudent";
+
+static long long maintenantNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * Ouvre une connexion MySQL
+ * @return Connexion ou NULL en cas d'erreur
+ */
+static MYSQL *connecter() {
+    MYSQL *connexion = mysql_init(NULL);
+    if (connexion && !mysql_real_connect(connexion, hote, utilisateur, motDePasse, base, 0, NULL, 0)) {
+        fprintf(stderr, "Connexion impossible: %s\n", mysql_error(connexion));
+        mysql_close(connexion);
+        return NULL;
+    }
+    return connexion;
+}
+
+// ============================================================================
+// VARIANTES MESURÉES
+// ============================================================================
+
+/**
+ * Requête texte, construite comme le faisait le serveur
+ * @param sorte Sorte de requête du mélange
+ * @return Nombre de lignes lues ou -1 en cas d'erreur
+ */
+static int requeteTexte(MYSQL *connexion, int sorte) {
+    std::string requete;
+    if (sorte < 4) {
+        requete = "SELECT c.id, s.name, CONCAT(d.first_name, ' ', d.last_name), c.date, c.hour ";
+        requete += "FROM consultations c ";
+        requete += "JOIN doctors d ON c.doctor_id = d.id ";
+        requete += "JOIN specialties s ON d.specialty_id = s.id ";
+        requete += "WHERE c.patient_id IS NULL ";
+        if (sorte & 1) {
+            requete += "AND s.name = '" + SPECIALITE + "' ";
+        }
+        if (sorte & 2) {
+            requete += "AND CONCAT(d.first_name, ' ', d.last_name) = '" + MEDECIN + "' ";
+        }
+        requete += "AND c.date BETWEEN '" + DEBUT + "' AND '" + FIN + "' ";
+        requete += "ORDER BY c.date, c.hour";
+    } else if (sorte == 4) {
+        char texte[256];
+        snprintf(texte, sizeof(texte),
+                 "SELECT id FROM patients WHERE id=%d AND last_name='%s' AND first_name='%s'",
+                 ID_PATIENT, NOM.c_str(), PRENOM.c_str());
+        requete = texte;
+    } else {
+        requete = "SELECT CONCAT(d.first_name, ' ', d.last_name) FROM doctors d ";
+        requete += "JOIN specialties s ON d.specialty_id = s.id ";
+        requete += "WHERE s.name = '" + SPECIALITE + "' ";
+        requete += "ORDER BY d.last_name, d.first_name";
+    }
+
+    if (mysql_query(connexion, requete.c_str()) != 0) {
+        return -1;
+    }
+    MYSQL_RES *resultat = mysql_store_result(connexion);
+    if (!resultat) {
+        return -1;
+    }
+    int nbLignes = 0;
+    while (mysql_fetch_row(resultat)) {
+        nbLignes++;
+    }
+    mysql_free_result(resultat);
+    return nbLignes;
+}
+
+/**
+ * Même requête, préparée par la couche d'accès aux données
+ * @param sorte Sorte de requête du mélange
+ * @return Nombre de lignes lues ou -1 en cas d'erreur
+ */
+static int requetePreparee(Dal *dal, MYSQL *connexion, int sorte) {
+    static const DalStatement recherches[] = {DAL_SEARCH, DAL_SEARCH_SPECIALTY, DAL_SEARCH_DOCTOR,
+                                              DAL_SEARCH_SPECIALTY_DOCTOR};
+    DalParam params[4];
+    int nbParams = 0;
+    DalStatement requete;
+    if (sorte < 4) {
+        requete = recherches[sorte];
+        if (sorte & 1) {
+            params[nbParams++] = DalText(SPECIALITE);
+        }
+        if (sorte & 2) {
+            params[nbParams++] = DalText(MEDECIN);
+        }
+        params[nbParams++] = DalText(DEBUT);
+        params[nbParams++] = DalText(FIN);
+    } else if (sorte == 4) {
+        requete = DAL_PATIENT_VERIFY;
+        params[nbParams++] = DalNumber(ID_PATIENT);
+        params[nbParams++] = DalText(NOM);
+        params[nbParams++] = DalText(PRENOM);
+    } else {
+        requete = DAL_DOCTORS_SPECIALTY;
+        params[nbParams++] = DalText(SPECIALITE);
+    }
+
+    DalRows *lignes = DalSelect(dal, connexion, requete, params);
+    if (!lignes) {
+        return -1;
+    }
+    int nbLignes = DalRowsCount(lignes);
+    DalRowsFree(lignes);
+    return nbLignes;
+}
+
+// ============================================================================
+// MESURE
+// ============================================================================
+
+/**
+ * Paramètres et résultats d'un thread de mesure
+ */
+struct Participant {
+    Dal *dal;                       // NULL = requêtes texte
+    int nbRequetes;                 // Requêtes à exécuter
+    int erreurs;                    // Requêtes en échec
+    std::vector<long long> latences; // Durée de chaque requête (ns)
+};
+
+static void *threadRequetes(void *arg) {
+    Participant *participant = (Participant *)arg;
+    mysql_thread_init();
+    MYSQL *connexion = connecter();
+    if (!connexion) {
+        participant->erreurs = participant->nbRequetes;
+        mysql_thread_end();
+        return NULL;
+    }
+    for (int i = 0; i < participant->nbRequetes; i++) {
+        long long debut = maintenantNs();
+        int nbLignes = participant->dal ? requetePreparee(participant->dal, connexion, i % NB_SORTES)
+                                        : requeteTexte(connexion, i % NB_SORTES);
+        participant->latences.push_back(maintenantNs() - debut);
+        if (nbLignes < 0) {
+            participant->erreurs++;
+        }
+    }
+    if (participant->dal) {
+        DalForget(participant->dal, connexion);
+    }
+    mysql_close(connexion);
+    mysql_thread_end();
+    return NULL;
+}
+
+/**
+ * Mesure une variante et affiche une ligne de résultats
+ * @param nom Nom de la variante
+ * @param dal Couche d'accès aux données (NULL = requêtes texte)
+ * @param nbThreads Nombre de threads (une connexion chacun)
+ * @param nbRequetes Nombre total de requêtes
+ */
+static void mesurer(const char *nom, Dal *dal, int nbThreads, int nbRequetes) {
+    std::vector<Participant> participants(nbThreads);
+    std::vector<pthread_t> threads(nbThreads);
+    long long debut = maintenantNs();
+    for (int i = 0; i < nbThreads; i++) {
+        participants[i].dal = dal;
+        participants[i].nbRequetes = nbRequetes / nbThreads + (i < nbRequetes % nbThreads ? 1 : 0);
+        participants[i].erreurs = 0;
+        pthread_create(&threads[i], NULL, threadRequetes, &participants[i]);
+    }
+    std::vector<long long> latences;
+    int erreurs = 0;
+    for (int i = 0; i < nbThreads; i++) {
+        pthread_join(threads[i], NULL);
+        latences.insert(latences.end(), participants[i].latences.begin(),
+                        participants[i].latences.end());
+        erreurs += participants[i].erreurs;
+    }
+    double duree = (maintenantNs() - debut) / 1e9;
+    if (latences.empty()) {
+        printf("%-10s %8d %12s\n", nom, nbThreads, "échec");
+        return;
+    }
+
+    std::sort(latences.begin(), latences.end());
+    size_t n = latences.size();
+    printf("%-10s %8d %12.0f %10.1f %10.1f %8d\n", nom, nbThreads, n / duree,
+           latences[n / 2] / 1000.0, latences[(size_t)(n * 0.99)] / 1000.0, erreurs);
+}
+
+// ============================================================================
+// FONCTION PRINCIPALE
+// ============================================================================
+
+int main(int argc, char *argv[]) {
+    int nbRequetes = argc > 1 ? atoi(argv[1]) : NB_REQUETES_DEFAUT;
+    if (nbRequetes <= 0) {
+        fprintf(stderr, "Usage: %s [nbRequetes] [hote] [utilisateur] [motDePasse] [base]\n", argv[0]);
+        return 1;
+    }
+    hote = argc > 2 ? argv[2] : hote;
+    utilisateur = argc > 3 ? argv[3] : utilisateur;
+    motDePasse = argc > 4 ? argv[4] : motDePasse;
+    base = argc > 5 ? argv[5] : base;
+
+    mysql_library_init(0, NULL, NULL);
+    Dal *dal = DalCreate();
+    printf("%d requêtes (SEARCH x4, LOGIN_EXIST, GET_DOCTORS), base %s@%s, %ld coeur(s)\n",
+           nbRequetes, base, hote, sysconf(_SC_NPROCESSORS_ONLN));
+    printf("%-10s %8s %12s %10s %10s %8s\n", "requêtes", "threads", "requêtes/s",
+           "p50 (µs)", "p99 (µs)", "erreurs");
+    for (int nbThreads : nbThreadsMesures) {
+        mesurer("texte", NULL, nbThreads, nbRequetes);
+        mesurer("mysql_stmt", dal, nbThreads, nbRequetes);
+    }
+    DalDestroy(dal);
+    mysql_library_end();
+    return 0;
+}
@@ -0,0 +1,268 @@
+/**
+ * Banc d'essai : file de tâches sans verrou contre file mutex/condition
+ *
+ * Pour 1, 8 et 64 producteurs (autant de consommateurs), deux mesures :
+ * - débit : les producteurs déposent les tâches sans pause, les consommateurs
+ *   les retirent ; on mesure le nombre de tâches transmises par seconde ;
+ * - latence de transmission : chaque producteur dépose une tâche puis marque
+ *   une courte pause, les consommateurs ont donc le temps de s'endormir ; on
+ *   mesure le délai entre le dépôt et le retrait (réveil compris).
+ *
+ * La file mutex/condition reproduit celle qu'utilisait le pool de threads du
+ * serveur (std::queue, pthread_cond_signal à chaque dépôt).
+ *
+ * Avant les mesures, vérifie qu'une file fermée refuse les dépôts, même
+ * quand elle a de la place, et rend encore les tâches déposées avant.
+ *
+ * Usage : bench_taskqueue [nbTaches] [capacite]
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "taskqueue.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <algorithm>
+#include <queue>
+#include <vector>
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+#define NB_TACHES_DEFAUT 1000000
+#define CAPACITE_DEFAUT 1024
+#define PAUSE_LATENCE_NS 20000      // Pause d'un producteur entre deux dépôts (latence)
+
+static const int nbThreadsMesures[] = {1, 8, 64};
+
+// ============================================================================
+// FILES COMPARÉES
+// ============================================================================
+
+/**
+ * Tâche transmise (même taille qu'une ClientTask du serveur)
+ */
+struct Tache {
+    long long depot;                // Instant du dépôt (ns)
+    char donnees[24];               // Remplissage (socket, adresse IP, session)
+};
+
+/**
+ * File protégée par un mutex et une condition (ancienne file du serveur)
+ */
+class FileMutex {
+public:
+    explicit FileMutex(size_t capacite) {
+        (void)capacite; // File non bornée, comme dans le serveur
+        pthread_mutex_init(&mutex, NULL);
+        pthread_cond_init(&condition, NULL);
+        fermee = false;
+    }
+
+    ~FileMutex() {
+        pthread_mutex_destroy(&mutex);
+        pthread_cond_destroy(&condition);
+    }
+
+    bool push(const Tache &tache) {
+        pthread_mutex_lock(&mutex);
+        taches.push(tache);
+        pthread_cond_signal(&condition);
+        pthread_mutex_unlock(&mutex);
+        return true;
+    }
+
+    bool pop(Tache &tache) {
+        pthread_mutex_lock(&mutex);
+        while (taches.empty() && !fermee) {
+            pthread_cond_wait(&condition, &mutex);
+        }
+        if (taches.empty()) {
+            pthread_mutex_unlock(&mutex);
+            return false;
+        }
+        tache = taches.front();
+        taches.pop();
+        pthread_mutex_unlock(&mutex);
+        return true;
+    }
+
+    void close() {
+        pthread_mutex_lock(&mutex);
+        fermee = true;
+        pthread_cond_broadcast(&condition);
+        pthread_mutex_unlock(&mutex);
+    }
+
+private:
+    std::queue<Tache> taches;
+    pthread_mutex_t mutex;
+    pthread_cond_t condition;
+    bool fermee;
+};
+
+// ============================================================================
+// MESURE
+// ============================================================================
+
+static long long maintenantNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * Paramètres et résultats d'un thread de mesure
+ */
+template <typename File>
+struct Participant {
+    File *file;                     // File mesurée
+    int nbTaches;                   // Tâches à déposer (producteur)
+    bool pause;                     // Pause entre deux dépôts (mesure de latence)
+    std::vector<long long> latences; // Délais dépôt → retrait (consommateur, ns)
+};
+
+template <typename File>
+static void *threadProducteur(void *arg) {
+    Participant<File> *participant = (Participant<File> *)arg;
+    struct timespec pause = {0, PAUSE_LATENCE_NS};
+    Tache tache = {};
+    for (int i = 0; i < participant->nbTaches; i++) {
+        tache.depot = maintenantNs();
+        participant->file->push(tache);
+        if (participant->pause) {
+            nanosleep(&pause, NULL);
+        }
+    }
+    return NULL;
+}
+
+template <typename File>
+static void *threadConsommateur(void *arg) {
+    Participant<File> *participant = (Participant<File> *)arg;
+    Tache tache;
+    while (participant->file->pop(tache)) {
+        if (participant->pause) {
+            participant->latences.push_back(maintenantNs() - tache.depot);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Fait transiter nbTaches tâches par la file
+ * @param nbThreads Nombre de producteurs (et de consommateurs)
+ * @param nbTaches Nombre total de tâches
+ * @param capacite Capacité de la file
+ * @param pause true pour espacer les dépôts (mesure de latence)
+ * @param latences Délais dépôt → retrait (rempli si pause)
+ * @return Durée de la mesure en secondes
+ */
+template <typename File>
+static double transmettre(int nbThreads, int nbTaches, size_t capacite, bool pause,
+                          std::vector<long long> &latences) {
+    File file(capacite);
+    std::vector<Participant<File>> producteurs(nbThreads), consommateurs(nbThreads);
+    std::vector<pthread_t> threadsProducteurs(nbThreads), threadsConsommateurs(nbThreads);
+
+    for (int i = 0; i < nbThreads; i++) {
+        consommateurs[i].file = &file;
+        consommateurs[i].nbTaches = 0;
+        consommateurs[i].pause = pause;
+        pthread_create(&threadsConsommateurs[i], NULL, threadConsommateur<File>, &consommateurs[i]);
+    }
+    long long debut = maintenantNs();
+    for (int i = 0; i < nbThreads; i++) {
+        producteurs[i].file = &file;
+        producteurs[i].nbTaches = nbTaches / nbThreads + (i < nbTaches % nbThreads ? 1 : 0);
+        producteurs[i].pause = pause;
+        pthread_create(&threadsProducteurs[i], NULL, threadProducteur<File>, &producteurs[i]);
+    }
+    for (int i = 0; i < nbThreads; i++) {
+        pthread_join(threadsProducteurs[i], NULL);
+    }
+    // Les consommateurs vident la file avant de s'arrêter
+    file.close();
+    for (int i = 0; i < nbThreads; i++) {
+        pthread_join(threadsConsommateurs[i], NULL);
+        latences.insert(latences.end(), consommateurs[i].latences.begin(),
+                        consommateurs[i].latences.end());
+    }
+    return (maintenantNs() - debut) / 1e9;
+}
+
+/**
+ * Mesure une file et affiche une ligne de résultats
+ * @param nom Nom de la file
+ * @param nbThreads Nombre de producteurs (et de consommateurs)
+ * @param nbTaches Tâches transmises pour la mesure de débit
+ * @param capacite Capacité de la file
+ */
+template <typename File>
+static void mesurer(const char *nom, int nbThreads, int nbTaches, size_t capacite) {
+    std::vector<long long> latences;
+    double duree = transmettre<File>(nbThreads, nbTaches, capacite, false, latences);
+    double debit = nbTaches / duree;
+
+    // Mesure de latence sur moins de tâches : chaque dépôt est suivi d'une pause
+    int nbLatence = std::max(nbTaches / 50, nbThreads);
+    transmettre<File>(nbThreads, nbLatence, capacite, true, latences);
+    std::sort(latences.begin(), latences.end());
+    size_t n = latences.size();
+    printf("%-10s %8d %12.0f %10.2f %10.2f %10.2f\n", nom, nbThreads, debit,
+           latences[n / 2] / 1000.0,
+           latences[(size_t)(n * 0.99)] / 1000.0,
+           latences[n - 1] / 1000.0);
+}
+
+/**
+ * Vérifie la fermeture de la file sans verrou : push() et tryPush() refusent
+ * toute tâche, pop() rend les tâches déjà déposées puis false
+ * @return 0 si le comportement est correct, -1 sinon
+ */
+static int verifierFermeture() {
+    TaskQueue<Tache> file(CAPACITE_DEFAUT);
+    Tache tache = {0, {0}};
+    if (!file.push(tache)) {
+        return -1;
+    }
+    file.close();
+    if (file.push(tache) || file.tryPush(tache)) {
+        return -1;
+    }
+    if (!file.pop(tache) || file.pop(tache)) {
+        return -1;
+    }
+    return 0;
+}
+
+// ============================================================================
+// FONCTION PRINCIPALE
+// ============================================================================
+
+int main(int argc, char *argv[]) {
+    int nbTaches = argc > 1 ? atoi(argv[1]) : NB_TACHES_DEFAUT;
+    int capacite = argc > 2 ? atoi(argv[2]) : CAPACITE_DEFAUT;
+    if (nbTaches <= 0 || capacite <= 0) {
+        fprintf(stderr, "Usage: %s [nbTaches] [capacite]\n", argv[0]);
+        return 1;
+    }
+
+    if (verifierFermeture() < 0) {
+        fprintf(stderr, "ERREUR: La file fermée accepte encore des tâches\n");
+        return 1;
+    }
+
+    printf("%d tâches, capacité %d, %ld coeur(s)\n", nbTaches, capacite,
+           sysconf(_SC_NPROCESSORS_ONLN));
+    printf("%-10s %8s %12s %10s %10s %10s\n", "file", "threads", "tâches/s",
+           "p50 (µs)", "p99 (µs)", "max (µs)");
+    for (int nbThreads : nbThreadsMesures) {
+        mesurer<FileMutex>("mutex", nbThreads, nbTaches, capacite);
+        mesurer<TaskQueue<Tache>>("sansverrou", nbThreads, nbTaches, capacite);
+    }
+    return 0;
+}
@@ -0,0 +1,370 @@
+/**
+ * Implémentation du moteur de réservation par lots
+ *
+ * Le thread de validation dort tant qu'aucune demande n'attend. À l'arrivée
+ * de la première, il attend windowUs (ou maxBatch demandes), emprunte une
+ * connexion et applique le lot dans une transaction : une mise à jour
+ * conditionnelle par demande, puis un seul COMMIT. Pendant la transaction,
+ * les nouvelles demandes s'accumulent pour le lot suivant. Chaque mise à jour
+ * est précédée d'un point de sauvegarde : une demande refusée par MySQL
+ * (contrainte violée) est annulée seule et reçoit BOOKING_ERROR, le reste du
+ * lot est validé. Seule une erreur de la transaction elle-même (connexion
+ * perdue, échec du COMMIT) annule tout le lot.
+ *
+ * Une mise à jour sans effet ne dit pas si la consultation est prise ou
+ * inexistante : ces demandes-là sont départagées après la validation, par
+ * une lecture de la consultation.
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "booking.h"
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <deque>
+#include <vector>
+
+using namespace std;
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+struct BookingEngine {
+    BookingConfig config;
+    DbPool *pool;
+    Dal *dal;
+    pthread_t thread;               // Thread de validation
+    pthread_mutex_t mutex;          // Protège tous les champs qui suivent
+    pthread_cond_t wakeCond;        // Réveil du thread de validation
+    deque<BookingRequest *> pending; // Demandes en attente d'un lot
+    long long firstArrivalUs;       // Arrivée de la plus ancienne demande en attente
+    bool stopping;
+    BookingStats stats;
+};
+
+// ============================================================================
+// FONCTIONS INTERNES
+// ============================================================================
+
+/**
+ * Horloge monotone en microsecondes
+ */
+static long long nowUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static struct timespec deadlineAtUs(long long deadlineUs) {
+    struct timespec ts;
+    ts.tv_sec = deadlineUs / 1000000;
+    ts.tv_nsec = (deadlineUs % 1000000) * 1000;
+    return ts;
+}
+
+/**
+ * Réclame un créneau derrière un point de sauvegarde : une mise à jour
+ * refusée n'annule qu'elle-même
+ * @param connection Connexion en transaction
+ * @param request Demande (result renseigné : BOOKING_OK, BOOKING_TAKEN ou
+ *                BOOKING_ERROR)
+ * @return 0 si la transaction continue, -1 si elle doit être annulée
+ */
+static int claimSlot(BookingEngine *engine, MYSQL *connection, BookingRequest *request) {
+    if (mysql_query(connection, "SAVEPOINT claim")) {
+        printf("ERREUR: Impossible de poser le point de sauvegarde: %s\n", mysql_error(connection));
+        return -1;
+    }
+    DalParam params[] = {
+        DalNumber(request->patientId),
+        DalParam{true, 0, request->reason, request->reasonLength},
+        DalNumber(request->consultationId),
+    };
+    long long updated = DalExecute(engine->dal, connection, DAL_CONSULTATION_CLAIM, params, NULL);
+    if (updated >= 0) {
+        request->result = updated > 0 ? BOOKING_OK : BOOKING_TAKEN;
+        return 0;
+    }
+    // Le retour au point de sauvegarde échoue si la transaction est perdue
+    // (connexion coupée, interblocage) : tout le lot est alors annulé
+    if (mysql_query(connection, "ROLLBACK TO SAVEPOINT claim")) {
+        printf("ERREUR: Transaction de réservation perdue: %s\n", mysql_error(connection));
+        return -1;
+    }
+    printf("ERREUR: Réservation de la consultation %d refusée par la base\n", request->consultationId);
+    request->result = BOOKING_ERROR;
+    return 0;
+}
+
+/**
+ * Réclame chaque créneau du lot dans une transaction
+ * @param connection Connexion empruntée
+ * @param batch Demandes (result renseigné : BOOKING_OK, BOOKING_TAKEN ou
+ *              BOOKING_ERROR pour une demande refusée seule)
+ * @return 0 si le lot est validé, -1 s'il est annulé
+ */
+static int claimBatch(BookingEngine *engine, MYSQL *connection, const vector<BookingRequest *> &batch) {
+    if (mysql_autocommit(connection, false)) {
+        printf("ERREUR: Impossible d'ouvrir la transaction de réservation: %s\n", mysql_error(connection));
+        return -1;
+    }
+
+    int status = 0;
+    for (BookingRequest *request : batch) {
+        if (claimSlot(engine, connection, request) < 0) {
+            status = -1;
+            break;
+        }
+    }
+
+    if (status == 0 && mysql_commit(connection)) {
+        printf("ERREUR: Échec de la validation des réservations: %s\n", mysql_error(connection));
+        status = -1;
+    }
+    if (status < 0) {
+        mysql_rollback(connection);
+    }
+    mysql_autocommit(connection, true);
+    return status;
+}
+
+/**
+ * Départage les créneaux non obtenus : déjà pris ou inexistants
+ * @param connection Connexion empruntée
+ * @param batch Demandes du lot validé
+ */
+static void explainMisses(BookingEngine *engine, MYSQL *connection, const vector<BookingRequest *> &batch) {
+    for (BookingRequest *request : batch) {
+        if (request->result != BOOKING_TAKEN) {
+            continue;
+        }
+        DalParam params[] = {DalNumber(request->consultationId)};
+        DalRows *rows = DalSelect(engine->dal, connection, DAL_CONSULTATION_GET, params);
+        if (rows && DalRowsCount(rows) == 0) {
+            request->result = BOOKING_NOT_FOUND;
+        }
+        DalRowsFree(rows);
+    }
+}
+
+/**
+ * Applique un lot et réveille ses demandeurs
+ * @param batch Demandes du lot
+ */
+static void applyBatch(BookingEngine *engine, const vector<BookingRequest *> &batch) {
+    MYSQL *connection = DbPoolAcquire(engine->pool);
+    if (!connection) {
+        printf("ERREUR: Aucune connexion à la base de données pour %zu réservation(s)\n", batch.size());
+    }
+    long long start = nowUs();
+    if (!connection || claimBatch(engine, connection, batch) < 0) {
+        for (BookingRequest *request : batch) {
+            request->result = BOOKING_ERROR;
+        }
+    }
+    long long commitUs = nowUs() - start;
+    if (connection) {
+        explainMisses(engine, connection, batch);
+        DbPoolRelease(engine->pool, connection);
+    }
+
+    pthread_mutex_lock(&engine->mutex);
+    engine->stats.batches++;
+    engine->stats.requests += batch.size();
+    engine->stats.commitTotalUs += commitUs;
+    if ((int)batch.size() > engine->stats.maxBatch) {
+        engine->stats.maxBatch = (int)batch.size();
+    }
+    for (BookingRequest *request : batch) {
+        switch (request->result) {
+            case BOOKING_OK: engine->stats.booked++; break;
+            case BOOKING_TAKEN: engine->stats.taken++; break;
+            case BOOKING_NOT_FOUND: engine->stats.notFound++; break;
+            case BOOKING_ERROR: engine->stats.errors++; break;
+        }
+        request->done = true;
+        if (request->notifyFd < 0) {
+            pthread_cond_signal(&request->cond);
+        }
+    }
+    pthread_mutex_unlock(&engine->mutex);
+
+    // Une demande signalée par eventfd peut être libérée dès l'écriture :
+    // elle n'est plus lue ensuite
+    for (BookingRequest *request : batch) {
+        int notifyFd = request->notifyFd;
+        if (notifyFd >= 0) {
+            uint64_t one = 1;
+            if (write(notifyFd, &one, sizeof(one)) < 0) {
+                perror("ERREUR: Impossible de signaler une réservation");
+            }
+        }
+    }
+}
+
+/**
+ * Thread de validation : forme les lots et les applique
+ * @param arg Moteur
+ * @return NULL
+ */
+static void *commitThread(void *arg) {
+    BookingEngine *engine = (BookingEngine *)arg;
+    vector<BookingRequest *> batch;
+
+    pthread_mutex_lock(&engine->mutex);
+    while (true) {
+        while (engine->pending.empty() && !engine->stopping) {
+            pthread_cond_wait(&engine->wakeCond, &engine->mutex);
+        }
+        if (engine->pending.empty()) {
+            break;
+        }
+
+        // Fenêtre de regroupement, comptée depuis la plus ancienne demande
+        struct timespec deadline = deadlineAtUs(engine->firstArrivalUs + engine->config.windowUs);
+        while ((int)engine->pending.size() < engine->config.maxBatch && !engine->stopping &&
+               pthread_cond_timedwait(&engine->wakeCond, &engine->mutex, &deadline) != ETIMEDOUT) {
+        }
+
+        batch.clear();
+        while (!engine->pending.empty() && (int)batch.size() < engine->config.maxBatch) {
+            batch.push_back(engine->pending.front());
+            engine->pending.pop_front();
+        }
+        pthread_mutex_unlock(&engine->mutex);
+
+        applyBatch(engine, batch);
+        pthread_mutex_lock(&engine->mutex);
+    }
+    pthread_mutex_unlock(&engine->mutex);
+    return NULL;
+}
+
+// ============================================================================
+// FONCTIONS PUBLIQUES
+// ============================================================================
+
+/**
+ * Démarre le thread de validation
+ * @param config Paramètres
+ * @param pool Pool MySQL
+ * @param dal Requêtes préparées
+ * @return Moteur créé ou NULL en cas d'erreur
+ */
+BookingEngine *BookingCreate(const BookingConfig *config, DbPool *pool, Dal *dal) {
+    if (config->windowUs < 0 || config->maxBatch <= 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    BookingEngine *engine = new BookingEngine();
+    engine->config = *config;
+    engine->pool = pool;
+    engine->dal = dal;
+    engine->firstArrivalUs = 0;
+    engine->stopping = false;
+    pthread_mutex_init(&engine->mutex, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&engine->wakeCond, &attr);
+    pthread_condattr_destroy(&attr);
+    if (pthread_create(&engine->thread, NULL, commitThread, engine) != 0) {
+        pthread_cond_destroy(&engine->wakeCond);
+        pthread_mutex_destroy(&engine->mutex);
+        delete engine;
+        return NULL;
+    }
+    return engine;
+}
+
+/**
+ * Valide les demandes en attente puis arrête le moteur
+ * @param engine Moteur
+ */
+void BookingDestroy(BookingEngine *engine) {
+    if (!engine) {
+        return;
+    }
+
+    pthread_mutex_lock(&engine->mutex);
+    engine->stopping = true;
+    pthread_cond_signal(&engine->wakeCond);
+    pthread_mutex_unlock(&engine->mutex);
+    pthread_join(engine->thread, NULL);
+
+    pthread_cond_destroy(&engine->wakeCond);
+    pthread_mutex_destroy(&engine->mutex);
+    delete engine;
+}
+
+/**
+ * Confie une demande au moteur
+ * @param engine Moteur
+ * @param request Demande
+ */
+void BookingSubmit(BookingEngine *engine, BookingRequest *request) {
+    request->done = false;
+    request->result = BOOKING_ERROR;
+    if (request->notifyFd < 0) {
+        pthread_cond_init(&request->cond, NULL);
+    }
+
+    pthread_mutex_lock(&engine->mutex);
+    if (engine->pending.empty()) {
+        engine->firstArrivalUs = nowUs();
+    }
+    engine->pending.push_back(request);
+    // Réveil pour ouvrir la fenêtre, ou pour la fermer quand le lot est plein
+    if (engine->pending.size() == 1 || (int)engine->pending.size() >= engine->config.maxBatch) {
+        pthread_cond_signal(&engine->wakeCond);
+    }
+    pthread_mutex_unlock(&engine->mutex);
+}
+
+/**
+ * Attend le résultat d'une demande
+ * @param engine Moteur
+ * @param request Demande soumise avec notifyFd = -1
+ * @return Résultat de la demande
+ */
+BookingResult BookingWait(BookingEngine *engine, BookingRequest *request) {
+    pthread_mutex_lock(&engine->mutex);
+    while (!request->done) {
+        pthread_cond_wait(&request->cond, &engine->mutex);
+    }
+    pthread_mutex_unlock(&engine->mutex);
+    pthread_cond_destroy(&request->cond);
+    return request->result;
+}
+
+/**
+ * Copie les métriques courantes du moteur
+ * @param engine Moteur
+ * @param stats Métriques à remplir
+ */
+void BookingGetStats(BookingEngine *engine, BookingStats *stats) {
+    pthread_mutex_lock(&engine->mutex);
+    *stats = engine->stats;
+    pthread_mutex_unlock(&engine->mutex);
+}
+
+/**
+ * Affiche les métriques du moteur sur une ligne
+ * @param engine Moteur
+ */
+void BookingReport(BookingEngine *engine) {
+    BookingStats stats;
+    BookingGetStats(engine, &stats);
+    printf("Réservations: %llu demandes en %llu lots (moy %.1f, max %d), %llu réservées, "
+           "%llu déjà prises, %llu inexistantes, %llu en erreur, transaction moy %.2f ms\n",
+           stats.requests, stats.batches,
+           stats.batches ? (double)stats.requests / stats.batches : 0.0, stats.maxBatch,
+           stats.booked, stats.taken, stats.notFound, stats.errors,
+           stats.batches ? stats.commitTotalUs / 1000.0 / stats.batches : 0.0);
+}
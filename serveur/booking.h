@@ -0,0 +1,128 @@
+/**
+ * Moteur de réservation par lots (validation groupée)
+ *
+ * Les réservations simultanées sont confiées à un thread de validation qui
+ * les regroupe pendant une courte fenêtre (quelques centaines de µs), puis
+ * les applique dans une seule transaction : chaque créneau est pris par une
+ * mise à jour conditionnelle (patient_id encore NULL), sans lecture préalable
+ * ni fenêtre de concurrence entre la vérification et la mise à jour. Le coût
+ * d'une validation (écriture du journal MySQL) est ainsi partagé par tout le
+ * lot, et chaque demandeur reçoit le résultat de son propre créneau.
+ */
+
+#ifndef BOOKING_H
+#define BOOKING_H
+
+#include <pthread.h>
+#include "dal.h"
+#include "dbpool.h"
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Résultat d'une réservation
+ */
+typedef enum {
+    BOOKING_OK,                     // Créneau réservé
+    BOOKING_TAKEN,                  // Créneau déjà réservé
+    BOOKING_NOT_FOUND,              // Consultation inexistante
+    BOOKING_ERROR                   // Erreur MySQL (demande refusée, ou lot annulé)
+} BookingResult;
+
+/**
+ * Paramètres du moteur
+ */
+typedef struct {
+    int windowUs;                   // Attente après la première demande d'un lot (µs)
+    int maxBatch;                   // Demandes par lot au maximum
+} BookingConfig;
+
+/**
+ * Métriques du moteur
+ */
+typedef struct {
+    unsigned long long requests;    // Demandes traitées
+    unsigned long long batches;     // Lots validés (ou annulés)
+    unsigned long long booked;      // Créneaux réservés
+    unsigned long long taken;       // Créneaux déjà pris
+    unsigned long long notFound;    // Consultations inexistantes
+    unsigned long long errors;      // Demandes en erreur
+    int maxBatch;                   // Plus grand lot observé
+    long long commitTotalUs;        // Durée cumulée des transactions (µs)
+} BookingStats;
+
+/**
+ * Demande de réservation. Les champs internes sont initialisés par
+ * BookingSubmit ; la demande doit rester valide jusqu'à son résultat.
+ */
+typedef struct BookingRequest {
+    int consultationId;             // Consultation demandée
+    int patientId;                  // Patient
+    const char *reason;             // Motif (recopié dans la transaction)
+    unsigned long reasonLength;     // Longueur du motif
+    int notifyFd;                   // eventfd signalé à la fin (-1 = BookingWait)
+
+    // Usage interne
+    BookingResult result;           // Résultat (valide quand done est vrai)
+    bool done;                      // Résultat disponible
+    pthread_cond_t cond;            // Réveil du demandeur (notifyFd = -1)
+} BookingRequest;
+
+/**
+ * Moteur de réservation (structure opaque, thread-safe)
+ */
+typedef struct BookingEngine BookingEngine;
+
+// ============================================================================
+// FONCTIONS
+// ============================================================================
+
+/**
+ * Démarre le thread de validation
+ * @param config Paramètres
+ * @param pool Pool MySQL (une connexion empruntée par lot)
+ * @param dal Requêtes préparées des connexions du pool
+ * @return Moteur créé ou NULL en cas d'erreur
+ */
+BookingEngine *BookingCreate(const BookingConfig *config, DbPool *pool, Dal *dal);
+
+/**
+ * Valide les demandes en attente puis arrête le moteur (aucune demande ne
+ * doit plus être soumise)
+ * @param engine Moteur
+ */
+void BookingDestroy(BookingEngine *engine);
+
+/**
+ * Confie une demande au moteur, sans attendre son résultat. Si notifyFd est
+ * un eventfd, il est signalé quand le résultat est disponible (attente dans
+ * une coroutine avec CoWait) ; sinon le résultat s'attend avec BookingWait.
+ * @param engine Moteur
+ * @param request Demande (consultationId, patientId, reason, notifyFd remplis)
+ */
+void BookingSubmit(BookingEngine *engine, BookingRequest *request);
+
+/**
+ * Attend le résultat d'une demande soumise avec notifyFd = -1
+ * @param engine Moteur
+ * @param request Demande
+ * @return Résultat de la demande
+ */
+BookingResult BookingWait(BookingEngine *engine, BookingRequest *request);
+
+/**
+ * Copie les métriques courantes du moteur
+ * @param engine Moteur
+ * @param stats Métriques à remplir
+ */
+void BookingGetStats(BookingEngine *engine, BookingStats *stats);
+
+/**
+ * Affiche les métriques du moteur sur une ligne
+ * @param engine Moteur
+ */
+void BookingReport(BookingEngine *engine);
+
+#endif // BOOKING_H
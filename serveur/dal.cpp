@@ -0,0 +1,516 @@
+/**
+ * Implémentation de la couche d'accès aux données
+ *
+ * Les requêtes préparées sont rangées par connexion, dans une table protégée
+ * par un mutex (consultée une fois par requête). Une connexion n'étant
+ * empruntée que par un thread à la fois, ses requêtes sont ensuite utilisées
+ * sans verrou. Une requête est préparée à sa première utilisation sur la
+ * connexion ; après une erreur d'exécution, elle est fermée et sera préparée
+ * à nouveau.
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "dal.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+const unsigned long FIELD_BUFFER_SIZE = 256;   // Tampon de résultat par colonne
+const int MAX_PARAMS = 4;                      // Paramètres d'une requête au maximum
+const unsigned long NULL_FIELD = (unsigned long)-1; // Début d'un champ NULL (DalRows)
+
+// Parties communes des recherches de créneaux libres
+#define SEARCH_SELECT "SELECT c.id, s.name, CONCAT(d.first_name, ' ', d.last_name), c.date, c.hour " \
+                      "FROM consultations c " \
+                      "JOIN doctors d ON c.doctor_id = d.id " \
+                      "JOIN specialties s ON d.specialty_id = s.id " \
+                      "WHERE c.patient_id IS NULL "
+#define SEARCH_SPECIALTY "AND s.name = ? "
+#define SEARCH_DOCTOR "AND CONCAT(d.first_name, ' ', d.last_name) = ? "
+#define SEARCH_PERIOD "AND c.date BETWEEN ? AND ? ORDER BY c.date, c.hour"
+
+/**
+ * Texte SQL de chaque requête (dans l'ordre de DalStatement)
+ */
+static const char *const statementSql[DAL_NB_STATEMENTS] = {
+    SEARCH_SELECT SEARCH_PERIOD,
+    SEARCH_SELECT SEARCH_SPECIALTY SEARCH_PERIOD,
+    SEARCH_SELECT SEARCH_DOCTOR SEARCH_PERIOD,
+    SEARCH_SELECT SEARCH_SPECIALTY SEARCH_DOCTOR SEARCH_PERIOD,
+    "SELECT name FROM specialties ORDER BY name",
+    "SELECT CONCAT(d.first_name, ' ', d.last_name) FROM doctors d "
+        "JOIN specialties s ON d.specialty_id = s.id ORDER BY d.last_name, d.first_name",
+    "SELECT CONCAT(d.first_name, ' ', d.last_name) FROM doctors d "
+        "JOIN specialties s ON d.specialty_id = s.id WHERE s.name = ? "
+        "ORDER BY d.last_name, d.first_name",
+    "SELECT id, last_name, first_name FROM patients",
+    "INSERT INTO patients (last_name, first_name, birth_date) VALUES (?, ?, '2000-01-01')",
+    "SELECT id FROM patients WHERE id = ? AND last_name = ? AND first_name = ?",
+    "SELECT id, patient_id FROM consultations WHERE id = ?",
+    "UPDATE consultations SET patient_id = ?, reason = ? WHERE id = ? AND patient_id IS NULL",
+};
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Tampon de résultat binaire d'une colonne
+ */
+struct FieldBuffer {
+    char data[FIELD_BUFFER_SIZE];
+    unsigned long length;           // Longueur réelle du champ (peut dépasser le tampon)
+    bool isNull;
+    bool truncated;
+};
+
+/**
+ * Requête préparée et ses tampons de résultat
+ */
+struct Prepared {
+    MYSQL_STMT *stmt;
+    unsigned long nbParams;
+    vector<FieldBuffer> buffers;    // Un tampon par colonne
+    vector<MYSQL_BIND> fields;      // Liaisons des tampons (mysql_stmt_bind_result)
+};
+
+/**
+ * Requêtes préparées d'une connexion (NULL = pas encore préparée)
+ */
+struct ConnectionStatements {
+    Prepared *statements[DAL_NB_STATEMENTS];
+};
+
+struct Dal {
+    pthread_mutex_t mutex;          // Protège connections
+    unordered_map<MYSQL *, ConnectionStatements *> connections;
+};
+
+struct DalRows {
+    int nbFields;
+    int nbRows;
+    string data;                    // Champs bout à bout, chacun terminé par '\0'
+    vector<unsigned long> starts;   // Début de chaque champ (NULL_FIELD = NULL)
+    vector<unsigned long> lengths;  // Longueur de chaque champ
+};
+
+// ============================================================================
+// FONCTIONS INTERNES
+// ============================================================================
+
+/**
+ * Ferme une requête préparée
+ */
+static void closePrepared(Prepared *prepared) {
+    if (prepared) {
+        mysql_stmt_close(prepared->stmt);
+        delete prepared;
+    }
+}
+
+/**
+ * Prépare une requête sur une connexion et lie ses tampons de résultat
+ * @return Requête préparée ou NULL en cas d'erreur
+ */
+static Prepared *prepare(MYSQL *connection, DalStatement statement) {
+    const char *sql = statementSql[statement];
+    MYSQL_STMT *stmt = mysql_stmt_init(connection);
+    if (!stmt) {
+        printf("ERREUR: Impossible d'initialiser une requête préparée: %s\n", mysql_error(connection));
+        return NULL;
+    }
+    if (mysql_stmt_prepare(stmt, sql, strlen(sql)) != 0) {
+        printf("ERREUR: Échec de la préparation de la requête: %s (%s)\n", mysql_stmt_error(stmt), sql);
+        mysql_stmt_close(stmt);
+        return NULL;
+    }
+
+    Prepared *prepared = new Prepared();
+    prepared->stmt = stmt;
+    prepared->nbParams = mysql_stmt_param_count(stmt);
+    unsigned int nbFields = mysql_stmt_field_count(stmt);
+    prepared->buffers.resize(nbFields);
+    prepared->fields.assign(nbFields, MYSQL_BIND());
+    for (unsigned int i = 0; i < nbFields; i++) {
+        // Toutes les colonnes sont lues en texte (dates et heures comprises)
+        MYSQL_BIND &field = prepared->fields[i];
+        field.buffer_type = MYSQL_TYPE_STRING;
+        field.buffer = prepared->buffers[i].data;
+        field.buffer_length = FIELD_BUFFER_SIZE;
+        field.length = &prepared->buffers[i].length;
+        field.is_null = &prepared->buffers[i].isNull;
+        field.error = &prepared->buffers[i].truncated;
+    }
+    if (nbFields > 0 && mysql_stmt_bind_result(stmt, prepared->fields.data()) != 0) {
+        printf("ERREUR: Échec de la liaison du résultat: %s\n", mysql_stmt_error(stmt));
+        closePrepared(prepared);
+        return NULL;
+    }
+    return prepared;
+}
+
+/**
+ * Requête préparée d'une connexion, préparée à sa première utilisation
+ * @return Requête préparée ou NULL en cas d'erreur
+ */
+static Prepared *statementFor(Dal *dal, MYSQL *connection, DalStatement statement) {
+    pthread_mutex_lock(&dal->mutex);
+    ConnectionStatements *&statements = dal->connections[connection];
+    if (!statements) {
+        statements = new ConnectionStatements();
+    }
+    ConnectionStatements *owned = statements;
+    pthread_mutex_unlock(&dal->mutex);
+
+    // La connexion n'est utilisée que par le thread appelant
+    if (!owned->statements[statement]) {
+        owned->statements[statement] = prepare(connection, statement);
+    }
+    return owned->statements[statement];
+}
+
+/**
+ * Oublie une requête préparée qui a échoué : elle sera préparée à nouveau
+ * (par exemple si le serveur MySQL l'a perdue)
+ */
+static void discardStatement(Dal *dal, MYSQL *connection, DalStatement statement) {
+    pthread_mutex_lock(&dal->mutex);
+    ConnectionStatements *statements = dal->connections[connection];
+    pthread_mutex_unlock(&dal->mutex);
+    closePrepared(statements->statements[statement]);
+    statements->statements[statement] = NULL;
+}
+
+/**
+ * Lie les paramètres et exécute une requête préparée
+ * @return Requête exécutée ou NULL en cas d'erreur (requête oubliée)
+ */
+static Prepared *execute(Dal *dal, MYSQL *connection, DalStatement statement, const DalParam *params) {
+    Prepared *prepared = statementFor(dal, connection, statement);
+    if (!prepared) {
+        return NULL;
+    }
+
+    MYSQL_BIND binds[MAX_PARAMS];
+    long long numbers[MAX_PARAMS];
+    unsigned long lengths[MAX_PARAMS];
+    memset(binds, 0, sizeof(binds));
+    for (unsigned long i = 0; i < prepared->nbParams && i < (unsigned long)MAX_PARAMS; i++) {
+        if (params[i].isText) {
+            lengths[i] = params[i].length;
+            binds[i].buffer_type = MYSQL_TYPE_STRING;
+            binds[i].buffer = (void *)params[i].text;
+            binds[i].buffer_length = params[i].length;
+            binds[i].length = &lengths[i];
+        } else {
+            numbers[i] = params[i].number;
+            binds[i].buffer_type = MYSQL_TYPE_LONGLONG;
+            binds[i].buffer = &numbers[i];
+        }
+    }
+
+    if ((prepared->nbParams > 0 && mysql_stmt_bind_param(prepared->stmt, binds) != 0) ||
+        mysql_stmt_execute(prepared->stmt) != 0) {
+        printf("ERREUR: Échec de la requête préparée: %s\n", mysql_stmt_error(prepared->stmt));
+        discardStatement(dal, connection, statement);
+        return NULL;
+    }
+    return prepared;
+}
+
+/**
+ * Ajoute un champ à des lignes lues
+ * @param value Champ (NULL = valeur SQL NULL)
+ */
+static void appendField(DalRows *rows, const char *value, unsigned long length) {
+    if (!value) {
+        rows->starts.push_back(NULL_FIELD);
+        rows->lengths.push_back(0);
+        return;
+    }
+    rows->starts.push_back(rows->data.size());
+    rows->lengths.push_back(length);
+    rows->data.append(value, length);
+    rows->data.push_back('\0');
+}
+
+// ============================================================================
+// FONCTIONS PUBLIQUES
+// ============================================================================
+
+/**
+ * Crée la couche d'accès aux données
+ * @return Couche créée
+ */
+Dal *DalCreate(void) {
+    Dal *dal = new Dal();
+    pthread_mutex_init(&dal->mutex, NULL);
+    return dal;
+}
+
+/**
+ * Libère la couche d'accès aux données
+ * @param dal Couche d'accès aux données
+ */
+void DalDestroy(Dal *dal) {
+    if (!dal) {
+        return;
+    }
+    for (auto &entry : dal->connections) {
+        for (Prepared *prepared : entry.second->statements) {
+            closePrepared(prepared);
+        }
+        delete entry.second;
+    }
+    pthread_mutex_destroy(&dal->mutex);
+    delete dal;
+}
+
+/**
+ * Ferme les requêtes préparées d'une connexion (voir dal.h)
+ * @param context Couche d'accès aux données
+ * @param connection Connexion fermée
+ */
+void DalForget(void *context, MYSQL *connection) {
+    Dal *dal = (Dal *)context;
+    pthread_mutex_lock(&dal->mutex);
+    auto it = dal->connections.find(connection);
+    ConnectionStatements *statements = NULL;
+    if (it != dal->connections.end()) {
+        statements = it->second;
+        dal->connections.erase(it);
+    }
+    pthread_mutex_unlock(&dal->mutex);
+
+    if (statements) {
+        for (Prepared *prepared : statements->statements) {
+            closePrepared(prepared);
+        }
+        delete statements;
+    }
+}
+
+/**
+ * Exécute une requête SELECT préparée et lit toutes ses lignes
+ * @param dal Couche d'accès aux données
+ * @param connection Connexion empruntée
+ * @param statement Requête
+ * @param params Paramètres
+ * @return Lignes lues ou NULL en cas d'erreur
+ */
+DalRows *DalSelect(Dal *dal, MYSQL *connection, DalStatement statement, const DalParam *params) {
+    Prepared *prepared = execute(dal, connection, statement, params);
+    if (!prepared) {
+        return NULL;
+    }
+
+    DalRows *rows = new DalRows();
+    rows->nbFields = (int)prepared->buffers.size();
+    rows->nbRows = 0;
+    int status;
+    while ((status = mysql_stmt_fetch(prepared->stmt)) == 0 || status == MYSQL_DATA_TRUNCATED) {
+        for (int i = 0; i < rows->nbFields; i++) {
+            FieldBuffer &buffer = prepared->buffers[i];
+            if (buffer.isNull) {
+                appendField(rows, NULL, 0);
+            } else if (!buffer.truncated) {
+                appendField(rows, buffer.data, buffer.length);
+            } else {
+                // Champ plus long que son tampon : relu en entier
+                string value(buffer.length, '\0');
+                MYSQL_BIND column;
+                memset(&column, 0, sizeof(column));
+                column.buffer_type = MYSQL_TYPE_STRING;
+                column.buffer = &value[0];
+                column.buffer_length = buffer.length;
+                mysql_stmt_fetch_column(prepared->stmt, &column, i, 0);
+                appendField(rows, value.data(), buffer.length);
+            }
+        }
+        rows->nbRows++;
+    }
+    mysql_stmt_free_result(prepared->stmt);
+
+    if (status != MYSQL_NO_DATA) {
+        printf("ERREUR: Échec de la lecture du résultat: %s\n", mysql_stmt_error(prepared->stmt));
+        discardStatement(dal, connection, statement);
+        DalRowsFree(rows);
+        return NULL;
+    }
+    return rows;
+}
+
+/**
+ * Exécute une requête SELECT préparée et traite ses lignes une à une
+ * @param dal Couche d'accès aux données
+ * @param connection Connexion empruntée
+ * @param statement Requête
+ * @param params Paramètres
+ * @param handler Traitement de chaque ligne
+ * @param context Contexte du traitement
+ * @return Nombre de lignes traitées ou -1 en cas d'erreur
+ */
+long long DalStream(Dal *dal, MYSQL *connection, DalStatement statement, const DalParam *params,
+                    DalRowHandler handler, void *context) {
+    Prepared *prepared = execute(dal, connection, statement, params);
+    if (!prepared) {
+        return -1;
+    }
+
+    // Sans mysql_stmt_store_result, chaque ligne est lue du réseau par
+    // mysql_stmt_fetch (équivalent de mysql_use_result)
+    int nbFields = (int)prepared->buffers.size();
+    vector<const char *> fields(nbFields);
+    vector<unsigned long> lengths(nbFields);
+    vector<string> overflow(nbFields);   // Champs plus longs que leur tampon
+    DalRow row = {nbFields, fields.data(), lengths.data()};
+    long long nbRows = 0;
+    bool stopped = false;
+    int status = 0;
+    while (!stopped && ((status = mysql_stmt_fetch(prepared->stmt)) == 0 || status == MYSQL_DATA_TRUNCATED)) {
+        for (int i = 0; i < nbFields; i++) {
+            FieldBuffer &buffer = prepared->buffers[i];
+            lengths[i] = buffer.isNull ? 0 : buffer.length;
+            if (buffer.isNull) {
+                fields[i] = NULL;
+            } else if (!buffer.truncated) {
+                fields[i] = buffer.data;
+            } else {
+                overflow[i].assign(buffer.length, '\0');
+                MYSQL_BIND column;
+                memset(&column, 0, sizeof(column));
+                column.buffer_type = MYSQL_TYPE_STRING;
+                column.buffer = &overflow[i][0];
+                column.buffer_length = buffer.length;
+                mysql_stmt_fetch_column(prepared->stmt, &column, i, 0);
+                fields[i] = overflow[i].data();
+            }
+        }
+        stopped = handler(context, &row) < 0;
+        nbRows++;
+    }
+    // Lignes restantes lues et ignorées
+    mysql_stmt_free_result(prepared->stmt);
+
+    if (!stopped && status != MYSQL_NO_DATA) {
+        printf("ERREUR: Échec de la lecture du résultat: %s\n", mysql_stmt_error(prepared->stmt));
+        discardStatement(dal, connection, statement);
+        return -1;
+    }
+    return nbRows;
+}
+
+/**
+ * Exécute une requête INSERT ou UPDATE préparée
+ * @param dal Couche d'accès aux données
+ * @param connection Connexion empruntée
+ * @param statement Requête
+ * @param params Paramètres
+ * @param insertId Identifiant créé par un INSERT (NULL = ignoré)
+ * @return Nombre de lignes modifiées ou -1 en cas d'erreur
+ */
+long long DalExecute(Dal *dal, MYSQL *connection, DalStatement statement, const DalParam *params,
+                     long long *insertId) {
+    Prepared *prepared = execute(dal, connection, statement, params);
+    if (!prepared) {
+        return -1;
+    }
+    if (insertId) {
+        *insertId = (long long)mysql_stmt_insert_id(prepared->stmt);
+    }
+    return (long long)mysql_stmt_affected_rows(prepared->stmt);
+}
+
+/**
+ * Construit le texte SQL d'une requête, paramètres échappés
+ * @param connection Connexion
+ * @param statement Requête
+ * @param params Paramètres
+ * @return Requête SQL
+ */
+string DalFormat(MYSQL *connection, DalStatement statement, const DalParam *params) {
+    string query;
+    int index = 0;
+    for (const char *c = statementSql[statement]; *c; c++) {
+        if (*c != '?') {
+            query += *c;
+            continue;
+        }
+        const DalParam &param = params[index++];
+        if (!param.isText) {
+            query += to_string(param.number);
+            continue;
+        }
+        string escaped(2 * param.length + 1, '\0');
+        unsigned long length = mysql_real_escape_string(connection, &escaped[0], param.text, param.length);
+        query += '\'';
+        query.append(escaped, 0, length);
+        query += '\'';
+    }
+    return query;
+}
+
+/**
+ * Recopie les lignes d'un résultat texte
+ * @param result Résultat
+ * @return Lignes lues
+ */
+DalRows *DalRowsFromResult(MYSQL_RES *result) {
+    DalRows *rows = new DalRows();
+    rows->nbFields = (int)mysql_num_fields(result);
+    rows->nbRows = 0;
+    MYSQL_ROW row;
+    while ((row = mysql_fetch_row(result))) {
+        unsigned long *lengths = mysql_fetch_lengths(result);
+        for (int i = 0; i < rows->nbFields; i++) {
+            appendField(rows, row[i], lengths[i]);
+        }
+        rows->nbRows++;
+    }
+    return rows;
+}
+
+/**
+ * Nombre de lignes lues
+ * @param rows Lignes
+ * @return Nombre de lignes
+ */
+int DalRowsCount(const DalRows *rows) {
+    return rows->nbRows;
+}
+
+/**
+ * Champ d'une ligne
+ * @param rows Lignes
+ * @param row Ligne
+ * @param field Colonne
+ * @param length Longueur du champ (NULL = ignorée)
+ * @return Champ ou NULL (valeur SQL NULL)
+ */
+const char *DalRowsField(const DalRows *rows, int row, int field, unsigned long *length) {
+    size_t index = (size_t)row * rows->nbFields + field;
+    if (length) {
+        *length = rows->lengths[index];
+    }
+    if (rows->starts[index] == NULL_FIELD) {
+        return NULL;
+    }
+    return rows->data.c_str() + rows->starts[index];
+}
+
+/**
+ * Libère des lignes lues
+ * @param rows Lignes
+ */
+void DalRowsFree(DalRows *rows) {
+    delete rows;
+}
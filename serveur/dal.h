@@ -0,0 +1,200 @@
+/**
+ * Couche d'accès aux données
+ *
+ * Toutes les requêtes SQL du serveur sont décrites ici, avec des paramètres
+ * (?) au lieu de texte du client recopié dans le SQL. Chaque requête est
+ * préparée une seule fois par connexion (mysql_stmt_prepare) puis exécutée
+ * avec ses paramètres liés ; les lignes sont lues dans des tampons de
+ * résultat binaires alloués à la préparation, puis recopiées dans un jeu de
+ * lignes indépendant de la connexion, qui peut donc être rendue au pool avant
+ * l'encodage de la réponse.
+ *
+ * Les requêtes préparées d'une connexion sont fermées avec elle (voir
+ * DbPoolConfig.onClose et DalForget).
+ */
+
+#ifndef DAL_H
+#define DAL_H
+
+#include <mysql.h>
+#include <string>
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Requêtes du serveur (une variante par combinaison de filtres)
+ */
+typedef enum {
+    DAL_SEARCH,                     // Créneaux libres d'une période
+    DAL_SEARCH_SPECIALTY,           // ... d'une spécialité
+    DAL_SEARCH_DOCTOR,              // ... d'un médecin
+    DAL_SEARCH_SPECIALTY_DOCTOR,    // ... d'une spécialité et d'un médecin
+    DAL_SPECIALTIES,                // Toutes les spécialités
+    DAL_DOCTORS,                    // Tous les médecins
+    DAL_DOCTORS_SPECIALTY,          // Médecins d'une spécialité
+    DAL_PATIENTS,                   // Tous les patients (annuaire)
+    DAL_PATIENT_INSERT,             // Création d'un patient
+    DAL_PATIENT_VERIFY,             // Patient par identifiant, nom et prénom
+    DAL_CONSULTATION_GET,           // Consultation et son patient éventuel
+    DAL_CONSULTATION_CLAIM,         // Réservation d'une consultation encore libre
+    DAL_NB_STATEMENTS
+} DalStatement;
+
+/**
+ * Paramètre d'une requête (voir DalNumber et DalText)
+ */
+typedef struct {
+    bool isText;                    // Texte (sinon entier)
+    long long number;               // Valeur entière
+    const char *text;               // Valeur texte (valide jusqu'à la fin de l'appel)
+    unsigned long length;           // Longueur du texte
+} DalParam;
+
+/**
+ * Lignes lues (structure opaque, indépendante de la connexion)
+ */
+typedef struct DalRows DalRows;
+
+/**
+ * Ligne lue au fil de l'eau (voir DalStream), valide jusqu'au retour du
+ * traitement de la ligne
+ */
+typedef struct {
+    int nbFields;                   // Nombre de colonnes
+    const char *const *fields;      // Champs (NULL = valeur SQL NULL)
+    const unsigned long *lengths;   // Longueur de chaque champ
+} DalRow;
+
+/**
+ * Traitement d'une ligne lue au fil de l'eau
+ * @return 0 pour continuer, -1 pour abandonner les lignes suivantes
+ */
+typedef int (*DalRowHandler)(void *context, const DalRow *row);
+
+/**
+ * Requêtes préparées de toutes les connexions (structure opaque, thread-safe)
+ */
+typedef struct Dal Dal;
+
+/**
+ * Paramètre entier
+ */
+static inline DalParam DalNumber(long long number) {
+    return DalParam{false, number, NULL, 0};
+}
+
+/**
+ * Paramètre texte
+ */
+static inline DalParam DalText(const std::string &text) {
+    return DalParam{true, 0, text.c_str(), (unsigned long)text.length()};
+}
+
+// ============================================================================
+// FONCTIONS
+// ============================================================================
+
+/**
+ * Crée la couche d'accès aux données (aucune requête n'est encore préparée)
+ * @return Couche créée
+ */
+Dal *DalCreate(void);
+
+/**
+ * Libère la couche d'accès aux données (toutes les connexions doivent avoir
+ * été oubliées, voir DalForget)
+ * @param dal Couche d'accès aux données
+ */
+void DalDestroy(Dal *dal);
+
+/**
+ * Ferme les requêtes préparées d'une connexion, avant sa fermeture.
+ * Signature de DbPoolConfig.onClose.
+ * @param context Couche d'accès aux données (Dal *)
+ * @param connection Connexion fermée
+ */
+void DalForget(void *context, MYSQL *connection);
+
+/**
+ * Exécute une requête SELECT préparée et lit toutes ses lignes
+ * @param dal Couche d'accès aux données
+ * @param connection Connexion empruntée (utilisée par un seul thread)
+ * @param statement Requête
+ * @param params Paramètres, dans l'ordre des ?
+ * @return Lignes lues (à libérer avec DalRowsFree) ou NULL en cas d'erreur
+ */
+DalRows *DalSelect(Dal *dal, MYSQL *connection, DalStatement statement, const DalParam *params);
+
+/**
+ * Exécute une requête SELECT préparée et traite ses lignes une à une, à
+ * mesure qu'elles arrivent du serveur MySQL : rien n'est gardé entre deux
+ * lignes, quelle que soit la taille du résultat. La connexion reste occupée
+ * jusqu'à la dernière ligne : le traitement doit être rapide.
+ * @param dal Couche d'accès aux données
+ * @param connection Connexion empruntée (utilisée par un seul thread)
+ * @param statement Requête
+ * @param params Paramètres, dans l'ordre des ?
+ * @param handler Traitement de chaque ligne
+ * @param context Contexte du traitement
+ * @return Nombre de lignes traitées (lignes restantes ignorées si le
+ *         traitement abandonne) ou -1 en cas d'erreur MySQL
+ */
+long long DalStream(Dal *dal, MYSQL *connection, DalStatement statement, const DalParam *params,
+                    DalRowHandler handler, void *context);
+
+/**
+ * Exécute une requête INSERT ou UPDATE préparée
+ * @param dal Couche d'accès aux données
+ * @param connection Connexion empruntée (utilisée par un seul thread)
+ * @param statement Requête
+ * @param params Paramètres, dans l'ordre des ?
+ * @param insertId Identifiant créé par un INSERT (NULL = ignoré)
+ * @return Nombre de lignes modifiées ou -1 en cas d'erreur
+ */
+long long DalExecute(Dal *dal, MYSQL *connection, DalStatement statement, const DalParam *params,
+                     long long *insertId);
+
+/**
+ * Construit le texte SQL d'une requête, paramètres échappés
+ * (mysql_real_escape_string), pour l'API non bloquante de MySQL qui
+ * n'accepte pas de requête préparée
+ * @param connection Connexion (jeu de caractères de l'échappement)
+ * @param statement Requête
+ * @param params Paramètres, dans l'ordre des ?
+ * @return Requête SQL
+ */
+std::string DalFormat(MYSQL *connection, DalStatement statement, const DalParam *params);
+
+/**
+ * Recopie les lignes d'un résultat texte (voir DalFormat)
+ * @param result Résultat (libéré par l'appelant)
+ * @return Lignes lues (à libérer avec DalRowsFree)
+ */
+DalRows *DalRowsFromResult(MYSQL_RES *result);
+
+/**
+ * Nombre de lignes lues
+ * @param rows Lignes
+ * @return Nombre de lignes
+ */
+int DalRowsCount(const DalRows *rows);
+
+/**
+ * Champ d'une ligne (terminé par un caractère nul)
+ * @param rows Lignes
+ * @param row Ligne (0 à DalRowsCount - 1)
+ * @param field Colonne
+ * @param length Longueur du champ (NULL = ignorée)
+ * @return Champ, valide jusqu'à DalRowsFree, ou NULL (valeur SQL NULL)
+ */
+const char *DalRowsField(const DalRows *rows, int row, int field, unsigned long *length);
+
+/**
+ * Libère des lignes lues
+ * @param rows Lignes (NULL accepté)
+ */
+void DalRowsFree(DalRows *rows);
+
+#endif // DAL_H
@@ -0,0 +1,599 @@
+/**
+ * Implémentation du pool borné de connexions MySQL
+ *
+ * Toutes les décisions (emprunt, remise, attente) sont prises sous un seul
+ * mutex ; les opérations réseau (ouverture, ping, fermeture) sont faites hors
+ * verrou. Un emplacement est réservé (total++) avant d'ouvrir une connexion,
+ * de sorte que le pool ne dépasse jamais maxConnections. DbPoolTryAcquire
+ * ne fait aucune opération réseau : il confie la vérification d'une
+ * connexion libre ou l'ouverture d'une nouvelle au thread de maintenance.
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "dbpool.h"
+#include <errmsg.h>
+#include <pthread.h>
+#include <errno.h>
+#include <stdio.h>
+#include <time.h>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+const int MAINTENANCE_TICK_MS = 1000;   // Période du thread de maintenance
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Connexion libre et date de sa dernière utilisation
+ */
+struct FreeConnection {
+    MYSQL *connection;
+    long long lastUse;              // Dernière utilisation (ms, horloge monotone)
+};
+
+/**
+ * Thread en attente d'une connexion (sur sa propre condition)
+ */
+struct Waiter {
+    pthread_cond_t cond;
+    bool granted;                   // Remise effectuée par DbPoolRelease
+    MYSQL *connection;              // Connexion remise (NULL = ouvrir une connexion)
+    long long lastUse;              // Dernière utilisation de la connexion remise
+};
+
+struct DbPool {
+    DbPoolConfig config;
+    string host, user, password, database; // Copies des chaînes de config
+    pthread_mutex_t mutex;
+    deque<FreeConnection> idle;     // Connexions libres (fin = plus récente)
+    deque<Waiter *> waiters;        // File d'attente (début = plus ancien)
+    unordered_map<MYSQL *, long long> leasedAt; // Début de chaque emprunt en cours (µs)
+    unordered_set<MYSQL *> condemned; // Connexions empruntées à fermer (DbPoolMarkBroken)
+    DbPoolStats stats;              // Compteurs (total, inUse tenus à jour)
+    pthread_t maintenance;          // Thread de fermeture des connexions inactives
+    pthread_cond_t wakeCond;        // Réveil du thread de maintenance (arrêt, préparation)
+    vector<MYSQL *> toCheck;        // Connexions libres à vérifier (DbPoolTryAcquire)
+    int toOpen;                     // Emplacements réservés à ouvrir (DbPoolTryAcquire)
+    bool unreachable;               // Dernières ouvertures demandées toutes en échec
+    bool stopping;
+};
+
+// ============================================================================
+// FONCTIONS INTERNES
+// ============================================================================
+
+/**
+ * Horloge monotone en millisecondes
+ */
+static long long nowMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * Horloge monotone en microsecondes (mesure des attentes)
+ */
+static long long nowUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/**
+ * Initialise une condition sur l'horloge monotone (échéances insensibles
+ * aux changements d'heure du système)
+ */
+static void initCond(pthread_cond_t *cond) {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+static struct timespec deadlineAt(long long deadlineMs) {
+    struct timespec ts;
+    ts.tv_sec = deadlineMs / 1000;
+    ts.tv_nsec = (deadlineMs % 1000) * 1000000;
+    return ts;
+}
+
+/**
+ * Ouvre une nouvelle connexion MySQL (hors verrou)
+ * @return Connexion ouverte ou NULL en cas d'échec
+ */
+static MYSQL *openConnection(DbPool *pool) {
+    MYSQL *connection = mysql_init(NULL);
+    if (!connection) {
+        printf("ERREUR: Impossible d'initialiser la connexion MySQL\n");
+        return NULL;
+    }
+
+    if (!mysql_real_connect(connection, pool->host.c_str(), pool->user.c_str(),
+                            pool->password.c_str(), pool->database.c_str(), 0, NULL, 0)) {
+        printf("ERREUR: Impossible de se connecter à la base de données: %s\n", mysql_error(connection));
+        mysql_close(connection);
+        return NULL;
+    }
+    return connection;
+}
+
+/**
+ * Ferme une connexion, après l'appel de onClose (hors verrou)
+ */
+static void closeConnection(DbPool *pool, MYSQL *connection) {
+    if (pool->config.onClose) {
+        pool->config.onClose(pool->config.closeContext, connection);
+    }
+    mysql_close(connection);
+}
+
+/**
+ * Libère un emplacement (connexion fermée ou jamais ouverte). Si un thread
+ * attend, l'emplacement lui est aussitôt confié : il ouvrira une connexion.
+ * Appelée sous le verrou du pool.
+ */
+static void releaseSlot(DbPool *pool) {
+    pool->stats.total--;
+    pool->stats.inUse--;
+    if (!pool->waiters.empty()) {
+        Waiter *waiter = pool->waiters.front();
+        pool->waiters.pop_front();
+        pool->stats.total++;
+        pool->stats.inUse++;
+        waiter->granted = true;
+        waiter->connection = NULL;
+        pthread_cond_signal(&waiter->cond);
+    }
+}
+
+/**
+ * Comptabilise la durée d'un emprunt qui se termine. Appelée sous le verrou.
+ * @param connection Connexion rendue
+ */
+static void endLease(DbPool *pool, MYSQL *connection) {
+    auto it = pool->leasedAt.find(connection);
+    if (it != pool->leasedAt.end()) {
+        pool->stats.released++;
+        pool->stats.useTotalUs += nowUs() - it->second;
+        pool->leasedAt.erase(it);
+    }
+}
+
+/**
+ * Remet une connexion utilisable : au plus ancien thread en attente s'il y
+ * en a un (pas de dépassement), sinon dans les connexions libres. La
+ * connexion ne doit pas être comptée comme empruntée. Appelée sous le verrou.
+ * @param connection Connexion à remettre
+ * @param now Date de sa dernière utilisation (ms)
+ */
+static void offerConnection(DbPool *pool, MYSQL *connection, long long now) {
+    if (!pool->waiters.empty()) {
+        Waiter *waiter = pool->waiters.front();
+        pool->waiters.pop_front();
+        waiter->granted = true;
+        waiter->connection = connection;
+        waiter->lastUse = now;
+        pool->stats.inUse++;
+        pool->leasedAt[connection] = nowUs();
+        pthread_cond_signal(&waiter->cond);
+    } else {
+        pool->idle.push_back({connection, now});
+    }
+}
+
+/**
+ * Prend une connexion libre, ou réserve un emplacement si le pool n'est pas
+ * plein, sans passer devant les threads qui attendent. Appelée sous le verrou.
+ * @param connection Connexion prise (NULL pour un emplacement réservé)
+ * @param lastUse Dernière utilisation de la connexion prise
+ * @return false si le pool est occupé (il faut attendre)
+ */
+static bool takeSlot(DbPool *pool, MYSQL **connection, long long *lastUse) {
+    if (!pool->waiters.empty()) {
+        return false;
+    }
+    if (!pool->idle.empty()) {
+        // Connexion libre la plus récente (encore chaude côté serveur)
+        *connection = pool->idle.back().connection;
+        *lastUse = pool->idle.back().lastUse;
+        pool->idle.pop_back();
+        pool->stats.inUse++;
+        pool->leasedAt[*connection] = nowUs();
+        return true;
+    }
+    if (pool->stats.total < pool->config.maxConnections) {
+        // Réserver l'emplacement, la connexion est ouverte hors verrou
+        pool->stats.total++;
+        pool->stats.inUse++;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Fin commune des emprunts, hors verrou : vérifie une connexion restée
+ * longtemps inutilisée et ouvre celle d'un emplacement réservé
+ * @param pool Pool de connexions
+ * @param connection Connexion obtenue (NULL = emplacement réservé)
+ * @param lastUse Dernière utilisation de la connexion
+ * @return Connexion utilisable ou NULL (base injoignable)
+ */
+static MYSQL *prepareConnection(DbPool *pool, MYSQL *connection, long long lastUse) {
+    // Vérifier une connexion restée longtemps inutilisée
+    if (connection && nowMs() - lastUse > pool->config.pingIntervalMs &&
+        mysql_ping(connection) != 0) {
+        printf("ATTENTION: Connexion MySQL perdue (%s), reconnexion\n", mysql_error(connection));
+        pthread_mutex_lock(&pool->mutex);
+        pool->stats.broken++;
+        pool->leasedAt.erase(connection);
+        pthread_mutex_unlock(&pool->mutex);
+        closeConnection(pool, connection);
+        connection = NULL;
+    }
+
+    // Emplacement réservé sans connexion : en ouvrir une
+    if (!connection) {
+        connection = openConnection(pool);
+        pthread_mutex_lock(&pool->mutex);
+        if (connection) {
+            pool->stats.created++;
+            pool->leasedAt[connection] = nowUs();
+        } else {
+            pool->stats.failures++;
+            pool->stats.acquired--;
+            releaseSlot(pool);
+        }
+        pthread_mutex_unlock(&pool->mutex);
+    }
+    return connection;
+}
+
+/**
+ * Vérifie et ouvre les connexions demandées par DbPoolTryAcquire, puis les
+ * remet au pool, où le demandeur les prendra à son prochain essai. Appelée
+ * sous le verrou, qui est relâché pendant les opérations réseau.
+ * @param pool Pool de connexions
+ */
+static void prepareRequested(DbPool *pool) {
+    vector<MYSQL *> checks;
+    checks.swap(pool->toCheck);
+    int opens = pool->toOpen;
+    pool->toOpen = 0;
+    if (checks.empty() && opens == 0) {
+        return;
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    vector<MYSQL *> ready;
+    int lost = 0;
+    int failed = 0;
+    for (MYSQL *connection : checks) {
+        if (mysql_ping(connection) == 0) {
+            ready.push_back(connection);
+        } else {
+            printf("ATTENTION: Connexion MySQL perdue (%s), fermée\n", mysql_error(connection));
+            closeConnection(pool, connection);
+            lost++;
+        }
+    }
+    for (int i = 0; i < opens; i++) {
+        MYSQL *connection = openConnection(pool);
+        if (connection) {
+            ready.push_back(connection);
+        } else {
+            failed++;
+        }
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->stats.broken += lost;
+    pool->stats.created += opens - failed;
+    pool->stats.failures += failed;
+    if (opens > 0) {
+        pool->unreachable = failed == opens;
+    }
+    long long now = nowMs();
+    for (MYSQL *connection : ready) {
+        offerConnection(pool, connection, now);
+    }
+    // Emplacements perdus, ni libres ni empruntés (voir releaseSlot)
+    for (int i = 0; i < lost + failed; i++) {
+        pool->stats.inUse++;
+        releaseSlot(pool);
+    }
+}
+
+/**
+ * Thread de maintenance : prépare les connexions demandées sans attente,
+ * ferme les connexions libres depuis plus de idleTimeoutMs et affiche
+ * périodiquement les métriques
+ * @param arg Pool de connexions
+ * @return NULL
+ */
+static void *maintenanceThread(void *arg) {
+    DbPool *pool = (DbPool *)arg;
+    long long nextReport = nowMs() + pool->config.statsIntervalMs;
+
+    pthread_mutex_lock(&pool->mutex);
+    while (!pool->stopping) {
+        if (pool->toCheck.empty() && pool->toOpen == 0) {
+            struct timespec deadline = deadlineAt(nowMs() + MAINTENANCE_TICK_MS);
+            pthread_cond_timedwait(&pool->wakeCond, &pool->mutex, &deadline);
+            if (pool->stopping) {
+                break;
+            }
+        }
+        prepareRequested(pool);
+
+        // Les plus anciennes connexions libres sont en début de file
+        long long now = nowMs();
+        vector<MYSQL *> expired;
+        while (pool->config.idleTimeoutMs > 0 && !pool->idle.empty() &&
+               now - pool->idle.front().lastUse > pool->config.idleTimeoutMs) {
+            expired.push_back(pool->idle.front().connection);
+            pool->idle.pop_front();
+            pool->stats.total--;
+            pool->stats.evicted++;
+        }
+        bool report = pool->config.statsIntervalMs > 0 && now >= nextReport;
+        pthread_mutex_unlock(&pool->mutex);
+
+        for (MYSQL *connection : expired) {
+            closeConnection(pool, connection);
+        }
+        if (!expired.empty()) {
+            printf("Pool MySQL: %zu connexion(s) inactive(s) fermée(s)\n", expired.size());
+        }
+        if (report) {
+            DbPoolReport(pool);
+            nextReport = now + pool->config.statsIntervalMs;
+        }
+        pthread_mutex_lock(&pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return NULL;
+}
+
+// ============================================================================
+// FONCTIONS PUBLIQUES
+// ============================================================================
+
+/**
+ * Crée le pool et démarre son thread de maintenance
+ * @param config Paramètres du pool
+ * @return Pool créé ou NULL en cas d'erreur
+ */
+DbPool *DbPoolCreate(const DbPoolConfig *config) {
+    if (config->maxConnections <= 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    DbPool *pool = new DbPool();
+    pool->config = *config;
+    pool->host = config->host ? config->host : "";
+    pool->user = config->user ? config->user : "";
+    pool->password = config->password ? config->password : "";
+    pool->database = config->database ? config->database : "";
+    pthread_mutex_init(&pool->mutex, NULL);
+    initCond(&pool->wakeCond);
+    pool->toOpen = 0;
+    pool->unreachable = false;
+    pool->stopping = false;
+
+    if (pthread_create(&pool->maintenance, NULL, maintenanceThread, pool) != 0) {
+        pthread_cond_destroy(&pool->wakeCond);
+        pthread_mutex_destroy(&pool->mutex);
+        delete pool;
+        return NULL;
+    }
+    return pool;
+}
+
+/**
+ * Arrête le thread de maintenance et ferme les connexions libres
+ * @param pool Pool de connexions
+ */
+void DbPoolDestroy(DbPool *pool) {
+    if (!pool) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->stopping = true;
+    pthread_cond_signal(&pool->wakeCond);
+    pthread_mutex_unlock(&pool->mutex);
+    pthread_join(pool->maintenance, NULL);
+
+    for (const FreeConnection &entry : pool->idle) {
+        closeConnection(pool, entry.connection);
+    }
+    for (MYSQL *connection : pool->toCheck) {
+        closeConnection(pool, connection);
+    }
+    pthread_cond_destroy(&pool->wakeCond);
+    pthread_mutex_destroy(&pool->mutex);
+    delete pool;
+}
+
+/**
+ * Emprunte une connexion (voir dbpool.h)
+ * @param pool Pool de connexions
+ * @return Connexion utilisable ou NULL (délai dépassé ou base injoignable)
+ */
+MYSQL *DbPoolAcquire(DbPool *pool) {
+    long long start = nowUs();
+    MYSQL *connection = NULL;
+    long long lastUse = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    if (!takeSlot(pool, &connection, &lastUse)) {
+        // Attendre son tour : DbPoolRelease sert la file dans l'ordre d'arrivée
+        Waiter waiter;
+        initCond(&waiter.cond);
+        waiter.granted = false;
+        waiter.connection = NULL;
+        waiter.lastUse = 0;
+        pool->waiters.push_back(&waiter);
+        if ((int)pool->waiters.size() > pool->stats.maxWaiting) {
+            pool->stats.maxWaiting = pool->waiters.size();
+        }
+
+        struct timespec deadline = deadlineAt(nowMs() + pool->config.acquireTimeoutMs);
+        while (!waiter.granted) {
+            if (pthread_cond_timedwait(&waiter.cond, &pool->mutex, &deadline) == ETIMEDOUT &&
+                !waiter.granted) {
+                for (auto it = pool->waiters.begin(); it != pool->waiters.end(); ++it) {
+                    if (*it == &waiter) {
+                        pool->waiters.erase(it);
+                        break;
+                    }
+                }
+                pool->stats.timeouts++;
+                pthread_mutex_unlock(&pool->mutex);
+                pthread_cond_destroy(&waiter.cond);
+                errno = ETIMEDOUT;
+                return NULL;
+            }
+        }
+        pthread_cond_destroy(&waiter.cond);
+        connection = waiter.connection;
+        lastUse = waiter.lastUse;
+    }
+
+    long long waited = nowUs() - start;
+    pool->stats.acquired++;
+    pool->stats.waitTotalUs += waited;
+    if (waited > pool->stats.waitMaxUs) {
+        pool->stats.waitMaxUs = waited;
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return prepareConnection(pool, connection, lastUse);
+}
+
+/**
+ * Emprunte une connexion sans attendre (voir dbpool.h)
+ * @param pool Pool de connexions
+ * @return Connexion utilisable, ou NULL (errno = EAGAIN : réessayer plus tard)
+ */
+MYSQL *DbPoolTryAcquire(DbPool *pool) {
+    pthread_mutex_lock(&pool->mutex);
+    bool first = pool->waiters.empty();
+    if (first && !pool->idle.empty() &&
+        nowMs() - pool->idle.back().lastUse <= pool->config.pingIntervalMs) {
+        // Connexion libre la plus récente, utilisable sans vérification
+        MYSQL *connection = pool->idle.back().connection;
+        pool->idle.pop_back();
+        pool->stats.inUse++;
+        pool->stats.acquired++;
+        pool->leasedAt[connection] = nowUs();
+        pthread_mutex_unlock(&pool->mutex);
+        return connection;
+    }
+
+    // Rien de prêt : le thread de maintenance vérifie ou ouvre une connexion
+    int error = EAGAIN;
+    if (first && !pool->idle.empty()) {
+        pool->toCheck.push_back(pool->idle.back().connection);
+        pool->idle.pop_back();
+        pthread_cond_signal(&pool->wakeCond);
+    } else if (first && pool->stats.total < pool->config.maxConnections) {
+        pool->stats.total++;
+        pool->toOpen++;
+        pthread_cond_signal(&pool->wakeCond);
+        if (pool->unreachable) {
+            error = ECONNREFUSED;
+        }
+    } else {
+        pool->stats.busy++;
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    errno = error;
+    return NULL;
+}
+
+/**
+ * Rend une connexion empruntée (voir dbpool.h)
+ * @param pool Pool de connexions
+ * @param connection Connexion obtenue par DbPoolAcquire
+ */
+void DbPoolRelease(DbPool *pool, MYSQL *connection) {
+    unsigned int error = mysql_errno(connection);
+    bool lost = error == CR_SERVER_GONE_ERROR || error == CR_SERVER_LOST;
+    long long now = nowMs();
+    pthread_mutex_lock(&pool->mutex);
+    endLease(pool, connection);
+    bool condemned = pool->condemned.erase(connection) > 0;
+    if (lost || condemned) {
+        pool->stats.broken++;
+        releaseSlot(pool);
+        pthread_mutex_unlock(&pool->mutex);
+        if (lost) {
+            printf("ATTENTION: Connexion MySQL perdue (%s), fermée\n", mysql_error(connection));
+        } else {
+            printf("ATTENTION: Connexion MySQL abandonnée en cours d'échange, fermée\n");
+        }
+        closeConnection(pool, connection);
+        return;
+    }
+
+    pool->stats.inUse--;
+    offerConnection(pool, connection, now);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+/**
+ * Signale une connexion empruntée à fermer (voir dbpool.h)
+ * @param pool Pool de connexions
+ * @param connection Connexion empruntée
+ */
+void DbPoolMarkBroken(DbPool *pool, MYSQL *connection) {
+    pthread_mutex_lock(&pool->mutex);
+    pool->condemned.insert(connection);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+/**
+ * Copie les métriques courantes du pool
+ * @param pool Pool de connexions
+ * @param stats Métriques à remplir
+ */
+void DbPoolGetStats(DbPool *pool, DbPoolStats *stats) {
+    pthread_mutex_lock(&pool->mutex);
+    *stats = pool->stats;
+    stats->idle = pool->idle.size();
+    stats->waiting = pool->waiters.size();
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+/**
+ * Affiche les métriques du pool sur une ligne
+ * @param pool Pool de connexions
+ */
+void DbPoolReport(DbPool *pool) {
+    DbPoolStats stats;
+    DbPoolGetStats(pool, &stats);
+    printf("Pool MySQL: %d/%d ouvertes (%d libres, %d empruntées), %d en attente (max %d), "
+           "%llu emprunts (attente moy %lld µs, max %lld µs, durée moy %lld µs), %llu expirés, "
+           "%llu refusés, %llu créées, %llu fermées inactives, %llu perdues, %llu échecs\n",
+           stats.total, pool->config.maxConnections, stats.idle, stats.inUse,
+           stats.waiting, stats.maxWaiting, stats.acquired,
+           stats.acquired ? stats.waitTotalUs / (long long)stats.acquired : 0LL,
+           stats.waitMaxUs,
+           stats.released ? stats.useTotalUs / (long long)stats.released : 0LL, stats.timeouts, stats.busy, stats.created, stats.evicted,
+           stats.broken, stats.failures);
+}
@@ -0,0 +1,135 @@
+/**
+ * Pool borné de connexions MySQL
+ *
+ * Les threads empruntent une connexion le temps d'une requête puis la
+ * rendent. Quand toutes les connexions sont prises, les demandeurs attendent
+ * dans l'ordre d'arrivée (une connexion rendue est remise directement au plus
+ * ancien) et abandonnent au bout du délai d'attente. Un thread de maintenance
+ * ferme les connexions restées inutilisées trop longtemps, et prépare celles
+ * qu'un emprunt sans attente n'a pas pu obtenir tout de suite.
+ */
+
+#ifndef DBPOOL_H
+#define DBPOOL_H
+
+#include <mysql.h>
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Paramètres du pool (les chaînes sont recopiées par DbPoolCreate)
+ */
+typedef struct {
+    const char *host;               // Hôte de la base de données
+    const char *user;               // Utilisateur
+    const char *password;           // Mot de passe
+    const char *database;           // Nom de la base
+    int maxConnections;             // Connexions ouvertes au maximum
+    int acquireTimeoutMs;           // Attente maximale d'une connexion libre
+    int idleTimeoutMs;              // Inutilisation avant fermeture (0 = jamais)
+    int pingIntervalMs;             // Inutilisation avant vérification (mysql_ping)
+    int statsIntervalMs;            // Période d'affichage des métriques (0 = jamais)
+    void (*onClose)(void *context, MYSQL *connection); // Appelée avant chaque fermeture
+                                    // de connexion, hors verrou (NULL = aucune)
+    void *closeContext;             // Premier argument de onClose
+} DbPoolConfig;
+
+/**
+ * Métriques du pool
+ */
+typedef struct {
+    int total;                      // Connexions ouvertes (ou en cours d'ouverture)
+    int idle;                       // Connexions libres
+    int inUse;                      // Connexions empruntées
+    int waiting;                    // Threads en attente d'une connexion
+    int maxWaiting;                 // Plus longue file d'attente observée
+    unsigned long long acquired;    // Emprunts réussis
+    unsigned long long timeouts;    // Emprunts abandonnés (délai dépassé)
+    unsigned long long busy;        // Emprunts sans attente refusés (pool occupé)
+    unsigned long long created;     // Connexions ouvertes depuis le démarrage
+    unsigned long long evicted;     // Connexions fermées pour inactivité
+    unsigned long long broken;      // Connexions perdues (ping ou requête)
+    unsigned long long failures;    // Échecs d'ouverture
+    long long waitTotalUs;          // Attente cumulée des emprunts (µs)
+    long long waitMaxUs;            // Plus longue attente d'un emprunt (µs)
+    unsigned long long released;    // Emprunts terminés (connexion rendue)
+    long long useTotalUs;           // Durée cumulée des emprunts terminés (µs)
+} DbPoolStats;
+
+/**
+ * Pool de connexions (structure opaque, thread-safe)
+ */
+typedef struct DbPool DbPool;
+
+// ============================================================================
+// FONCTIONS
+// ============================================================================
+
+/**
+ * Crée le pool (sans ouvrir de connexion) et démarre son thread de maintenance
+ * @param config Paramètres du pool
+ * @return Pool créé ou NULL en cas d'erreur
+ */
+DbPool *DbPoolCreate(const DbPoolConfig *config);
+
+/**
+ * Arrête le thread de maintenance et ferme les connexions libres
+ * (toutes les connexions doivent avoir été rendues)
+ * @param pool Pool de connexions
+ */
+void DbPoolDestroy(DbPool *pool);
+
+/**
+ * Emprunte une connexion : libre si possible, nouvelle si le pool n'est pas
+ * plein, sinon attendue dans l'ordre d'arrivée jusqu'au délai configuré
+ * @param pool Pool de connexions
+ * @return Connexion utilisable ou NULL (délai dépassé ou base injoignable)
+ */
+MYSQL *DbPoolAcquire(DbPool *pool);
+
+/**
+ * Emprunte une connexion sans jamais attendre ni faire d'opération réseau :
+ * une connexion libre utilisée depuis moins de pingIntervalMs, sinon refus
+ * immédiat. Une connexion libre à vérifier (mysql_ping), ou une nouvelle
+ * connexion si le pool n'est pas plein, est alors préparée par le thread de
+ * maintenance et prise au prochain essai. Pour les appelants qui ne doivent
+ * pas bloquer leur thread (coroutines).
+ * @param pool Pool de connexions
+ * @return Connexion utilisable, ou NULL (errno = EAGAIN : réessayer plus tard,
+ *         autre valeur si la dernière ouverture a échoué : base injoignable)
+ */
+MYSQL *DbPoolTryAcquire(DbPool *pool);
+
+/**
+ * Rend une connexion empruntée. Une connexion perdue pendant la requête
+ * (CR_SERVER_GONE_ERROR, CR_SERVER_LOST) est fermée au lieu d'être réutilisée.
+ * @param pool Pool de connexions
+ * @param connection Connexion obtenue par DbPoolAcquire ou DbPoolTryAcquire
+ */
+void DbPoolRelease(DbPool *pool, MYSQL *connection);
+
+/**
+ * Signale une connexion empruntée dont l'état est inconnu (échange non
+ * bloquant abandonné en cours de route) : DbPoolRelease la fermera au lieu
+ * de la remettre dans le pool.
+ * @param pool Pool de connexions
+ * @param connection Connexion empruntée
+ */
+void DbPoolMarkBroken(DbPool *pool, MYSQL *connection);
+
+/**
+ * Copie les métriques courantes du pool
+ * @param pool Pool de connexions
+ * @param stats Métriques à remplir
+ */
+void DbPoolGetStats(DbPool *pool, DbPoolStats *stats);
+
+/**
+ * Affiche les métriques du pool sur une ligne
+ * @param pool Pool de connexions
+ */
+void DbPoolReport(DbPool *pool);
+
+#endif // DBPOOL_H
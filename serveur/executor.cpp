@@ -0,0 +1,526 @@
+/**
+ * Implémentation de l'exécuteur à vol de travail
+ *
+ * Chaque file locale est protégée par son propre mutex : le propriétaire et
+ * un éventuel voleur sont les seuls à se la disputer. Le propriétaire comme
+ * le voleur prennent les tâches les plus anciennes, pour que les requêtes
+ * d'une même connexion finissent dans l'ordre où elles sont arrivées. La file
+ * d'injection est la file sans verrou du serveur (taskqueue.h).
+ *
+ * Un thread sans travail s'endort sur une condition après s'être déclaré
+ * (endormis) puis avoir regardé une dernière fois toutes les files ; une
+ * soumission ne prend le mutex de sommeil que si quelqu'un dort.
+ *
+ * Les threads au-delà du nombre actif (ExecutorResize) finissent leur file
+ * locale puis se retirent sur une condition à part : ils ne prennent plus de
+ * tâche jusqu'à ce que le nombre actif remonte, et les réveils destinés aux
+ * threads actifs ne se perdent pas sur eux.
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "executor.h"
+#include "taskqueue.h"
+#include <pthread.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <atomic>
+#include <deque>
+#include <vector>
+
+using namespace std;
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+const int INJECTION_CHECK_PERIOD = 61; // Tâches locales entre deux regards sur l'injection
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Tâche en attente d'exécution
+ */
+struct ExecutorTask {
+    ExecutorFunction function;
+    void *argument;
+    long long submitNs;             // Date de soumission (attente en file)
+};
+
+/**
+ * Thread de l'exécuteur et sa file locale
+ */
+struct alignas(TAILLE_LIGNE_CACHE) Worker {
+    Executor *executor;
+    int index;
+    pthread_t thread;
+    pthread_mutex_t mutex;          // Protège tasks
+    deque<ExecutorTask> tasks;      // File locale (début = plus ancienne)
+    atomic<int> size{0};            // Taille de la file, lue sans verrou par les voleurs
+    unsigned int seed;              // Choix de la première victime
+    unsigned int tick;              // Tâches exécutées (regard périodique sur l'injection)
+
+    // Compteurs tenus par le seul propriétaire
+    atomic<unsigned long long> spawned{0};
+    atomic<unsigned long long> executed{0};
+    atomic<unsigned long long> steals{0};
+    atomic<unsigned long long> stolen{0};
+    atomic<unsigned long long> parks{0};
+    atomic<unsigned long long> started{0};
+    atomic<long long> waitTotalNs{0};   // Attente cumulée en file des tâches commencées
+};
+
+struct Executor {
+    vector<Worker *> workers;
+    TaskQueue<ExecutorTask> injection; // Tâches soumises de l'extérieur
+    atomic<bool> stopping{false};
+    atomic<int> sleeping{0};        // Threads déclarés en sommeil
+    atomic<int> active{0};          // Threads autorisés à prendre des tâches
+    pthread_mutex_t parkMutex;      // Sommeil des threads sans travail
+    pthread_cond_t parkCond;
+    pthread_cond_t retireCond;      // Threads retirés (rang >= active)
+    atomic<unsigned long long> injected{0};
+    atomic<size_t> maxQueued{0};    // Plus longue file observée
+    ExecutorThreadStart onStart = NULL; // Appelée au démarrage de chaque thread
+    bool stopped = false;           // Threads arrêtés (ExecutorStop)
+
+    explicit Executor(size_t capacity) : injection(capacity) {}
+};
+
+static __thread Worker *currentWorker = NULL;  // Thread de l'exécuteur appelant
+
+// ============================================================================
+// FONCTIONS INTERNES
+// ============================================================================
+
+/**
+ * Horloge monotone en nanosecondes
+ */
+static long long nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * Indique si un thread est au-delà du nombre actif
+ */
+static bool retired(Worker *worker) {
+    return worker->index >= worker->executor->active.load(memory_order_acquire);
+}
+
+/**
+ * Réveille un thread endormi s'il y en a (après une soumission)
+ */
+static void wakeOne(Executor *executor) {
+    // Ordonne la publication de la tâche avant la lecture du compteur
+    atomic_thread_fence(memory_order_seq_cst);
+    if (executor->sleeping.load(memory_order_relaxed) > 0) {
+        pthread_mutex_lock(&executor->parkMutex);
+        pthread_cond_signal(&executor->parkCond);
+        pthread_mutex_unlock(&executor->parkMutex);
+    }
+}
+
+/**
+ * Retient la longueur d'une file après une soumission si c'est la plus longue
+ */
+static void recordDepth(Executor *executor, size_t depth) {
+    size_t max = executor->maxQueued.load(memory_order_relaxed);
+    while (depth > max &&
+           !executor->maxQueued.compare_exchange_weak(max, depth, memory_order_relaxed)) {
+    }
+}
+
+/**
+ * Ajoute une tâche à la file locale d'un thread de l'exécuteur
+ */
+static void pushLocal(Worker *worker, const ExecutorTask &task) {
+    pthread_mutex_lock(&worker->mutex);
+    worker->tasks.push_back(task);
+    size_t depth = worker->tasks.size();
+    worker->size.store(depth, memory_order_relaxed);
+    pthread_mutex_unlock(&worker->mutex);
+    worker->spawned.fetch_add(1, memory_order_relaxed);
+    recordDepth(worker->executor, depth);
+}
+
+/**
+ * Retire la tâche la plus ancienne de la file locale
+ */
+static bool popLocal(Worker *worker, ExecutorTask &task) {
+    if (worker->size.load(memory_order_relaxed) == 0) {
+        return false;
+    }
+    pthread_mutex_lock(&worker->mutex);
+    bool found = !worker->tasks.empty();
+    if (found) {
+        task = worker->tasks.front();
+        worker->tasks.pop_front();
+        worker->size.store(worker->tasks.size(), memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&worker->mutex);
+    return found;
+}
+
+/**
+ * Vole la moitié (arrondie au-dessus) des tâches d'un autre thread, en
+ * commençant par une victime tirée au hasard. La première tâche volée est
+ * rendue, les autres rejoignent la file locale du voleur.
+ */
+static bool steal(Worker *thief, ExecutorTask &task) {
+    Executor *executor = thief->executor;
+    int nbWorkers = executor->workers.size();
+    int start = rand_r(&thief->seed) % nbWorkers;
+    vector<ExecutorTask> loot;
+
+    for (int i = 0; i < nbWorkers; i++) {
+        Worker *victim = executor->workers[(start + i) % nbWorkers];
+        if (victim == thief || victim->size.load(memory_order_relaxed) == 0) {
+            continue;
+        }
+        pthread_mutex_lock(&victim->mutex);
+        size_t count = (victim->tasks.size() + 1) / 2;
+        for (size_t j = 0; j < count; j++) {
+            loot.push_back(victim->tasks.front());
+            victim->tasks.pop_front();
+        }
+        victim->size.store(victim->tasks.size(), memory_order_relaxed);
+        pthread_mutex_unlock(&victim->mutex);
+        if (!loot.empty()) {
+            break;
+        }
+    }
+    if (loot.empty()) {
+        return false;
+    }
+
+    task = loot[0];
+    if (loot.size() > 1) {
+        pthread_mutex_lock(&thief->mutex);
+        thief->tasks.insert(thief->tasks.end(), loot.begin() + 1, loot.end());
+        thief->size.store(thief->tasks.size(), memory_order_relaxed);
+        pthread_mutex_unlock(&thief->mutex);
+    }
+    thief->steals.fetch_add(1, memory_order_relaxed);
+    thief->stolen.fetch_add(loot.size(), memory_order_relaxed);
+    return true;
+}
+
+/**
+ * Cherche une tâche : file locale, puis injection, puis vol. L'injection est
+ * consultée en premier de temps en temps pour ne pas être affamée par une
+ * file locale qui se remplit sans cesse. Un thread retiré ne fait que vider
+ * sa file locale.
+ */
+static bool findTask(Worker *worker, ExecutorTask &task) {
+    Executor *executor = worker->executor;
+    if (retired(worker)) {
+        // Thread retiré : ne vide plus que sa propre file
+        return popLocal(worker, task);
+    }
+    if (++worker->tick % INJECTION_CHECK_PERIOD == 0 && executor->injection.tryPop(task)) {
+        return true;
+    }
+    return popLocal(worker, task) || executor->injection.tryPop(task) || steal(worker, task);
+}
+
+/**
+ * Boucle d'un thread de l'exécuteur
+ * @param arg Thread (voir Worker)
+ * @return NULL
+ */
+static void *workerLoop(void *arg) {
+    Worker *worker = (Worker *)arg;
+    Executor *executor = worker->executor;
+    currentWorker = worker;
+    if (executor->onStart) {
+        executor->onStart(worker->index);
+    }
+
+    while (true) {
+        ExecutorTask task;
+        if (!findTask(worker, task)) {
+            // Se déclarer avant le dernier regard : une soumission postérieure
+            // voit le compteur et réveille un thread
+            pthread_mutex_lock(&executor->parkMutex);
+            if (retired(worker) && worker->size.load(memory_order_relaxed) == 0) {
+                // Retiré, file vide : attendre le retour parmi les actifs (ou
+                // l'arrêt, les threads actifs vidant les autres files)
+                while (retired(worker) && !executor->stopping.load(memory_order_acquire)) {
+                    pthread_cond_wait(&executor->retireCond, &executor->parkMutex);
+                }
+                bool stop = executor->stopping.load(memory_order_acquire) && retired(worker);
+                pthread_mutex_unlock(&executor->parkMutex);
+                if (stop) {
+                    break;
+                }
+                continue;
+            }
+            executor->sleeping.fetch_add(1, memory_order_seq_cst);
+            atomic_thread_fence(memory_order_seq_cst);
+            bool found = findTask(worker, task);
+            bool stop = !found && executor->stopping.load(memory_order_acquire);
+            if (!found && !stop) {
+                worker->parks.fetch_add(1, memory_order_relaxed);
+                pthread_cond_wait(&executor->parkCond, &executor->parkMutex);
+            }
+            executor->sleeping.fetch_sub(1, memory_order_relaxed);
+            pthread_mutex_unlock(&executor->parkMutex);
+            if (stop) {
+                break;
+            }
+            if (!found) {
+                continue;
+            }
+        }
+        worker->waitTotalNs.fetch_add(nowNs() - task.submitNs, memory_order_relaxed);
+        worker->started.fetch_add(1, memory_order_relaxed);
+        task.function(task.argument);
+        worker->executed.fetch_add(1, memory_order_relaxed);
+    }
+
+    currentWorker = NULL;
+    return NULL;
+}
+
+/**
+ * Refuse les soumissions externes, réveille les threads et attend qu'ils
+ * aient vidé les files
+ * @param executor Exécuteur
+ * @param started Nombre de threads démarrés
+ */
+static void stopWorkers(Executor *executor, int started) {
+    executor->injection.close();
+    pthread_mutex_lock(&executor->parkMutex);
+    executor->stopping.store(true, memory_order_seq_cst);
+    pthread_cond_broadcast(&executor->parkCond);
+    pthread_cond_broadcast(&executor->retireCond);
+    pthread_mutex_unlock(&executor->parkMutex);
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(executor->workers[i]->thread, NULL);
+    }
+}
+
+/**
+ * Libère l'exécuteur (threads arrêtés)
+ */
+static void freeExecutor(Executor *executor) {
+    for (Worker *worker : executor->workers) {
+        pthread_mutex_destroy(&worker->mutex);
+        delete worker;
+    }
+    pthread_cond_destroy(&executor->parkCond);
+    pthread_cond_destroy(&executor->retireCond);
+    pthread_mutex_destroy(&executor->parkMutex);
+    delete executor;
+}
+
+// ============================================================================
+// FONCTIONS PUBLIQUES
+// ============================================================================
+
+/**
+ * Crée l'exécuteur et démarre ses threads
+ * @param nbThreads Nombre de threads
+ * @param injectionCapacity Tâches externes en attente au maximum
+ * @return Exécuteur créé ou NULL en cas d'erreur
+ */
+Executor *ExecutorCreate(int nbThreads, size_t injectionCapacity) {
+    return ExecutorCreateEx(nbThreads, injectionCapacity, NULL);
+}
+
+/**
+ * Crée l'exécuteur et démarre ses threads, qui appellent onStart en premier
+ * @param nbThreads Nombre de threads
+ * @param injectionCapacity Tâches externes en attente au maximum
+ * @param onStart Fonction appelée au démarrage de chaque thread (ou NULL)
+ * @return Exécuteur créé ou NULL en cas d'erreur
+ */
+Executor *ExecutorCreateEx(int nbThreads, size_t injectionCapacity, ExecutorThreadStart onStart) {
+    if (nbThreads <= 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    Executor *executor = new Executor(injectionCapacity);
+    executor->onStart = onStart;
+    executor->active.store(nbThreads, memory_order_relaxed);
+    pthread_mutex_init(&executor->parkMutex, NULL);
+    pthread_cond_init(&executor->parkCond, NULL);
+    pthread_cond_init(&executor->retireCond, NULL);
+    for (int i = 0; i < nbThreads; i++) {
+        Worker *worker = new Worker();
+        worker->executor = executor;
+        worker->index = i;
+        pthread_mutex_init(&worker->mutex, NULL);
+        worker->seed = i + 1;
+        worker->tick = 0;
+        executor->workers.push_back(worker);
+    }
+
+    // Toutes les files existent avant le premier vol
+    int started = 0;
+    while (started < nbThreads &&
+           pthread_create(&executor->workers[started]->thread, NULL, workerLoop,
+                          executor->workers[started]) == 0) {
+        started++;
+    }
+    if (started < nbThreads) {
+        stopWorkers(executor, started);
+        freeExecutor(executor);
+        return NULL;
+    }
+    return executor;
+}
+
+/**
+ * Exécute les tâches restantes puis arrête les threads, sans libérer
+ * @param executor Exécuteur
+ */
+void ExecutorStop(Executor *executor) {
+    if (!executor || executor->stopped) {
+        return;
+    }
+
+    stopWorkers(executor, executor->workers.size());
+    executor->stopped = true;
+}
+
+/**
+ * Arrête les threads si besoin puis libère l'exécuteur
+ * @param executor Exécuteur
+ */
+void ExecutorDestroy(Executor *executor) {
+    if (!executor) {
+        return;
+    }
+
+    ExecutorStop(executor);
+    freeExecutor(executor);
+}
+
+/**
+ * Soumet une tâche (voir executor.h)
+ * @param executor Exécuteur
+ * @param function Fonction à exécuter
+ * @param argument Argument de la fonction
+ * @return 0 en cas de succès, -1 si l'exécuteur est arrêté
+ */
+int ExecutorSubmit(Executor *executor, ExecutorFunction function, void *argument) {
+    ExecutorTask task = {function, argument, nowNs()};
+    Worker *worker = currentWorker;
+
+    if (worker != NULL && worker->executor == executor) {
+        pushLocal(worker, task);
+    } else {
+        if (!executor->injection.push(task)) {
+            return -1;
+        }
+        executor->injected.fetch_add(1, memory_order_relaxed);
+        recordDepth(executor, executor->injection.sizeApprox());
+    }
+    wakeOne(executor);
+    return 0;
+}
+
+/**
+ * Soumet une tâche sans attendre (voir executor.h)
+ * @param executor Exécuteur
+ * @param function Fonction à exécuter
+ * @param argument Argument de la fonction
+ * @return 0 en cas de succès, -1 si la file est pleine ou l'exécuteur arrêté
+ */
+int ExecutorTrySubmit(Executor *executor, ExecutorFunction function, void *argument) {
+    ExecutorTask task = {function, argument, nowNs()};
+    Worker *worker = currentWorker;
+
+    if (worker != NULL && worker->executor == executor) {
+        pushLocal(worker, task);
+    } else {
+        if (executor->stopping.load(memory_order_acquire) || !executor->injection.tryPush(task)) {
+            return -1;
+        }
+        executor->injected.fetch_add(1, memory_order_relaxed);
+        recordDepth(executor, executor->injection.sizeApprox());
+    }
+    wakeOne(executor);
+    return 0;
+}
+
+/**
+ * Change le nombre de threads actifs (voir executor.h)
+ * @param executor Exécuteur
+ * @param nbActive Threads actifs souhaités
+ * @return Nombre de threads actifs retenu
+ */
+int ExecutorResize(Executor *executor, int nbActive) {
+    int nbThreads = executor->workers.size();
+    if (nbActive < 1) {
+        nbActive = 1;
+    } else if (nbActive > nbThreads) {
+        nbActive = nbThreads;
+    }
+
+    pthread_mutex_lock(&executor->parkMutex);
+    executor->active.store(nbActive, memory_order_seq_cst);
+    // Les threads rappelés quittent la retraite, les threads retirés qui
+    // dormaient sur parkCond rejoignent retireCond
+    pthread_cond_broadcast(&executor->retireCond);
+    pthread_cond_broadcast(&executor->parkCond);
+    pthread_mutex_unlock(&executor->parkMutex);
+    return nbActive;
+}
+
+/**
+ * Copie les métriques courantes de l'exécuteur
+ * @param executor Exécuteur
+ * @param stats Métriques à remplir
+ */
+void ExecutorGetStats(Executor *executor, ExecutorStats *stats) {
+    stats->threads = executor->workers.size();
+    stats->active = executor->active.load(memory_order_relaxed);
+    stats->sleeping = executor->sleeping.load(memory_order_relaxed);
+    stats->injected = executor->injected.load(memory_order_relaxed);
+    stats->spawned = 0;
+    stats->executed = 0;
+    stats->steals = 0;
+    stats->stolen = 0;
+    stats->parks = 0;
+    stats->started = 0;
+    stats->waitTotalUs = 0;
+    stats->queued = executor->injection.sizeApprox();
+    stats->maxQueued = executor->maxQueued.load(memory_order_relaxed);
+    for (Worker *worker : executor->workers) {
+        stats->queued += worker->size.load(memory_order_relaxed);
+        stats->spawned += worker->spawned.load(memory_order_relaxed);
+        stats->executed += worker->executed.load(memory_order_relaxed);
+        stats->steals += worker->steals.load(memory_order_relaxed);
+        stats->stolen += worker->stolen.load(memory_order_relaxed);
+        stats->parks += worker->parks.load(memory_order_relaxed);
+        stats->started += worker->started.load(memory_order_relaxed);
+        stats->waitTotalUs += worker->waitTotalNs.load(memory_order_relaxed) / 1000;
+    }
+}
+
+/**
+ * Affiche les métriques de l'exécuteur sur une ligne
+ * @param executor Exécuteur
+ * @param name Nom affiché
+ */
+void ExecutorReport(Executor *executor, const char *name) {
+    ExecutorStats stats;
+    ExecutorGetStats(executor, &stats);
+    printf("Exécuteur %s: %d/%d threads actifs (%d endormis), file %zu (max %zu), "
+           "%llu tâches exécutées (%llu injectées, %llu locales, attente moy %lld µs), "
+           "%llu vols (%llu tâches), %llu mises en sommeil\n",
+           name, stats.active, stats.threads, stats.sleeping, stats.queued, stats.maxQueued,
+           stats.executed, stats.injected, stats.spawned,
+           stats.started ? stats.waitTotalUs / (long long)stats.started : 0LL,
+           stats.steals, stats.stolen, stats.parks);
+}
@@ -0,0 +1,141 @@
+/**
+ * Exécuteur de tâches à vol de travail
+ *
+ * Chaque thread possède sa propre file de tâches : une tâche soumise par un
+ * thread de l'exécuteur va dans sa file, une tâche soumise de l'extérieur
+ * (réacteur, boucle io_uring, accepteur) dans la file d'injection commune.
+ * Un thread sans travail vole la moitié des tâches d'un autre thread, de
+ * sorte qu'une rafale produite par un seul thread se répartit sur tous.
+ * Les tâches d'une même file sont exécutées dans leur ordre de soumission.
+ * Le nombre de threads actifs peut varier en cours de route (ExecutorResize)
+ * entre 1 et le nombre de threads créés.
+ */
+
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <stddef.h>
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Fonction exécutée par une tâche
+ * @param argument Argument fourni à ExecutorSubmit
+ */
+typedef void (*ExecutorFunction)(void *argument);
+
+/**
+ * Fonction appelée par chaque thread de l'exécuteur à son démarrage
+ * @param index Rang du thread (0 à nbThreads - 1)
+ */
+typedef void (*ExecutorThreadStart)(int index);
+
+/**
+ * Métriques de l'exécuteur
+ */
+typedef struct {
+    int threads;                    // Threads de l'exécuteur
+    int active;                     // Threads actifs (les autres sont retirés)
+    int sleeping;                   // Threads endormis faute de travail
+    unsigned long long injected;    // Tâches soumises de l'extérieur
+    unsigned long long spawned;     // Tâches soumises par un thread de l'exécuteur
+    unsigned long long executed;    // Tâches exécutées
+    unsigned long long steals;      // Vols réussis
+    unsigned long long stolen;      // Tâches obtenues par vol
+    unsigned long long parks;       // Mises en sommeil
+    unsigned long long started;     // Tâches commencées
+    long long waitTotalUs;          // Attente cumulée en file des tâches commencées (µs)
+    size_t queued;                  // Tâches en attente (toutes files confondues)
+    size_t maxQueued;               // Plus longue file observée lors d'une soumission
+} ExecutorStats;
+
+/**
+ * Exécuteur (structure opaque, thread-safe)
+ */
+typedef struct Executor Executor;
+
+// ============================================================================
+// FONCTIONS
+// ============================================================================
+
+/**
+ * Crée l'exécuteur et démarre ses threads
+ * @param nbThreads Nombre de threads
+ * @param injectionCapacity Tâches externes en attente au maximum (les
+ *                          soumissions externes attendent au-delà)
+ * @return Exécuteur créé ou NULL en cas d'erreur
+ */
+Executor *ExecutorCreate(int nbThreads, size_t injectionCapacity);
+
+/**
+ * Crée l'exécuteur en exécutant une fonction au démarrage de chaque thread
+ * (placement sur un processeur par exemple)
+ * @param nbThreads Nombre de threads
+ * @param injectionCapacity Tâches externes en attente au maximum
+ * @param onStart Fonction appelée par chaque thread avant sa première tâche
+ *                (NULL = aucune)
+ * @return Exécuteur créé ou NULL en cas d'erreur
+ */
+Executor *ExecutorCreateEx(int nbThreads, size_t injectionCapacity, ExecutorThreadStart onStart);
+
+/**
+ * Arrête l'exécuteur sans le libérer : les tâches en attente sont exécutées,
+ * puis les threads se terminent. Les soumissions externes sont refusées dès
+ * l'appel (utile quand d'autres exécuteurs lui soumettent encore des tâches).
+ * @param executor Exécuteur
+ */
+void ExecutorStop(Executor *executor);
+
+/**
+ * Arrête l'exécuteur (s'il ne l'est pas déjà) puis le libère
+ * @param executor Exécuteur
+ */
+void ExecutorDestroy(Executor *executor);
+
+/**
+ * Soumet une tâche (dans la file du thread appelant s'il appartient à
+ * l'exécuteur, dans la file d'injection sinon)
+ * @param executor Exécuteur
+ * @param function Fonction à exécuter
+ * @param argument Argument de la fonction
+ * @return 0 en cas de succès, -1 si l'exécuteur est arrêté
+ */
+int ExecutorSubmit(Executor *executor, ExecutorFunction function, void *argument);
+
+/**
+ * Soumet une tâche sans jamais attendre (file d'injection pleine = échec)
+ * @param executor Exécuteur
+ * @param function Fonction à exécuter
+ * @param argument Argument de la fonction
+ * @return 0 en cas de succès, -1 si la file est pleine ou l'exécuteur arrêté
+ */
+int ExecutorTrySubmit(Executor *executor, ExecutorFunction function, void *argument);
+
+/**
+ * Change le nombre de threads actifs. Un thread retiré termine sa tâche en
+ * cours et sa file locale avant de s'arrêter de prendre du travail ; il
+ * reprend dès qu'il redevient actif (les threads ne sont jamais détruits
+ * avant ExecutorDestroy).
+ * @param executor Exécuteur
+ * @param nbActive Threads actifs souhaités (ramené entre 1 et nbThreads)
+ * @return Nombre de threads actifs retenu
+ */
+int ExecutorResize(Executor *executor, int nbActive);
+
+/**
+ * Copie les métriques courantes de l'exécuteur
+ * @param executor Exécuteur
+ * @param stats Métriques à remplir
+ */
+void ExecutorGetStats(Executor *executor, ExecutorStats *stats);
+
+/**
+ * Affiche les métriques de l'exécuteur sur une ligne
+ * @param executor Exécuteur
+ * @param name Nom affiché (rôle de l'exécuteur)
+ */
+void ExecutorReport(Executor *executor, const char *name);
+
+#endif // EXECUTOR_H
@@ -0,0 +1,290 @@
+/**
+ * Implémentation de l'annuaire des patients
+ *
+ * Deux tables (par identifiant, par nom et prénom) protégées par un verrou
+ * lecteurs/rédacteur : les vérifications, bien plus nombreuses que les
+ * créations, se font en parallèle. Le filtre de Bloom est un tableau de mots
+ * atomiques consulté avant le verrou : un identifiant absent du filtre part
+ * vers la base sans prendre le verrou. Il est dimensionné au chargement pour
+ * le double des patients lus, et sa proportion de faux positifs augmente
+ * au-delà (les réponses restent exactes, la recherche dans la table tranche).
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "patientdir.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+const size_t BLOOM_BITS_PER_PATIENT = 10;      // Environ 1 % de faux positifs
+const int BLOOM_HASHES = 7;                    // Bits par identifiant
+const size_t MIN_CAPACITY = 4096;              // Patients prévus au minimum
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Nom et prénom d'un patient
+ */
+struct PatientEntry {
+    string lastName;
+    string firstName;
+};
+
+struct PatientDirectory {
+    pthread_rwlock_t lock;          // Protège byId et byName
+    unordered_map<int, PatientEntry> byId;
+    unordered_map<string, vector<int>> byName; // Clé : nom, '\0', prénom
+    vector<atomic<uint64_t>> bloom; // Filtre de Bloom des identifiants (lu sans verrou)
+    size_t bloomMask;               // Nombre de bits - 1 (puissance de 2)
+
+    atomic<unsigned long long> lookups{0};
+    atomic<unsigned long long> known{0};
+    atomic<unsigned long long> unknown{0};
+    atomic<unsigned long long> unsure{0};
+    atomic<unsigned long long> bloomMisses{0};
+
+    explicit PatientDirectory(size_t words) : bloom(words) {}
+};
+
+// ============================================================================
+// FONCTIONS INTERNES
+// ============================================================================
+
+/**
+ * Mélange un identifiant (splitmix64) : les identifiants consécutifs donnent
+ * des positions indépendantes dans le filtre
+ */
+static uint64_t mixId(int id) {
+    uint64_t x = (uint64_t)(uint32_t)id + 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * Position du i-ème bit d'un identifiant (double hachage)
+ */
+static size_t bloomBit(const PatientDirectory *directory, uint64_t hash, int i) {
+    uint64_t step = (hash >> 32) | 1;
+    return (size_t)(hash + i * step) & directory->bloomMask;
+}
+
+static void bloomAdd(PatientDirectory *directory, int id) {
+    uint64_t hash = mixId(id);
+    for (int i = 0; i < BLOOM_HASHES; i++) {
+        size_t bit = bloomBit(directory, hash, i);
+        directory->bloom[bit / 64].fetch_or(1ULL << (bit % 64), memory_order_relaxed);
+    }
+}
+
+static bool bloomMayContain(const PatientDirectory *directory, int id) {
+    uint64_t hash = mixId(id);
+    for (int i = 0; i < BLOOM_HASHES; i++) {
+        size_t bit = bloomBit(directory, hash, i);
+        if (!(directory->bloom[bit / 64].load(memory_order_relaxed) & (1ULL << (bit % 64)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static string nameKey(const string &lastName, const string &firstName) {
+    string key;
+    key.reserve(lastName.length() + 1 + firstName.length());
+    key += lastName;
+    key += '\0';
+    key += firstName;
+    return key;
+}
+
+/**
+ * Crée un annuaire vide
+ * @param capacity Patients prévus (dimension du filtre de Bloom)
+ */
+static PatientDirectory *createDirectory(size_t capacity) {
+    size_t bits = 64;
+    while (bits < capacity * BLOOM_BITS_PER_PATIENT) {
+        bits *= 2;
+    }
+    PatientDirectory *directory = new PatientDirectory(bits / 64);
+    directory->bloomMask = bits - 1;
+    directory->byId.reserve(capacity);
+    pthread_rwlock_init(&directory->lock, NULL);
+    return directory;
+}
+
+// ============================================================================
+// FONCTIONS PUBLIQUES
+// ============================================================================
+
+/**
+ * Crée l'annuaire et y charge tous les patients de la base
+ * @param pool Pool MySQL
+ * @param dal Requêtes préparées
+ * @return Annuaire chargé ou NULL en cas d'erreur
+ */
+PatientDirectory *PatientDirectoryLoad(DbPool *pool, Dal *dal) {
+    MYSQL *connection = DbPoolAcquire(pool);
+    if (!connection) {
+        printf("ERREUR: Aucune connexion à la base de données pour charger les patients\n");
+        return NULL;
+    }
+    DalRows *rows = DalSelect(dal, connection, DAL_PATIENTS, NULL);
+    DbPoolRelease(pool, connection);
+    if (!rows) {
+        printf("ERREUR: Échec de la lecture des patients\n");
+        return NULL;
+    }
+
+    int count = DalRowsCount(rows);
+    size_t capacity = 2 * (size_t)count;
+    PatientDirectory *directory = createDirectory(capacity > MIN_CAPACITY ? capacity : MIN_CAPACITY);
+    for (int row = 0; row < count; row++) {
+        const char *id = DalRowsField(rows, row, 0, NULL);
+        const char *lastName = DalRowsField(rows, row, 1, NULL);
+        const char *firstName = DalRowsField(rows, row, 2, NULL);
+        if (id && lastName && firstName) {
+            PatientDirectoryAdd(directory, atoi(id), lastName, firstName);
+        }
+    }
+    DalRowsFree(rows);
+    return directory;
+}
+
+/**
+ * Libère l'annuaire
+ * @param directory Annuaire (NULL accepté)
+ */
+void PatientDirectoryDestroy(PatientDirectory *directory) {
+    if (!directory) {
+        return;
+    }
+    pthread_rwlock_destroy(&directory->lock);
+    delete directory;
+}
+
+/**
+ * Ajoute un patient (sans effet si l'identifiant est déjà connu : l'annuaire
+ * garde les noms lus dans la base)
+ * @param directory Annuaire
+ * @param id Identifiant du patient
+ * @param lastName Nom
+ * @param firstName Prénom
+ */
+void PatientDirectoryAdd(PatientDirectory *directory, int id, const string &lastName,
+                         const string &firstName) {
+    if (id <= 0) {
+        return;
+    }
+
+    pthread_rwlock_wrlock(&directory->lock);
+    if (directory->byId.emplace(id, PatientEntry{lastName, firstName}).second) {
+        directory->byName[nameKey(lastName, firstName)].push_back(id);
+        bloomAdd(directory, id);
+    }
+    pthread_rwlock_unlock(&directory->lock);
+}
+
+/**
+ * Vérifie un patient
+ * @param directory Annuaire
+ * @param id Identifiant annoncé
+ * @param lastName Nom annoncé
+ * @param firstName Prénom annoncé
+ * @return PATIENT_KNOWN, PATIENT_UNKNOWN ou PATIENT_UNSURE
+ */
+PatientLookup PatientDirectoryVerify(PatientDirectory *directory, int id, const string &lastName,
+                                     const string &firstName) {
+    directory->lookups.fetch_add(1, memory_order_relaxed);
+    if (id <= 0) {
+        // AUTO_INCREMENT commence à 1
+        directory->unknown.fetch_add(1, memory_order_relaxed);
+        return PATIENT_UNKNOWN;
+    }
+    if (!bloomMayContain(directory, id)) {
+        // Absent de l'annuaire, mais peut-être créé par un autre programme
+        directory->bloomMisses.fetch_add(1, memory_order_relaxed);
+        directory->unsure.fetch_add(1, memory_order_relaxed);
+        return PATIENT_UNSURE;
+    }
+
+    PatientLookup result;
+    pthread_rwlock_rdlock(&directory->lock);
+    auto found = directory->byId.find(id);
+    if (found == directory->byId.end()) {
+        // Faux positif du filtre : absent, à vérifier comme ci-dessus
+        result = PATIENT_UNSURE;
+    } else if (found->second.lastName == lastName && found->second.firstName == firstName) {
+        result = PATIENT_KNOWN;
+    } else {
+        // La collation de MySQL peut ignorer la casse ou les accents
+        result = PATIENT_UNSURE;
+    }
+    pthread_rwlock_unlock(&directory->lock);
+
+    if (result == PATIENT_KNOWN) {
+        directory->known.fetch_add(1, memory_order_relaxed);
+    } else {
+        directory->unsure.fetch_add(1, memory_order_relaxed);
+    }
+    return result;
+}
+
+/**
+ * Compte les patients d'un nom et prénom donnés
+ * @param directory Annuaire
+ * @param lastName Nom
+ * @param firstName Prénom
+ * @return Nombre de patients connus sous ce nom
+ */
+int PatientDirectoryCountByName(PatientDirectory *directory, const string &lastName,
+                                const string &firstName) {
+    pthread_rwlock_rdlock(&directory->lock);
+    auto found = directory->byName.find(nameKey(lastName, firstName));
+    int count = found == directory->byName.end() ? 0 : (int)found->second.size();
+    pthread_rwlock_unlock(&directory->lock);
+    return count;
+}
+
+/**
+ * Copie les métriques courantes de l'annuaire
+ * @param directory Annuaire
+ * @param stats Métriques à remplir
+ */
+void PatientDirectoryGetStats(PatientDirectory *directory, PatientDirectoryStats *stats) {
+    pthread_rwlock_rdlock(&directory->lock);
+    stats->patients = directory->byId.size();
+    pthread_rwlock_unlock(&directory->lock);
+    stats->bloomBits = directory->bloomMask + 1;
+    stats->lookups = directory->lookups.load(memory_order_relaxed);
+    stats->known = directory->known.load(memory_order_relaxed);
+    stats->unknown = directory->unknown.load(memory_order_relaxed);
+    stats->unsure = directory->unsure.load(memory_order_relaxed);
+    stats->bloomMisses = directory->bloomMisses.load(memory_order_relaxed);
+}
+
+/**
+ * Affiche les métriques de l'annuaire sur une ligne
+ * @param directory Annuaire
+ */
+void PatientDirectoryReport(PatientDirectory *directory) {
+    PatientDirectoryStats stats;
+    PatientDirectoryGetStats(directory, &stats);
+    printf("Annuaire: %zu patients (Bloom %zu bits), %llu vérifications, %llu confirmées, "
+           "%llu renvoyées à la base (dont %llu absentes du filtre), %llu impossibles\n",
+           stats.patients, stats.bloomBits, stats.lookups, stats.known,
+           stats.unsure, stats.bloomMisses, stats.unknown);
+}
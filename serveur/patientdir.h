@@ -0,0 +1,121 @@
+/**
+ * Annuaire des patients en mémoire
+ *
+ * Copie des patients de la base (identifiant, nom, prénom), chargée au
+ * démarrage puis complétée à chaque création : LOGIN_EXIST est vérifié sans
+ * requête MySQL. Un filtre de Bloom sur les identifiants, lu sans verrou,
+ * renvoie les identifiants absents à la base sans recherche dans les tables.
+ *
+ * MySQL reste la référence : d'autres programmes (le serveur C de server/,
+ * un administrateur) créent aussi des patients, à n'importe quel moment et
+ * donc sous des identifiants que l'annuaire ne connaît pas encore. Un
+ * identifiant absent de l'annuaire n'est donc jamais déclaré inexistant :
+ * l'annuaire répond PATIENT_UNSURE quand il ne peut pas conclure seul
+ * (identifiant absent, nom ou prénom écrit autrement, que la collation de
+ * MySQL peut accepter). L'appelant interroge alors la base, puis ajoute le
+ * patient confirmé avec PatientDirectoryAdd. Seul un identifiant nul ou
+ * négatif, qu'AUTO_INCREMENT n'attribue jamais, est déclaré inexistant.
+ */
+
+#ifndef PATIENTDIR_H
+#define PATIENTDIR_H
+
+#include <stddef.h>
+#include <string>
+#include "dal.h"
+#include "dbpool.h"
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Réponse de l'annuaire pour un patient
+ */
+typedef enum {
+    PATIENT_KNOWN,                  // Identifiant, nom et prénom connus
+    PATIENT_UNKNOWN,                // Identifiant impossible (nul ou négatif)
+    PATIENT_UNSURE                  // À vérifier dans la base
+} PatientLookup;
+
+/**
+ * Métriques de l'annuaire
+ */
+typedef struct {
+    size_t patients;                // Patients connus
+    size_t bloomBits;               // Taille du filtre de Bloom (bits)
+    unsigned long long lookups;     // Vérifications
+    unsigned long long known;       // ... confirmées sans la base
+    unsigned long long unknown;     // ... écartées (identifiant impossible)
+    unsigned long long unsure;      // ... renvoyées à la base
+    unsigned long long bloomMisses; // ... dont absentes du filtre de Bloom
+} PatientDirectoryStats;
+
+/**
+ * Annuaire (structure opaque, thread-safe)
+ */
+typedef struct PatientDirectory PatientDirectory;
+
+// ============================================================================
+// FONCTIONS
+// ============================================================================
+
+/**
+ * Crée l'annuaire et y charge tous les patients de la base
+ * @param pool Pool MySQL (une connexion empruntée le temps du chargement)
+ * @param dal Requêtes préparées des connexions du pool
+ * @return Annuaire chargé ou NULL en cas d'erreur
+ */
+PatientDirectory *PatientDirectoryLoad(DbPool *pool, Dal *dal);
+
+/**
+ * Libère l'annuaire
+ * @param directory Annuaire (NULL accepté)
+ */
+void PatientDirectoryDestroy(PatientDirectory *directory);
+
+/**
+ * Ajoute un patient créé ou confirmé par la base
+ * @param directory Annuaire
+ * @param id Identifiant du patient
+ * @param lastName Nom
+ * @param firstName Prénom
+ */
+void PatientDirectoryAdd(PatientDirectory *directory, int id, const std::string &lastName,
+                         const std::string &firstName);
+
+/**
+ * Vérifie un patient (LOGIN_EXIST)
+ * @param directory Annuaire
+ * @param id Identifiant annoncé
+ * @param lastName Nom annoncé
+ * @param firstName Prénom annoncé
+ * @return PATIENT_KNOWN, PATIENT_UNKNOWN ou PATIENT_UNSURE (voir la base)
+ */
+PatientLookup PatientDirectoryVerify(PatientDirectory *directory, int id, const std::string &lastName,
+                                     const std::string &firstName);
+
+/**
+ * Compte les patients d'un nom et prénom donnés
+ * @param directory Annuaire
+ * @param lastName Nom
+ * @param firstName Prénom
+ * @return Nombre de patients connus sous ce nom
+ */
+int PatientDirectoryCountByName(PatientDirectory *directory, const std::string &lastName,
+                                const std::string &firstName);
+
+/**
+ * Copie les métriques courantes de l'annuaire
+ * @param directory Annuaire
+ * @param stats Métriques à remplir
+ */
+void PatientDirectoryGetStats(PatientDirectory *directory, PatientDirectoryStats *stats);
+
+/**
+ * Affiche les métriques de l'annuaire sur une ligne
+ * @param directory Annuaire
+ */
+void PatientDirectoryReport(PatientDirectory *directory);
+
+#endif // PATIENTDIR_H
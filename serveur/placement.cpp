@@ -0,0 +1,287 @@
+/**
+ * Implémentation du placement des threads
+ *
+ * La topologie est lue dans /sys/devices/system/node (sans libnuma) :
+ * chaque nœud y publie la liste de ses processeurs. Sans ce répertoire
+ * (noyau sans NUMA), tous les processeurs sont considérés sur le nœud 0.
+ *
+ * La mémoire locale repose sur la politique MPOL_LOCAL : une page est prise
+ * sur le nœud du processeur qui la touche en premier. Elle remplace une
+ * éventuelle politique héritée du processus (numactl --interleave par ex.).
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "placement.h"
+#include <sched.h>
+#include <errno.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+static const char *NODE_DIRECTORY = "/sys/devices/system/node";
+static const char *roleNames[PLACEMENT_NB_ROLES] = {"accepteur", "réacteur", "thread du pool"};
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Ensemble de processeurs d'un rôle
+ */
+struct RolePlacement {
+    vector<int> cpus;               // Processeurs retenus, dans l'ordre de la liste
+    bool wholeSet = false;          // Thread libre sur tout l'ensemble
+    atomic<unsigned int> next{0};   // Prochain processeur attribué (tour de rôle)
+};
+
+static RolePlacement roles[PLACEMENT_NB_ROLES];
+static vector<int> cpuNodes;        // Nœud de chaque processeur (-1 inconnu)
+static int nbNodes = 0;             // Nœuds NUMA en ligne
+
+// ============================================================================
+// FONCTIONS INTERNES
+// ============================================================================
+
+/**
+ * Analyse une liste de processeurs au format du noyau ("0-3,8,10-11")
+ * @param list Liste à analyser
+ * @param cpus Processeurs lus (ajoutés)
+ * @return true si la liste est bien formée
+ */
+static bool parseCpuList(const string &list, vector<int> &cpus) {
+    size_t position = 0;
+    while (position < list.size()) {
+        size_t end = list.find(',', position);
+        if (end == string::npos) {
+            end = list.size();
+        }
+        string item = list.substr(position, end - position);
+        position = end + 1;
+
+        int first, last;
+        char extra;
+        if (item.find_first_not_of(" \t\n") == string::npos) {
+            continue;
+        }
+        if (sscanf(item.c_str(), " %d - %d %c", &first, &last, &extra) == 2) {
+            // Intervalle
+        } else if (sscanf(item.c_str(), " %d %c", &first, &extra) == 1) {
+            last = first;
+        } else {
+            return false;
+        }
+        if (first < 0 || last < first || last >= CPU_SETSIZE) {
+            return false;
+        }
+        for (int cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+    return true;
+}
+
+/**
+ * Lit la topologie NUMA (une seule fois, au premier appel)
+ */
+static void loadTopology() {
+    if (!cpuNodes.empty()) {
+        return;
+    }
+    cpuNodes.assign(CPU_SETSIZE, -1);
+
+    vector<int> nodes;
+    ifstream online(string(NODE_DIRECTORY) + "/online");
+    string line;
+    if (online && getline(online, line)) {
+        parseCpuList(line, nodes);
+    }
+    for (int node : nodes) {
+        ifstream cpulist(string(NODE_DIRECTORY) + "/node" + to_string(node) + "/cpulist");
+        vector<int> cpus;
+        if (cpulist && getline(cpulist, line) && parseCpuList(line, cpus)) {
+            for (int cpu : cpus) {
+                cpuNodes[cpu] = node;
+            }
+        }
+    }
+    nbNodes = nodes.size();
+
+    // Noyau sans NUMA : un seul nœud
+    if (nbNodes == 0) {
+        nbNodes = 1;
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            cpuNodes[cpu] = 0;
+        }
+    }
+}
+
+/**
+ * Formate une liste de processeurs en intervalles ("0-3,8")
+ */
+static string formatCpus(const vector<int> &cpus) {
+    string text;
+    for (size_t i = 0; i < cpus.size(); i++) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+            j++;
+        }
+        if (!text.empty()) {
+            text += ",";
+        }
+        text += to_string(cpus[i]);
+        if (j > i) {
+            text += "-" + to_string(cpus[j]);
+        }
+        i = j;
+    }
+    return text;
+}
+
+// ============================================================================
+// FONCTIONS PUBLIQUES
+// ============================================================================
+
+/**
+ * Restreint un rôle à un ensemble de processeurs (voir placement.h)
+ * @param role Rôle concerné
+ * @param cpuList Liste de processeurs et de nœuds
+ * @param wholeSet true pour laisser chaque thread sur tout l'ensemble
+ * @return Nombre de processeurs retenus, -1 si la liste est invalide ou vide
+ */
+int PlacementConfigure(PlacementRole role, const char *cpuList, bool wholeSet) {
+    loadTopology();
+
+    // Remplacer chaque "nodeN" par les processeurs du nœud
+    vector<int> requested;
+    string list = cpuList;
+    string cpuItems;
+    size_t position = 0;
+    while (position < list.size()) {
+        size_t end = list.find(',', position);
+        if (end == string::npos) {
+            end = list.size();
+        }
+        string item = list.substr(position, end - position);
+        position = end + 1;
+
+        int node;
+        char extra;
+        if (sscanf(item.c_str(), " node%d %c", &node, &extra) == 1) {
+            size_t before = requested.size();
+            for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                if (cpuNodes[cpu] == node) {
+                    requested.push_back(cpu);
+                }
+            }
+            if (requested.size() == before) {
+                return -1;
+            }
+        } else {
+            cpuItems += item + ",";
+        }
+    }
+    if (!parseCpuList(cpuItems, requested)) {
+        return -1;
+    }
+
+    // Ne garder que les processeurs autorisés au processus, sans doublon
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return -1;
+    }
+    RolePlacement &placement = roles[role];
+    placement.cpus.clear();
+    cpu_set_t seen;
+    CPU_ZERO(&seen);
+    for (int cpu : requested) {
+        if (CPU_ISSET(cpu, &allowed) && !CPU_ISSET(cpu, &seen)) {
+            CPU_SET(cpu, &seen);
+            placement.cpus.push_back(cpu);
+        }
+    }
+    placement.wholeSet = wholeSet;
+    placement.next.store(0, memory_order_relaxed);
+    return placement.cpus.empty() ? -1 : (int)placement.cpus.size();
+}
+
+/**
+ * Place le thread appelant selon son rôle (voir placement.h)
+ * @param role Rôle du thread appelant
+ * @return 0 en cas de succès (ou sans ensemble configuré), -1 en cas d'erreur
+ */
+int PlacementBindThread(PlacementRole role) {
+    RolePlacement &placement = roles[role];
+    if (placement.cpus.empty()) {
+        return 0;
+    }
+
+    unsigned int index = placement.next.fetch_add(1, memory_order_relaxed);
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (placement.wholeSet) {
+        for (int cpu : placement.cpus) {
+            CPU_SET(cpu, &set);
+        }
+    } else {
+        CPU_SET(placement.cpus[index % placement.cpus.size()], &set);
+    }
+    int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (error != 0) {
+        errno = error;
+        return -1;
+    }
+
+    // Les prochaines allocations du thread se font sur son nœud
+    bool localMemory = syscall(SYS_set_mempolicy, MPOL_LOCAL, NULL, 0) == 0;
+
+    unsigned int cpu = 0, node = 0;
+    syscall(SYS_getcpu, &cpu, &node, NULL);
+    if (placement.wholeSet) {
+        printf("Placement: %s %u sur les processeurs %s (actuellement %u, nœud %u)%s\n",
+               roleNames[role], index, formatCpus(placement.cpus).c_str(), cpu, node,
+               localMemory ? "" : ", mémoire non locale");
+    } else {
+        printf("Placement: %s %u sur le processeur %u (nœud %u)%s\n",
+               roleNames[role], index, cpu, node,
+               localMemory ? "" : ", mémoire non locale");
+    }
+    return 0;
+}
+
+/**
+ * Affiche la topologie et les ensembles configurés
+ */
+void PlacementReport(void) {
+    loadTopology();
+    cpu_set_t allowed;
+    vector<int> cpus;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &allowed)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    printf("Topologie: %d nœud(s) NUMA, processeurs autorisés %s\n",
+           nbNodes, formatCpus(cpus).c_str());
+    for (int role = 0; role < PLACEMENT_NB_ROLES; role++) {
+        if (!roles[role].cpus.empty()) {
+            printf("Placement %s: processeurs %s (%s)\n", roleNames[role],
+                   formatCpus(roles[role].cpus).c_str(),
+                   roles[role].wholeSet ? "ensemble" : "un processeur par thread");
+        }
+    }
+}
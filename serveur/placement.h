@@ -0,0 +1,56 @@
+/**
+ * Placement des threads sur les processeurs
+ *
+ * Chaque rôle (accepteurs, réacteurs, threads du pool) peut être restreint à
+ * un ensemble de processeurs, donné par une liste ("0-3,8") et/ou par des
+ * nœuds NUMA ("node1"). Un thread placé alloue ensuite sa mémoire sur son
+ * nœud local : les tampons qu'il crée restent près du processeur qui s'en sert.
+ */
+
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Rôles des threads du serveur
+ */
+typedef enum {
+    PLACEMENT_ACCEPTOR,             // Threads accepteurs (et thread principal)
+    PLACEMENT_REACTOR,              // Réacteurs epoll et boucle io_uring
+    PLACEMENT_WORKER,               // Threads du pool (exécuteur)
+    PLACEMENT_NB_ROLES
+} PlacementRole;
+
+// ============================================================================
+// FONCTIONS
+// ============================================================================
+
+/**
+ * Restreint un rôle à un ensemble de processeurs (à appeler avant la création
+ * des threads). Les processeurs hors de l'affinité du processus sont ignorés.
+ * @param role Rôle concerné
+ * @param cpuList Liste de processeurs et de nœuds, ex. "0-3,8" ou "node1"
+ * @param wholeSet true : chaque thread peut tourner sur tout l'ensemble ;
+ *                 false : chaque thread est fixé sur un processeur de
+ *                 l'ensemble, à tour de rôle
+ * @return Nombre de processeurs retenus, -1 si la liste est invalide ou vide
+ */
+int PlacementConfigure(PlacementRole role, const char *cpuList, bool wholeSet);
+
+/**
+ * Place le thread appelant selon son rôle et lui fait allouer sa mémoire sur
+ * son nœud NUMA local. Sans ensemble configuré pour le rôle, ne fait rien.
+ * @param role Rôle du thread appelant
+ * @return 0 en cas de succès (ou sans ensemble configuré), -1 en cas d'erreur
+ */
+int PlacementBindThread(PlacementRole role);
+
+/**
+ * Affiche la topologie (processeurs, nœuds) et les ensembles configurés
+ */
+void PlacementReport(void);
+
+#endif // PLACEMENT_H
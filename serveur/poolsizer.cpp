@@ -0,0 +1,302 @@
+/**
+ * Implémentation du dimensionnement adaptatif
+ *
+ * À chaque période, le contrôleur compare les compteurs cumulés de
+ * l'exécuteur et du pool MySQL à ceux de la période précédente :
+ * - attente en file = attente des tâches commencées / tâches commencées
+ *   (une file non vide sans aucune tâche commencée compte comme une période
+ *   entière d'attente) ;
+ * - latence MySQL = durée des emprunts terminés / emprunts terminés.
+ *
+ * Une base lente ne se soigne pas avec plus de threads : au-delà de
+ * maxDbLatencyMs, le pool rétrécit pour moins la charger, et il ne grandit
+ * pas tant que des threads attendent une connexion du pool MySQL.
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "poolsizer.h"
+#include <pthread.h>
+#include <errno.h>
+#include <stdio.h>
+#include <time.h>
+#include <string>
+
+using namespace std;
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+const int GROW_DIVISOR = 4;             // Agrandissement : un quart des threads actifs (au moins 1)
+const int LOW_WAIT_DIVISOR = 4;         // Seuil bas : un quart de l'attente visée
+const int SEVERE_WAIT_FACTOR = 4;       // Attente au-delà de 4 fois la visée : doublement
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+struct PoolSizer {
+    PoolSizerConfig config;
+    string name;
+    Executor *executor;
+    DbPool *pool;
+    pthread_t thread;               // Thread de contrôle
+    pthread_mutex_t mutex;          // Protège stats et stopping
+    pthread_cond_t stopCond;        // Réveil du thread de contrôle à l'arrêt
+    bool stopping;
+    PoolSizerStats stats;
+    int highPeriods;                // Périodes consécutives au-dessus de l'attente visée
+    int lowPeriods;                 // Périodes consécutives sous le seuil bas
+    int overloadPeriods;            // Périodes consécutives de base surchargée
+};
+
+// ============================================================================
+// FONCTIONS INTERNES
+// ============================================================================
+
+/**
+ * Échéance absolue sur l'horloge monotone, dans delayMs millisecondes
+ */
+static struct timespec deadlineIn(int delayMs) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_sec += delayMs / 1000;
+    ts.tv_nsec += (long)(delayMs % 1000) * 1000000;
+    if (ts.tv_nsec >= 1000000000) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+    }
+    return ts;
+}
+
+/**
+ * Applique un nouveau nombre de threads actifs et affiche la décision
+ * @param sizer Contrôleur
+ * @param threads Threads actifs souhaités (déjà borné)
+ * @param reason Motif affiché
+ */
+static void resize(PoolSizer *sizer, int threads, const char *reason) {
+    int previous = sizer->stats.threads;
+    threads = ExecutorResize(sizer->executor, threads);
+    if (threads == previous) {
+        return;
+    }
+
+    pthread_mutex_lock(&sizer->mutex);
+    sizer->stats.threads = threads;
+    if (threads > previous) {
+        sizer->stats.grows++;
+    } else {
+        sizer->stats.shrinks++;
+    }
+    pthread_mutex_unlock(&sizer->mutex);
+    printf("Pool adaptatif %s: %d -> %d threads (attente file %.1f ms, MySQL %.1f ms, %s)\n",
+           sizer->name.c_str(), previous, threads, sizer->stats.queueWaitMs,
+           sizer->stats.dbLatencyMs, reason);
+}
+
+/**
+ * Prend une décision à partir des mesures d'une période
+ * @param sizer Contrôleur
+ * @param poolWaiting Threads en attente d'une connexion MySQL
+ */
+static void decide(PoolSizer *sizer, int poolWaiting) {
+    const PoolSizerConfig &config = sizer->config;
+    int threads = sizer->stats.threads;
+    double lowWaitMs = (double)config.targetWaitMs / LOW_WAIT_DIVISOR;
+    bool overloaded = config.maxDbLatencyMs > 0 && sizer->stats.dbLatencyMs > config.maxDbLatencyMs;
+    bool high = sizer->stats.queueWaitMs > config.targetWaitMs;
+    bool low = sizer->stats.queueWaitMs < lowWaitMs;
+
+    sizer->overloadPeriods = overloaded ? sizer->overloadPeriods + 1 : 0;
+    sizer->highPeriods = high && !overloaded ? sizer->highPeriods + 1 : 0;
+    sizer->lowPeriods = low && !overloaded ? sizer->lowPeriods + 1 : 0;
+
+    if (sizer->overloadPeriods >= config.growPeriods) {
+        // Base surchargée : moins de requêtes simultanées
+        sizer->overloadPeriods = 0;
+        if (threads > config.minThreads) {
+            resize(sizer, threads - 1, "base surchargée");
+        }
+    } else if (sizer->highPeriods >= config.growPeriods) {
+        sizer->highPeriods = 0;
+        if (threads >= config.maxThreads) {
+            return;
+        }
+        if (poolWaiting > 0) {
+            // Des threads attendent déjà une connexion : en ajouter ne ferait
+            // qu'allonger la file du pool MySQL
+            pthread_mutex_lock(&sizer->mutex);
+            sizer->stats.blocked++;
+            pthread_mutex_unlock(&sizer->mutex);
+            printf("Pool adaptatif %s: %d threads maintenus (attente file %.1f ms, "
+                   "%d en attente du pool MySQL)\n", sizer->name.c_str(), threads,
+                   sizer->stats.queueWaitMs, poolWaiting);
+            return;
+        }
+        int step = threads / GROW_DIVISOR > 1 ? threads / GROW_DIVISOR : 1;
+        if (sizer->stats.queueWaitMs > (double)config.targetWaitMs * SEVERE_WAIT_FACTOR) {
+            step = threads;
+        }
+        resize(sizer, threads + step < config.maxThreads ? threads + step : config.maxThreads,
+               "file en attente");
+    } else if (sizer->lowPeriods >= config.shrinkPeriods) {
+        sizer->lowPeriods = 0;
+        if (threads > config.minThreads) {
+            resize(sizer, threads - 1, "file vide");
+        }
+    }
+}
+
+/**
+ * Thread de contrôle : mesure, décide, puis attend la période suivante
+ * @param arg Contrôleur
+ * @return NULL
+ */
+static void *controlThread(void *arg) {
+    PoolSizer *sizer = (PoolSizer *)arg;
+    ExecutorStats previous, current;
+    DbPoolStats previousDb = {}, currentDb = {};
+    ExecutorGetStats(sizer->executor, &previous);
+    if (sizer->pool) {
+        DbPoolGetStats(sizer->pool, &previousDb);
+    }
+
+    pthread_mutex_lock(&sizer->mutex);
+    while (!sizer->stopping) {
+        struct timespec deadline = deadlineIn(sizer->config.intervalMs);
+        pthread_cond_timedwait(&sizer->stopCond, &sizer->mutex, &deadline);
+        if (sizer->stopping) {
+            break;
+        }
+        pthread_mutex_unlock(&sizer->mutex);
+
+        ExecutorGetStats(sizer->executor, &current);
+        unsigned long long started = current.started - previous.started;
+        double waitMs = started ? (current.waitTotalUs - previous.waitTotalUs) / 1000.0 / started
+                                : 0.0;
+        if (started == 0 && current.queued > 0) {
+            waitMs = sizer->config.intervalMs;
+        }
+        double dbMs = 0.0;
+        if (sizer->pool) {
+            DbPoolGetStats(sizer->pool, &currentDb);
+            unsigned long long released = currentDb.released - previousDb.released;
+            if (released) {
+                dbMs = (currentDb.useTotalUs - previousDb.useTotalUs) / 1000.0 / released;
+            }
+            previousDb = currentDb;
+        }
+        previous = current;
+
+        pthread_mutex_lock(&sizer->mutex);
+        sizer->stats.queueWaitMs = waitMs;
+        sizer->stats.dbLatencyMs = dbMs;
+        pthread_mutex_unlock(&sizer->mutex);
+        decide(sizer, sizer->pool ? currentDb.waiting : 0);
+        pthread_mutex_lock(&sizer->mutex);
+    }
+    pthread_mutex_unlock(&sizer->mutex);
+    return NULL;
+}
+
+// ============================================================================
+// FONCTIONS PUBLIQUES
+// ============================================================================
+
+/**
+ * Démarre le contrôle d'un exécuteur
+ * @param config Paramètres du contrôleur
+ * @param executor Exécuteur contrôlé
+ * @param pool Pool MySQL (ou NULL)
+ * @param name Nom affiché
+ * @return Contrôleur créé ou NULL en cas d'erreur
+ */
+PoolSizer *PoolSizerCreate(const PoolSizerConfig *config, Executor *executor, DbPool *pool,
+                           const char *name) {
+    if (config->minThreads <= 0 || config->maxThreads < config->minThreads ||
+        config->intervalMs <= 0 || config->growPeriods <= 0 || config->shrinkPeriods <= 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    PoolSizer *sizer = new PoolSizer();
+    sizer->config = *config;
+    sizer->name = name ? name : "";
+    sizer->executor = executor;
+    sizer->pool = pool;
+    sizer->stopping = false;
+    sizer->stats.minThreads = config->minThreads;
+    sizer->stats.maxThreads = config->maxThreads;
+
+    // Partir d'un nombre de threads actifs compris entre les bornes
+    ExecutorStats stats;
+    ExecutorGetStats(executor, &stats);
+    int threads = stats.active;
+    if (threads < config->minThreads) {
+        threads = config->minThreads;
+    } else if (threads > config->maxThreads) {
+        threads = config->maxThreads;
+    }
+    sizer->stats.threads = ExecutorResize(executor, threads);
+
+    pthread_mutex_init(&sizer->mutex, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&sizer->stopCond, &attr);
+    pthread_condattr_destroy(&attr);
+    if (pthread_create(&sizer->thread, NULL, controlThread, sizer) != 0) {
+        pthread_cond_destroy(&sizer->stopCond);
+        pthread_mutex_destroy(&sizer->mutex);
+        delete sizer;
+        return NULL;
+    }
+    return sizer;
+}
+
+/**
+ * Arrête le thread de contrôle et libère le contrôleur
+ * @param sizer Contrôleur
+ */
+void PoolSizerDestroy(PoolSizer *sizer) {
+    if (!sizer) {
+        return;
+    }
+
+    pthread_mutex_lock(&sizer->mutex);
+    sizer->stopping = true;
+    pthread_cond_signal(&sizer->stopCond);
+    pthread_mutex_unlock(&sizer->mutex);
+    pthread_join(sizer->thread, NULL);
+
+    pthread_cond_destroy(&sizer->stopCond);
+    pthread_mutex_destroy(&sizer->mutex);
+    delete sizer;
+}
+
+/**
+ * Copie les métriques courantes du contrôleur
+ * @param sizer Contrôleur
+ * @param stats Métriques à remplir
+ */
+void PoolSizerGetStats(PoolSizer *sizer, PoolSizerStats *stats) {
+    pthread_mutex_lock(&sizer->mutex);
+    *stats = sizer->stats;
+    pthread_mutex_unlock(&sizer->mutex);
+}
+
+/**
+ * Affiche les métriques du contrôleur sur une ligne
+ * @param sizer Contrôleur
+ */
+void PoolSizerReport(PoolSizer *sizer) {
+    PoolSizerStats stats;
+    PoolSizerGetStats(sizer, &stats);
+    printf("Pool adaptatif %s: %d threads actifs (bornes %d-%d), %llu agrandissements, "
+           "%llu réductions, %llu refusés (pool MySQL saturé), attente file %.1f ms, "
+           "MySQL %.1f ms\n", sizer->name.c_str(), stats.threads, stats.minThreads,
+           stats.maxThreads, stats.grows, stats.shrinks, stats.blocked, stats.queueWaitMs,
+           stats.dbLatencyMs);
+}
@@ -0,0 +1,90 @@
+/**
+ * Dimensionnement adaptatif d'un pool de threads
+ *
+ * Un thread de contrôle mesure périodiquement l'attente des tâches dans les
+ * files de l'exécuteur et la durée des emprunts MySQL, puis ajuste le nombre
+ * de threads actifs entre deux bornes (ExecutorResize). Les décisions ont de
+ * l'hystérésis : seuils de croissance et de réduction distincts, et plusieurs
+ * périodes consécutives exigées avant d'agir. Chaque décision est affichée.
+ */
+
+#ifndef POOLSIZER_H
+#define POOLSIZER_H
+
+#include "executor.h"
+#include "dbpool.h"
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Paramètres du contrôleur
+ */
+typedef struct {
+    int minThreads;                 // Threads actifs au minimum
+    int maxThreads;                 // Threads actifs au maximum (threads de l'exécuteur)
+    int intervalMs;                 // Période de mesure
+    int targetWaitMs;               // Attente en file au-delà de laquelle le pool grandit
+    int maxDbLatencyMs;             // Durée d'emprunt MySQL au-delà de laquelle le pool
+                                    // rétrécit au lieu de grandir (0 = ignorée)
+    int growPeriods;                // Périodes au-dessus du seuil avant de grandir
+    int shrinkPeriods;              // Périodes sous le seuil bas avant de rétrécir
+} PoolSizerConfig;
+
+/**
+ * Métriques du contrôleur
+ */
+typedef struct {
+    int threads;                    // Threads actifs
+    int minThreads;                 // Borne basse
+    int maxThreads;                 // Borne haute
+    unsigned long long grows;       // Agrandissements
+    unsigned long long shrinks;     // Réductions
+    unsigned long long blocked;     // Agrandissements refusés (pool MySQL saturé)
+    double queueWaitMs;             // Attente moyenne en file (dernière période)
+    double dbLatencyMs;             // Durée moyenne d'un emprunt MySQL (dernière période)
+} PoolSizerStats;
+
+/**
+ * Contrôleur (structure opaque, thread-safe)
+ */
+typedef struct PoolSizer PoolSizer;
+
+// ============================================================================
+// FONCTIONS
+// ============================================================================
+
+/**
+ * Démarre le contrôle d'un exécuteur, dont le nombre de threads actifs est
+ * d'abord ramené entre les bornes
+ * @param config Paramètres du contrôleur
+ * @param executor Exécuteur contrôlé (créé avec maxThreads threads)
+ * @param pool Pool MySQL utilisé par les tâches (NULL = latence ignorée)
+ * @param name Nom affiché dans les décisions (recopié)
+ * @return Contrôleur créé ou NULL en cas d'erreur
+ */
+PoolSizer *PoolSizerCreate(const PoolSizerConfig *config, Executor *executor, DbPool *pool,
+                           const char *name);
+
+/**
+ * Arrête le thread de contrôle et libère le contrôleur (l'exécuteur garde
+ * son nombre de threads actifs)
+ * @param sizer Contrôleur
+ */
+void PoolSizerDestroy(PoolSizer *sizer);
+
+/**
+ * Copie les métriques courantes du contrôleur
+ * @param sizer Contrôleur
+ * @param stats Métriques à remplir
+ */
+void PoolSizerGetStats(PoolSizer *sizer, PoolSizerStats *stats);
+
+/**
+ * Affiche les métriques du contrôleur sur une ligne
+ * @param sizer Contrôleur
+ */
+void PoolSizerReport(PoolSizer *sizer);
+
+#endif // POOLSIZER_H
@@ -0,0 +1,164 @@
+/**
+ * Implémentation du cache des réponses de référence
+ *
+ * Une table protégée par un mutex, tenu le temps d'une recherche et de la
+ * copie d'un pointeur partagé : une réponse remplacée ou expirée reste
+ * valide pour les envois en cours qui la référencent encore.
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "refcache.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+#include <unordered_map>
+
+using namespace std;
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+struct ReferenceCache {
+    int ttlMs;
+    size_t maxEntries;
+    pthread_mutex_t mutex;          // Protège tous les champs qui suivent
+    unordered_map<string, shared_ptr<const string>> entries;
+    unsigned long long generation;  // Génération des entrées
+    long long generationStartMs;    // Début de la génération courante
+    unsigned long long hits;
+    unsigned long long misses;
+};
+
+// ============================================================================
+// FONCTIONS INTERNES
+// ============================================================================
+
+/**
+ * Horloge monotone en millisecondes
+ */
+static long long nowMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * Passe à une nouvelle génération si la courante a expiré (mutex pris)
+ */
+static void expireGeneration(ReferenceCache *cache) {
+    long long now = nowMs();
+    if (now - cache->generationStartMs >= cache->ttlMs) {
+        cache->entries.clear();
+        cache->generation++;
+        cache->generationStartMs = now;
+    }
+}
+
+// ============================================================================
+// FONCTIONS PUBLIQUES
+// ============================================================================
+
+/**
+ * Crée un cache vide
+ * @param ttlMs Durée de vie d'une génération (ms)
+ * @param maxEntries Réponses gardées au maximum
+ * @return Cache créé
+ */
+ReferenceCache *ReferenceCacheCreate(int ttlMs, int maxEntries) {
+    ReferenceCache *cache = new ReferenceCache();
+    cache->ttlMs = ttlMs;
+    cache->maxEntries = maxEntries > 0 ? (size_t)maxEntries : 1;
+    pthread_mutex_init(&cache->mutex, NULL);
+    cache->generation = 1;
+    cache->generationStartMs = nowMs();
+    cache->hits = 0;
+    cache->misses = 0;
+    return cache;
+}
+
+/**
+ * Libère le cache
+ * @param cache Cache (NULL accepté)
+ */
+void ReferenceCacheDestroy(ReferenceCache *cache) {
+    if (!cache) {
+        return;
+    }
+    pthread_mutex_destroy(&cache->mutex);
+    delete cache;
+}
+
+/**
+ * Cherche une réponse
+ * @param cache Cache
+ * @param key Commande et filtre
+ * @param generation Génération courante (pour ReferenceCachePut)
+ * @return Réponse partagée ou nullptr
+ */
+shared_ptr<const string> ReferenceCacheGet(ReferenceCache *cache, const string &key,
+                                           unsigned long long *generation) {
+    shared_ptr<const string> response;
+    pthread_mutex_lock(&cache->mutex);
+    expireGeneration(cache);
+    auto found = cache->entries.find(key);
+    if (found != cache->entries.end()) {
+        response = found->second;
+        cache->hits++;
+    } else {
+        cache->misses++;
+    }
+    *generation = cache->generation;
+    pthread_mutex_unlock(&cache->mutex);
+    return response;
+}
+
+/**
+ * Garde une réponse calculée, si sa génération est toujours la courante
+ * @param cache Cache
+ * @param key Commande et filtre
+ * @param generation Génération lue avant la requête
+ * @param response Réponse terminée
+ */
+void ReferenceCachePut(ReferenceCache *cache, const string &key, unsigned long long generation,
+                       shared_ptr<const string> response) {
+    pthread_mutex_lock(&cache->mutex);
+    expireGeneration(cache);
+    // Une génération expirée pendant la requête a pu lire des tables
+    // modifiées depuis : sa réponse n'est pas gardée
+    if (generation == cache->generation &&
+        (cache->entries.size() < cache->maxEntries || cache->entries.count(key))) {
+        cache->entries[key] = move(response);
+    }
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+/**
+ * Copie les métriques courantes du cache
+ * @param cache Cache
+ * @param stats Métriques à remplir
+ */
+void ReferenceCacheGetStats(ReferenceCache *cache, ReferenceCacheStats *stats) {
+    pthread_mutex_lock(&cache->mutex);
+    stats->entries = cache->entries.size();
+    stats->generation = cache->generation;
+    stats->hits = cache->hits;
+    stats->misses = cache->misses;
+    pthread_mutex_unlock(&cache->mutex);
+}
+
+/**
+ * Affiche les métriques du cache sur une ligne
+ * @param cache Cache
+ */
+void ReferenceCacheReport(ReferenceCache *cache) {
+    ReferenceCacheStats stats;
+    ReferenceCacheGetStats(cache, &stats);
+    unsigned long long total = stats.hits + stats.misses;
+    printf("Cache des listes: %zu réponse(s), génération %llu, %llu servies (%.1f %%), "
+           "%llu calculées\n",
+           stats.entries, stats.generation, stats.hits,
+           total ? 100.0 * stats.hits / total : 0.0, stats.misses);
+}
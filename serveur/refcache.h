@@ -0,0 +1,93 @@
+/**
+ * Cache des réponses de référence (GET_SPECIALTIES, GET_DOCTORS)
+ *
+ * Les listes de spécialités et de médecins changent rarement mais sont
+ * demandées à chaque connexion et à chaque changement de spécialité du
+ * client. Le cache garde la réponse terminée (SPECIALTIES_OK;..., une entrée
+ * par filtre de GET_DOCTORS), envoyée telle quelle sans requête ni encodage.
+ *
+ * Les entrées appartiennent à une génération, qui expire en bloc après ttlMs :
+ * toutes les listes sont alors relues dans la base et restent cohérentes
+ * entre elles. Une réponse calculée pendant une génération expirée depuis
+ * n'est pas gardée (voir ReferenceCachePut).
+ */
+
+#ifndef REFCACHE_H
+#define REFCACHE_H
+
+#include <stddef.h>
+#include <memory>
+#include <string>
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Métriques du cache
+ */
+typedef struct {
+    size_t entries;                 // Réponses gardées
+    unsigned long long generation;  // Génération courante
+    unsigned long long hits;        // Réponses servies par le cache
+    unsigned long long misses;      // Réponses calculées dans la base
+} ReferenceCacheStats;
+
+/**
+ * Cache (structure opaque, thread-safe)
+ */
+typedef struct ReferenceCache ReferenceCache;
+
+// ============================================================================
+// FONCTIONS
+// ============================================================================
+
+/**
+ * Crée un cache vide
+ * @param ttlMs Durée de vie d'une génération (ms, > 0)
+ * @param maxEntries Réponses gardées au maximum (filtres inconnus compris)
+ * @return Cache créé
+ */
+ReferenceCache *ReferenceCacheCreate(int ttlMs, int maxEntries);
+
+/**
+ * Libère le cache
+ * @param cache Cache (NULL accepté)
+ */
+void ReferenceCacheDestroy(ReferenceCache *cache);
+
+/**
+ * Cherche une réponse
+ * @param cache Cache
+ * @param key Commande et filtre
+ * @param generation Génération courante, à rendre à ReferenceCachePut en
+ *                   cas d'absence
+ * @return Réponse partagée ou nullptr si elle doit être calculée
+ */
+std::shared_ptr<const std::string> ReferenceCacheGet(ReferenceCache *cache, const std::string &key,
+                                                     unsigned long long *generation);
+
+/**
+ * Garde une réponse calculée, si sa génération est toujours la courante
+ * @param cache Cache
+ * @param key Commande et filtre
+ * @param generation Génération lue par ReferenceCacheGet avant la requête
+ * @param response Réponse terminée
+ */
+void ReferenceCachePut(ReferenceCache *cache, const std::string &key, unsigned long long generation,
+                       std::shared_ptr<const std::string> response);
+
+/**
+ * Copie les métriques courantes du cache
+ * @param cache Cache
+ * @param stats Métriques à remplir
+ */
+void ReferenceCacheGetStats(ReferenceCache *cache, ReferenceCacheStats *stats);
+
+/**
+ * Affiche les métriques du cache sur une ligne
+ * @param cache Cache
+ */
+void ReferenceCacheReport(ReferenceCache *cache);
+
+#endif // REFCACHE_H
@@ -0,0 +1,136 @@
+/**
+ * Implémentation de la réponse SEARCH_OK envoyée au fil de la lecture
+ *
+ * Le contenu en attente est le tampon d'une trame, suivi au plus d'une ligne
+ * trop longue pour y tenir. Il part comme trame partielle dès que la ligne
+ * suivante ne peut pas s'y ajouter, et en dernière trame à la fin.
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "searchstream.h"
+#include <string.h>
+
+// ============================================================================
+// FONCTIONS INTERNES
+// ============================================================================
+
+/**
+ * Ajoute le contenu en attente à l'émetteur
+ * @param stream Réponse en cours
+ * @return 0 en cas de succès, -1 si un envoi a échoué
+ */
+static int ajouterAttente(SearchStream *stream) {
+    struct iovec contenu[2] = {
+        {stream->buffer, stream->used},
+        {(void *)stream->longue.data(), stream->longue.size()},
+    };
+    return ChunkWriterAppend(&stream->writer, contenu, 2);
+}
+
+/**
+ * Envoie le contenu en attente comme trame partielle
+ * @param stream Réponse en cours
+ * @return 0 en cas de succès, -1 si l'envoi a échoué
+ */
+static int envoyerAttente(SearchStream *stream) {
+    if (stream->used == 0 && stream->longue.empty()) {
+        return 0;
+    }
+    if (ajouterAttente(stream) < 0 || ChunkWriterFlush(&stream->writer) < 0) {
+        return -1;
+    }
+    stream->used = 0;
+    stream->longue.clear();
+    stream->flushed = true;
+    return 0;
+}
+
+// ============================================================================
+// FONCTIONS PUBLIQUES
+// ============================================================================
+
+/**
+ * Tampons d'une ligne de SEARCH_OK
+ * @param fields Champs de la consultation (NULL = vide)
+ * @param lengths Longueur de chaque champ
+ * @param first Première ligne de la réponse
+ * @param line Tampons à remplir (2 * SEARCH_FIELDS)
+ * @return Nombre de tampons
+ */
+int SearchLine(const char *const *fields, const unsigned long *lengths, bool first,
+               struct iovec *line) {
+    static const char SEPARATEUR_LIGNE[] = "|";
+    static const char SEPARATEUR_CHAMP[] = ";";
+    int nbTampons = 0;
+    for (int i = 0; i < SEARCH_FIELDS; i++) {
+        if (i > 0 || !first) {
+            line[nbTampons++] = {(void *)(i > 0 ? SEPARATEUR_CHAMP : SEPARATEUR_LIGNE), 1};
+        }
+        line[nbTampons++] = {(void *)(fields[i] ? fields[i] : ""), fields[i] ? lengths[i] : 0};
+    }
+    return nbTampons;
+}
+
+/**
+ * Commence une réponse
+ * @param stream Réponse à initialiser
+ * @param sSocket Socket du client
+ * @param header En-tête de la réponse
+ */
+void SearchStreamInit(SearchStream *stream, int sSocket, const char *header) {
+    ChunkWriterInit(&stream->writer, sSocket);
+    stream->used = strlen(header);
+    memcpy(stream->buffer, header, stream->used);
+    stream->longue.clear();
+    stream->nbRows = 0;
+    stream->flushed = false;
+}
+
+/**
+ * Ajoute une consultation à la réponse
+ * @param stream Réponse en cours
+ * @param fields Champs de la consultation
+ * @param lengths Longueur de chaque champ
+ * @return 0 en cas de succès, -1 si le client ne reçoit plus
+ */
+int SearchStreamAdd(SearchStream *stream, const char *const *fields, const unsigned long *lengths) {
+    struct iovec line[2 * SEARCH_FIELDS];
+    int nbTampons = SearchLine(fields, lengths, stream->nbRows == 0, line);
+    size_t size = 0;
+    for (int i = 0; i < nbTampons; i++) {
+        size += line[i].iov_len;
+    }
+
+    // Une ligne longue en attente doit partir avant la suivante
+    if ((!stream->longue.empty() || stream->used + size > sizeof(stream->buffer)) &&
+        envoyerAttente(stream) < 0) {
+        return -1;
+    }
+
+    // Les champs ne sont valides que jusqu'à la ligne suivante : une ligne
+    // trop longue pour le tampon est recopiée à part
+    for (int i = 0; i < nbTampons; i++) {
+        if (size > sizeof(stream->buffer)) {
+            stream->longue.append((const char *)line[i].iov_base, line[i].iov_len);
+        } else {
+            memcpy(stream->buffer + stream->used, line[i].iov_base, line[i].iov_len);
+            stream->used += line[i].iov_len;
+        }
+    }
+    stream->nbRows++;
+    return 0;
+}
+
+/**
+ * Envoie la fin de la réponse
+ * @param stream Réponse en cours
+ * @return Nombre total d'octets envoyés ou -1 en cas d'erreur
+ */
+int SearchStreamFinish(SearchStream *stream) {
+    if (ajouterAttente(stream) < 0) {
+        return -1;
+    }
+    return ChunkWriterFinish(&stream->writer);
+}
@@ -0,0 +1,83 @@
+/**
+ * Réponse SEARCH_OK envoyée au fil de la lecture
+ *
+ * Les consultations lues dans la base sont recopiées dans un tampon d'une
+ * trame, envoyé comme trame partielle dès qu'il est plein (voir ChunkWriter) :
+ * la mémoire utilisée ne dépend pas du nombre de consultations trouvées.
+ * Une ligne n'est pas coupée entre deux trames, sauf si elle dépasse une
+ * trame entière : elle est alors recopiée à part et envoyée avec la ligne
+ * suivante, ou avec la dernière trame. La dernière trame de la réponse n'est
+ * donc jamais vide.
+ */
+
+#ifndef SEARCHSTREAM_H
+#define SEARCHSTREAM_H
+
+#include <stddef.h>
+#include <sys/uio.h>
+#include <string>
+#include "../socket/socket.h"
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+#define SEARCH_FIELDS 5             // Champs d'une consultation dans SEARCH_OK
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Réponse en cours d'envoi (un seul thread écrit sur le socket)
+ */
+typedef struct {
+    ChunkWriter writer;
+    char buffer[TAILLE_TRAME - 1];  // Contenu d'une trame (marque exclue)
+    size_t used;                    // Octets en attente dans le tampon
+    std::string longue;             // Ligne plus longue qu'une trame, en attente
+    int nbRows;                     // Lignes envoyées ou en attente
+    bool flushed;                   // Une trame est partie : la réponse est commencée
+} SearchStream;
+
+// ============================================================================
+// FONCTIONS
+// ============================================================================
+
+/**
+ * Tampons d'une ligne de SEARCH_OK : séparateur de ligne (sauf pour la
+ * première), puis champs séparés par ';'
+ * @param fields Champs de la consultation (NULL = vide)
+ * @param lengths Longueur de chaque champ
+ * @param first Première ligne de la réponse
+ * @param line Tampons à remplir (2 * SEARCH_FIELDS)
+ * @return Nombre de tampons
+ */
+int SearchLine(const char *const *fields, const unsigned long *lengths, bool first,
+               struct iovec *line);
+
+/**
+ * Commence une réponse
+ * @param stream Réponse à initialiser
+ * @param sSocket Socket du client
+ * @param header En-tête de la réponse (SEARCH_OK), plus court qu'une trame
+ */
+void SearchStreamInit(SearchStream *stream, int sSocket, const char *header);
+
+/**
+ * Ajoute une consultation à la réponse
+ * @param stream Réponse en cours
+ * @param fields Champs de la consultation (SEARCH_FIELDS, NULL = vide),
+ *               valides seulement pendant l'appel
+ * @param lengths Longueur de chaque champ
+ * @return 0 en cas de succès, -1 si le client ne reçoit plus
+ */
+int SearchStreamAdd(SearchStream *stream, const char *const *fields, const unsigned long *lengths);
+
+/**
+ * Envoie la fin de la réponse, dans une dernière trame non vide
+ * @param stream Réponse en cours
+ * @return Nombre total d'octets envoyés ou -1 en cas d'erreur
+ */
+int SearchStreamFinish(SearchStream *stream);
+
+#endif
@@ -21,14 +21,38 @@
 #include <arpa/inet.h>
 #include <cstring>
 #include <pthread.h>
+#include <cerrno>
+#include <cstdint>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
 #include <string>
 #include <vector>
-#include <queue>
+#include <utility>
+#include <algorithm>
+#include <map>
+#include <memory>
 #include <fstream>
 #include <iostream>
 #include <mysql.h>
+#include <errmsg.h>
 #include "../util/name.h"
 #include "../socket/socket.h"
+#include "../socket/uring.h"
+#include "../socket/timerwheel.h"
+#include "../socket/tuning.h"
+#include "../socket/coroutine.h"
+#include "admission.h"
+#include "booking.h"
+#include "dal.h"
+#include "dbpool.h"
+#include "executor.h"
+#include "patientdir.h"
+#include "refcache.h"
+#include "searchstream.h"
+#include "placement.h"
+#include "poolsizer.h"
 
 using namespace std;
 
@@ -36,8 +60,19 @@ using namespace std;
 // CONSTANTES ET CONFIGURATION
 // ============================================================================
 const int BUFFER_SIZE = 1024;           // Taille du buffer de réception
-const int QUERY_SIZE = 512;             // Taille maximale des requêtes SQL
 const int MAX_PATIENT_NAME_LENGTH = 50; // Longueur maximale des noms
+const size_t MAX_REASON_LENGTH = 255;   // Caractères du motif d'une réservation (VARCHAR(255))
+const int MAX_EPOLL_EVENTS = 256;       // Événements traités par appel à epoll_wait
+const int EPOLL_TIMEOUT_MS = 1000;      // Attente maximale d'un réacteur (ms)
+const size_t MAX_URING_BACKLOG = 16 * TAILLE_LECTEUR; // Octets reçus en avance tolérés (io_uring)
+const int DB_PING_INTERVAL_MS = 5000;   // Inactivité avant vérification d'une connexion MySQL
+const size_t MAX_PENDING_TASKS = 65536; // Tâches externes en attente d'un thread du pool
+const int MAX_PIPELINED_REQUESTS = 64;  // Requêtes d'une session en cours au maximum
+const int DB_RETRY_MAX_MS = 8;          // Attente maximale entre deux essais d'emprunt (coroutine)
+const int FRAMES_PER_TURN = 16;         // Commandes d'une session avant de céder le thread (coroutine)
+const int ADAPTIVE_GROW_PERIODS = 2;    // Périodes d'attente excessive avant d'agrandir le pool
+const int ADAPTIVE_SHRINK_PERIODS = 10; // Périodes de file vide avant de réduire le pool
+const int REFERENCE_CACHE_ENTRIES = 256; // Listes gardées au maximum (une par filtre de GET_DOCTORS)
 
 // Longueurs des commandes du protocole CBP
 const int LOGIN_NEW_LENGTH = 10;         // "LOGIN_NEW;" = 10 caractères
@@ -60,10 +95,132 @@ struct ServerConfig {
     string dbUser;             // Utilisateur de la base de données
     string dbPass;             // Mot de passe de la base de données
     string dbName;             // Nom de la base de données
+    bool reactorMode = false;       // Mode réacteur epoll (sinon un thread par session)
+    bool coroutineMode = false;     // Sessions en coroutines sur NB_THREADS threads
+    int nbReactors = 1;             // Nombre de threads réacteurs (mode réacteur)
+    bool uringBackend = false;      // Backend io_uring (repli sur le mode configuré)
+    int listenBacklog = BACKLOG_DEFAUT; // File d'attente de chaque socket d'écoute
+    int nbAcceptors = 1;            // Sockets d'écoute SO_REUSEPORT (1 = socket unique)
+    int connectionTimeout = 300;    // Inactivité tolérée en secondes (0 = illimitée)
+    int sendTimeoutMs = DELAI_ENVOI_DEFAUT_MS; // Attente d'un client qui ne lit plus (ms, 0 = illimitée)
+    string unixSocketPath;          // Socket local AF_UNIX (vide = désactivé)
+    string socketProfile = "defaut"; // Profil de réglage des sockets (voir tuning.h)
+    vector<pair<string, int>> socketOptions; // Options SOCKET_* modifiant le profil
+    int dbPoolSize = 0;             // Connexions MySQL partagées (0 = NB_THREADS)
+    int dbPoolTimeout = 2000;       // Attente maximale d'une connexion (ms)
+    int dbPoolIdleTimeout = 300;    // Inactivité avant fermeture d'une connexion (s)
+    int dbPoolStatsInterval = 0;    // Période d'affichage des métriques du pool (s)
+    int dbThreads = 0;              // Threads de l'étape base de données (0 = DB_POOL_SIZE)
+    int encodeThreads = 0;          // Threads de l'étape d'encodage (0 = NB_THREADS)
+    int stageStatsInterval = 0;     // Période d'affichage des files des étapes (s)
+    int adaptiveMinThreads = 1;     // Threads actifs au minimum (pool adaptatif)
+    int adaptiveMaxThreads = 0;     // Threads actifs au maximum (0 = pool fixe)
+    int adaptiveTargetWaitMs = 5;   // Attente en file au-delà de laquelle le pool grandit
+    int adaptiveMaxDbLatencyMs = 100; // Durée d'emprunt MySQL au-delà de laquelle il rétrécit
+    int adaptiveIntervalMs = 500;   // Période de mesure du pool adaptatif
+    int admissionMaxQueue = 0;      // File tolérée avant refus (0 = ignorée)
+    int admissionLatencyMs = 0;     // Attente en file tolérée avant refus (0 = ignorée)
+    int admissionRetryMs = 500;     // Délai minimal conseillé aux clients refusés
+    int admissionIntervalMs = 50;   // Période de mesure de la charge
+    int bookingWindowUs = 300;      // Regroupement des réservations simultanées (µs)
+    int bookingMaxBatch = 64;       // Réservations par transaction au maximum
+    bool patientDirectory = true;   // LOGIN_EXIST vérifié dans l'annuaire en mémoire
+    int referenceCacheTtl = 60;     // Durée de vie des listes en cache (s, 0 = sans cache)
+    bool searchStreaming = true;    // SEARCH envoyé au fil de la lecture (mode thread par session)
+    string cpuAcceptors;            // Processeurs des accepteurs (vide = non placés)
+    string cpuReactors;             // Processeurs des réacteurs et de la boucle io_uring
+    string cpuWorkers;              // Processeurs des threads du pool
+    bool cpuWholeSet = false;       // Threads libres sur tout leur ensemble (sinon un processeur chacun)
 };
 
 /**
- * Tâche client à traiter par un thread
+ * Réacteur epoll, éventuellement propriétaire de son socket d'écoute
+ */
+struct Reactor {
+    int epollFd;                    // Instance epoll du réacteur
+    int listenSocket;               // Socket d'écoute SO_REUSEPORT du réacteur (-1 sinon)
+};
+
+/**
+ * Session client multiplexée par un réacteur epoll
+ */
+struct Session {
+    int socket;                     // Socket non bloquant du client
+    int epollFd;                    // Instance epoll du réacteur (-1 avec io_uring)
+    char ip[INET_ADDRSTRLEN];       // Adresse IP du client
+    FrameReader reader;             // Octets reçus et pas encore traités
+
+    // Backend io_uring : le lecteur est alimenté par la boucle io_uring
+    pthread_mutex_t verrou;         // Protège tous les champs qui suivent (et reader avec io_uring)
+    string excedent;                // Octets reçus ne tenant pas dans le lecteur
+    bool busy;                      // Un thread du pool lit les commandes (io_uring)
+    bool closed;                    // Connexion terminée (lecture finie)
+    bool released;                  // Socket rendu à la boucle io_uring : plus d'envoi
+    bool failed;                    // Envoi échoué : connexion coupée, réponses abandonnées
+    
+    // Requêtes exécutées en parallèle, réponses envoyées dans leur ordre
+    unsigned long nextRequest;      // Rang de la prochaine requête lue
+    unsigned long nextReply;        // Rang de la prochaine réponse à envoyer
+    map<unsigned long, SendCapture> replies; // Réponses prêtes, en attente des précédentes
+    int pending;                    // Requêtes lues dont la réponse n'est pas envoyée
+    bool sending;                   // Un thread envoie les réponses prêtes
+    bool suspended;                 // Lecture suspendue (trop de requêtes en cours)
+    
+    IdleConnection idle;            // Surveillance de l'inactivité
+};
+
+/**
+ * Type de commande CBP
+ */
+enum CommandType {
+    COMMAND_INVALID,                // Message mal formé ou inconnu (réponse immédiate)
+    COMMAND_LOGIN_NEW,
+    COMMAND_LOGIN_EXIST,
+    COMMAND_SEARCH,
+    COMMAND_GET_SPECIALTIES,
+    COMMAND_GET_DOCTORS,
+    COMMAND_BOOK_CONSULTATION
+};
+
+/**
+ * Commande analysée, complétée par l'étape base de données puis encodée
+ */
+struct Command {
+    CommandType type = COMMAND_INVALID;
+    string reply;                   // Réponse immédiate (COMMAND_INVALID)
+    string lastName;                // Nom du patient (LOGIN_*)
+    string firstName;               // Prénom du patient (LOGIN_*)
+    string specialty;               // Spécialité (SEARCH, GET_DOCTORS)
+    string doctor;                  // Médecin (SEARCH)
+    string startDate;               // Début de la période (SEARCH)
+    string endDate;                 // Fin de la période (SEARCH)
+    string reason;                  // Motif (BOOK_CONSULTATION)
+    int patientId = 0;              // Patient (LOGIN_EXIST, BOOK_CONSULTATION, créé par LOGIN_NEW)
+    int consultationId = 0;         // Consultation (BOOK_CONSULTATION)
+    int streamSocket = -1;          // Socket où SEARCH envoie ses lignes à la lecture (-1 = gardées)
+
+    // Résultat de l'étape base de données
+    bool answered = false;          // Résultat connu dès l'analyse (sans étape base de données)
+    const char *failure = NULL;     // Motif d'échec (DB, NOT_FOUND...), NULL si succès
+    DalRows *rows = NULL;           // Lignes à encoder (SEARCH, listes)
+    bool streamed = false;          // Réponse déjà envoyée pendant la lecture (SEARCH)
+    shared_ptr<const string> cached; // Réponse terminée (GET_SPECIALTIES, GET_DOCTORS)
+    unsigned long long cacheGeneration = 0; // Génération du cache lue à l'analyse
+};
+
+/**
+ * Requête d'une session multiplexée, qui traverse les étapes d'analyse,
+ * de base de données et d'encodage
+ */
+struct Request {
+    Session *session;               // Session d'origine
+    unsigned long number;           // Rang de la requête dans la session
+    string message;                 // Commande reçue (sans le délimiteur)
+    Command command;                // Commande analysée et son résultat
+};
+
+/**
+ * Connexion client traitée par un thread (mode thread par session)
  */
 struct ClientTask {
     int socket;                     // Socket de communication avec le client
@@ -75,9 +232,25 @@ struct ClientTask {
 // ============================================================================
 static ServerConfig config;                    // Configuration du serveur
 static bool stop = false;                     // Flag d'arrêt du serveur
-static queue<ClientTask> tasks;          // File de tâches à traiter
-static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;  // Mutex pour la file
-static pthread_cond_t condition = PTHREAD_COND_INITIALIZER; // Condition pour les threads
+static Executor *executor = NULL;              // Threads du pool : lecture et analyse
+static CoScheduler *coScheduler = NULL;       // Threads des sessions en coroutines (mode coroutine)
+static Executor *dbStage = NULL;               // Étape base de données (modes multiplexés)
+static Executor *encodeStage = NULL;           // Étape d'encodage et d'envoi (modes multiplexés)
+static PoolSizer *poolSizer = NULL;            // Dimensionnement adaptatif (pool ou étape base de données)
+static Admission *admission = NULL;            // Contrôle d'admission (NULL = tout est admis)
+static pthread_mutex_t resumeMutex = PTHREAD_MUTEX_INITIALIZER; // Protège resumedSessions
+static vector<Session *> resumedSessions;      // Sessions dont la lecture reprend
+static int nbResumedSessions = 0;              // Taille de resumedSessions (lue sans verrou)
+static UringServer *uringServer = NULL;        // Boucle io_uring (backend io_uring)
+static IdleMonitor *idleMonitor = NULL;        // Fermeture des sessions inactives
+static SocketProfile socketProfile;            // Options appliquées aux sockets
+static DbPool *dbPool = NULL;                  // Connexions MySQL partagées par les requêtes
+static Dal *dal = NULL;                        // Requêtes préparées de chaque connexion du pool
+static BookingEngine *bookingEngine = NULL;    // Réservations validées par lots
+static PatientDirectory *patientDirectory = NULL; // Patients connus (NULL = vérifiés dans la base)
+static ReferenceCache *referenceCache = NULL;  // Listes de spécialités et de médecins (NULL = sans cache)
+static vector<Reactor> reactors;               // Réacteurs epoll (mode réacteur)
+static unsigned int nextReactor = 0;           // Prochain réacteur (tourniquet)
 
 // ============================================================================
 // FONCTIONS UTILITAIRES
@@ -158,6 +331,113 @@ static bool loadConfig(const char *path, ServerConfig &cfg) {
         else if (key == "DB_NAME") {
             cfg.dbName = value;
         }
+        else if (key == "SERVER_MODE") {
+            cfg.reactorMode = (value == "reactor");
+            cfg.coroutineMode = (value == "coroutine");
+        }
+        else if (key == "NB_REACTORS") {
+            cfg.nbReactors = atoi(value.c_str());
+        }
+        else if (key == "IO_BACKEND") {
+            cfg.uringBackend = (value == "uring");
+        }
+        else if (key == "LISTEN_BACKLOG") {
+            cfg.listenBacklog = atoi(value.c_str());
+        }
+        else if (key == "NB_ACCEPTORS") {
+            cfg.nbAcceptors = atoi(value.c_str());
+        }
+        else if (key == "CONNECTION_TIMEOUT") {
+            cfg.connectionTimeout = atoi(value.c_str());
+        }
+        else if (key == "SEND_TIMEOUT_MS") {
+            cfg.sendTimeoutMs = atoi(value.c_str());
+        }
+        else if (key == "UNIX_SOCKET_PATH") {
+            cfg.unixSocketPath = value;
+        }
+        else if (key == "DB_POOL_SIZE") {
+            cfg.dbPoolSize = atoi(value.c_str());
+        }
+        else if (key == "DB_POOL_TIMEOUT") {
+            cfg.dbPoolTimeout = atoi(value.c_str());
+        }
+        else if (key == "DB_POOL_IDLE_TIMEOUT") {
+            cfg.dbPoolIdleTimeout = atoi(value.c_str());
+        }
+        else if (key == "DB_POOL_STATS_INTERVAL") {
+            cfg.dbPoolStatsInterval = atoi(value.c_str());
+        }
+        else if (key == "DB_THREADS") {
+            cfg.dbThreads = atoi(value.c_str());
+        }
+        else if (key == "ENCODE_THREADS") {
+            cfg.encodeThreads = atoi(value.c_str());
+        }
+        else if (key == "STAGE_STATS_INTERVAL") {
+            cfg.stageStatsInterval = atoi(value.c_str());
+        }
+        else if (key == "ADAPTIVE_MIN_THREADS") {
+            cfg.adaptiveMinThreads = atoi(value.c_str());
+        }
+        else if (key == "ADAPTIVE_MAX_THREADS") {
+            cfg.adaptiveMaxThreads = atoi(value.c_str());
+        }
+        else if (key == "ADAPTIVE_TARGET_WAIT_MS") {
+            cfg.adaptiveTargetWaitMs = atoi(value.c_str());
+        }
+        else if (key == "ADAPTIVE_MAX_DB_LATENCY_MS") {
+            cfg.adaptiveMaxDbLatencyMs = atoi(value.c_str());
+        }
+        else if (key == "ADAPTIVE_INTERVAL_MS") {
+            cfg.adaptiveIntervalMs = atoi(value.c_str());
+        }
+        else if (key == "ADMISSION_MAX_QUEUE") {
+            cfg.admissionMaxQueue = atoi(value.c_str());
+        }
+        else if (key == "ADMISSION_LATENCY_MS") {
+            cfg.admissionLatencyMs = atoi(value.c_str());
+        }
+        else if (key == "ADMISSION_RETRY_MS") {
+            cfg.admissionRetryMs = atoi(value.c_str());
+        }
+        else if (key == "ADMISSION_INTERVAL_MS") {
+            cfg.admissionIntervalMs = atoi(value.c_str());
+        }
+        else if (key == "BOOKING_WINDOW_US") {
+            cfg.bookingWindowUs = atoi(value.c_str());
+        }
+        else if (key == "BOOKING_MAX_BATCH") {
+            cfg.bookingMaxBatch = atoi(value.c_str());
+        }
+        else if (key == "PATIENT_DIRECTORY") {
+            cfg.patientDirectory = atoi(value.c_str()) != 0;
+        }
+        else if (key == "REFERENCE_CACHE_TTL") {
+            cfg.referenceCacheTtl = atoi(value.c_str());
+        }
+        else if (key == "SEARCH_STREAMING") {
+            cfg.searchStreaming = atoi(value.c_str()) != 0;
+        }
+        else if (key == "CPU_AFFINITY_ACCEPTORS") {
+            cfg.cpuAcceptors = value;
+        }
+        else if (key == "CPU_AFFINITY_REACTORS") {
+            cfg.cpuReactors = value;
+        }
+        else if (key == "CPU_AFFINITY_WORKERS") {
+            cfg.cpuWorkers = value;
+        }
+        else if (key == "CPU_PIN_MODE") {
+            cfg.cpuWholeSet = (value == "set");
+        }
+        else if (key == "SOCKET_PROFILE") {
+            cfg.socketProfile = value;
+        }
+        else if (key.compare(0, 7, "SOCKET_") == 0) {
+            // Appliquées après le profil, quel que soit l'ordre du fichier
+            cfg.socketOptions.push_back(make_pair(key.substr(7), atoi(value.c_str())));
+        }
     }
     
     // Vérifier que le port est configuré
@@ -169,28 +449,149 @@ static bool loadConfig(const char *path, ServerConfig &cfg) {
 // ============================================================================
 
 /**
- * Établit une connexion à la base de données MySQL
- * @return Pointeur vers la connexion MySQL ou NULL en cas d'échec
+ * Connexion empruntée au pool le temps d'une requête (acquireConnection),
+ * rendue à la destruction (ou plus tôt par release(), dès que le résultat
+ * est stocké)
  */
-static MYSQL *openDb() {
-    MYSQL *connection = mysql_init(NULL);
-    if (!connection) {
-        printf("ERREUR: Impossible d'initialiser la connexion MySQL\n");
-        return NULL;
+struct DbLease {
+    MYSQL *connection;              // Connexion empruntée (NULL si indisponible)
+
+    explicit DbLease(MYSQL *borrowed) : connection(borrowed) {}
+    ~DbLease() { release(); }
+    DbLease(const DbLease &) = delete;
+    DbLease &operator=(const DbLease &) = delete;
+
+    void release() {
+        if (connection) {
+            DbPoolRelease(dbPool, connection);
+            connection = NULL;
+        }
     }
-    
-    if (!mysql_real_connect(connection, 
-                           config.dbHost.c_str(), 
-                           config.dbUser.c_str(), 
-                           config.dbPass.c_str(), 
-                           config.dbName.c_str(), 
-                           0, NULL, 0)) {
-        printf("ERREUR: Impossible de se connecter à la base de données: %s\n", mysql_error(connection));
-        mysql_close(connection);
-        return NULL;
+};
+
+// Les fonctions d'accès à la base sont des coroutines : dans une session en
+// coroutine (mode coroutine), chaque attente de MySQL suspend la session et
+// libère le thread ; partout ailleurs (CoRunSync), les mêmes appels bloquent
+// le thread appelant comme des appels MySQL ordinaires.
+
+/**
+ * Emprunte une connexion au pool. Dans une coroutine, le thread n'est jamais
+ * bloqué : l'emprunt est retenté après un délai croissant, jusqu'à
+ * DB_POOL_TIMEOUT, pendant que le thread de maintenance du pool vérifie ou
+ * ouvre une connexion (voir DbPoolTryAcquire).
+ * @return Connexion empruntée ou NULL (délai dépassé ou base injoignable)
+ */
+static CoTask<MYSQL *> acquireConnection() {
+    if (!CoScheduled()) {
+        co_return DbPoolAcquire(dbPool);
     }
-    
-    return connection;
+    int waited = 0;
+    int delay = 1;
+    MYSQL *connection;
+    while (!(connection = DbPoolTryAcquire(dbPool)) && errno == EAGAIN &&
+           waited < config.dbPoolTimeout) {
+        co_await CoSleep(delay);
+        waited += delay;
+        delay = min(2 * delay, DB_RETRY_MAX_MS);
+    }
+    co_return connection;
+}
+
+/**
+ * Exécute une requête SQL. Dans une coroutine, la requête passe par l'API non
+ * bloquante de MySQL et la coroutine attend la réponse sur le socket de la
+ * connexion.
+ * @param connection Connexion empruntée
+ * @param query Requête SQL (valide jusqu'à la fin de l'appel)
+ * @return 0 en cas de succès, non nul en cas d'erreur (voir mysql_error)
+ */
+static CoTask<int> dbQuery(MYSQL *connection, const char *query) {
+    if (!CoScheduled()) {
+        co_return mysql_query(connection, query);
+    }
+    net_async_status status;
+    while ((status = mysql_real_query_nonblocking(connection, query, strlen(query))) ==
+           NET_ASYNC_NOT_READY) {
+        if (co_await CoWait(connection->net.fd, EPOLLIN) < 0) {
+            // Échange interrompu : la connexion ne peut plus servir
+            DbPoolMarkBroken(dbPool, connection);
+            co_return -1;
+        }
+    }
+    co_return status == NET_ASYNC_ERROR ? -1 : 0;
+}
+
+/**
+ * Reçoit le résultat complet de la dernière requête (voir dbQuery)
+ * @param connection Connexion empruntée
+ * @return Résultat ou NULL en cas d'erreur
+ */
+static CoTask<MYSQL_RES *> dbStoreResult(MYSQL *connection) {
+    if (!CoScheduled()) {
+        co_return mysql_store_result(connection);
+    }
+    MYSQL_RES *result = NULL;
+    net_async_status status;
+    while ((status = mysql_store_result_nonblocking(connection, &result)) == NET_ASYNC_NOT_READY) {
+        if (co_await CoWait(connection->net.fd, EPOLLIN) < 0) {
+            DbPoolMarkBroken(dbPool, connection);
+            co_return NULL;
+        }
+    }
+    co_return status == NET_ASYNC_ERROR ? NULL : result;
+}
+
+/**
+ * Exécute une requête SELECT de la couche d'accès aux données. Hors
+ * coroutine, c'est la requête préparée de la connexion ; dans une coroutine,
+ * son texte (paramètres échappés) passe par l'API non bloquante de MySQL, qui
+ * n'a pas d'équivalent pour les requêtes préparées.
+ * @param connection Connexion empruntée
+ * @param statement Requête
+ * @param params Paramètres, dans l'ordre des ?
+ * @return Lignes lues ou NULL en cas d'erreur
+ */
+static CoTask<DalRows *> dbSelect(MYSQL *connection, DalStatement statement, const DalParam *params) {
+    if (!CoScheduled()) {
+        co_return DalSelect(dal, connection, statement, params);
+    }
+    string query = DalFormat(connection, statement, params);
+    if (co_await dbQuery(connection, query.c_str()) != 0) {
+        printf("ERREUR: Échec de la requête: %s\n", mysql_error(connection));
+        co_return NULL;
+    }
+    MYSQL_RES *result = co_await dbStoreResult(connection);
+    if (!result) {
+        co_return NULL;
+    }
+    DalRows *rows = DalRowsFromResult(result);
+    mysql_free_result(result);
+    co_return rows;
+}
+
+/**
+ * Exécute une requête INSERT ou UPDATE de la couche d'accès aux données
+ * (voir dbSelect)
+ * @param connection Connexion empruntée
+ * @param statement Requête
+ * @param params Paramètres, dans l'ordre des ?
+ * @param insertId Identifiant créé par un INSERT (NULL = ignoré)
+ * @return Nombre de lignes modifiées ou -1 en cas d'erreur
+ */
+static CoTask<long long> dbExecute(MYSQL *connection, DalStatement statement, const DalParam *params,
+                                   long long *insertId) {
+    if (!CoScheduled()) {
+        co_return DalExecute(dal, connection, statement, params, insertId);
+    }
+    string query = DalFormat(connection, statement, params);
+    if (co_await dbQuery(connection, query.c_str()) != 0) {
+        printf("ERREUR: Échec de la requête: %s\n", mysql_error(connection));
+        co_return -1;
+    }
+    if (insertId) {
+        *insertId = (long long)mysql_insert_id(connection);
+    }
+    co_return (long long)mysql_affected_rows(connection);
 }
 
 // ============================================================================
@@ -204,44 +605,25 @@ static MYSQL *openDb() {
  * @param firstName Prénom du patient
  * @return ID du patient créé ou -1 en cas d'échec
  */
-static int createNewPatient(MYSQL *connection, const string &lastName, const string &firstName) {
+static CoTask<int> createNewPatient(MYSQL *connection, const string &lastName, const string &firstName) {
     // Validation des entrées
     if (lastName.empty() || firstName.empty() || 
         lastName.length() > MAX_PATIENT_NAME_LENGTH || 
         firstName.length() > MAX_PATIENT_NAME_LENGTH) {
         printf("ERREUR: Données patient invalides (nom: %s, prénom: %s)\n", 
                lastName.c_str(), firstName.c_str());
-        return -1;
-    }
-
-    // Échappement des caractères spéciaux pour éviter les injections SQL
-    string escapedLastName = lastName;
-    string escapedFirstName = firstName;
-
-    // Remplacer les apostrophes par des apostrophes doubles
-    size_t pos = 0;
-    while ((pos = escapedLastName.find("'", pos)) != string::npos) {
-        escapedLastName.replace(pos, 1, "''");
-        pos += 2;
-    }
-    pos = 0;
-    while ((pos = escapedFirstName.find("'", pos)) != string::npos) {
-        escapedFirstName.replace(pos, 1, "''");
-        pos += 2;
+        co_return -1;
     }
 
-    // Construction et exécution de la requête SQL
-    char query[QUERY_SIZE];
-    snprintf(query, sizeof(query), 
-             "INSERT INTO patients (last_name, first_name, birth_date) VALUES ('%s','%s','2000-01-01')",
-             escapedLastName.c_str(), escapedFirstName.c_str());
-    
-    if (mysql_query(connection, query) != 0) {
-        printf("ERREUR: Échec de l'insertion du patient: %s\n", mysql_error(connection));
-        return -1;
+    // Nom et prénom passés en paramètres : aucun échappement nécessaire
+    DalParam params[] = {DalText(lastName), DalText(firstName)};
+    long long patientId = 0;
+    if (co_await dbExecute(connection, DAL_PATIENT_INSERT, params, &patientId) < 0) {
+        printf("ERREUR: Échec de l'insertion du patient\n");
+        co_return -1;
     }
     
-    return (int)mysql_insert_id(connection);
+    co_return (int)patientId;
 }
 
 /**
@@ -252,494 +634,1614 @@ static int createNewPatient(MYSQL *connection, const string &lastName, const str
  * @param firstName Prénom du patient
  * @return true si le patient existe, false sinon
  */
-static bool verifyExistingPatient(MYSQL *connection, int patientId, const string &lastName, const string &firstName) {
-    char query[QUERY_SIZE];
-    snprintf(query, sizeof(query), 
-             "SELECT id FROM patients WHERE id=%d AND last_name='%s' AND first_name='%s'",
-             patientId, lastName.c_str(), firstName.c_str());
-
-    if (mysql_query(connection, query) != 0) {
-        printf("ERREUR: Échec de la vérification du patient: %s\n", mysql_error(connection));
-        return false;
-    }
-
-    MYSQL_RES *result = mysql_store_result(connection);
-    if (!result) {
-        printf("ERREUR: Impossible de stocker le résultat de la requête\n");
-        return false;
+static CoTask<bool> verifyExistingPatient(MYSQL *connection, int patientId, const string &lastName, const string &firstName) {
+    DalParam params[] = {DalNumber(patientId), DalText(lastName), DalText(firstName)};
+    DalRows *rows = co_await dbSelect(connection, DAL_PATIENT_VERIFY, params);
+    if (!rows) {
+        printf("ERREUR: Échec de la vérification du patient\n");
+        co_return false;
     }
 
-    bool patientExists = (mysql_num_rows(result) > 0);
-    mysql_free_result(result);
-    return patientExists;
+    bool patientExists = (DalRowsCount(rows) > 0);
+    DalRowsFree(rows);
+    co_return patientExists;
 }
 
 // ============================================================================
-// COMMUNICATION RÉSEAU
+// ÉTAPE BASE DE DONNÉES
 // ============================================================================
 
 /**
- * Envoie une réponse au client
- * @param clientSocket Socket de communication avec le client
- * @param response Message de réponse à envoyer
+ * Exécute une requête SELECT et garde ses lignes pour l'encodage
+ * @param command Commande (rows ou failure renseigné)
+ * @param statement Requête
+ * @param params Paramètres, dans l'ordre des ?
+ * @param label Données demandées (pour les traces)
  */
-static void sendResponse(int clientSocket, const string &response) {
-    int result = Send(clientSocket, response.c_str(), response.length());
-    if (result < 0) {
-        printf("ERREUR: Impossible d'envoyer la réponse au client\n");
+static CoTask<void> queryRows(Command &command, DalStatement statement, const DalParam *params,
+                              const char *label) {
+    DbLease db(co_await acquireConnection());
+    MYSQL *connection = db.connection;
+    if (!connection) {
+        command.failure = DB;
+        printf("ERREUR: Aucune connexion à la base de données disponible\n");
+        co_return;
     }
-}
 
-// ============================================================================
-// GESTION DES REQUÊTES CLIENT
-// ============================================================================
+    // Lignes recopiées hors de la connexion : elle est rendue avant l'encodage
+    command.rows = co_await dbSelect(connection, statement, params);
+    if (!command.rows) {
+        command.failure = DB;
+        printf("ERREUR: Échec de la requête %s\n", label);
+    }
+}
 
 /**
- * Gère la connexion d'un nouveau patient
- * @param connection Connexion à la base de données
- * @param clientSocket Socket de communication avec le client
- * @param lastName Nom de famille du patient
- * @param firstName Prénom du patient
+ * Crée un nouveau patient
+ * @param command Commande LOGIN_NEW (patientId ou failure renseigné)
  */
-static void handleLoginNew(MYSQL *connection, int clientSocket, const string &lastName, const string &firstName) {
-    printf("Traitement LOGIN_NEW pour %s %s\n", lastName.c_str(), firstName.c_str());
+static CoTask<void> queryLoginNew(Command &command) {
+    printf("Traitement LOGIN_NEW pour %s %s\n", command.lastName.c_str(), command.firstName.c_str());
+
+    DbLease db(co_await acquireConnection());
+    MYSQL *connection = db.connection;
+    if (!connection) {
+        command.failure = DB;
+        printf("ERREUR: Aucune connexion à la base de données disponible\n");
+        co_return;
+    }
 
-    int patientId = createNewPatient(connection, lastName, firstName);
+    int patientId = co_await createNewPatient(connection, command.lastName, command.firstName);
     if (patientId > 0) {
-        // Succès : envoyer l'ID du nouveau patient
-        string response = string(LOGIN_OK) + to_string(patientId);
-        sendResponse(clientSocket, response);
+        command.patientId = patientId;
         printf("Nouveau patient créé avec ID: %d\n", patientId);
-
-        // Vérification optionnelle de la création
-        char query[QUERY_SIZE];
-        snprintf(query, sizeof(query), 
-                 "SELECT id, last_name, first_name FROM patients WHERE id=%d", patientId);
-        if (mysql_query(connection, query) == 0) {
-            MYSQL_RES *result = mysql_store_result(connection);
-            if (result && mysql_num_rows(result) > 0) {
-                MYSQL_ROW row = mysql_fetch_row(result);
-                printf("Vérification: Patient ID=%s, Nom=%s, Prénom=%s\n", 
-                       row[0], row[1], row[2]);
+        if (patientDirectory) {
+            int homonyms = PatientDirectoryCountByName(patientDirectory, command.lastName, command.firstName);
+            if (homonyms > 0) {
+                printf("Note: %d patient(s) déjà inscrit(s) sous le nom %s %s\n", homonyms,
+                       command.lastName.c_str(), command.firstName.c_str());
             }
-            mysql_free_result(result);
+            PatientDirectoryAdd(patientDirectory, patientId, command.lastName, command.firstName);
         }
     } else {
-        // Échec : envoyer message d'erreur
-        sendResponse(clientSocket, string(LOGIN_FAIL) + INSERT);
-        printf("ERREUR: Échec de la création du patient %s %s\n", 
-               lastName.c_str(), firstName.c_str());
+        command.failure = INSERT;
+        printf("ERREUR: Échec de la création du patient %s %s\n",
+               command.lastName.c_str(), command.firstName.c_str());
     }
 }
 
 /**
- * Gère la connexion d'un patient existant
- * @param connection Connexion à la base de données
- * @param clientSocket Socket de communication avec le client
- * @param patientId ID du patient à vérifier
- * @param lastName Nom de famille du patient
- * @param firstName Prénom du patient
+ * Vérifie un patient existant dans la base (l'annuaire n'a pas pu conclure,
+ * voir lookupPatient)
+ * @param command Commande LOGIN_EXIST (failure renseigné en cas d'échec)
  */
-static void handleLoginExist(MYSQL *connection, int clientSocket, int patientId, const string &lastName, const string &firstName) {
-    printf("Traitement LOGIN_EXIST pour ID=%d, %s %s\n", patientId, lastName.c_str(), firstName.c_str());
+static CoTask<void> queryLoginExist(Command &command) {
+    printf("Traitement LOGIN_EXIST pour ID=%d, %s %s\n", command.patientId,
+           command.lastName.c_str(), command.firstName.c_str());
+
+    DbLease db(co_await acquireConnection());
+    MYSQL *connection = db.connection;
+    if (!connection) {
+        command.failure = DB;
+        printf("ERREUR: Aucune connexion à la base de données disponible\n");
+        co_return;
+    }
 
-    if (verifyExistingPatient(connection, patientId, lastName, firstName)) {
-        // Succès : patient trouvé et vérifié
-        string response = string(LOGIN_OK) + to_string(patientId);
-        sendResponse(clientSocket, response);
-        printf("Patient existant vérifié avec succès (ID: %d)\n", patientId);
+    if (co_await verifyExistingPatient(connection, command.patientId, command.lastName, command.firstName)) {
+        printf("Patient existant vérifié avec succès (ID: %d)\n", command.patientId);
+        if (patientDirectory) {
+            PatientDirectoryAdd(patientDirectory, command.patientId, command.lastName, command.firstName);
+        }
     } else {
-        // Échec : patient non trouvé ou données incorrectes
-        sendResponse(clientSocket, string(LOGIN_FAIL) + NOT_FOUND);
-        printf("ERREUR: Patient non trouvé ou données incorrectes (ID: %d, %s %s)\n", 
-               patientId, lastName.c_str(), firstName.c_str());
+        command.failure = NOT_FOUND;
+        printf("ERREUR: Patient non trouvé ou données incorrectes (ID: %d, %s %s)\n",
+               command.patientId, command.lastName.c_str(), command.firstName.c_str());
     }
 }
 
 /**
- * Gère la recherche de consultations disponibles
- * @param connection Connexion à la base de données
- * @param clientSocket Socket de communication avec le client
- * @param specialty Spécialité recherchée (ou "--- TOUTES ---")
- * @param doctor Médecin recherché (ou "--- TOUS ---")
- * @param startDate Date de début de recherche
- * @param endDate Date de fin de recherche
+ * Ajoute une consultation lue à une réponse SEARCH (voir DalStream)
+ * @param context Réponse (SearchStream)
+ * @param row Consultation
+ * @return 0, ou -1 si le client ne reçoit plus
  */
-static void handleSearch(MYSQL *connection, int clientSocket, const string &specialty, const string &doctor, const string &startDate, const string &endDate) {
-    printf("Traitement SEARCH: specialty=%s, doctor=%s, startDate=%s, endDate=%s\n",
-           specialty.c_str(), doctor.c_str(), startDate.c_str(), endDate.c_str());
-
-    // Construction de la requête SQL de base
-    string query = "SELECT c.id, s.name, CONCAT(d.first_name, ' ', d.last_name), c.date, c.hour ";
-    query += "FROM consultations c ";
-    query += "JOIN doctors d ON c.doctor_id = d.id ";
-    query += "JOIN specialties s ON d.specialty_id = s.id ";
-    query += "WHERE c.patient_id IS NULL "; // Seulement les créneaux libres
-
-    // Ajout des filtres selon les critères
-    if (specialty != TOUTES) {
-        query += "AND s.name = '" + specialty + "' ";
-    }
-    if (doctor != TOUS) {
-        query += "AND CONCAT(d.first_name, ' ', d.last_name) = '" + doctor + "' ";
+static int streamSearchRow(void *context, const DalRow *row) {
+    if (row->nbFields < SEARCH_FIELDS) {
+        return -1;
     }
-    query += "AND c.date BETWEEN '" + startDate + "' AND '" + endDate + "' ";
-    query += "ORDER BY c.date, c.hour";
-
-    printf("Requête SQL: %s\n", query.c_str());
+    return SearchStreamAdd((SearchStream *)context, row->fields, row->lengths);
+}
 
-    // Exécution de la requête
-    if (mysql_query(connection, query.c_str()) != 0) {
-        sendResponse(clientSocket, string(SEARCH_FAIL) + DB);
-        printf("ERREUR: Échec de la requête SQL: %s\n", mysql_error(connection));
-        return;
+/**
+ * Exécute une recherche en envoyant ses lignes au client à mesure qu'elles
+ * arrivent de MySQL (mode thread par session, où le socket n'est écrit que
+ * par ce thread). Une erreur avant le premier envoi donne SEARCH_FAIL ;
+ * après, la réponse commencée ne peut plus devenir un échec : la connexion
+ * est coupée sans la dernière trame, et le client, qui l'attend encore, sait
+ * que la liste reçue est incomplète.
+ * @param command Commande SEARCH (streamed ou failure renseigné)
+ * @param statement Requête
+ * @param params Paramètres, dans l'ordre des ?
+ */
+static CoTask<void> streamSearch(Command &command, DalStatement statement, const DalParam *params) {
+    DbLease db(co_await acquireConnection());
+    MYSQL *connection = db.connection;
+    if (!connection) {
+        command.failure = DB;
+        printf("ERREUR: Aucune connexion à la base de données disponible\n");
+        co_return;
     }
 
-    // Récupération des résultats
-    MYSQL_RES *result = mysql_store_result(connection);
-    if (!result) {
-        sendResponse(clientSocket, string(SEARCH_FAIL) + DB);
-        printf("ERREUR: Impossible de stocker le résultat de la requête\n");
-        return;
+    SearchStream stream;
+    SearchStreamInit(&stream, command.streamSocket, SEARCH_OK);
+
+    long long nbRows = DalStream(dal, connection, statement, params, streamSearchRow, &stream);
+    if (nbRows < 0 && !stream.flushed) {
+        command.failure = DB;
+        printf("ERREUR: Échec de la requête consultations\n");
+    } else if (nbRows < 0) {
+        command.streamed = true;
+        printf("ERREUR: Recherche interrompue après %d consultation(s), connexion coupée\n",
+               stream.nbRows);
+        shutdown(command.streamSocket, SHUT_RDWR);
+    } else {
+        command.streamed = true;
+        int sent = SearchStreamFinish(&stream);
+        if (sent < 0) {
+            // Réponse tronquée : le flux est perdu
+            printf("ERREUR: Impossible d'envoyer la réponse au client, connexion coupée\n");
+            shutdown(command.streamSocket, SHUT_RDWR);
+        } else {
+            printf("Réponse envoyée au fil de la lecture: %d consultation(s), %d octets\n",
+                   stream.nbRows, sent);
+        }
     }
+}
 
-    // Construction de la réponse
-    string response = SEARCH_OK;
-    int numRows = mysql_num_rows(result);
-    printf("Nombre de consultations trouvées: %d\n", numRows);
-
-    if (numRows == 0) {
-        sendResponse(clientSocket, response);
-        mysql_free_result(result);
-        return;
+/**
+ * Recherche les consultations disponibles
+ * @param command Commande SEARCH (rows, streamed ou failure renseigné)
+ */
+static CoTask<void> querySearch(Command &command) {
+    printf("Traitement SEARCH: specialty=%s, doctor=%s, startDate=%s, endDate=%s\n",
+           command.specialty.c_str(), command.doctor.c_str(),
+           command.startDate.c_str(), command.endDate.c_str());
+
+    // Une requête préparée par combinaison de filtres, période en dernier
+    bool bySpecialty = command.specialty != TOUTES;
+    bool byDoctor = command.doctor != TOUS;
+    DalStatement statement = bySpecialty ? (byDoctor ? DAL_SEARCH_SPECIALTY_DOCTOR : DAL_SEARCH_SPECIALTY)
+                                         : (byDoctor ? DAL_SEARCH_DOCTOR : DAL_SEARCH);
+    DalParam params[4];
+    int nbParams = 0;
+    if (bySpecialty) {
+        params[nbParams++] = DalText(command.specialty);
     }
-
-    // Formatage des résultats : ID;SPECIALTY;DOCTOR;DATE;HOUR
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result))) {
-        if (!response.empty() && response.back() != ';') {
-            response += "|";
-        }
-        response += string(row[0]) + ";" + string(row[1]) + ";" + 
-                   string(row[2]) + ";" + string(row[3]) + ";" + string(row[4]);
+    if (byDoctor) {
+        params[nbParams++] = DalText(command.doctor);
     }
+    params[nbParams++] = DalText(command.startDate);
+    params[nbParams++] = DalText(command.endDate);
 
-    mysql_free_result(result);
-    sendResponse(clientSocket, response);
-    printf("Réponse envoyée: %s\n", response.c_str());
+    if (command.streamSocket >= 0 && !CoScheduled()) {
+        co_await streamSearch(command, statement, params);
+    } else {
+        co_await queryRows(command, statement, params, "consultations");
+    }
 }
 
 /**
- * Gère la récupération de la liste des spécialités
- * @param connection Connexion à la base de données
- * @param clientSocket Socket de communication avec le client
+ * Récupère la liste des médecins
+ * @param command Commande GET_DOCTORS (rows ou failure renseigné)
  */
-static void handleGetSpecialties(MYSQL *connection, int clientSocket) {
-    printf("Traitement GET_SPECIALTIES\n");
+static CoTask<void> queryDoctors(Command &command) {
+    printf("Traitement GET_DOCTORS pour spécialité: %s\n", command.specialty.c_str());
 
-    string query = "SELECT name FROM specialties ORDER BY name";
-
-    if (mysql_query(connection, query.c_str()) != 0) {
-        sendResponse(clientSocket, "SPECIALTIES_FAIL;DB");
-        printf("ERREUR: Échec de la requête spécialités: %s\n", mysql_error(connection));
-        return;
+    if (command.specialty != TOUS) {
+        DalParam params[] = {DalText(command.specialty)};
+        co_await queryRows(command, DAL_DOCTORS_SPECIALTY, params, "médecins");
+    } else {
+        co_await queryRows(command, DAL_DOCTORS, NULL, "médecins");
     }
+}
 
-    MYSQL_RES *result = mysql_store_result(connection);
-    if (!result) {
-        sendResponse(clientSocket, "SPECIALTIES_FAIL;DB");
-        printf("ERREUR: Impossible de stocker le résultat spécialités\n");
-        return;
-    }
+/**
+ * Réserve une consultation. La demande passe par le moteur de réservation,
+ * qui la valide dans la même transaction que les réservations simultanées.
+ * @param command Commande BOOK_CONSULTATION (failure renseigné en cas d'échec)
+ */
+static CoTask<void> queryBookConsultation(Command &command) {
+    int consultationId = command.consultationId;
+    int patientId = command.patientId;
+    printf("Traitement BOOK_CONSULTATION pour consultation ID=%d, patient ID=%d\n", consultationId, patientId);
 
-    // Construction de la réponse : SPECIALTIES_OK;SPEC1|SPEC2|SPEC3
-    string response = SPECIALTIES_OK;
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result))) {
-        if (!response.empty() && response.back() != ';') {
-            response += "|";
+    BookingRequest request;
+    request.consultationId = consultationId;
+    request.patientId = patientId;
+    request.reason = command.reason.c_str();
+    request.reasonLength = command.reason.length();
+    request.notifyFd = -1;
+    BookingResult result;
+    if (!CoScheduled()) {
+        BookingSubmit(bookingEngine, &request);
+        result = BookingWait(bookingEngine, &request);
+    } else {
+        // La coroutine attend l'eventfd sans bloquer son thread. La demande
+        // appartient au moteur jusqu'à ce que la lecture réussisse : un
+        // réveil sans signal est suivi d'une nouvelle attente
+        request.notifyFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (request.notifyFd < 0) {
+            command.failure = DB;
+            perror("ERREUR: Impossible de créer l'eventfd de réservation");
+            co_return;
+        }
+        BookingSubmit(bookingEngine, &request);
+        uint64_t value;
+        bool suspendable = true;
+        while (read(request.notifyFd, &value, sizeof(value)) < 0) {
+            if (errno != EAGAIN && errno != EINTR) {
+                perror("ERREUR: Impossible de lire l'eventfd de réservation");
+                break;
+            }
+            if (suspendable && co_await CoWait(request.notifyFd, EPOLLIN) < 0) {
+                // eventfd non surveillé : attente bloquante, faute de mieux
+                printf("ATTENTION: Attente bloquante de la réservation %d\n", consultationId);
+                suspendable = false;
+            }
+            if (!suspendable) {
+                struct pollfd attente = {request.notifyFd, POLLIN, 0};
+                poll(&attente, 1, -1);
+            }
         }
-        response += string(row[0]);
+        close(request.notifyFd);
+        result = request.result;
     }
 
-    mysql_free_result(result);
-    sendResponse(clientSocket, response);
-    printf("Spécialités envoyées: %s\n", response.c_str());
+    switch (result) {
+        case BOOKING_OK:
+            printf("SUCCÈS: Consultation %d réservée pour le patient %d (raison: %s)\n",
+                   consultationId, patientId, command.reason.c_str());
+            break;
+        case BOOKING_TAKEN:
+            command.failure = ALREADY_BOOKED;
+            printf("ERREUR: Consultation %d déjà réservée\n", consultationId);
+            break;
+        case BOOKING_NOT_FOUND:
+            command.failure = NOT_FOUND;
+            printf("ERREUR: Consultation %d non trouvée\n", consultationId);
+            break;
+        case BOOKING_ERROR:
+            command.failure = DB;
+            printf("ERREUR: Échec de la réservation de la consultation %d\n", consultationId);
+            break;
+    }
 }
 
 /**
- * Gère la récupération de la liste des médecins
- * @param connection Connexion à la base de données
- * @param clientSocket Socket de communication avec le client
- * @param specialty Spécialité pour filtrer les médecins (ou "--- TOUS ---")
+ * Étape base de données : exécute les requêtes SQL d'une commande analysée
+ * (bloquantes avec CoRunSync sur les threads de l'étape base de données,
+ * suspensives dans une session en coroutine)
+ * @param command Commande analysée, complétée par son résultat
  */
-static void handleGetDoctors(MYSQL *connection, int clientSocket, const string &specialty) {
-    printf("Traitement GET_DOCTORS pour spécialité: %s\n", specialty.c_str());
+static CoTask<void> queryCommand(Command &command) {
+    if (command.answered) {
+        co_return;
+    }
+    switch (command.type) {
+        case COMMAND_LOGIN_NEW:
+            co_await queryLoginNew(command);
+            break;
+        case COMMAND_LOGIN_EXIST:
+            co_await queryLoginExist(command);
+            break;
+        case COMMAND_SEARCH:
+            co_await querySearch(command);
+            break;
+        case COMMAND_GET_SPECIALTIES:
+            printf("Traitement GET_SPECIALTIES\n");
+            co_await queryRows(command, DAL_SPECIALTIES, NULL, "spécialités");
+            break;
+        case COMMAND_GET_DOCTORS:
+            co_await queryDoctors(command);
+            break;
+        case COMMAND_BOOK_CONSULTATION:
+            co_await queryBookConsultation(command);
+            break;
+        case COMMAND_INVALID:
+            break;
+    }
+}
 
-    // Construction de la requête SQL
-    string query = "SELECT CONCAT(d.first_name, ' ', d.last_name) ";
-    query += "FROM doctors d ";
-    query += "JOIN specialties s ON d.specialty_id = s.id ";
-    
-    // Ajout du filtre de spécialité si nécessaire
-    if (specialty != TOUS) {
-        query += "WHERE s.name = '" + specialty + "' ";
+// ============================================================================
+// ÉTAPE D'ENCODAGE
+// ============================================================================
+
+/**
+ * Envoie une réponse au client
+ * @param clientSocket Socket de communication avec le client
+ * @param response Message de réponse à envoyer
+ */
+static void sendResponse(int clientSocket, const string &response) {
+    int result = Send(clientSocket, response.c_str(), response.length());
+    if (result < 0) {
+        printf("ERREUR: Impossible d'envoyer la réponse au client\n");
     }
-    query += "ORDER BY d.last_name, d.first_name";
+}
 
-    printf("Requête SQL GET_DOCTORS: %s\n", query.c_str());
+/**
+ * Encode le résultat d'une recherche, directement depuis les champs du
+ * résultat et sans concaténation : SEARCH_OK;ID;SPECIALTY;DOCTOR;DATE;HOUR|...
+ * Au-delà de TAILLE_MAX, la réponse est découpée en trames (voir ChunkWriter)
+ * @param clientSocket Socket de communication avec le client
+ * @param rows Lignes trouvées
+ */
+static void encodeSearch(int clientSocket, const DalRows *rows) {
+    int numRows = DalRowsCount(rows);
+    printf("Nombre de consultations trouvées: %d\n", numRows);
 
-    // Exécution de la requête
-    if (mysql_query(connection, query.c_str()) != 0) {
-        sendResponse(clientSocket, "DOCTORS_FAIL;DB");
-        printf("ERREUR: Échec de la requête médecins: %s\n", mysql_error(connection));
-        return;
+    ChunkWriter writer;
+    ChunkWriterInit(&writer, clientSocket);
+    struct iovec entete = {(void *)SEARCH_OK, strlen(SEARCH_OK)};
+    ChunkWriterAppend(&writer, &entete, 1);
+
+    // Chaque ligne est ajoutée d'un bloc pour ne pas être coupée
+    for (int row = 0; row < numRows; row++) {
+        const char *fields[SEARCH_FIELDS];
+        unsigned long lengths[SEARCH_FIELDS];
+        for (int i = 0; i < SEARCH_FIELDS; i++) {
+            fields[i] = DalRowsField(rows, row, i, &lengths[i]);
+        }
+        struct iovec ligne[2 * SEARCH_FIELDS];
+        int nbTampons = SearchLine(fields, lengths, row == 0, ligne);
+        if (ChunkWriterAppend(&writer, ligne, nbTampons) < 0) {
+            break;
+        }
     }
 
-    // Récupération des résultats
-    MYSQL_RES *result = mysql_store_result(connection);
-    if (!result) {
-        sendResponse(clientSocket, "DOCTORS_FAIL;DB");
-        printf("ERREUR: Impossible de stocker le résultat médecins\n");
+    // Les champs restent valides jusqu'à la libération des lignes (appelant)
+    int sent = ChunkWriterFinish(&writer);
+    if (sent < 0) {
+        printf("ERREUR: Impossible d'envoyer la réponse au client\n");
         return;
     }
+    printf("Réponse envoyée: %d consultation(s), %d octets\n", numRows, sent);
+}
 
-    // Construction de la réponse : DOCTORS_OK;DOC1|DOC2|DOC3
-    string response = DOCTORS_OK;
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result))) {
+/**
+ * Encode une liste à une colonne : PREFIXE;VALEUR1|VALEUR2|VALEUR3
+ * @param prefix Préfixe de la réponse (SPECIALTIES_OK, DOCTORS_OK)
+ * @param rows Lignes trouvées
+ * @return Réponse construite
+ */
+static string encodeList(const char *prefix, const DalRows *rows) {
+    string response = prefix;
+    for (int row = 0; row < DalRowsCount(rows); row++) {
         if (!response.empty() && response.back() != ';') {
             response += "|";
         }
-        response += string(row[0]);
+        unsigned long length;
+        const char *field = DalRowsField(rows, row, 0, &length);
+        response.append(field ? field : "", length);
     }
-
-    mysql_free_result(result);
-    sendResponse(clientSocket, response);
-    printf("Médecins envoyés: %s\n", response.c_str());
+    return response;
 }
 
 /**
- * Gère la réservation d'une consultation
- * @param connection Connexion à la base de données
- * @param clientSocket Socket de communication avec le client
- * @param consultationId ID de la consultation à réserver
- * @param patientId ID du patient qui réserve
- * @param reason Raison de la consultation
+ * Clé d'une liste de référence dans le cache (commande et filtre)
+ * @param command Commande GET_SPECIALTIES ou GET_DOCTORS
+ * @return Clé
  */
-static void handleBookConsultation(MYSQL *connection, int clientSocket, int consultationId, int patientId, const string &reason) {
-    printf("Traitement BOOK_CONSULTATION pour consultation ID=%d, patient ID=%d\n", consultationId, patientId);
-
-    // Étape 1: Vérifier que la consultation existe et est libre
-    char query[QUERY_SIZE];
-    snprintf(query, sizeof(query), "SELECT id, patient_id FROM consultations WHERE id=%d", consultationId);
-
-    if (mysql_query(connection, query) != 0) {
-        sendResponse(clientSocket, string(BOOK_FAIL) + DB);
-        printf("ERREUR: Échec de la vérification de la consultation: %s\n", mysql_error(connection));
-        return;
+static string referenceKey(const Command &command) {
+    if (command.type == COMMAND_GET_SPECIALTIES) {
+        return GET_SPECIALTIES;
     }
+    return "GET_DOCTORS;" + command.specialty;
+}
 
-    MYSQL_RES *result = mysql_store_result(connection);
-    if (!result) {
-        sendResponse(clientSocket, string(BOOK_FAIL) + DB);
-        printf("ERREUR: Impossible de stocker le résultat de vérification\n");
-        return;
+/**
+ * Envoie une liste de référence en un seul envoi : la réponse du cache telle
+ * quelle, ou celle encodée depuis les lignes lues, gardée pour les suivantes
+ * @param clientSocket Socket de communication avec le client
+ * @param command Commande GET_SPECIALTIES ou GET_DOCTORS (cached renseigné)
+ * @param prefix Préfixe de la réponse
+ */
+static void encodeReference(int clientSocket, Command &command, const char *prefix) {
+    if (!command.cached) {
+        command.cached = make_shared<const string>(encodeList(prefix, command.rows));
+        if (referenceCache) {
+            ReferenceCachePut(referenceCache, referenceKey(command), command.cacheGeneration, command.cached);
+        }
     }
+    sendResponse(clientSocket, *command.cached);
+}
 
-    // Vérifier si la consultation existe
-    if (mysql_num_rows(result) == 0) {
-        mysql_free_result(result);
-        sendResponse(clientSocket, string(BOOK_FAIL) + NOT_FOUND);
-        printf("ERREUR: Consultation %d non trouvée\n", consultationId);
-        return;
-    }
+/**
+ * Étape d'encodage : construit la réponse d'une commande et l'envoie (ou la
+ * capture, dans les modes multiplexés), puis libère ses lignes
+ * @param clientSocket Socket de communication avec le client
+ * @param command Commande complétée par l'étape base de données
+ */
+static void encodeCommand(int clientSocket, Command &command) {
+    const char *failure = command.failure;
+    switch (command.type) {
+        case COMMAND_INVALID:
+            sendResponse(clientSocket, command.reply);
+            break;
+        case COMMAND_LOGIN_NEW:
+        case COMMAND_LOGIN_EXIST:
+            if (failure) {
+                sendResponse(clientSocket, string(LOGIN_FAIL) + failure);
+            } else {
+                sendResponse(clientSocket, string(LOGIN_OK) + to_string(command.patientId));
+            }
+            break;
+        case COMMAND_SEARCH:
+            if (failure) {
+                sendResponse(clientSocket, string(SEARCH_FAIL) + failure);
+            } else if (!command.streamed) {
+                encodeSearch(clientSocket, command.rows);
+            }
+            break;
+        case COMMAND_GET_SPECIALTIES:
+            if (failure) {
+                sendResponse(clientSocket, string(SPECIALTIES_FAIL) + failure);
+            } else {
+                encodeReference(clientSocket, command, SPECIALTIES_OK);
+                printf("Spécialités envoyées: %s\n", command.cached->c_str());
+            }
+            break;
+        case COMMAND_GET_DOCTORS:
+            if (failure) {
+                sendResponse(clientSocket, string(DOCTORS_FAIL) + failure);
+            } else {
+                encodeReference(clientSocket, command, DOCTORS_OK);
+                printf("Médecins envoyés: %s\n", command.cached->c_str());
+            }
+            break;
+        case COMMAND_BOOK_CONSULTATION:
+            sendResponse(clientSocket, failure ? string(BOOK_FAIL) + failure : string(BOOK_OK));
+            break;
+    }
+
+    DalRowsFree(command.rows);
+    command.rows = NULL;
+}
+
+// ============================================================================
+// ÉTAPE D'ANALYSE
+// ============================================================================
+
+/**
+ * Nombre de caractères d'un texte UTF-8 (longueur comptée par MySQL)
+ * @param text Texte UTF-8
+ * @return Caractères du texte (octets de continuation non comptés)
+ */
+static size_t utf8Length(const string &text) {
+    size_t length = 0;
+    for (unsigned char c : text) {
+        if ((c & 0xC0) != 0x80) {
+            length++;
+        }
+    }
+    return length;
+}
+
+/**
+ * Analyse une commande CBP reçue (sans accès à la base de données)
+ * @param ip Adresse IP du client (pour les traces)
+ * @param buffer Message reçu (sans le délimiteur)
+ * @param command Commande à remplir (COMMAND_INVALID et réponse immédiate
+ *                si le message est mal formé ou inconnu)
+ */
+static void parseCommand(const char *ip, const char *buffer, Command &command) {
+    string message(buffer);
+    printf("Message reçu de %s: %s\n", ip, buffer);
+    command.type = COMMAND_INVALID;
+
+    // ================================================================
+    // PARSING DES COMMANDES CBP
+    // ================================================================
+
+    // Commande: LOGIN_NEW (nouveau patient)
+    if (message.find(LOGIN_NEW) == 0) {
+        // Format: LOGIN_NEW;NOM;PRENOM
+        size_t pos1 = message.find(';', LOGIN_NEW_LENGTH);
+        if (pos1 != string::npos) {
+            command.type = COMMAND_LOGIN_NEW;
+            command.lastName = message.substr(LOGIN_NEW_LENGTH, pos1 - LOGIN_NEW_LENGTH);
+            command.firstName = message.substr(pos1 + 1);
+        } else {
+            command.reply = string(LOGIN_FAIL) + FORMAT;
+        }
+    }
+    // Commande: LOGIN_EXIST (patient existant)
+    else if (message.find(LOGIN_EXIST) == 0) {
+        // Format: LOGIN_EXIST;ID;NOM;PRENOM
+        size_t pos1 = message.find(';', LOGIN_EXIST_LENGTH);
+        size_t pos2 = message.find(';', pos1 + 1);
+        if (pos1 != string::npos && pos2 != string::npos) {
+            command.type = COMMAND_LOGIN_EXIST;
+            command.patientId = atoi(message.substr(LOGIN_EXIST_LENGTH, pos1 - LOGIN_EXIST_LENGTH).c_str());
+            command.lastName = message.substr(pos1 + 1, pos2 - pos1 - 1);
+            command.firstName = message.substr(pos2 + 1);
+        } else {
+            command.reply = string(LOGIN_FAIL) + FORMAT;
+        }
+    }
+    // Commande: SEARCH (recherche de consultations)
+    else if (message.find(SEARCH) == 0) {
+        // Format: SEARCH;SPECIALTY;DOCTOR;START_DATE;END_DATE
+        size_t pos1 = message.find(';', SEARCH_LENGTH);
+        size_t pos2 = message.find(';', pos1 + 1);
+        size_t pos3 = message.find(';', pos2 + 1);
+
+        if (pos1 != string::npos && pos2 != string::npos && pos3 != string::npos) {
+            command.type = COMMAND_SEARCH;
+            command.specialty = message.substr(SEARCH_LENGTH, pos1 - SEARCH_LENGTH);
+            command.doctor = message.substr(pos1 + 1, pos2 - pos1 - 1);
+            command.startDate = message.substr(pos2 + 1, pos3 - pos2 - 1);
+            command.endDate = message.substr(pos3 + 1);
+        } else {
+            command.reply = string(SEARCH_FAIL) + FORMAT;
+        }
+    }
+    // Commande: GET_SPECIALTIES (liste des spécialités)
+    else if (message.find(GET_SPECIALTIES) == 0) {
+        command.type = COMMAND_GET_SPECIALTIES;
+    }
+    // Commande: GET_DOCTORS (liste des médecins)
+    else if (message.find("GET_DOCTORS;") == 0) {
+        // Format: GET_DOCTORS;SPECIALTY
+        command.type = COMMAND_GET_DOCTORS;
+        command.specialty = message.substr(GET_DOCTORS_LENGTH);
+    }
+    // Commande: BOOK_CONSULTATION (réservation de consultation)
+    else if (message.find("BOOK_CONSULTATION;") == 0) {
+        // Format: BOOK_CONSULTATION;CONSULTATION_ID;PATIENT_ID;REASON
+        size_t pos1 = message.find(';', BOOK_CONSULTATION_LENGTH);
+        size_t pos2 = message.find(';', pos1 + 1);
+
+        if (pos1 != string::npos && pos2 != string::npos) {
+            command.type = COMMAND_BOOK_CONSULTATION;
+            command.consultationId = atoi(message.substr(BOOK_CONSULTATION_LENGTH, pos1 - BOOK_CONSULTATION_LENGTH).c_str());
+            command.patientId = atoi(message.substr(pos1 + 1, pos2 - pos1 - 1).c_str());
+            command.reason = message.substr(pos2 + 1);
+            // Une demande que MySQL refuserait (patient inexistant, motif
+            // trop long) n'entre pas dans un lot de réservations
+            if (command.consultationId <= 0 || command.patientId <= 0 ||
+                utf8Length(command.reason) > MAX_REASON_LENGTH) {
+                command.type = COMMAND_INVALID;
+                command.reply = string(BOOK_FAIL) + FORMAT;
+            }
+        } else {
+            command.reply = string(BOOK_FAIL) + FORMAT;
+        }
+    }
+    // Commande inconnue
+    else {
+        command.reply = string(LOGIN_FAIL) + UNKNOWN_CMD;
+        printf("ERREUR: Commande inconnue reçue: %s\n", message.c_str());
+    }
+}
 
-    // Vérifier si la consultation est déjà réservée
-    MYSQL_ROW row = mysql_fetch_row(result);
-    if (row[1] != NULL) { // patient_id n'est pas NULL = déjà réservée
-        mysql_free_result(result);
-        sendResponse(clientSocket, string(BOOK_FAIL) + ALREADY_BOOKED);
-        printf("ERREUR: Consultation %d déjà réservée par le patient %s\n", consultationId, row[1]);
+/**
+ * Répond à LOGIN_EXIST depuis l'annuaire des patients quand il peut
+ * conclure seul : la commande ne passe alors pas par la base (ni par le
+ * contrôle d'admission, puisqu'elle ne coûte rien à MySQL)
+ * @param command Commande analysée (answered, et failure si le patient est inconnu)
+ */
+static void lookupPatient(Command &command) {
+    if (!patientDirectory || command.type != COMMAND_LOGIN_EXIST) {
         return;
     }
 
-    mysql_free_result(result);
+    switch (PatientDirectoryVerify(patientDirectory, command.patientId, command.lastName, command.firstName)) {
+        case PATIENT_KNOWN:
+            command.answered = true;
+            printf("Patient existant vérifié dans l'annuaire (ID: %d)\n", command.patientId);
+            break;
+        case PATIENT_UNKNOWN:
+            command.answered = true;
+            command.failure = NOT_FOUND;
+            printf("ERREUR: Identifiant de patient impossible (ID: %d, %s %s)\n",
+                   command.patientId, command.lastName.c_str(), command.firstName.c_str());
+            break;
+        case PATIENT_UNSURE:
+            break;
+    }
+}
 
-    // Étape 2: Effectuer la réservation
-    snprintf(query, sizeof(query), 
-             "UPDATE consultations SET patient_id=%d, reason='%s' WHERE id=%d",
-             patientId, reason.c_str(), consultationId);
+/**
+ * Reprend du cache la réponse d'une liste de référence : la commande ne passe
+ * alors ni par la base ni par le contrôle d'admission
+ * @param command Commande analysée (answered et cached si la réponse est connue)
+ */
+static void lookupReference(Command &command) {
+    if (!referenceCache ||
+        (command.type != COMMAND_GET_SPECIALTIES && command.type != COMMAND_GET_DOCTORS)) {
+        return;
+    }
+    command.cached = ReferenceCacheGet(referenceCache, referenceKey(command), &command.cacheGeneration);
+    command.answered = command.cached != nullptr;
+}
 
-    if (mysql_query(connection, query) != 0) {
-        sendResponse(clientSocket, string(BOOK_FAIL) + DB);
-        printf("ERREUR: Échec de la réservation: %s\n", mysql_error(connection));
+/**
+ * Refuse une commande analysée quand le serveur est surchargé : elle reçoit
+ * aussitôt BUSY;retry_ms, sans passer par la base. Les recherches sont
+ * refusées les premières, les réservations jamais.
+ * @param command Commande analysée (COMMAND_INVALID et réponse BUSY si refusée)
+ */
+static void admitCommand(Command &command) {
+    if (!admission || command.type == COMMAND_INVALID || command.answered) {
         return;
     }
 
-    // Vérifier que la mise à jour a bien eu lieu
-    if (mysql_affected_rows(connection) > 0) {
-        sendResponse(clientSocket, BOOK_OK);
-        printf("SUCCÈS: Consultation %d réservée pour le patient %d (raison: %s)\n", 
-               consultationId, patientId, reason.c_str());
-    } else {
-        sendResponse(clientSocket, string(BOOK_FAIL) + UPDATE_FAILED);
-        printf("ERREUR: Aucune ligne mise à jour lors de la réservation\n");
+    AdmissionClass workClass = ADMISSION_QUERY;
+    if (command.type == COMMAND_SEARCH) {
+        workClass = ADMISSION_SEARCH;
+    } else if (command.type == COMMAND_BOOK_CONSULTATION) {
+        workClass = ADMISSION_BOOK;
     }
+    int retryMs = AdmissionCheck(admission, workClass);
+    if (retryMs > 0) {
+        command.type = COMMAND_INVALID;
+        command.reply = string(BUSY) + to_string(retryMs);
+    }
+}
+
+/**
+ * Traite une commande de bout en bout sur le thread appelant (mode thread
+ * par session, où le thread est de toute façon dédié à la connexion)
+ * @param clientSocket Socket de communication avec le client
+ * @param ip Adresse IP du client (pour les traces)
+ * @param buffer Message reçu (sans le délimiteur)
+ */
+static void processMessage(int clientSocket, const char *ip, const char *buffer) {
+    Command command;
+    parseCommand(ip, buffer, command);
+    lookupPatient(command);
+    lookupReference(command);
+    admitCommand(command);
+    if (config.searchStreaming) {
+        command.streamSocket = clientSocket;
+    }
+    CoRunSync(queryCommand(command));
+    encodeCommand(clientSocket, command);
 }
 
 // ============================================================================
-// GESTION DES THREADS
+// GESTION DES SESSIONS (MODE RÉACTEUR)
 // ============================================================================
 
 /**
- * Fonction exécutée par chaque thread du pool
- * @param arg Paramètre non utilisé
- * @return NULL
+ * Crée une session pour une connexion acceptée
+ * @param clientSocket Socket du client
+ * @param epollFd Instance epoll du réacteur (-1 avec io_uring)
+ * @param ipClient Adresse IP du client
+ * @return Session initialisée
+ */
+static Session *createSession(int clientSocket, int epollFd, const char *ipClient) {
+    Session *session = new Session;
+    session->socket = clientSocket;
+    session->epollFd = epollFd;
+    strncpy(session->ip, ipClient, INET_ADDRSTRLEN - 1);
+    session->ip[INET_ADDRSTRLEN - 1] = '\0';
+    FrameReaderInit(&session->reader, epollFd >= 0 ? clientSocket : -1);
+    pthread_mutex_init(&session->verrou, NULL);
+    session->busy = false;
+    session->closed = false;
+    session->released = false;
+    session->failed = false;
+    session->nextRequest = 0;
+    session->nextReply = 0;
+    session->pending = 0;
+    session->sending = false;
+    session->suspended = false;
+    return session;
+}
+
+/**
+ * Libère la mémoire d'une session (le socket est déjà fermé ou confié)
+ * @param session Session à libérer
+ */
+static void destroySession(Session *session) {
+    for (auto &reply : session->replies) {
+        SendCaptureFree(&reply.second);
+    }
+    pthread_mutex_destroy(&session->verrou);
+    delete session;
+}
+
+/**
+ * Ferme une session multiplexée et libère ses ressources
+ * @param session Session à fermer
+ */
+static void closeSession(Session *session) {
+    // La fermeture du socket le retire aussi de l'instance epoll
+    IdleMonitorRemove(idleMonitor, &session->idle);
+    closeSocket(session->socket);
+    printf("Socket %d fermé pour le client %s\n", session->socket, session->ip);
+    destroySession(session);
+}
+
+/**
+ * Demande à la boucle io_uring de fermer le socket d'une session, après
+ * l'avoir retirée du moniteur d'inactivité (le socket peut être réutilisé)
+ * @param session Session io_uring
+ */
+static void releaseUringSocket(Session *session) {
+    pthread_mutex_lock(&session->verrou);
+    session->released = true;
+    pthread_mutex_unlock(&session->verrou);
+    IdleMonitorRemove(idleMonitor, &session->idle);
+    UringClose(uringServer, session->socket);
+}
+
+/**
+ * Libère une session terminée dont toutes les réponses sont parties
+ * @param session Session multiplexée (epoll ou io_uring)
+ */
+static void finishSession(Session *session) {
+    if (session->epollFd >= 0) {
+        closeSession(session);
+        return;
+    }
+    printf("Client %s déconnecté (socket %d)\n", session->ip, session->socket);
+    releaseUringSocket(session);
+    destroySession(session);
+}
+
+static void serviceSession(Session *session);
+static void serviceUringSession(Session *session);
+static void resumeSessions(void *arg);
+
+/**
+ * Tâche de lecture d'une session prête (réacteur epoll)
+ * @param arg Session
+ */
+static void runSession(void *arg) {
+    serviceSession((Session *)arg);
+    resumeSessions(NULL);
+}
+
+/**
+ * Tâche de lecture d'une session prête (boucle io_uring)
+ * @param arg Session
+ */
+static void runUringSession(void *arg) {
+    serviceUringSession((Session *)arg);
+    resumeSessions(NULL);
+}
+
+/**
+ * Reprend la lecture des sessions dont la suspension a été levée. Appelée
+ * comme tâche, et après chaque tâche de lecture ou d'analyse : une reprise
+ * qui n'a pas trouvé de place dans la file du pool n'est jamais oubliée.
+ * @param arg Inutilisé
+ */
+static void resumeSessions(void *arg) {
+    (void)arg;
+    if (__atomic_load_n(&nbResumedSessions, __ATOMIC_ACQUIRE) == 0) {
+        return;
+    }
+    vector<Session *> sessions;
+    pthread_mutex_lock(&resumeMutex);
+    sessions.swap(resumedSessions);
+    __atomic_store_n(&nbResumedSessions, 0, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&resumeMutex);
+    
+    for (Session *session : sessions) {
+        if (session->epollFd >= 0) {
+            serviceSession(session);
+        } else {
+            serviceUringSession(session);
+        }
+    }
+}
+
+/**
+ * Confie la reprise de lecture d'une session au pool. Appelée par l'étape
+ * d'encodage, elle n'attend jamais une place dans la file du pool : les
+ * étapes se soumettent des tâches en boucle (lecture, base de données,
+ * encodage, lecture) et des files pleines partout se bloqueraient sinon.
+ * @param session Session dont la lecture reprend
+ */
+static void resumeSession(Session *session) {
+    pthread_mutex_lock(&resumeMutex);
+    resumedSessions.push_back(session);
+    __atomic_store_n(&nbResumedSessions, (int)resumedSessions.size(), __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&resumeMutex);
+    
+    // File pleine : la session sera reprise après l'une des tâches en attente
+    ExecutorTrySubmit(executor, resumeSessions, NULL);
+}
+
+/**
+ * Confie une session io_uring prête aux threads du pool
+ * @param session Session ayant au moins une commande à traiter
+ */
+static void dispatchSession(Session *session) {
+    ExecutorSubmit(executor, runUringSession, session);
+}
+
+// ============================================================================
+// REQUÊTES EN PARALLÈLE (SESSIONS MULTIPLEXÉES)
+// ============================================================================
+
+/**
+ * Range la réponse d'une requête puis envoie, dans l'ordre des requêtes,
+ * toutes celles qui ne dépendent plus d'une réponse manquante. Un seul thread
+ * envoie à la fois ; les autres déposent leur réponse et repartent.
+ * @param session Session de la requête
+ * @param number Rang de la requête
+ * @param reply Réponse capturée (confiée à la session)
+ */
+static void completeRequest(Session *session, unsigned long number, const SendCapture &reply) {
+    pthread_mutex_lock(&session->verrou);
+    session->replies[number] = reply;
+    if (session->sending) {
+        pthread_mutex_unlock(&session->verrou);
+        return;
+    }
+    session->sending = true;
+    
+    while (true) {
+        vector<SendCapture> ready;
+        auto next = session->replies.find(session->nextReply);
+        while (next != session->replies.end() && next->first == session->nextReply) {
+            ready.push_back(next->second);
+            next = session->replies.erase(next);
+            session->nextReply++;
+        }
+        if (ready.empty()) {
+            break;
+        }
+        bool skip = session->released || session->failed;
+        pthread_mutex_unlock(&session->verrou);
+        
+        bool failed = false;
+        for (SendCapture &capture : ready) {
+            if (!skip && !failed && SendCaptured(&capture) < 0) {
+                // Réponse tronquée ou client qui ne lit plus (délai d'envoi
+                // dépassé) : le flux est perdu, la connexion est coupée et
+                // la boucle de lecture la fermera
+                printf("ERREUR: Impossible d'envoyer la réponse au client %s (%s), "
+                       "connexion coupée\n", session->ip, strerror(errno));
+                shutdown(session->socket, SHUT_RDWR);
+                failed = true;
+            }
+            SendCaptureFree(&capture);
+        }
+        
+        pthread_mutex_lock(&session->verrou);
+        session->failed = session->failed || failed;
+        session->pending -= ready.size();
+    }
+    session->sending = false;
+    
+    // Reprendre une lecture suspendue, ou libérer une session terminée
+    bool resume = session->suspended &&
+                  (session->pending <= MAX_PIPELINED_REQUESTS / 2 || session->closed);
+    if (resume) {
+        session->suspended = false;
+        session->busy = session->epollFd < 0;
+    }
+    bool done = session->closed && !session->busy && session->pending == 0;
+    pthread_mutex_unlock(&session->verrou);
+    
+    if (resume) {
+        resumeSession(session);
+    } else if (done) {
+        finishSession(session);
+    }
+}
+
+/**
+ * Étape d'encodage d'une requête : la réponse est capturée puis envoyée à
+ * son tour
+ * @param arg Requête (voir Request)
+ */
+static void encodeRequest(void *arg) {
+    Request *request = (Request *)arg;
+    Session *session = request->session;
+    
+    SendCapture reply;
+    SendCaptureBegin(&reply, session->socket);
+    encodeCommand(session->socket, request->command);
+    SendCaptureEnd(&reply);
+    
+    completeRequest(session, request->number, reply);
+    delete request;
+}
+
+/**
+ * Étape base de données d'une requête, puis passage à l'encodage
+ * @param arg Requête (voir Request)
+ */
+static void queryRequest(void *arg) {
+    Request *request = (Request *)arg;
+    CoRunSync(queryCommand(request->command));
+    if (ExecutorSubmit(encodeStage, encodeRequest, request) < 0) {
+        encodeRequest(request);
+    }
+}
+
+/**
+ * Étape d'analyse d'une requête, puis passage à l'étape base de données
+ * (un message invalide, ou déjà résolu par l'annuaire ou le cache, est
+ * encodé aussitôt)
+ * @param arg Requête (voir Request)
+ */
+static void parseRequest(void *arg) {
+    Request *request = (Request *)arg;
+    parseCommand(request->session->ip, request->message.c_str(), request->command);
+    lookupPatient(request->command);
+    lookupReference(request->command);
+    admitCommand(request->command);
+    if (request->command.type == COMMAND_INVALID || request->command.answered) {
+        encodeRequest(request);
+    } else if (ExecutorSubmit(dbStage, queryRequest, request) < 0) {
+        queryRequest(request);
+    }
+    resumeSessions(NULL);
+}
+
+/**
+ * Numérote une commande lue et la confie à l'étape d'analyse : les commandes
+ * d'une même session peuvent ainsi être traitées par plusieurs threads à la fois
+ * @param session Session d'origine
+ * @param message Commande reçue (recopiée)
+ */
+static void submitRequest(Session *session, const char *message) {
+    Request *request = new Request;
+    request->session = session;
+    request->message = message;
+    
+    pthread_mutex_lock(&session->verrou);
+    request->number = session->nextRequest++;
+    session->pending++;
+    pthread_mutex_unlock(&session->verrou);
+    
+    ExecutorSubmit(executor, parseRequest, request);
+}
+
+/**
+ * Suspend la lecture d'une session qui a trop de requêtes en cours : elle
+ * reprendra quand la moitié des réponses seront parties (completeRequest)
+ * @param session Session lue par le thread courant (verrou pris)
+ * @return true si la lecture est suspendue
+ */
+static bool suspendIfSaturated(Session *session) {
+    session->suspended = session->pending >= MAX_PIPELINED_REQUESTS && !session->closed;
+    return session->suspended;
+}
+
+/**
+ * Réarme la surveillance d'une session auprès de son réacteur
+ * @param session Session à surveiller de nouveau
+ * @return true si la session est réarmée, false sinon
+ */
+static bool rearmSession(Session *session) {
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    event.data.ptr = session;
+    if (epoll_ctl(session->epollFd, EPOLL_CTL_MOD, session->socket, &event) < 0) {
+        perror("ERREUR: epoll_ctl (réarmement)");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Lit toutes les commandes disponibles d'une session prête et les confie à
+ * l'exécuteur, puis la rend à son réacteur. EPOLLONESHOT garantit qu'un seul
+ * thread la lit à la fois.
+ * @param session Session signalée prête par le réacteur
  */
-static void *workerThread(void *arg) {
-    (void)arg; // Éviter l'avertissement du compilateur
+static void serviceSession(Session *session) {
+    char *buffer = NULL;
     
     while (true) {
-        // Attendre une tâche à traiter
-        pthread_mutex_lock(&mutex);
-        while (tasks.empty() && !stop) {
-            pthread_cond_wait(&condition, &mutex);
+        pthread_mutex_lock(&session->verrou);
+        bool suspended = suspendIfSaturated(session);
+        pthread_mutex_unlock(&session->verrou);
+        if (suspended) {
+            return;
         }
         
-        // Vérifier si on doit s'arrêter
-        if (stop && tasks.empty()) {
-            pthread_mutex_unlock(&mutex);
+        int bytesReceived = ReceiveFrame(&session->reader, &buffer);
+        
+        if (bytesReceived == TRAME_INCOMPLETE) {
+            // Plus de commande complète : attendre de nouvelles données
+            if (rearmSession(session)) {
+                return;
+            }
+            break;
+        }
+        if (bytesReceived <= 0) {
+            // Client déconnecté
+            printf("Client %s déconnecté (socket %d)\n", session->ip, session->socket);
             break;
         }
         
-        // Récupérer la tâche à traiter
-        ClientTask task = tasks.front();
-        tasks.pop();
-        pthread_mutex_unlock(&mutex);
-
-        // Traitement de la connexion client
-        printf("Thread traite la connexion de %s (socket %d)\n", task.ip, task.socket);
-
-        // Connexion à la base de données pour ce thread
-        MYSQL *connection = openDb();
-        if (!connection) {
-            printf("ERREUR: Impossible de se connecter à la base de données\n");
-            closeSocket(task.socket);
+        IdleMonitorTouch(idleMonitor, &session->idle);
+        submitRequest(session, buffer);
+    }
+    
+    // Fermer une fois la dernière réponse envoyée
+    pthread_mutex_lock(&session->verrou);
+    session->closed = true;
+    bool done = session->pending == 0 && !session->sending;
+    pthread_mutex_unlock(&session->verrou);
+    if (done) {
+        closeSession(session);
+    }
+}
+
+/**
+ * Refuse une nouvelle connexion quand le serveur est surchargé : le client
+ * reçoit aussitôt BUSY;retry_ms au lieu d'attendre une place en file
+ * @param clientSocket Socket du client accepté (à fermer par l'appelant si refusé)
+ * @param ipClient Adresse IP du client
+ * @return true si la connexion est refusée
+ */
+static bool rejectClient(int clientSocket, const char *ipClient) {
+    int retryMs = admission ? AdmissionCheck(admission, ADMISSION_SESSION) : 0;
+    if (retryMs == 0) {
+        return false;
+    }
+
+    string response = string(BUSY) + to_string(retryMs);
+    Send(clientSocket, response.c_str(), response.size());
+    printf("Connexion de %s refusée: serveur occupé (réessai dans %d ms)\n", ipClient, retryMs);
+    return true;
+}
+
+/**
+ * Confie une nouvelle connexion à un réacteur
+ * @param epollFd Instance epoll du réacteur choisi
+ * @param clientSocket Socket du client accepté
+ * @param ipClient Adresse IP du client
+ * @return true si la session est enregistrée, false sinon
+ */
+static bool registerSession(int epollFd, int clientSocket, const char *ipClient) {
+    if (SetNonBlocking(clientSocket) < 0) {
+        perror("ERREUR: SetNonBlocking");
+        return false;
+    }
+    
+    // Surveillée avant l'ajout : un thread du pool peut la fermer aussitôt après
+    Session *session = createSession(clientSocket, epollFd, ipClient);
+    IdleMonitorAdd(idleMonitor, &session->idle, clientSocket);
+    
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    event.data.ptr = session;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, clientSocket, &event) < 0) {
+        perror("ERREUR: epoll_ctl (ajout)");
+        IdleMonitorRemove(idleMonitor, &session->idle);
+        destroySession(session);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Accepte toutes les connexions en attente sur le socket d'écoute d'un
+ * réacteur et les enregistre auprès de ce même réacteur
+ * @param reactor Réacteur propriétaire du socket d'écoute
+ */
+static void acceptReactorConnections(Reactor *reactor) {
+    while (true) {
+        char ipClient[INET_ADDRSTRLEN] = {0};
+        int clientSocket = AcceptConnection(reactor->listenSocket, ipClient);
+        if (clientSocket < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                perror("ERREUR: AcceptConnection");
+            }
+            return;
+        }
+        
+        printf("Connexion acceptée de %s (socket %d)\n", ipClient, clientSocket);
+        if (rejectClient(clientSocket, ipClient)) {
+            closeSocket(clientSocket);
             continue;
         }
+        SocketTuneConnection(clientSocket, &socketProfile);
+        if (!registerSession(reactor->epollFd, clientSocket, ipClient)) {
+            closeSocket(clientSocket);
+        }
+    }
+}
+
+/**
+ * Place le thread appelant sur les processeurs de son rôle (CPU_AFFINITY_*)
+ * @param role Rôle du thread
+ */
+static void bindThread(PlacementRole role) {
+    if (PlacementBindThread(role) < 0) {
+        perror("ATTENTION: Placement du thread impossible");
+    }
+}
 
-        // Boucle de traitement des messages du client
-        char buffer[BUFFER_SIZE];
-        bool clientConnected = true;
+/**
+ * Thread du pool au démarrage : placement sur les processeurs des workers
+ * @param index Rang du thread dans le pool
+ */
+static void onWorkerStart(int index) {
+    (void)index;
+    bindThread(PLACEMENT_WORKER);
+}
+
+/**
+ * Boucle d'un thread réacteur : surveille ses sessions avec epoll et
+ * transmet aux threads du pool celles qui ont des données à lire.
+ * Un réacteur propriétaire d'un socket d'écoute accepte aussi lui-même
+ * ses nouvelles connexions (événement sans session associée).
+ * @param arg Réacteur (voir Reactor)
+ * @return NULL
+ */
+static void *reactorThread(void *arg) {
+    Reactor *reactor = (Reactor *)arg;
+    struct epoll_event events[MAX_EPOLL_EVENTS];
+    bindThread(PLACEMENT_REACTOR);
+    
+    while (!stop) {
+        int nbEvents = epoll_wait(reactor->epollFd, events, MAX_EPOLL_EVENTS, EPOLL_TIMEOUT_MS);
+        if (nbEvents < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("ERREUR: epoll_wait");
+            break;
+        }
+        if (nbEvents == 0) {
+            continue;
+        }
         
-        while (clientConnected) {
-            // Réception du message du client
-            int bytesReceived = Receive(task.socket, buffer);
-
-            if (bytesReceived <= 0) {
-                // Client déconnecté
-                printf("Client %s déconnecté (socket %d)\n", task.ip, task.socket);
-                clientConnected = false;
-            } else {
-                // Traitement du message reçu
-                string message(buffer);
-                printf("Message reçu de %s: %s\n", task.ip, buffer);
-
-                // ================================================================
-                // PARSING ET TRAITEMENT DES COMMANDES CBP
-                // ================================================================
-                
-                // Commande: LOGIN_NEW (nouveau patient)
-                if (message.find(LOGIN_NEW) == 0) {
-                    // Format: LOGIN_NEW;NOM;PRENOM
-                    size_t pos1 = message.find(';', LOGIN_NEW_LENGTH);
-                    if (pos1 != string::npos) {
-                        string lastName = message.substr(LOGIN_NEW_LENGTH, pos1 - LOGIN_NEW_LENGTH);
-                        string firstName = message.substr(pos1 + 1);
-                        handleLoginNew(connection, task.socket, lastName, firstName);
-                    } else {
-                        sendResponse(task.socket, string(LOGIN_FAIL) + FORMAT);
-                    }
-                }
-                // Commande: LOGIN_EXIST (patient existant)
-                else if (message.find(LOGIN_EXIST) == 0) {
-                    // Format: LOGIN_EXIST;ID;NOM;PRENOM
-                    size_t pos1 = message.find(';', LOGIN_EXIST_LENGTH);
-                    size_t pos2 = message.find(';', pos1 + 1);
-                    if (pos1 != string::npos && pos2 != string::npos) {
-                        int patientId = atoi(message.substr(LOGIN_EXIST_LENGTH, pos1 - LOGIN_EXIST_LENGTH).c_str());
-                        string lastName = message.substr(pos1 + 1, pos2 - pos1 - 1);
-                        string firstName = message.substr(pos2 + 1);
-                        handleLoginExist(connection, task.socket, patientId, lastName, firstName);
-                    } else {
-                        sendResponse(task.socket, string(LOGIN_FAIL) + FORMAT);
-                    }
-                }
-                // Commande: SEARCH (recherche de consultations)
-                else if (message.find(SEARCH) == 0) {
-                    // Format: SEARCH;SPECIALTY;DOCTOR;START_DATE;END_DATE
-                    size_t pos1 = message.find(';', SEARCH_LENGTH);
-                    size_t pos2 = message.find(';', pos1 + 1);
-                    size_t pos3 = message.find(';', pos2 + 1);
-
-                    if (pos1 != string::npos && pos2 != string::npos && pos3 != string::npos) {
-                        string specialty = message.substr(SEARCH_LENGTH, pos1 - SEARCH_LENGTH);
-                        string doctor = message.substr(pos1 + 1, pos2 - pos1 - 1);
-                        string startDate = message.substr(pos2 + 1, pos3 - pos2 - 1);
-                        string endDate = message.substr(pos3 + 1);
-                        handleSearch(connection, task.socket, specialty, doctor, startDate, endDate);
-                    } else {
-                        sendResponse(task.socket, string(SEARCH_FAIL) + FORMAT);
-                    }
-                }
-                // Commande: GET_SPECIALTIES (liste des spécialités)
-                else if (message.find(GET_SPECIALTIES) == 0) {
-                    handleGetSpecialties(connection, task.socket);
-                }
-                // Commande: GET_DOCTORS (liste des médecins)
-                else if (message.find("GET_DOCTORS;") == 0) {
-                    // Format: GET_DOCTORS;SPECIALTY
-                    string specialty = message.substr(GET_DOCTORS_LENGTH);
-                    handleGetDoctors(connection, task.socket, specialty);
-                }
-                // Commande: BOOK_CONSULTATION (réservation de consultation)
-                else if (message.find("BOOK_CONSULTATION;") == 0) {
-                    // Format: BOOK_CONSULTATION;CONSULTATION_ID;PATIENT_ID;REASON
-                    size_t pos1 = message.find(';', BOOK_CONSULTATION_LENGTH);
-                    size_t pos2 = message.find(';', pos1 + 1);
-
-                    if (pos1 != string::npos && pos2 != string::npos) {
-                        int consultationId = atoi(message.substr(BOOK_CONSULTATION_LENGTH, pos1 - BOOK_CONSULTATION_LENGTH).c_str());
-                        int patientId = atoi(message.substr(pos1 + 1, pos2 - pos1 - 1).c_str());
-                        string reason = message.substr(pos2 + 1);
-                        handleBookConsultation(connection, task.socket, consultationId, patientId, reason);
-                    } else {
-                        sendResponse(task.socket, string(BOOK_FAIL) + FORMAT);
-                    }
-                }
-                // Commande inconnue
-                else {
-                    sendResponse(task.socket, string(LOGIN_FAIL) + UNKNOWN_CMD);
-                    printf("ERREUR: Commande inconnue reçue: %s\n", message.c_str());
-                }
+        // Transmettre les sessions prêtes aux threads du pool
+        bool listenReady = false;
+        for (int i = 0; i < nbEvents; i++) {
+            Session *session = (Session *)events[i].data.ptr;
+            if (session == NULL) {
+                listenReady = true;
+                continue;
             }
+            ExecutorSubmit(executor, runSession, session);
+        }
+        
+        // Accepter les connexions du socket d'écoute
+        if (listenReady) {
+            acceptReactorConnections(reactor);
         }
+    }
+    
+    printf("Thread réacteur terminé\n");
+    return nullptr;
+}
 
-        // ================================================================
-        // NETTOYAGE ET FERMETURE
-        // ================================================================
+/**
+ * Rattache un socket d'écoute SO_REUSEPORT à un réacteur
+ * @param reactor Réacteur propriétaire du socket d'écoute
+ * @param listenSocket Socket d'écoute (rendu non bloquant)
+ * @return true si le socket est surveillé par le réacteur, false sinon
+ */
+static bool attachListener(Reactor *reactor, int listenSocket) {
+    if (SetNonBlocking(listenSocket) < 0) {
+        perror("ERREUR: SetNonBlocking (écoute)");
+        return false;
+    }
+    
+    // Surveillance permanente (sans EPOLLONESHOT) : data.ptr nul = écoute
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = NULL;
+    if (epoll_ctl(reactor->epollFd, EPOLL_CTL_ADD, listenSocket, &event) < 0) {
+        perror("ERREUR: epoll_ctl (écoute)");
+        return false;
+    }
+    reactor->listenSocket = listenSocket;
+    return true;
+}
 
-        // Fermer la connexion à la base de données
-        mysql_close(connection);
-        printf("Connexion base de données fermée pour le client %s\n", task.ip);
+/**
+ * Lit les commandes d'une session io_uring et les confie à l'exécuteur, puis
+ * rend la session à la boucle. La trame est copiée sous verrou car la boucle
+ * peut alimenter le lecteur pendant ce temps.
+ * @param session Session signalée prête par la boucle io_uring
+ */
+static void serviceUringSession(Session *session) {
+    char message[TAILLE_LECTEUR];
+    
+    while (true) {
+        pthread_mutex_lock(&session->verrou);
+        if (suspendIfSaturated(session)) {
+            // busy reste vrai : la boucle ne relance pas la lecture
+            pthread_mutex_unlock(&session->verrou);
+            return;
+        }
+        char *frame = NULL;
+        int taille = NextFrame(&session->reader, &frame);
+        bool tropLong = false;
+        if (taille == TRAME_INCOMPLETE && !session->excedent.empty()) {
+            // Reprendre les octets qui ne tenaient pas dans le lecteur
+            int accepte = FrameReaderFeed(&session->reader, session->excedent.data(),
+                                          session->excedent.size());
+            session->excedent.erase(0, accepte);
+            taille = NextFrame(&session->reader, &frame);
+            tropLong = (taille == TRAME_INCOMPLETE && accepte == 0);
+        }
+        
+        if (taille == TRAME_INCOMPLETE || tropLong || session->closed) {
+            session->busy = false;
+            bool done = session->closed && session->pending == 0 && !session->sending;
+            pthread_mutex_unlock(&session->verrou);
+            
+            if (done) {
+                // La boucle a signalé la fin de connexion pendant la lecture
+                finishSession(session);
+            } else if (tropLong) {
+                // La boucle appellera uringOnClose, qui libérera la session
+                printf("ERREUR: Trame trop longue reçue de %s\n", session->ip);
+                releaseUringSocket(session);
+            }
+            return;
+        }
+        
+        memcpy(message, frame, taille + 1);
+        pthread_mutex_unlock(&session->verrou);
+        
+        submitRequest(session, message);
+    }
+}
+
+/**
+ * Nouvelle connexion acceptée par la boucle io_uring
+ */
+static void *uringOnOpen(int clientSocket, const char *ipClient, void *userData) {
+    (void)userData;
+    printf("Connexion acceptée de %s (socket %d)\n", ipClient, clientSocket);
+    SocketTuneConnection(clientSocket, &socketProfile);
+    Session *session = createSession(clientSocket, -1, ipClient);
+    IdleMonitorAdd(idleMonitor, &session->idle, clientSocket);
+    if (rejectClient(clientSocket, ipClient)) {
+        // Le socket appartient à la boucle : la coupure lui fait fermer la
+        // connexion (onClose) une fois la réponse partie
+        shutdown(clientSocket, SHUT_RDWR);
+    }
+    return session;
+}
 
-        // Fermeture propre du socket client
-        closeSocket(task.socket);
-        printf("Socket %d fermé pour le client %s\n", task.socket, task.ip);
+/**
+ * Octets reçus par la boucle io_uring : alimente le lecteur de la session et
+ * la confie au pool si une commande est complète et qu'aucun thread ne la traite
+ */
+static void uringOnData(void *contexte, const char *data, int taille) {
+    Session *session = (Session *)contexte;
+    IdleMonitorTouch(idleMonitor, &session->idle);
+    
+    pthread_mutex_lock(&session->verrou);
+    int accepte = session->excedent.empty() ? FrameReaderFeed(&session->reader, data, taille) : 0;
+    if (accepte < taille) {
+        session->excedent.append(data + accepte, taille - accepte);
+    }
+    bool saturee = session->excedent.size() > MAX_URING_BACKLOG;
+    bool dispatch = !session->busy && !saturee &&
+                    (FrameReaderPending(&session->reader) || !session->excedent.empty());
+    if (dispatch) {
+        session->busy = true;
+    }
+    pthread_mutex_unlock(&session->verrou);
+    
+    if (saturee) {
+        printf("ERREUR: Trop de données en attente pour %s\n", session->ip);
+        releaseUringSocket(session);
+    } else if (dispatch) {
+        dispatchSession(session);
     }
+}
+
+/**
+ * Fin de connexion signalée par la boucle io_uring : la session est libérée
+ * ici si aucun thread ne la lit et que toutes ses réponses sont parties,
+ * sinon par le dernier thread qui la lit ou envoie ses réponses
+ */
+static void uringOnClose(void *contexte) {
+    Session *session = (Session *)contexte;
     
-    printf("Thread worker terminé\n");
+    pthread_mutex_lock(&session->verrou);
+    session->closed = true;
+    bool libre = !session->busy && session->pending == 0 && !session->sending;
+    pthread_mutex_unlock(&session->verrou);
+    
+    if (libre) {
+        finishSession(session);
+    }
+}
+
+/**
+ * Session inactive depuis plus de CONNECTION_TIMEOUT secondes
+ * (appelé par le thread du moniteur juste avant la fermeture du socket)
+ */
+static void onIdleSession(int clientSocket, void *userData) {
+    (void)userData;
+    printf("Session inactive fermée (socket %d)\n", clientSocket);
+}
+
+/**
+ * Relève la limite de descripteurs ouverts au maximum autorisé,
+ * nécessaire pour garder des milliers de sessions connectées
+ */
+static void raiseFileLimit() {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        if (setrlimit(RLIMIT_NOFILE, &limit) < 0) {
+            perror("ATTENTION: setrlimit(RLIMIT_NOFILE)");
+        }
+    }
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        printf("Limite de descripteurs ouverts: %lu\n", (unsigned long)limit.rlim_cur);
+    }
+}
+
+// ============================================================================
+// GESTION DES SESSIONS (MODE COROUTINE)
+// ============================================================================
+
+/**
+ * Traite une commande d'une session en coroutine : la réponse est capturée
+ * puis envoyée sans bloquer le thread
+ * @param clientSocket Socket non bloquant du client
+ * @param ip Adresse IP du client (pour les traces)
+ * @param buffer Message reçu (sans le délimiteur)
+ */
+static CoTask<void> serveCommand(int clientSocket, const char *ip, const char *buffer) {
+    Command command;
+    parseCommand(ip, buffer, command);
+    lookupPatient(command);
+    lookupReference(command);
+    admitCommand(command);
+    co_await queryCommand(command);
+
+    // Encodage sans suspension : la capture du thread ne sert qu'à cette session
+    SendCapture reply;
+    SendCaptureBegin(&reply, clientSocket);
+    encodeCommand(clientSocket, command);
+    SendCaptureEnd(&reply);
+    if (co_await CoSendCaptured(&reply) < 0) {
+        printf("ERREUR: Impossible d'envoyer la réponse au client\n");
+    }
+    SendCaptureFree(&reply);
+}
+
+/**
+ * Session d'un client en coroutine, écrite comme la boucle du mode thread
+ * par session : chaque attente (commande du client, réponse de MySQL, socket
+ * plein) suspend la session et laisse le thread aux autres sessions
+ * @param task Connexion du client (copiée dans la coroutine)
+ */
+static CoTask<void> runCoroutineSession(ClientTask task) {
+    printf("Coroutine traite la connexion de %s (socket %d)\n", task.ip, task.socket);
+    SetNonBlocking(task.socket);
+
+    FrameReader reader;
+    FrameReaderInit(&reader, task.socket);
+    IdleConnection idle;
+    IdleMonitorAdd(idleMonitor, &idle, task.socket);
+    char *buffer = NULL;
+    bool clientConnected = true;
+    int served = 0;
+
+    while (clientConnected) {
+        int bytesReceived = co_await CoReceiveFrame(&reader, &buffer);
+
+        if (bytesReceived <= 0) {
+            // Client déconnecté (ou session inactive fermée par le moniteur)
+            printf("Client %s déconnecté (socket %d)\n", task.ip, task.socket);
+            clientConnected = false;
+        } else {
+            IdleMonitorTouch(idleMonitor, &idle);
+            co_await serveCommand(task.socket, task.ip, buffer);
+
+            // Un client qui envoie sans relâche ne monopolise pas le thread
+            if (++served % FRAMES_PER_TURN == 0) {
+                co_await CoYield();
+            }
+        }
+    }
+
+    IdleMonitorRemove(idleMonitor, &idle);
+    closeSocket(task.socket);
+    printf("Socket %d fermé pour le client %s\n", task.socket, task.ip);
+}
+
+/**
+ * Lance la session d'un client accepté sur un thread de l'ordonnanceur
+ * @param clientSocket Socket du client accepté
+ * @param ipClient Adresse IP du client
+ */
+static void spawnSession(int clientSocket, const char *ipClient) {
+    ClientTask task = {};
+    task.socket = clientSocket;
+    strncpy(task.ip, ipClient, INET_ADDRSTRLEN - 1);
+    if (CoSchedulerSpawn(coScheduler, runCoroutineSession(task)) < 0) {
+        // Serveur en cours d'arrêt
+        closeSocket(clientSocket);
+    }
+}
+
+// ============================================================================
+// GESTION DES THREADS
+// ============================================================================
+
+/**
+ * Tâche traitant une connexion client jusqu'à sa fermeture (mode thread par
+ * session) : les commandes sont traitées dans l'ordre par ce seul thread
+ * @param arg Connexion (ClientTask allouée par queueClient)
+ */
+static void runConnection(void *arg) {
+    ClientTask *connection = (ClientTask *)arg;
+    ClientTask task = *connection;
+    delete connection;
+
+    // Traitement de la connexion client
+    printf("Thread traite la connexion de %s (socket %d)\n", task.ip, task.socket);
+
+    // Boucle de traitement des messages du client : le lecteur de trames
+    // conserve les commandes reçues d'un bloc et les rend une à une
+    FrameReader reader;
+    FrameReaderInit(&reader, task.socket);
+    IdleConnection idle;
+    IdleMonitorAdd(idleMonitor, &idle, task.socket);
+    char *buffer = NULL;
+    bool clientConnected = true;
+    
+    while (clientConnected) {
+        // Réception du message du client
+        int bytesReceived = ReceiveFrame(&reader, &buffer);
+
+        if (bytesReceived <= 0) {
+            // Client déconnecté
+            printf("Client %s déconnecté (socket %d)\n", task.ip, task.socket);
+            clientConnected = false;
+        } else {
+            // Traitement du message reçu (connexion MySQL empruntée au pool)
+            IdleMonitorTouch(idleMonitor, &idle);
+            processMessage(task.socket, task.ip, buffer);
+        }
+    }
+
+    // ================================================================
+    // NETTOYAGE ET FERMETURE
+    // ================================================================
+
+    // Fermeture propre du socket client
+    IdleMonitorRemove(idleMonitor, &idle);
+    closeSocket(task.socket);
+    printf("Socket %d fermé pour le client %s\n", task.socket, task.ip);
+}
+
+/**
+ * Ajoute un client accepté à la file d'attente (mode thread par session)
+ * @param clientSocket Socket du client accepté
+ * @param ipClient Adresse IP du client
+ */
+static void queueClient(int clientSocket, const char *ipClient) {
+    ClientTask *task = new ClientTask();
+    task->socket = clientSocket;
+    strncpy(task->ip, ipClient, INET_ADDRSTRLEN - 1);
+    if (ExecutorSubmit(executor, runConnection, task) < 0) {
+        // Serveur en cours d'arrêt
+        delete task;
+        closeSocket(clientSocket);
+        return;
+    }
+    
+    printf("Tâche ajoutée à la file d'attente\n");
+}
+
+/**
+ * Confie un client accepté à un réacteur (tourniquet), à l'ordonnanceur de
+ * coroutines ou, sinon, à la file d'attente des threads (sauf surcharge)
+ * @param clientSocket Socket du client accepté
+ * @param ipClient Adresse IP du client
+ */
+static void handOffClient(int clientSocket, const char *ipClient) {
+    if (rejectClient(clientSocket, ipClient)) {
+        closeSocket(clientSocket);
+        return;
+    }
+    SocketTuneConnection(clientSocket, &socketProfile);
+    if (coScheduler) {
+        spawnSession(clientSocket, ipClient);
+        return;
+    }
+    if (!reactors.empty()) {
+        unsigned int index = __atomic_fetch_add(&nextReactor, 1, __ATOMIC_RELAXED) % reactors.size();
+        if (!registerSession(reactors[index].epollFd, clientSocket, ipClient)) {
+            closeSocket(clientSocket);
+        }
+        return;
+    }
+    queueClient(clientSocket, ipClient);
+}
+
+/**
+ * Thread accepteur : accepte les connexions de son propre socket d'écoute
+ * (SO_REUSEPORT en mode thread par session, ou socket local AF_UNIX)
+ * @param arg Socket d'écoute du thread
+ * @return NULL
+ */
+static void *acceptorThread(void *arg) {
+    int serverSocket = (int)(intptr_t)arg;
+    bindThread(PLACEMENT_ACCEPTOR);
+    
+    while (!stop) {
+        char ipClient[INET_ADDRSTRLEN] = {0};
+        int clientSocket = AcceptConnection(serverSocket, ipClient);
+        
+        if (clientSocket < 0) {
+            if (!stop) {
+                perror("ERREUR: AcceptConnection");
+            }
+            continue;
+        }
+        
+        printf("Connexion acceptée de %s (socket %d)\n", ipClient, clientSocket);
+        handOffClient(clientSocket, ipClient);
+    }
+    
+    printf("Thread accepteur terminé\n");
+    return nullptr;
+}
+
+/**
+ * Affiche les métriques de chaque étape (threads, longueur de file, tâches)
+ */
+static void reportStages() {
+    if (coScheduler) {
+        CoSchedulerReport(coScheduler);
+    } else {
+        ExecutorReport(executor, dbStage ? "analyse" : "pool");
+    }
+    if (dbStage) {
+        ExecutorReport(dbStage, "base de données");
+    }
+    if (encodeStage) {
+        ExecutorReport(encodeStage, "encodage");
+    }
+    if (poolSizer) {
+        PoolSizerReport(poolSizer);
+    }
+    if (admission) {
+        AdmissionReport(admission);
+    }
+    BookingReport(bookingEngine);
+    if (patientDirectory) {
+        PatientDirectoryReport(patientDirectory);
+    }
+    if (referenceCache) {
+        ReferenceCacheReport(referenceCache);
+    }
+}
+
+/**
+ * Thread d'affichage périodique des métriques des étapes
+ * (STAGE_STATS_INTERVAL secondes)
+ * @param arg Inutilisé
+ * @return NULL
+ */
+static void *stageStatsThread(void *arg) {
+    (void)arg;
+    int elapsed = 0;
+    while (!stop) {
+        sleep(1);
+        if (++elapsed >= config.stageStatsInterval) {
+            elapsed = 0;
+            reportStages();
+        }
+    }
     return nullptr;
 }
 
@@ -785,41 +2287,451 @@ int main() {
         config.nbThreads = 4;
         printf("ATTENTION: Nombre de threads invalide, utilisation de la valeur par défaut: 4\n");
     }
+    if (config.nbReactors <= 0) {
+        config.nbReactors = 1;
+        printf("ATTENTION: Nombre de réacteurs invalide, utilisation de la valeur par défaut: 1\n");
+    }
+    if (config.listenBacklog <= 0) {
+        config.listenBacklog = BACKLOG_DEFAUT;
+        printf("ATTENTION: File d'attente invalide, utilisation de la valeur par défaut: %d\n",
+               BACKLOG_DEFAUT);
+    }
+    if (config.connectionTimeout < 0) {
+        config.connectionTimeout = 0;
+    }
+    if (config.dbPoolSize <= 0) {
+        config.dbPoolSize = config.nbThreads;
+    }
+    if (config.dbPoolTimeout <= 0) {
+        config.dbPoolTimeout = 2000;
+    }
+    if (config.dbPoolIdleTimeout < 0) {
+        config.dbPoolIdleTimeout = 0;
+    }
+    if (config.dbThreads <= 0) {
+        config.dbThreads = config.dbPoolSize;
+    }
+    if (config.encodeThreads <= 0) {
+        config.encodeThreads = config.nbThreads;
+    }
+    if (config.adaptiveMaxThreads > 0 && config.coroutineMode) {
+        config.adaptiveMaxThreads = 0;
+        printf("ATTENTION: Pool adaptatif ignoré en mode coroutine\n");
+    }
+    if (config.adaptiveMaxThreads > 0) {
+        if (config.adaptiveMinThreads <= 0) {
+            config.adaptiveMinThreads = 1;
+        }
+        if (config.adaptiveMaxThreads < config.adaptiveMinThreads) {
+            config.adaptiveMaxThreads = config.adaptiveMinThreads;
+        }
+        if (config.adaptiveTargetWaitMs <= 0) {
+            config.adaptiveTargetWaitMs = 5;
+        }
+        if (config.adaptiveMaxDbLatencyMs < 0) {
+            config.adaptiveMaxDbLatencyMs = 0;
+        }
+        if (config.adaptiveIntervalMs <= 0) {
+            config.adaptiveIntervalMs = 500;
+        }
+    }
+    bool admissionEnabled = config.admissionMaxQueue > 0 || config.admissionLatencyMs > 0;
+    if (admissionEnabled && config.coroutineMode) {
+        admissionEnabled = false;
+        printf("ATTENTION: Contrôle d'admission ignoré en mode coroutine\n");
+    }
+    if (config.admissionRetryMs <= 0) {
+        config.admissionRetryMs = 500;
+    }
+    if (config.admissionIntervalMs <= 0) {
+        config.admissionIntervalMs = 50;
+    }
+    if (config.bookingWindowUs < 0) {
+        config.bookingWindowUs = 300;
+    }
+    if (config.bookingMaxBatch <= 0) {
+        config.bookingMaxBatch = 64;
+    }
+    if (config.nbAcceptors <= 0) {
+        config.nbAcceptors = 1;
+        printf("ATTENTION: Nombre d'accepteurs invalide, utilisation de la valeur par défaut: 1\n");
+    }
+    if (config.coroutineMode && config.uringBackend) {
+        config.uringBackend = false;
+        printf("ATTENTION: IO_BACKEND=uring ignoré en mode coroutine (epoll par thread)\n");
+    }
+    if (SocketProfileInit(&socketProfile, config.socketProfile.c_str()) < 0) {
+        printf("ATTENTION: Profil de socket inconnu '%s', utilisation du profil par défaut\n",
+               config.socketProfile.c_str());
+    }
+    for (const auto &option : config.socketOptions) {
+        if (SocketProfileSet(&socketProfile, option.first.c_str(), option.second) < 0) {
+            printf("ATTENTION: Option de socket inconnue: SOCKET_%s\n", option.first.c_str());
+        }
+    }
+    const pair<PlacementRole, string *> cpuLists[] = {
+        {PLACEMENT_ACCEPTOR, &config.cpuAcceptors},
+        {PLACEMENT_REACTOR, &config.cpuReactors},
+        {PLACEMENT_WORKER, &config.cpuWorkers},
+    };
+    for (const auto &cpuList : cpuLists) {
+        if (!cpuList.second->empty() &&
+            PlacementConfigure(cpuList.first, cpuList.second->c_str(), config.cpuWholeSet) < 0) {
+            printf("ATTENTION: Liste de processeurs invalide ou hors affinité: '%s', threads non placés\n",
+                   cpuList.second->c_str());
+        }
+    }
     
     printf("Configuration chargée: port=%d threads=%d DB=%s@%s (%s)\n", 
            config.portReservation, config.nbThreads, 
            config.dbUser.c_str(), config.dbHost.c_str(), config.dbName.c_str());
+    if (config.reactorMode) {
+        printf("Mode réacteur: %d réacteur(s) epoll\n", config.nbReactors);
+        raiseFileLimit();
+    } else if (config.coroutineMode) {
+        printf("Mode coroutine: sessions en coroutines sur %d thread(s)\n", config.nbThreads);
+        raiseFileLimit();
+    } else {
+        printf("Mode thread par session\n");
+    }
+    PlacementReport();
 
     // ================================================================
     // INITIALISATION DU SERVEUR
     // ================================================================
 
-    int serverSocket = ServerSocket(config.portReservation);
-    if (serverSocket < 0) {
-        perror("ERREUR: Impossible de créer le socket serveur");
+    // Un socket d'écoute par accepteur : le noyau répartit les connexions
+    // entre eux (SO_REUSEPORT). io_uring n'utilise qu'un seul socket, et en
+    // mode réacteur chaque réacteur possède au plus un socket d'écoute.
+    bool useUring = config.uringBackend && UringSupported();
+    int nbListeners = config.nbAcceptors;
+    if (useUring && nbListeners > 1) {
+        nbListeners = 1;
+        printf("ATTENTION: io_uring utilise un seul socket d'écoute\n");
+    } else if (!useUring && config.reactorMode && nbListeners > config.nbReactors) {
+        nbListeners = config.nbReactors;
+        printf("ATTENTION: Accepteurs limités au nombre de réacteurs: %d\n", nbListeners);
+    }
+    
+    vector<int> listenSockets;
+    for (int i = 0; i < nbListeners; ++i) {
+        int listenSocket = ServerSocketEx(config.portReservation, config.listenBacklog,
+                                          nbListeners > 1);
+        if (listenSocket < 0) {
+            perror("ERREUR: Impossible de créer le socket serveur");
+            for (int previous : listenSockets) {
+                closeSocket(previous);
+            }
+            return 1;
+        }
+        SocketTuneListener(listenSocket, &socketProfile);
+        listenSockets.push_back(listenSocket);
+    }
+    int serverSocket = listenSockets[0];
+    printf("Serveur en écoute sur le port %d (file d'attente %d, %d socket(s) d'écoute%s)\n",
+           config.portReservation, config.listenBacklog, nbListeners,
+           nbListeners > 1 ? " SO_REUSEPORT" : "");
+    printf("Profil de socket: %s\n", socketProfile.nom);
+    SocketTuningReport(serverSocket, "Options effectives (écoute TCP)");
+
+    // Socket local pour les clients du même hôte (sans pile TCP/IP)
+    int unixSocket = -1;
+    if (!config.unixSocketPath.empty()) {
+        unixSocket = ServerSocketUnix(config.unixSocketPath.c_str(), config.listenBacklog);
+        if (unixSocket < 0) {
+            perror("ERREUR: Impossible de créer le socket local");
+            for (int listenSocket : listenSockets) {
+                closeSocket(listenSocket);
+            }
+            return 1;
+        }
+        SocketTuneListener(unixSocket, &socketProfile);
+        printf("Serveur en écoute sur le socket local %s\n", config.unixSocketPath.c_str());
+        SocketTuningReport(unixSocket, "Options effectives (socket local)");
+    }
+
+    // ================================================================
+    // SURVEILLANCE DE L'INACTIVITÉ
+    // ================================================================
+
+    // Un envoi bloqué par un client qui ne lit plus occupe un thread du
+    // pool : il échoue après ce délai et la session est coupée
+    SetSendTimeout(config.sendTimeoutMs > 0 ? config.sendTimeoutMs : -1);
+
+    if (config.connectionTimeout > 0) {
+        idleMonitor = IdleMonitorCreate(config.connectionTimeout, onIdleSession, NULL);
+        if (!idleMonitor) {
+            perror("ERREUR: Impossible de créer le moniteur d'inactivité");
+            return 1;
+        }
+        printf("Sessions inactives fermées après %d secondes\n", config.connectionTimeout);
+    }
+
+    // ================================================================
+    // POOL DE CONNEXIONS MYSQL
+    // ================================================================
+
+    // Les requêtes empruntent une connexion le temps de leur exécution : les
+    // sessions ouvertes ne retiennent aucune connexion entre deux commandes.
+    // Les requêtes préparées d'une connexion sont fermées avec elle.
+    mysql_library_init(0, NULL, NULL);
+    dal = DalCreate();
+    DbPoolConfig poolConfig;
+    poolConfig.host = config.dbHost.c_str();
+    poolConfig.user = config.dbUser.c_str();
+    poolConfig.password = config.dbPass.c_str();
+    poolConfig.database = config.dbName.c_str();
+    poolConfig.maxConnections = config.dbPoolSize;
+    poolConfig.acquireTimeoutMs = config.dbPoolTimeout;
+    poolConfig.idleTimeoutMs = config.dbPoolIdleTimeout * 1000;
+    poolConfig.pingIntervalMs = DB_PING_INTERVAL_MS;
+    poolConfig.statsIntervalMs = config.dbPoolStatsInterval * 1000;
+    poolConfig.onClose = DalForget;
+    poolConfig.closeContext = dal;
+    dbPool = DbPoolCreate(&poolConfig);
+    if (!dbPool) {
+        perror("ERREUR: Impossible de créer le pool de connexions MySQL");
         return 1;
     }
-    printf("Serveur en écoute sur le port %d\n", config.portReservation);
+    printf("Pool MySQL de %d connexion(s) au plus (attente max %d ms)\n",
+           config.dbPoolSize, config.dbPoolTimeout);
+
+    // Les réservations simultanées partagent une transaction (une connexion
+    // empruntée par lot)
+    BookingConfig bookingConfig;
+    bookingConfig.windowUs = config.bookingWindowUs;
+    bookingConfig.maxBatch = config.bookingMaxBatch;
+    bookingEngine = BookingCreate(&bookingConfig, dbPool, dal);
+    if (!bookingEngine) {
+        perror("ERREUR: Impossible de créer le moteur de réservation");
+        return 1;
+    }
+    printf("Réservations regroupées pendant %d µs, %d par transaction au plus\n",
+           config.bookingWindowUs, config.bookingMaxBatch);
+
+    // Sans annuaire, chaque LOGIN_EXIST est vérifié dans la base
+    if (config.patientDirectory) {
+        patientDirectory = PatientDirectoryLoad(dbPool, dal);
+        if (patientDirectory) {
+            PatientDirectoryStats directoryStats;
+            PatientDirectoryGetStats(patientDirectory, &directoryStats);
+            printf("Annuaire des patients chargé: %zu patient(s)\n", directoryStats.patients);
+        } else {
+            printf("ATTENTION: Annuaire des patients indisponible, vérifications dans la base\n");
+        }
+    }
+
+    // Listes de spécialités et de médecins relues au plus une fois par
+    // génération du cache
+    if (config.referenceCacheTtl > 0) {
+        referenceCache = ReferenceCacheCreate(config.referenceCacheTtl * 1000, REFERENCE_CACHE_ENTRIES);
+        printf("Listes de référence gardées %d s en cache\n", config.referenceCacheTtl);
+    }
 
     // ================================================================
     // CRÉATION DU POOL DE THREADS
     // ================================================================
     
-    vector<pthread_t> threads(config.nbThreads);
-    for (int i = 0; i < config.nbThreads; ++i) {
-        if (pthread_create(&threads[i], nullptr, workerThread, nullptr) != 0) {
+    if (config.coroutineMode) {
+        // Chaque thread exécute les sessions qui lui sont confiées et les
+        // reprend quand leur socket (client ou MySQL) est prêt
+        coScheduler = CoSchedulerCreate(config.nbThreads, onWorkerStart);
+        if (!coScheduler) {
+            perror("ERREUR: Impossible de créer l'ordonnanceur de coroutines");
+            closeSocket(serverSocket);
+            return 1;
+        }
+        printf("Ordonnanceur de %d threads créé avec succès\n", config.nbThreads);
+    } else {
+        // Chaque thread a sa file de tâches et vole celles des autres quand la
+        // sienne est vide : les requêtes d'une session très active se répartissent.
+        // Pool adaptatif en mode thread par session : tous les threads possibles
+        // sont créés, NB_THREADS d'entre eux actifs au départ.
+        bool adaptive = config.adaptiveMaxThreads > 0 && !config.reactorMode && !useUring;
+        executor = ExecutorCreateEx(adaptive ? config.adaptiveMaxThreads : config.nbThreads,
+                                    MAX_PENDING_TASKS, onWorkerStart);
+        if (!executor) {
             perror("ERREUR: Impossible de créer le thread");
             closeSocket(serverSocket);
             return 1;
         }
+        printf("Pool de %d threads créé avec succès\n", config.nbThreads);
+    }
+
+    // Modes multiplexés : chaque requête traverse trois étapes reliées par des
+    // files bornées. Le pool ci-dessus lit et analyse, l'étape base de données
+    // attend MySQL sans occuper les threads de calcul, l'étape d'encodage
+    // construit et envoie les réponses.
+    if (config.reactorMode || useUring) {
+        bool adaptive = config.adaptiveMaxThreads > 0;
+        dbStage = ExecutorCreateEx(adaptive ? config.adaptiveMaxThreads : config.dbThreads,
+                                   MAX_PENDING_TASKS, onWorkerStart);
+        encodeStage = ExecutorCreateEx(config.encodeThreads, MAX_PENDING_TASKS, onWorkerStart);
+        if (!dbStage || !encodeStage) {
+            perror("ERREUR: Impossible de créer les étapes du pipeline");
+            closeSocket(serverSocket);
+            return 1;
+        }
+        printf("Pipeline: analyse %d threads, base de données %d threads, encodage %d threads "
+               "(files de %zu tâches)\n", config.nbThreads, config.dbThreads,
+               config.encodeThreads, MAX_PENDING_TASKS);
+    }
+
+    // Pool adaptatif : le nombre de threads qui attendent MySQL (pool en
+    // mode thread par session, étape base de données sinon) suit l'attente
+    // des tâches en file et la latence de la base
+    if (config.adaptiveMaxThreads > 0) {
+        Executor *controlled = dbStage ? dbStage : executor;
+        ExecutorResize(controlled, dbStage ? config.dbThreads : config.nbThreads);
+        PoolSizerConfig sizerConfig;
+        sizerConfig.minThreads = config.adaptiveMinThreads;
+        sizerConfig.maxThreads = config.adaptiveMaxThreads;
+        sizerConfig.intervalMs = config.adaptiveIntervalMs;
+        sizerConfig.targetWaitMs = config.adaptiveTargetWaitMs;
+        sizerConfig.maxDbLatencyMs = config.adaptiveMaxDbLatencyMs;
+        sizerConfig.growPeriods = ADAPTIVE_GROW_PERIODS;
+        sizerConfig.shrinkPeriods = ADAPTIVE_SHRINK_PERIODS;
+        poolSizer = PoolSizerCreate(&sizerConfig, controlled, dbPool,
+                                    dbStage ? "base de données" : "pool");
+        if (!poolSizer) {
+            perror("ERREUR: Impossible de créer le pool adaptatif");
+            closeSocket(serverSocket);
+            return 1;
+        }
+        printf("Pool adaptatif: %d à %d threads (attente visée %d ms, MySQL %d ms au plus, "
+               "mesure toutes les %d ms)\n", config.adaptiveMinThreads,
+               config.adaptiveMaxThreads, config.adaptiveTargetWaitMs,
+               config.adaptiveMaxDbLatencyMs, config.adaptiveIntervalMs);
+    }
+
+    // Contrôle d'admission : la file observée est celle des tâches qui
+    // attendent MySQL, comme pour le pool adaptatif
+    if (admissionEnabled) {
+        AdmissionConfig admissionConfig;
+        admissionConfig.maxQueueDepth = config.admissionMaxQueue;
+        admissionConfig.latencyBudgetMs = config.admissionLatencyMs;
+        admissionConfig.retryMs = config.admissionRetryMs;
+        admissionConfig.intervalMs = config.admissionIntervalMs;
+        admission = AdmissionCreate(&admissionConfig, dbStage ? dbStage : executor, dbPool);
+        if (!admission) {
+            perror("ERREUR: Impossible de créer le contrôle d'admission");
+            closeSocket(serverSocket);
+            return 1;
+        }
+        printf("Contrôle d'admission: file de %d au plus, attente de %d ms au plus "
+               "(0 = ignorée), réessai conseillé après %d ms\n", config.admissionMaxQueue,
+               config.admissionLatencyMs, config.admissionRetryMs);
+    }
+    pthread_t statsThread;
+    bool statsStarted = config.stageStatsInterval > 0 &&
+                        pthread_create(&statsThread, nullptr, stageStatsThread, nullptr) == 0;
+
+    // ================================================================
+    // BACKEND IO_URING (OPTIONNEL)
+    // ================================================================
+
+    if (config.uringBackend) {
+        UringHandlers handlers = {uringOnOpen, uringOnData, uringOnClose, NULL};
+        if (useUring) {
+            uringServer = UringServerCreate(serverSocket, &handlers);
+        }
+        if (uringServer && unixSocket >= 0) {
+            UringServerAddListener(uringServer, unixSocket);
+        }
+        if (uringServer) {
+            printf("Backend io_uring actif (accept/recv multishot, envois groupés)\n");
+        } else {
+            printf("ATTENTION: io_uring indisponible, repli sur le mode %s\n",
+                   config.reactorMode ? "réacteur" : "thread par session");
+        }
+    }
+
+    // ================================================================
+    // CRÉATION DES RÉACTEURS (MODE RÉACTEUR)
+    // ================================================================
+
+    vector<pthread_t> reactorThreads;
+    if (config.reactorMode && !uringServer) {
+        reactors.resize(config.nbReactors);
+        reactorThreads.resize(config.nbReactors);
+        for (int i = 0; i < config.nbReactors; ++i) {
+            reactors[i].epollFd = epoll_create1(EPOLL_CLOEXEC);
+            reactors[i].listenSocket = -1;
+            // Avec SO_REUSEPORT, chaque réacteur accepte sur son propre socket
+            bool attached = nbListeners == 1 || i >= nbListeners ||
+                            (reactors[i].epollFd >= 0 &&
+                             attachListener(&reactors[i], listenSockets[i]));
+            if (reactors[i].epollFd < 0 || !attached ||
+                pthread_create(&reactorThreads[i], nullptr, reactorThread,
+                               &reactors[i]) != 0) {
+                perror("ERREUR: Impossible de créer le réacteur");
+                closeSocket(serverSocket);
+                return 1;
+            }
+        }
+        printf("%d réacteur(s) créé(s) avec succès\n", config.nbReactors);
+    }
+
+    // ================================================================
+    // CRÉATION DES ACCEPTEURS (SO_REUSEPORT, MODES THREAD PAR SESSION ET COROUTINE)
+    // ================================================================
+
+    // Le thread principal accepte sur le premier socket d'écoute
+    vector<pthread_t> acceptorThreads;
+    if (!config.reactorMode && !uringServer) {
+        for (int i = 1; i < nbListeners; ++i) {
+            pthread_t thread;
+            if (pthread_create(&thread, nullptr, acceptorThread,
+                               (void *)(intptr_t)listenSockets[i]) != 0) {
+                perror("ERREUR: Impossible de créer le thread accepteur");
+                closeSocket(serverSocket);
+                return 1;
+            }
+            acceptorThreads.push_back(thread);
+        }
+        if (nbListeners > 1) {
+            printf("%d accepteur(s) SO_REUSEPORT actif(s)\n", nbListeners);
+        }
+    }
+
+    // Le socket local a son propre accepteur (sauf avec io_uring)
+    if (unixSocket >= 0 && !uringServer) {
+        pthread_t thread;
+        if (pthread_create(&thread, nullptr, acceptorThread, (void *)(intptr_t)unixSocket) != 0) {
+            perror("ERREUR: Impossible de créer le thread accepteur");
+            closeSocket(serverSocket);
+            return 1;
+        }
+        acceptorThreads.push_back(thread);
     }
-    printf("Pool de %d threads créé avec succès\n", config.nbThreads);
 
     // ================================================================
     // BOUCLE PRINCIPALE - ACCEPTATION DES CONNEXIONS
     // ================================================================
     
     printf("Serveur prêt à accepter les connexions...\n");
+    
+    // Le thread principal n'est placé qu'ici : les threads qu'il a créés
+    // ont hérité de son affinité d'origine
+    if (uringServer) {
+        // La boucle io_uring accepte, reçoit et envoie jusqu'à l'arrêt
+        bindThread(PLACEMENT_REACTOR);
+        if (UringServerRun(uringServer) < 0) {
+            fprintf(stderr, "ERREUR: Boucle io_uring interrompue\n");
+        }
+        stop = true;
+    }
+    if (!reactors.empty() && nbListeners > 1) {
+        // Les réacteurs acceptent eux-mêmes : attendre leur fin
+        for (auto &thread : reactorThreads) {
+            pthread_join(thread, nullptr);
+        }
+        reactorThreads.clear();
+        stop = true;
+    }
+    if (!stop) {
+        bindThread(PLACEMENT_ACCEPTOR);
+    }
     while (!stop) {
         char ipClient[INET_ADDRSTRLEN] = {0};
         int clientSocket = AcceptConnection(serverSocket, ipClient);
@@ -831,14 +2743,8 @@ int main() {
         
         printf("Connexion acceptée de %s (socket %d)\n", ipClient, clientSocket);
         
-        // Ajouter la tâche à la file d'attente
-        pthread_mutex_lock(&mutex);
-        tasks.push({clientSocket, {0}});
-        strncpy(tasks.back().ip, ipClient, INET_ADDRSTRLEN - 1);
-        pthread_cond_signal(&condition);
-        pthread_mutex_unlock(&mutex);
-        
-        printf("Tâche ajoutée à la file d'attente\n");
+        // Répartir entre les réacteurs ou ajouter à la file d'attente
+        handOffClient(clientSocket, ipClient);
     }
 
     // ================================================================
@@ -847,16 +2753,60 @@ int main() {
     
     printf("Arrêt du serveur demandé...\n");
     stop = true;
-    pthread_cond_broadcast(&condition);
     
     // Attendre que tous les threads se terminent
-    for (auto &thread : threads) {
+    for (auto &thread : reactorThreads) {
         pthread_join(thread, nullptr);
     }
+    for (auto &reactor : reactors) {
+        close(reactor.epollFd);
+    }
+    
+    // Réveiller les accepteurs bloqués dans accept()
+    for (int listenSocket : listenSockets) {
+        shutdown(listenSocket, SHUT_RDWR);
+    }
+    if (unixSocket >= 0) {
+        shutdown(unixSocket, SHUT_RDWR);
+    }
+    for (auto &thread : acceptorThreads) {
+        pthread_join(thread, nullptr);
+    }
+    if (statsStarted) {
+        pthread_join(statsThread, nullptr);
+    }
+    
+    // Arrêter les étapes dans l'ordre du pipeline : chacune termine ses
+    // tâches en alimentant la suivante, encore active
+    ExecutorStop(executor);
+    ExecutorStop(dbStage);
+    ExecutorStop(encodeStage);
+    reportStages();
+    AdmissionDestroy(admission);
+    PoolSizerDestroy(poolSizer);
+    CoSchedulerDestroy(coScheduler);
+    ExecutorDestroy(encodeStage);
+    ExecutorDestroy(dbStage);
+    ExecutorDestroy(executor);
+    BookingDestroy(bookingEngine);
+    PatientDirectoryDestroy(patientDirectory);
+    ReferenceCacheDestroy(referenceCache);
     printf("Tous les threads terminés\n");
+    IdleMonitorDestroy(idleMonitor);
+    DbPoolReport(dbPool);
+    DbPoolDestroy(dbPool);
+    DalDestroy(dal);
+    mysql_library_end();
     
-    // Fermer le socket serveur
-    closeSocket(serverSocket);
+    // Libérer la boucle io_uring puis fermer les sockets d'écoute
+    UringServerDestroy(uringServer);
+    for (int listenSocket : listenSockets) {
+        closeSocket(listenSocket);
+    }
+    if (unixSocket >= 0) {
+        closeSocket(unixSocket);
+        unlink(config.unixSocketPath.c_str());
+    }
     printf("Serveur arrêté proprement\n");
     
     return 0;
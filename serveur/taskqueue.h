@@ -0,0 +1,298 @@
+/**
+ * File de tâches bornée sans verrou (plusieurs producteurs, plusieurs consommateurs)
+ *
+ * Anneau à numéros de séquence : chaque case porte un compteur qui indique
+ * si elle est libre pour le producteur du tour courant ou prête pour le
+ * consommateur. Producteurs et consommateurs réservent une case par un
+ * compare-and-swap sur leur position, sans jamais prendre de verrou.
+ *
+ * Les threads qui doivent attendre (file vide ou pleine) dorment sur un futex.
+ * Le compteur d'attente n'est consulté qu'après une insertion ou un retrait :
+ * tant que personne ne dort, aucun appel système n'est fait.
+ */
+
+#ifndef TASKQUEUE_H
+#define TASKQUEUE_H
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+#define TAILLE_LIGNE_CACHE 64       // Séparation des compteurs partagés
+#define ESSAIS_AVANT_SOMMEIL 64     // Tentatives avant de dormir sur le futex (multicœur)
+
+// ============================================================================
+// FILE DE TÂCHES
+// ============================================================================
+
+/**
+ * File bornée de valeurs T (copiables), thread-safe et sans verrou
+ */
+template <typename T>
+class TaskQueue {
+public:
+    /**
+     * Crée la file
+     * @param capacite Nombre maximal de tâches en attente (arrondi à une puissance de 2)
+     */
+    explicit TaskQueue(size_t capacite) {
+        size_t taille = 2;
+        while (taille < capacite) {
+            taille <<= 1;
+        }
+        masque = taille - 1;
+        cases = new Case[taille];
+        for (size_t i = 0; i < taille; i++) {
+            cases[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        positionInsertion.store(0, std::memory_order_relaxed);
+        positionRetrait.store(0, std::memory_order_relaxed);
+        // Sur un seul cœur, insister ne fait que retarder le thread attendu
+        essaisAvantSommeil = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? ESSAIS_AVANT_SOMMEIL : 1;
+    }
+
+    ~TaskQueue() {
+        delete[] cases;
+    }
+
+    TaskQueue(const TaskQueue &) = delete;
+    TaskQueue &operator=(const TaskQueue &) = delete;
+
+    /**
+     * Ajoute une tâche sans attendre
+     * @param tache Tâche à ajouter
+     * @return true si la tâche est ajoutée, false si la file est pleine ou fermée
+     */
+    bool tryPush(const T &tache) {
+        if (fermee.load(std::memory_order_acquire)) {
+            return false;
+        }
+        size_t position = positionInsertion.load(std::memory_order_relaxed);
+        while (true) {
+            Case *c = &cases[position & masque];
+            size_t sequence = c->sequence.load(std::memory_order_acquire);
+            intptr_t ecart = (intptr_t)sequence - (intptr_t)position;
+            if (ecart == 0) {
+                if (positionInsertion.compare_exchange_weak(position, position + 1,
+                                                            std::memory_order_relaxed)) {
+                    c->valeur = tache;
+                    c->sequence.store(position + 1, std::memory_order_release);
+                    reveiller(consommateurs);
+                    return true;
+                }
+            } else if (ecart < 0) {
+                return false;
+            } else {
+                position = positionInsertion.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Retire une tâche sans attendre
+     * @param tache Tâche retirée
+     * @return true si une tâche est retirée, false si la file est vide
+     */
+    bool tryPop(T &tache) {
+        size_t position = positionRetrait.load(std::memory_order_relaxed);
+        while (true) {
+            Case *c = &cases[position & masque];
+            size_t sequence = c->sequence.load(std::memory_order_acquire);
+            intptr_t ecart = (intptr_t)sequence - (intptr_t)(position + 1);
+            if (ecart == 0) {
+                if (positionRetrait.compare_exchange_weak(position, position + 1,
+                                                          std::memory_order_relaxed)) {
+                    tache = c->valeur;
+                    c->sequence.store(position + masque + 1, std::memory_order_release);
+                    reveiller(producteurs);
+                    return true;
+                }
+            } else if (ecart < 0) {
+                return false;
+            } else {
+                position = positionRetrait.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Ajoute une tâche, en attendant une place si la file est pleine
+     * @param tache Tâche à ajouter
+     * @return true si la tâche est ajoutée, false si la file est fermée
+     */
+    bool push(const T &tache) {
+        if (fermee.load(std::memory_order_acquire)) {
+            return false;
+        }
+        while (true) {
+            for (int essai = 0; essai < essaisAvantSommeil; essai++) {
+                if (tryPush(tache)) {
+                    return true;
+                }
+            }
+            uint32_t tour = declarer(producteurs);
+            bool ajoutee = tryPush(tache);
+            if (!ajoutee && !fermee.load(std::memory_order_acquire)) {
+                attendre(producteurs, tour);
+            }
+            partir(producteurs);
+            if (ajoutee) {
+                return true;
+            }
+            if (fermee.load(std::memory_order_acquire)) {
+                return false;
+            }
+        }
+    }
+
+    /**
+     * Retire une tâche, en dormant tant que la file est vide
+     * @param tache Tâche retirée
+     * @return true si une tâche est retirée, false si la file est fermée et vide
+     */
+    bool pop(T &tache) {
+        while (true) {
+            for (int essai = 0; essai < essaisAvantSommeil; essai++) {
+                if (tryPop(tache)) {
+                    return true;
+                }
+            }
+            uint32_t tour = declarer(consommateurs);
+            bool retiree = tryPop(tache);
+            if (!retiree && !fermee.load(std::memory_order_acquire)) {
+                attendre(consommateurs, tour);
+            }
+            partir(consommateurs);
+            if (retiree) {
+                return true;
+            }
+            if (fermee.load(std::memory_order_acquire) && !tryPop(tache)) {
+                return false;
+            }
+        }
+    }
+
+    /**
+     * Nombre approximatif de tâches en attente (instantané sans verrou)
+     * @return Tâches déposées et pas encore retirées
+     */
+    size_t sizeApprox() const {
+        size_t retrait = positionRetrait.load(std::memory_order_relaxed);
+        size_t insertion = positionInsertion.load(std::memory_order_relaxed);
+        return insertion > retrait ? insertion - retrait : 0;
+    }
+
+    /**
+     * Ferme la file : pop() vide les tâches restantes puis renvoie false,
+     * push() et tryPush() refusent toute nouvelle tâche (false), même s'il
+     * reste de la place. Réveille tous les threads endormis.
+     */
+    void close() {
+        fermee.store(true, std::memory_order_seq_cst);
+        reveillerTous(consommateurs);
+        reveillerTous(producteurs);
+    }
+
+private:
+    /**
+     * Case de l'anneau
+     */
+    struct Case {
+        std::atomic<size_t> sequence;   // Tour auquel la case est libre ou prête
+        T valeur;
+    };
+
+    /**
+     * Point de rendez-vous des threads endormis d'un côté de la file.
+     * L'état regroupe dans un seul mot les threads déclarés en attente (32 bits
+     * de poids fort) et les réveils déjà envoyés mais pas encore constatés
+     * (32 bits de poids faible) : un thread réveillé qui attend encore d'être
+     * ordonnancé ne provoque pas un nouvel appel système à chaque insertion.
+     */
+    struct alignas(TAILLE_LIGNE_CACHE) Sommeil {
+        std::atomic<uint32_t> tour{0};      // Mot du futex, incrémenté à chaque réveil
+        std::atomic<uint64_t> etat{0};      // Dormeurs << 32 | réveils en cours
+    };
+
+    static const uint64_t UN_DORMEUR = 1ULL << 32;
+    static const uint64_t MASQUE_REVEILS = UN_DORMEUR - 1;
+
+    static long futex(std::atomic<uint32_t> *mot, int operation, uint32_t valeur) {
+        return syscall(SYS_futex, reinterpret_cast<uint32_t *>(mot),
+                       operation | FUTEX_PRIVATE_FLAG, valeur, NULL, NULL, 0);
+    }
+
+    /**
+     * Déclare le thread en attente (à faire avant la dernière tentative)
+     * @return Tour à passer à attendre()
+     */
+    static uint32_t declarer(Sommeil &sommeil) {
+        // Lire le tour avant de se déclarer : un réveil postérieur change le
+        // tour et le futex ne s'endort pas
+        uint32_t tour = sommeil.tour.load(std::memory_order_acquire);
+        sommeil.etat.fetch_add(UN_DORMEUR, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return tour;
+    }
+
+    static void attendre(Sommeil &sommeil, uint32_t tour) {
+        futex(&sommeil.tour, FUTEX_WAIT, tour);
+    }
+
+    /**
+     * Retire la déclaration du thread et consomme un réveil en cours
+     */
+    static void partir(Sommeil &sommeil) {
+        uint64_t etat = sommeil.etat.load(std::memory_order_relaxed);
+        uint64_t nouveau;
+        do {
+            nouveau = etat - UN_DORMEUR;
+            if ((etat & MASQUE_REVEILS) > 0) {
+                nouveau -= 1;
+            }
+        } while (!sommeil.etat.compare_exchange_weak(etat, nouveau, std::memory_order_relaxed));
+    }
+
+    /**
+     * Réveille un thread endormi (après une insertion ou un retrait), sauf si
+     * tous les threads déclarés ont déjà reçu un réveil
+     */
+    static void reveiller(Sommeil &sommeil) {
+        // Ordonne la publication de la case avant la lecture de l'état
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint64_t etat = sommeil.etat.load(std::memory_order_relaxed);
+        while ((etat >> 32) > (etat & MASQUE_REVEILS)) {
+            if (sommeil.etat.compare_exchange_weak(etat, etat + 1, std::memory_order_relaxed)) {
+                sommeil.tour.fetch_add(1, std::memory_order_release);
+                futex(&sommeil.tour, FUTEX_WAKE, 1);
+                return;
+            }
+        }
+    }
+
+    static void reveillerTous(Sommeil &sommeil) {
+        sommeil.tour.fetch_add(1, std::memory_order_seq_cst);
+        futex(&sommeil.tour, FUTEX_WAKE, INT_MAX);
+    }
+
+    Case *cases;                                            // Anneau de cases
+    size_t masque;                                          // Taille - 1
+    int essaisAvantSommeil;                                 // Tentatives avant le futex
+    alignas(TAILLE_LIGNE_CACHE) std::atomic<size_t> positionInsertion;
+    alignas(TAILLE_LIGNE_CACHE) std::atomic<size_t> positionRetrait;
+    alignas(TAILLE_LIGNE_CACHE) std::atomic<bool> fermee{false};
+    Sommeil consommateurs;                                  // File vide : workers
+    Sommeil producteurs;                                    // File pleine : producteurs
+};
+
+#endif // TASKQUEUE_H
@@ -0,0 +1,168 @@
+/**
+ * Test du moteur de réservation : une demande refusée par MySQL dans un lot
+ *
+ * Soumet d'un coup NB_DEMANDES réservations de créneaux libres, regroupées
+ * dans un même lot ; l'une d'elles désigne un patient inexistant (clé
+ * étrangère violée). Seule cette demande doit échouer (BOOKING_ERROR), les
+ * autres doivent être validées (BOOKING_OK) dans la même transaction.
+ * Les créneaux réservés sont libérés à la fin : le test peut tourner sur la
+ * base réelle (données de BD_Hospital/CreationBD).
+ *
+ * Usage : test_booking [hote] [utilisateur] [motDePasse] [base]
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "booking.h"
+#include "testdb.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+#define NB_DEMANDES 5
+#define DEMANDE_REFUSEE 2           // Rang de la demande au patient inexistant
+#define FENETRE_US 200000           // Fenêtre du lot : toutes les demandes y entrent
+
+static const char *MOTIF = "Test du moteur de réservation";
+
+// ============================================================================
+// FONCTIONS INTERNES
+// ============================================================================
+
+/**
+ * Exécute une requête texte et lit la première colonne de chaque ligne
+ * @param connexion Connexion empruntée
+ * @param requete Requête SQL
+ * @param valeurs Valeurs lues (entiers)
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+static int lireEntiers(MYSQL *connexion, const char *requete, std::vector<int> &valeurs) {
+    if (mysql_query(connexion, requete) != 0) {
+        fprintf(stderr, "Échec de la requête: %s\n", mysql_error(connexion));
+        return -1;
+    }
+    MYSQL_RES *resultat = mysql_store_result(connexion);
+    if (!resultat) {
+        return -1;
+    }
+    MYSQL_ROW ligne;
+    while ((ligne = mysql_fetch_row(resultat)) != NULL) {
+        if (ligne[0]) {
+            valeurs.push_back(atoi(ligne[0]));
+        }
+    }
+    mysql_free_result(resultat);
+    return 0;
+}
+
+/**
+ * Nom d'un résultat de réservation (traces)
+ */
+static const char *nomResultat(BookingResult resultat) {
+    switch (resultat) {
+        case BOOKING_OK: return "BOOKING_OK";
+        case BOOKING_TAKEN: return "BOOKING_TAKEN";
+        case BOOKING_NOT_FOUND: return "BOOKING_NOT_FOUND";
+        case BOOKING_ERROR: return "BOOKING_ERROR";
+    }
+    return "?";
+}
+
+// ============================================================================
+// FONCTION PRINCIPALE
+// ============================================================================
+
+int main(int argc, char *argv[]) {
+    TestDb db;
+    if (TestDbOpen(&db, argc, argv, 2) < 0) {
+        return 1;
+    }
+    DbPool *pool = db.pool;
+    MYSQL *connexion = DbPoolAcquire(pool);
+    if (!connexion) {
+        fprintf(stderr, "Connexion à la base impossible\n");
+        return 1;
+    }
+
+    // Créneaux libres et patients (existant, inexistant)
+    std::vector<int> creneaux, premier, dernier;
+    char requete[256];
+    snprintf(requete, sizeof(requete),
+             "SELECT id FROM consultations WHERE patient_id IS NULL ORDER BY id DESC LIMIT %d",
+             NB_DEMANDES);
+    if (lireEntiers(connexion, requete, creneaux) < 0 ||
+        lireEntiers(connexion, "SELECT MIN(id) FROM patients", premier) < 0 ||
+        lireEntiers(connexion, "SELECT MAX(id) FROM patients", dernier) < 0 ||
+        creneaux.size() < NB_DEMANDES || premier.empty() || dernier.empty()) {
+        fprintf(stderr, "Il faut %d consultations libres et au moins un patient\n", NB_DEMANDES);
+        DbPoolRelease(pool, connexion);
+        return 1;
+    }
+    int patient = premier[0];
+    int inexistant = dernier[0] + 1;
+    DbPoolRelease(pool, connexion);
+
+    BookingConfig bookingConfig = {FENETRE_US, NB_DEMANDES};
+    BookingEngine *engine = BookingCreate(&bookingConfig, pool, db.dal);
+    if (!engine) {
+        fprintf(stderr, "Impossible de créer le moteur de réservation\n");
+        return 1;
+    }
+
+    // Toutes les demandes sont soumises avant d'en attendre une : elles
+    // forment un seul lot
+    BookingRequest demandes[NB_DEMANDES];
+    for (int i = 0; i < NB_DEMANDES; i++) {
+        demandes[i].consultationId = creneaux[i];
+        demandes[i].patientId = i == DEMANDE_REFUSEE ? inexistant : patient;
+        demandes[i].reason = MOTIF;
+        demandes[i].reasonLength = strlen(MOTIF);
+        demandes[i].notifyFd = -1;
+        BookingSubmit(engine, &demandes[i]);
+    }
+
+    int echecs = 0;
+    for (int i = 0; i < NB_DEMANDES; i++) {
+        BookingResult attendu = i == DEMANDE_REFUSEE ? BOOKING_ERROR : BOOKING_OK;
+        BookingResult obtenu = BookingWait(engine, &demandes[i]);
+        printf("Consultation %d, patient %d : %s\n", demandes[i].consultationId,
+               demandes[i].patientId, nomResultat(obtenu));
+        if (obtenu != attendu) {
+            printf("ÉCHEC: %s attendu\n", nomResultat(attendu));
+            echecs++;
+        }
+    }
+
+    BookingStats stats;
+    BookingGetStats(engine, &stats);
+    if (stats.batches != 1) {
+        printf("ÉCHEC: %llu lots au lieu d'un seul\n", stats.batches);
+        echecs++;
+    }
+    BookingDestroy(engine);
+
+    // Libération des créneaux réservés par le test
+    connexion = DbPoolAcquire(pool);
+    for (int i = 0; connexion && i < NB_DEMANDES; i++) {
+        if (demandes[i].result == BOOKING_OK) {
+            snprintf(requete, sizeof(requete),
+                     "UPDATE consultations SET patient_id = NULL, reason = '' WHERE id = %d",
+                     demandes[i].consultationId);
+            if (mysql_query(connexion, requete) != 0) {
+                fprintf(stderr, "Consultation %d non libérée: %s\n", demandes[i].consultationId,
+                        mysql_error(connexion));
+            }
+        }
+    }
+    if (connexion) {
+        DbPoolRelease(pool, connexion);
+    }
+    TestDbClose(&db);
+    return TestVerdict(echecs);
+}
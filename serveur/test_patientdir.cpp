@@ -0,0 +1,123 @@
+/**
+ * Test de l'annuaire des patients : patient créé en dehors du serveur
+ *
+ * Charge l'annuaire, puis crée deux patients dans la base : le premier sans
+ * prévenir l'annuaire (comme le serveur C de server/), le second en
+ * l'ajoutant comme le fait LOGIN_NEW. Le premier a donc un identifiant
+ * inférieur au plus récent de l'annuaire sans y figurer : sa vérification
+ * doit être renvoyée à la base (PATIENT_UNSURE), puis, une fois confirmé par
+ * la base et ajouté, être résolue par l'annuaire (PATIENT_KNOWN).
+ * Les patients de test sont supprimés à la fin : le test peut tourner sur la
+ * base réelle (données de BD_Hospital/CreationBD).
+ *
+ * Usage : test_patientdir [hote] [utilisateur] [motDePasse] [base]
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "patientdir.h"
+#include "testdb.h"
+#include <stdio.h>
+#include <string>
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+static const std::string NOM = "Test";
+static const std::string PRENOM_EXTERNE = "Annuaire externe";
+static const std::string PRENOM_SERVEUR = "Annuaire serveur";
+
+// ============================================================================
+// FONCTIONS INTERNES
+// ============================================================================
+
+static int echecs = 0;
+
+/**
+ * Compare la réponse de l'annuaire à la réponse attendue
+ * @param cas Description du cas (traces)
+ * @param obtenu Réponse de PatientDirectoryVerify
+ * @param attendu Réponse attendue
+ */
+static void verifier(const char *cas, PatientLookup obtenu, PatientLookup attendu) {
+    static const char *noms[] = {"PATIENT_KNOWN", "PATIENT_UNKNOWN", "PATIENT_UNSURE"};
+    printf("%-40s %s\n", cas, noms[obtenu]);
+    if (obtenu != attendu) {
+        printf("ÉCHEC: %s attendu\n", noms[attendu]);
+        echecs++;
+    }
+}
+
+/**
+ * Crée un patient dans la base
+ * @return Identifiant du patient ou -1 en cas d'erreur
+ */
+static int creerPatient(Dal *dal, MYSQL *connexion, const std::string &prenom) {
+    DalParam params[] = {DalText(NOM), DalText(prenom)};
+    long long id = -1;
+    if (DalExecute(dal, connexion, DAL_PATIENT_INSERT, params, &id) < 0) {
+        return -1;
+    }
+    return (int)id;
+}
+
+// ============================================================================
+// FONCTION PRINCIPALE
+// ============================================================================
+
+int main(int argc, char *argv[]) {
+    TestDb db;
+    if (TestDbOpen(&db, argc, argv, 1) < 0) {
+        return 1;
+    }
+    DbPool *pool = db.pool;
+    Dal *dal = db.dal;
+    PatientDirectory *directory = PatientDirectoryLoad(pool, dal);
+    MYSQL *connexion = directory ? DbPoolAcquire(pool) : NULL;
+    if (!connexion) {
+        fprintf(stderr, "Connexion à la base impossible\n");
+        return 1;
+    }
+
+    // Patient externe, puis patient du serveur (plus récent, dans l'annuaire)
+    int externe = creerPatient(dal, connexion, PRENOM_EXTERNE);
+    int serveur = creerPatient(dal, connexion, PRENOM_SERVEUR);
+    if (externe <= 0 || serveur <= 0) {
+        fprintf(stderr, "Impossible de créer les patients de test\n");
+        DbPoolRelease(pool, connexion);
+        return 1;
+    }
+    PatientDirectoryAdd(directory, serveur, NOM, PRENOM_SERVEUR);
+
+    verifier("Patient du serveur", PatientDirectoryVerify(directory, serveur, NOM, PRENOM_SERVEUR),
+             PATIENT_KNOWN);
+    verifier("Patient externe (absent de l'annuaire)",
+             PatientDirectoryVerify(directory, externe, NOM, PRENOM_EXTERNE), PATIENT_UNSURE);
+
+    // Vérification dans la base, comme LOGIN_EXIST, puis ajout à l'annuaire
+    DalParam params[] = {DalNumber(externe), DalText(NOM), DalText(PRENOM_EXTERNE)};
+    DalRows *rows = DalSelect(dal, connexion, DAL_PATIENT_VERIFY, params);
+    if (!rows || DalRowsCount(rows) == 0) {
+        printf("ÉCHEC: patient externe introuvable dans la base\n");
+        echecs++;
+    } else {
+        PatientDirectoryAdd(directory, externe, NOM, PRENOM_EXTERNE);
+    }
+    DalRowsFree(rows);
+    verifier("Patient externe (confirmé par la base)",
+             PatientDirectoryVerify(directory, externe, NOM, PRENOM_EXTERNE), PATIENT_KNOWN);
+    verifier("Identifiant nul", PatientDirectoryVerify(directory, 0, NOM, PRENOM_EXTERNE),
+             PATIENT_UNKNOWN);
+
+    // Suppression des patients de test
+    char requete[128];
+    snprintf(requete, sizeof(requete), "DELETE FROM patients WHERE id IN (%d, %d)", externe, serveur);
+    if (mysql_query(connexion, requete) != 0) {
+        fprintf(stderr, "Patients de test non supprimés: %s\n", mysql_error(connexion));
+    }
+    DbPoolRelease(pool, connexion);
+    PatientDirectoryDestroy(directory);
+    TestDbClose(&db);
+    return TestVerdict(echecs);
+}
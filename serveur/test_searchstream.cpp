@@ -0,0 +1,144 @@
+/**
+ * Test du découpage en trames d'une réponse SEARCH envoyée au fil de la lecture
+ *
+ * Chaque cas écrit une réponse sur une paire de sockets, puis la relit trame
+ * par trame comme le client : toutes les trames sauf la dernière commencent
+ * par MARQUE_SUITE, aucune ne dépasse TAILLE_TRAME, la dernière n'est pas
+ * vide (le client y verrait une connexion perdue) et le message reconstitué
+ * est identique à la réponse attendue. Les cas couvrent notamment une
+ * dernière ligne plus longue qu'une trame.
+ *
+ * Usage : test_searchstream
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "searchstream.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+#define ENTETE "SEARCH_OK;"
+#define LONGUEUR_LONGUE 1500        // Nom de médecin plus long qu'une trame
+
+// ============================================================================
+// FONCTIONS INTERNES
+// ============================================================================
+
+static int echecs = 0;
+
+/**
+ * Consultation de test
+ * @param id Identifiant
+ * @param medecin Nom du médecin
+ * @return Champs de la consultation (SEARCH_FIELDS)
+ */
+static std::vector<std::string> consultation(int id, const std::string &medecin) {
+    return {std::to_string(id), "Cardiologie", medecin, "2025-10-01", "09:00"};
+}
+
+/**
+ * Envoie une réponse puis la relit trame par trame
+ * @param cas Description du cas (traces)
+ * @param lignes Consultations de la réponse
+ */
+static void verifier(const char *cas, const std::vector<std::vector<std::string>> &lignes) {
+    int paire[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, paire) < 0) {
+        perror("socketpair");
+        echecs++;
+        return;
+    }
+
+    // Réponse attendue et réponse envoyée
+    std::string attendu = ENTETE;
+    SearchStream stream;
+    SearchStreamInit(&stream, paire[0], ENTETE);
+    int resultat = 0;
+    for (size_t i = 0; i < lignes.size(); i++) {
+        const char *fields[SEARCH_FIELDS];
+        unsigned long lengths[SEARCH_FIELDS];
+        for (int j = 0; j < SEARCH_FIELDS; j++) {
+            fields[j] = lignes[i][j].c_str();
+            lengths[j] = lignes[i][j].size();
+            attendu += (j > 0 ? ";" : (i > 0 ? "|" : "")) + lignes[i][j];
+        }
+        if (resultat == 0) {
+            resultat = SearchStreamAdd(&stream, fields, lengths);
+        }
+    }
+    if (resultat == 0) {
+        resultat = SearchStreamFinish(&stream);
+    }
+    shutdown(paire[0], SHUT_WR);
+
+    // Lecture comme le client
+    FrameReader reader;
+    FrameReaderInit(&reader, paire[1]);
+    std::string recu;
+    int nbTrames = 0;
+    bool complet = false;
+    const char *erreur = resultat < 0 ? "envoi impossible" : NULL;
+    while (!erreur && !complet) {
+        char *trame;
+        int taille = ReceiveFrame(&reader, &trame);
+        if (taille < 0) {
+            erreur = "réponse sans dernière trame";
+        } else if (taille == 0) {
+            erreur = "dernière trame vide";
+        } else if (taille > TAILLE_TRAME) {
+            erreur = "trame plus longue que TAILLE_TRAME";
+        } else if (trame[0] == MARQUE_SUITE) {
+            recu.append(trame + 1, taille - 1);
+        } else {
+            recu.append(trame, taille);
+            complet = true;
+        }
+        nbTrames++;
+    }
+    if (!erreur && recu != attendu) {
+        erreur = "message reconstitué différent";
+    }
+    close(paire[0]);
+    close(paire[1]);
+
+    printf("%-45s %d trame(s), %zu octets\n", cas, nbTrames, recu.size());
+    if (erreur) {
+        printf("ÉCHEC: %s\n", erreur);
+        echecs++;
+    }
+}
+
+// ============================================================================
+// FONCTION PRINCIPALE
+// ============================================================================
+
+int main() {
+    std::string longue(LONGUEUR_LONGUE, 'X');
+
+    verifier("Réponse sans consultation", {});
+    verifier("Réponse d'une trame", {consultation(1, "Dupont"), consultation(2, "Martin")});
+
+    std::vector<std::vector<std::string>> lignes;
+    for (int i = 0; i < 100; i++) {
+        lignes.push_back(consultation(i, "Dupont"));
+    }
+    verifier("Réponse de plusieurs trames", lignes);
+
+    lignes.push_back(consultation(100, longue));
+    verifier("Dernière ligne plus longue qu'une trame", lignes);
+    verifier("Seule ligne plus longue qu'une trame", {consultation(1, longue)});
+    verifier("Ligne longue suivie d'une ligne courte",
+             {consultation(1, "Dupont"), consultation(2, longue), consultation(3, "Martin")});
+    verifier("Lignes longues consécutives", {consultation(1, longue), consultation(2, longue)});
+
+    printf(echecs ? "ÉCHEC du test\n" : "Test réussi\n");
+    return echecs ? 1 : 0;
+}
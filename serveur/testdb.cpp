@@ -0,0 +1,73 @@
+/**
+ * Implémentation des outils communs des tests sur base MySQL
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "testdb.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+#define ATTENTE_CONNEXION_MS 2000   // Attente maximale d'une connexion libre
+#define VERIFICATION_MS 5000        // Inutilisation avant vérification
+
+// ============================================================================
+// FONCTIONS PUBLIQUES
+// ============================================================================
+
+/**
+ * Crée le pool et les requêtes préparées
+ * @param db Base du test à remplir
+ * @param argc Nombre d'arguments du programme
+ * @param argv Arguments : [hote] [utilisateur] [motDePasse] [base]
+ * @param maxConnections Connexions ouvertes au maximum
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int TestDbOpen(TestDb *db, int argc, char *argv[], int maxConnections) {
+    DbPoolConfig poolConfig;
+    memset(&poolConfig, 0, sizeof(poolConfig));
+    poolConfig.host = argc > 1 ? argv[1] : "localhost";
+    poolConfig.user = argc > 2 ? argv[2] : "Student";
+    poolConfig.password = argc > 3 ? argv[3] : "PassStudent1_";
+    poolConfig.database = argc > 4 ? argv[4] : "PourStudent";
+    poolConfig.maxConnections = maxConnections;
+    poolConfig.acquireTimeoutMs = ATTENTE_CONNEXION_MS;
+    poolConfig.pingIntervalMs = VERIFICATION_MS;
+
+    mysql_library_init(0, NULL, NULL);
+    db->dal = DalCreate();
+    poolConfig.onClose = DalForget;
+    poolConfig.closeContext = db->dal;
+    db->pool = DbPoolCreate(&poolConfig);
+    if (!db->pool) {
+        fprintf(stderr, "Impossible de créer le pool de connexions\n");
+        DalDestroy(db->dal);
+        mysql_library_end();
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Ferme le pool et les requêtes préparées
+ * @param db Base du test
+ */
+void TestDbClose(TestDb *db) {
+    DbPoolDestroy(db->pool);
+    DalDestroy(db->dal);
+    mysql_library_end();
+}
+
+/**
+ * Affiche le verdict du test
+ * @param echecs Nombre de vérifications en échec
+ * @return Code de sortie du test
+ */
+int TestVerdict(int echecs) {
+    printf(echecs ? "ÉCHEC du test\n" : "Test réussi\n");
+    return echecs ? 1 : 0;
+}
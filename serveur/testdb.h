@@ -0,0 +1,55 @@
+/**
+ * Outils communs des tests sur base MySQL (test_booking, test_patientdir)
+ *
+ * Ouvre le pool et les requêtes préparées sur la base désignée en ligne de
+ * commande (par défaut celle de BD_Hospital/CreationBD), les referme, et
+ * affiche le verdict du test.
+ */
+
+#ifndef TESTDB_H
+#define TESTDB_H
+
+#include "dal.h"
+#include "dbpool.h"
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Base de données d'un test
+ */
+typedef struct {
+    Dal *dal;                       // Requêtes préparées des connexions du pool
+    DbPool *pool;                   // Pool de connexions
+} TestDb;
+
+// ============================================================================
+// FONCTIONS
+// ============================================================================
+
+/**
+ * Crée le pool et les requêtes préparées (les connexions s'ouvrent au
+ * premier emprunt)
+ * @param db Base du test à remplir
+ * @param argc Nombre d'arguments du programme
+ * @param argv Arguments : [hote] [utilisateur] [motDePasse] [base]
+ * @param maxConnections Connexions ouvertes au maximum
+ * @return 0 en cas de succès, -1 en cas d'erreur (message affiché)
+ */
+int TestDbOpen(TestDb *db, int argc, char *argv[], int maxConnections);
+
+/**
+ * Ferme le pool (connexions toutes rendues) et les requêtes préparées
+ * @param db Base du test
+ */
+void TestDbClose(TestDb *db);
+
+/**
+ * Affiche le verdict du test
+ * @param echecs Nombre de vérifications en échec
+ * @return Code de sortie du test (0 si tout a réussi)
+ */
+int TestVerdict(int echecs);
+
+#endif
@@ -0,0 +1,366 @@
+/**
+ * Banc d'essai : coût d'un changement de contexte, coroutines contre pthreads
+ *
+ * Trois mesures, chacune avec des threads POSIX puis avec des coroutines
+ * (coroutine.h) :
+ * - appel : co_await d'une coroutine qui se termine aussitôt, comparé à
+ *   l'appel d'une fonction ordinaire
+ * - relais : deux contextes se passent la main sans E/S (sémaphores entre
+ *   deux threads, CoYield entre deux coroutines d'un même thread)
+ * - ping-pong : nbSessions paires client / écho sur des socketpair, comme
+ *   une session du serveur (ReceiveFrame + Send bloquants dans un thread par
+ *   extrémité, CoReceiveFrame + CoSend sur nbThreads threads d'ordonnanceur)
+ *
+ * Les changements de contexte du noyau (getrusage) sont comptés pour tout
+ * le processus pendant chaque mesure.
+ *
+ * Usage : bench_coroutine [nbAllerRetours] [nbSessions] [nbThreads]
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "socket.h"
+#include "coroutine.h"
+#include <pthread.h>
+#include <semaphore.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <atomic>
+#include <vector>
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+#define MESSAGE "GET_SPECIALTIES"
+
+// ============================================================================
+// MESURE
+// ============================================================================
+
+/**
+ * Mesure en cours : durée et changements de contexte du noyau
+ */
+struct Mesure {
+    long long debutNs;
+    long commutationsNoyau;
+};
+
+static long long maintenantNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static long commutationsNoyau() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+
+static void debuter(Mesure *mesure) {
+    mesure->commutationsNoyau = commutationsNoyau();
+    mesure->debutNs = maintenantNs();
+}
+
+/**
+ * Termine une mesure et affiche sa ligne
+ * @param mesure Mesure débutée
+ * @param nom Nom de la mesure
+ * @param nbOperations Opérations effectuées (appels, relais ou allers-retours)
+ */
+static void terminer(const Mesure *mesure, const char *nom, long long nbOperations) {
+    double dureeNs = maintenantNs() - mesure->debutNs;
+    long commutations = commutationsNoyau() - mesure->commutationsNoyau;
+    printf("%-24s %12.1f %14.0f %16ld\n", nom, dureeNs / nbOperations,
+           nbOperations / (dureeNs / 1e9), commutations);
+}
+
+/**
+ * Fin d'un groupe de coroutines : la dernière réveille le thread principal
+ */
+struct Fin {
+    std::atomic<int> restantes;
+    sem_t termine;
+
+    explicit Fin(int nombre) : restantes(nombre) { sem_init(&termine, 0, 0); }
+    ~Fin() { sem_destroy(&termine); }
+
+    void signaler() {
+        if (restantes.fetch_sub(1) == 1) {
+            sem_post(&termine);
+        }
+    }
+
+    void attendre() {
+        while (sem_wait(&termine) < 0) {
+        }
+    }
+};
+
+// ============================================================================
+// APPEL
+// ============================================================================
+
+static volatile long long puits;    // Résultat conservé (appels non éliminés)
+
+static int __attribute__((noipa)) fonctionVide(int valeur) {
+    return valeur + 1;
+}
+
+static CoTask<int> coroutineVide(int valeur) {
+    co_return valeur + 1;
+}
+
+static CoTask<long long> appelerCoroutines(int nbAppels) {
+    long long total = 0;
+    for (int i = 0; i < nbAppels; i++) {
+        total += co_await coroutineVide(i);
+    }
+    co_return total;
+}
+
+/**
+ * Mesure l'appel d'une fonction puis le co_await d'une coroutine
+ * @param nbAppels Nombre d'appels
+ */
+static void mesurerAppels(int nbAppels) {
+    Mesure mesure;
+    long long total = 0;
+
+    debuter(&mesure);
+    for (int i = 0; i < nbAppels; i++) {
+        total += fonctionVide(i);
+    }
+    terminer(&mesure, "appel fonction", nbAppels);
+
+    debuter(&mesure);
+    total += CoRunSync(appelerCoroutines(nbAppels));
+    terminer(&mesure, "appel coroutine", nbAppels);
+    puits = total;
+}
+
+// ============================================================================
+// RELAIS
+// ============================================================================
+
+/**
+ * Extrémité d'un relais entre deux threads
+ */
+struct Relais {
+    sem_t *attendu;                 // Sémaphore attendu avant chaque tour
+    sem_t *suivant;                 // Sémaphore du thread suivant
+    int nbTours;
+};
+
+static void *threadRelais(void *arg) {
+    Relais *relais = (Relais *)arg;
+    for (int i = 0; i < relais->nbTours; i++) {
+        sem_wait(relais->attendu);
+        sem_post(relais->suivant);
+    }
+    return NULL;
+}
+
+static CoTask<void> coroutineRelais(int nbTours, Fin *fin) {
+    for (int i = 0; i < nbTours; i++) {
+        co_await CoYield();
+    }
+    fin->signaler();
+}
+
+/**
+ * Mesure le passage de la main entre deux threads puis entre deux coroutines
+ * @param nbTours Tours de chaque contexte (2 x nbTours relais)
+ */
+static void mesurerRelais(int nbTours) {
+    Mesure mesure;
+
+    sem_t a, b;
+    sem_init(&a, 0, 1);
+    sem_init(&b, 0, 0);
+    Relais relais[2] = {{&a, &b, nbTours}, {&b, &a, nbTours}};
+    pthread_t threads[2];
+    debuter(&mesure);
+    for (int i = 0; i < 2; i++) {
+        pthread_create(&threads[i], NULL, threadRelais, &relais[i]);
+    }
+    for (int i = 0; i < 2; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    terminer(&mesure, "relais pthread", 2LL * nbTours);
+    sem_destroy(&a);
+    sem_destroy(&b);
+
+    // Un seul thread : les deux coroutines alternent dans sa liste des prêtes
+    CoScheduler *scheduler = CoSchedulerCreate(1, NULL);
+    Fin fin(2);
+    debuter(&mesure);
+    CoSchedulerSpawn(scheduler, coroutineRelais(nbTours, &fin));
+    CoSchedulerSpawn(scheduler, coroutineRelais(nbTours, &fin));
+    fin.attendre();
+    terminer(&mesure, "relais coroutine", 2LL * nbTours);
+    CoSchedulerDestroy(scheduler);
+}
+
+// ============================================================================
+// PING-PONG
+// ============================================================================
+
+/**
+ * Extrémité d'une paire client / écho
+ */
+struct Extremite {
+    int socket;
+    int nbAllerRetours;
+    bool client;                    // Le client parle le premier
+};
+
+static void *threadExtremite(void *arg) {
+    Extremite *extremite = (Extremite *)arg;
+    FrameReader reader;
+    FrameReaderInit(&reader, extremite->socket);
+    char *trame = NULL;
+    for (int i = 0; i < extremite->nbAllerRetours; i++) {
+        if ((extremite->client && Send(extremite->socket, MESSAGE, strlen(MESSAGE)) < 0) ||
+            ReceiveFrame(&reader, &trame) <= 0 ||
+            (!extremite->client && Send(extremite->socket, MESSAGE, strlen(MESSAGE)) < 0)) {
+            fprintf(stderr, "ERREUR: Échange interrompu (pthread)\n");
+            break;
+        }
+    }
+    return NULL;
+}
+
+static CoTask<void> coroutineExtremite(Extremite extremite, Fin *fin) {
+    FrameReader reader;
+    FrameReaderInit(&reader, extremite.socket);
+    char *trame = NULL;
+    bool erreur = false;
+    for (int i = 0; i < extremite.nbAllerRetours && !erreur; i++) {
+        if (extremite.client) {
+            erreur = co_await CoSend(extremite.socket, MESSAGE, strlen(MESSAGE)) < 0;
+        }
+        if (!erreur) {
+            erreur = co_await CoReceiveFrame(&reader, &trame) <= 0;
+        }
+        if (!erreur && !extremite.client) {
+            erreur = co_await CoSend(extremite.socket, MESSAGE, strlen(MESSAGE)) < 0;
+        }
+    }
+    if (erreur) {
+        fprintf(stderr, "ERREUR: Échange interrompu (coroutine)\n");
+    }
+    fin->signaler();
+}
+
+/**
+ * Crée les paires de sockets des sessions
+ * @return Extrémités (client puis écho pour chaque session), vide en cas d'erreur
+ */
+static std::vector<Extremite> creerSessions(int nbSessions, int nbAllerRetours, bool nonBloquant) {
+    std::vector<Extremite> extremites;
+    for (int i = 0; i < nbSessions; i++) {
+        int paire[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, paire) < 0) {
+            perror("ERREUR: socketpair");
+            for (Extremite &extremite : extremites) {
+                close(extremite.socket);
+            }
+            return std::vector<Extremite>();
+        }
+        for (int j = 0; j < 2; j++) {
+            if (nonBloquant) {
+                SetNonBlocking(paire[j]);
+            }
+            extremites.push_back({paire[j], nbAllerRetours, j == 0});
+        }
+    }
+    return extremites;
+}
+
+/**
+ * Mesure nbSessions ping-pongs simultanés : un thread par extrémité, puis
+ * une coroutine par extrémité sur nbThreads threads
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+static int mesurerPingPong(int nbAllerRetours, int nbSessions, int nbThreads) {
+    Mesure mesure;
+    char nom[64];
+    long long total = (long long)nbAllerRetours * nbSessions;
+
+    std::vector<Extremite> extremites = creerSessions(nbSessions, nbAllerRetours, false);
+    if (extremites.empty()) {
+        return -1;
+    }
+    std::vector<pthread_t> threads(extremites.size());
+    debuter(&mesure);
+    for (size_t i = 0; i < extremites.size(); i++) {
+        if (pthread_create(&threads[i], NULL, threadExtremite, &extremites[i]) != 0) {
+            perror("ERREUR: pthread_create");
+            return -1;
+        }
+    }
+    for (pthread_t thread : threads) {
+        pthread_join(thread, NULL);
+    }
+    snprintf(nom, sizeof(nom), "ping-pong pthread x%zu", extremites.size());
+    terminer(&mesure, nom, total);
+    for (Extremite &extremite : extremites) {
+        close(extremite.socket);
+    }
+
+    extremites = creerSessions(nbSessions, nbAllerRetours, true);
+    if (extremites.empty()) {
+        return -1;
+    }
+    CoScheduler *scheduler = CoSchedulerCreate(nbThreads, NULL);
+    Fin fin(extremites.size());
+    debuter(&mesure);
+    for (Extremite &extremite : extremites) {
+        CoSchedulerSpawn(scheduler, coroutineExtremite(extremite, &fin));
+    }
+    fin.attendre();
+    snprintf(nom, sizeof(nom), "ping-pong coro %d thr", nbThreads);
+    terminer(&mesure, nom, total);
+    CoSchedulerDestroy(scheduler);
+    for (Extremite &extremite : extremites) {
+        close(extremite.socket);
+    }
+    return 0;
+}
+
+// ============================================================================
+// FONCTION PRINCIPALE
+// ============================================================================
+
+int main(int argc, char *argv[]) {
+    int nbAllerRetours = argc > 1 ? atoi(argv[1]) : 100000;
+    int nbSessions = argc > 2 ? atoi(argv[2]) : 100;
+    int nbThreads = argc > 3 ? atoi(argv[3]) : 1;
+    if (nbAllerRetours <= 0 || nbSessions <= 0 || nbThreads <= 0) {
+        fprintf(stderr, "Usage: %s [nbAllerRetours] [nbSessions] [nbThreads]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%d aller(s)-retour(s), %d session(s), %d thread(s) d'ordonnanceur\n",
+           nbAllerRetours, nbSessions, nbThreads);
+    printf("%-24s %12s %14s %16s\n", "mesure", "ns/op", "op/s", "commut. noyau");
+    mesurerAppels(10 * nbAllerRetours);
+    mesurerRelais(nbAllerRetours);
+
+    // Une session seule mesure la latence, plusieurs le passage à l'échelle
+    if (mesurerPingPong(nbAllerRetours, 1, 1) < 0) {
+        return 1;
+    }
+    if (nbSessions > 1 &&
+        mesurerPingPong(nbAllerRetours / nbSessions > 0 ? nbAllerRetours / nbSessions : 1,
+                        nbSessions, nbThreads) < 0) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,218 @@
+/**
+ * Banc d'essai : aller-retour requête/réponse en TCP local et en AF_UNIX
+ *
+ * Un serveur d'écho intégré (un thread par connexion, FrameReader + Send)
+ * répond à chaque requête par une réponse de taille comparable à celles du
+ * serveur de réservation. Le client mesure la latence de chaque aller-retour
+ * sur le socket TCP 127.0.0.1 puis sur le socket AF_UNIX.
+ *
+ * Usage : bench_transport [nbRequetes] [nbClients] [port]
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "socket.h"
+#include <pthread.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+#define PORT_DEFAUT 12399
+#define CHEMIN_UNIX "/tmp/bench_transport.sock"
+#define REQUETE "GET_DOCTORS;Cardiologie"
+#define REPONSE "DOCTORS_OK;Jean Dupont|Marie Martin|Paul Durand|Claire Petit|Luc Moreau"
+
+// ============================================================================
+// SERVEUR D'ÉCHO
+// ============================================================================
+
+/**
+ * Traite les requêtes d'une connexion jusqu'à sa fermeture
+ * @param arg Socket du client
+ * @return NULL
+ */
+static void *threadConnexion(void *arg) {
+    int clientSocket = (int)(intptr_t)arg;
+    FrameReader reader;
+    FrameReaderInit(&reader, clientSocket);
+    char *trame = NULL;
+    while (ReceiveFrame(&reader, &trame) > 0) {
+        if (Send(clientSocket, REPONSE, strlen(REPONSE)) < 0) {
+            break;
+        }
+    }
+    closeSocket(clientSocket);
+    return NULL;
+}
+
+/**
+ * Accepte les connexions d'un socket d'écoute (un thread par connexion)
+ * @param arg Socket d'écoute
+ * @return NULL
+ */
+static void *threadEcoute(void *arg) {
+    int serverSocket = (int)(intptr_t)arg;
+    while (true) {
+        int clientSocket = AcceptConnection(serverSocket, NULL);
+        if (clientSocket < 0) {
+            break;
+        }
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, threadConnexion, (void *)(intptr_t)clientSocket) != 0) {
+            closeSocket(clientSocket);
+            continue;
+        }
+        pthread_detach(thread);
+    }
+    return NULL;
+}
+
+// ============================================================================
+// CLIENT
+// ============================================================================
+
+/**
+ * Paramètres et résultats d'un client
+ */
+struct Client {
+    int socket;                     // Socket connecté au serveur
+    int nbRequetes;                 // Allers-retours à effectuer
+    std::vector<long long> latences; // Latence de chaque aller-retour (ns)
+    bool erreur;                    // Un envoi ou une réception a échoué
+};
+
+static long long maintenantNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * Effectue les allers-retours d'un client
+ * @param arg Client (voir Client)
+ * @return NULL
+ */
+static void *threadClient(void *arg) {
+    Client *client = (Client *)arg;
+    FrameReader reader;
+    FrameReaderInit(&reader, client->socket);
+    char *trame = NULL;
+    client->latences.reserve(client->nbRequetes);
+
+    for (int i = 0; i < client->nbRequetes; i++) {
+        long long debut = maintenantNs();
+        if (Send(client->socket, REQUETE, strlen(REQUETE)) < 0 ||
+            ReceiveFrame(&reader, &trame) <= 0) {
+            client->erreur = true;
+            return NULL;
+        }
+        client->latences.push_back(maintenantNs() - debut);
+    }
+    return NULL;
+}
+
+/**
+ * Mesure un transport et affiche les résultats
+ * @param nom Nom du transport
+ * @param sockets Sockets clients connectés (un par client)
+ * @param nbRequetes Allers-retours par client
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+static int mesurer(const char *nom, const std::vector<int> &sockets, int nbRequetes) {
+    int nbClients = sockets.size();
+    std::vector<Client> clients(nbClients);
+    std::vector<pthread_t> threads(nbClients);
+
+    long long debut = maintenantNs();
+    for (int i = 0; i < nbClients; i++) {
+        clients[i].socket = sockets[i];
+        clients[i].nbRequetes = nbRequetes;
+        clients[i].erreur = false;
+        pthread_create(&threads[i], NULL, threadClient, &clients[i]);
+    }
+    std::vector<long long> latences;
+    for (int i = 0; i < nbClients; i++) {
+        pthread_join(threads[i], NULL);
+        if (clients[i].erreur) {
+            fprintf(stderr, "ERREUR: Échange interrompu (%s)\n", nom);
+            return -1;
+        }
+        latences.insert(latences.end(), clients[i].latences.begin(), clients[i].latences.end());
+    }
+    double duree = (maintenantNs() - debut) / 1e9;
+
+    std::sort(latences.begin(), latences.end());
+    long long total = 0;
+    for (long long latence : latences) {
+        total += latence;
+    }
+    size_t n = latences.size();
+    printf("%-10s %10.2f %10.2f %10.2f %10.2f %12.0f\n", nom,
+           total / (double)n / 1000.0,
+           latences[n / 2] / 1000.0,
+           latences[(size_t)(n * 0.99)] / 1000.0,
+           latences[n - 1] / 1000.0,
+           n / duree);
+    return 0;
+}
+
+// ============================================================================
+// FONCTION PRINCIPALE
+// ============================================================================
+
+int main(int argc, char *argv[]) {
+    int nbRequetes = argc > 1 ? atoi(argv[1]) : 100000;
+    int nbClients = argc > 2 ? atoi(argv[2]) : 1;
+    int port = argc > 3 ? atoi(argv[3]) : PORT_DEFAUT;
+    if (nbRequetes <= 0 || nbClients <= 0) {
+        fprintf(stderr, "Usage: %s [nbRequetes] [nbClients] [port]\n", argv[0]);
+        return 1;
+    }
+
+    // Serveurs d'écho TCP et AF_UNIX
+    int socketTcp = ServerSocket(port);
+    int socketUnix = ServerSocketUnix(CHEMIN_UNIX, BACKLOG_DEFAUT);
+    if (socketTcp < 0 || socketUnix < 0) {
+        perror("ERREUR: Impossible de créer les sockets serveur");
+        return 1;
+    }
+    pthread_t ecouteTcp, ecouteUnix;
+    pthread_create(&ecouteTcp, NULL, threadEcoute, (void *)(intptr_t)socketTcp);
+    pthread_create(&ecouteUnix, NULL, threadEcoute, (void *)(intptr_t)socketUnix);
+
+    // Connexions clients
+    std::vector<int> clientsTcp, clientsUnix;
+    for (int i = 0; i < nbClients; i++) {
+        clientsTcp.push_back(ClientSocketRetry("127.0.0.1", port, NULL));
+        clientsUnix.push_back(ClientSocketUnix(CHEMIN_UNIX));
+        if (clientsTcp.back() < 0 || clientsUnix.back() < 0) {
+            perror("ERREUR: Connexion au serveur d'écho");
+            return 1;
+        }
+    }
+
+    printf("%d requête(s) x %d client(s), requête %zu octets, réponse %zu octets\n",
+           nbRequetes, nbClients, strlen(REQUETE) + 1, strlen(REPONSE) + 1);
+    printf("%-10s %10s %10s %10s %10s %12s\n",
+           "transport", "moy (us)", "p50 (us)", "p99 (us)", "max (us)", "req/s");
+    int resultat = 0;
+    if (mesurer("tcp", clientsTcp, nbRequetes) < 0 ||
+        mesurer("unix", clientsUnix, nbRequetes) < 0) {
+        resultat = 1;
+    }
+
+    for (int i = 0; i < nbClients; i++) {
+        closeSocket(clientsTcp[i]);
+        closeSocket(clientsUnix[i]);
+    }
+    unlink(CHEMIN_UNIX);
+    return resultat;
+}
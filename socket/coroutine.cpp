@@ -0,0 +1,509 @@
+/**
+ * Implémentation des coroutines sur la librairie de sockets
+ *
+ * Chaque thread de l'ordonnanceur possède son epoll, sa liste de coroutines
+ * prêtes et ses minuteries : une coroutine suspendue sur un descripteur y est
+ * inscrite (EPOLLONESHOT, l'attendable en donnée associée) par le thread qui
+ * l'exécute, et seul ce thread la reprendra. Aucun verrou n'est pris sur ce
+ * chemin ; seul le lancement d'une coroutine depuis un autre thread passe par
+ * une boîte de réception protégée par un mutex, signalée par un eventfd.
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "coroutine.h"
+#include <pthread.h>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <atomic>
+#include <functional>
+#include <queue>
+#include <vector>
+
+using namespace std;
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+const int CO_MAX_EVENTS = 256;      // Événements traités par appel à epoll_wait
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Coroutine endormie jusqu'à une échéance (CoSleep)
+ */
+struct CoTimer {
+    long long echeance;             // Échéance (ms, horloge monotone)
+    coroutine_handle<> handle;      // Coroutine à reprendre
+
+    bool operator>(const CoTimer &autre) const { return echeance > autre.echeance; }
+};
+
+/**
+ * Thread de l'ordonnanceur et ses coroutines
+ */
+struct CoThread {
+    CoScheduler *scheduler;
+    int index;
+    pthread_t thread;
+    int epollFd;                    // Descripteurs attendus par les coroutines du thread
+    int wakeFd;                     // eventfd : lancement ou arrêt demandé
+
+    pthread_mutex_t mutex;          // Protège inbox et closed
+    vector<coroutine_handle<>> inbox; // Coroutines lancées depuis un autre thread
+    bool closed = false;            // Thread terminé : plus aucun lancement
+
+    // État tenu par le seul thread propriétaire
+    vector<coroutine_handle<>> ready; // Coroutines à reprendre (lancement, CoYield)
+    priority_queue<CoTimer, vector<CoTimer>, greater<CoTimer>> timers;
+    long live = 0;                  // Coroutines lancées non terminées
+
+    atomic<unsigned long long> spawned{0};
+    atomic<unsigned long long> finished{0};
+    atomic<unsigned long long> resumes{0};
+    atomic<unsigned long long> waits{0};
+};
+
+struct CoScheduler {
+    vector<CoThread *> threads;
+    atomic<bool> stopping{false};
+    atomic<unsigned int> next{0};   // Prochain thread (tourniquet)
+    CoThreadStart onStart = NULL;   // Appelée au démarrage de chaque thread
+};
+
+static __thread CoThread *currentThread = NULL; // Thread d'ordonnanceur appelant
+
+// ============================================================================
+// FONCTIONS INTERNES
+// ============================================================================
+
+/**
+ * @return Horloge monotone en millisecondes
+ */
+static long long maintenantMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * Réveille un thread de l'ordonnanceur bloqué dans epoll_wait
+ */
+static void reveiller(CoThread *self) {
+    uint64_t un = 1;
+    ssize_t ignore = write(self->wakeFd, &un, sizeof(un));
+    (void)ignore;
+}
+
+/**
+ * Reprend une coroutine sur le thread courant
+ */
+static void reprendre(CoThread *self, coroutine_handle<> handle) {
+    self->resumes.fetch_add(1, memory_order_relaxed);
+    handle.resume();
+}
+
+/**
+ * Récupère les coroutines lancées depuis d'autres threads. À l'arrêt, ferme
+ * la boîte de réception si plus aucune coroutine n'est en cours.
+ * @return true si le thread peut se terminer
+ */
+static bool relever(CoThread *self) {
+    pthread_mutex_lock(&self->mutex);
+    for (coroutine_handle<> handle : self->inbox) {
+        self->ready.push_back(handle);
+    }
+    self->live += self->inbox.size();
+    self->inbox.clear();
+    bool termine = self->scheduler->stopping.load(memory_order_acquire) &&
+                   self->live == 0 && self->ready.empty();
+    if (termine) {
+        self->closed = true;
+    }
+    pthread_mutex_unlock(&self->mutex);
+    return termine;
+}
+
+/**
+ * Boucle d'un thread de l'ordonnanceur : reprend les coroutines prêtes,
+ * échues ou dont le descripteur est prêt, puis attend avec epoll
+ * @param arg Thread de l'ordonnanceur (voir CoThread)
+ * @return NULL
+ */
+static void *boucleOrdonnanceur(void *arg) {
+    CoThread *self = (CoThread *)arg;
+    currentThread = self;
+    if (self->scheduler->onStart) {
+        self->scheduler->onStart(self->index);
+    }
+
+    struct epoll_event events[CO_MAX_EVENTS];
+    vector<coroutine_handle<>> aReprendre;
+    while (!relever(self)) {
+        // Coroutines prêtes : celles qui cèdent à nouveau attendront le tour suivant
+        aReprendre.swap(self->ready);
+        for (coroutine_handle<> handle : aReprendre) {
+            reprendre(self, handle);
+        }
+        aReprendre.clear();
+
+        // Minuteries échues
+        long long maintenant = maintenantMs();
+        while (!self->timers.empty() && self->timers.top().echeance <= maintenant) {
+            coroutine_handle<> handle = self->timers.top().handle;
+            self->timers.pop();
+            reprendre(self, handle);
+        }
+
+        int delai = -1;
+        if (!self->ready.empty()) {
+            delai = 0;
+        } else if (!self->timers.empty()) {
+            delai = (int)(self->timers.top().echeance - maintenantMs());
+            delai = delai < 0 ? 0 : delai;
+        }
+        int nbEvents = epoll_wait(self->epollFd, events, CO_MAX_EVENTS, delai);
+        for (int i = 0; i < nbEvents; i++) {
+            if (events[i].data.ptr == NULL) {
+                uint64_t compteur;
+                ssize_t ignore = read(self->wakeFd, &compteur, sizeof(compteur));
+                (void)ignore;
+                continue;
+            }
+            CoWaitAwaiter *awaiter = (CoWaitAwaiter *)events[i].data.ptr;
+            awaiter->result = events[i].events;
+            reprendre(self, awaiter->handle);
+        }
+    }
+    currentThread = NULL;
+    return NULL;
+}
+
+/**
+ * Arrête les threads démarrés et libère l'ordonnanceur
+ * @param scheduler Ordonnanceur
+ * @param started Nombre de threads démarrés
+ */
+static void arreterThreads(CoScheduler *scheduler, int started) {
+    scheduler->stopping.store(true, memory_order_release);
+    for (int i = 0; i < started; i++) {
+        reveiller(scheduler->threads[i]);
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(scheduler->threads[i]->thread, NULL);
+    }
+    for (CoThread *self : scheduler->threads) {
+        close(self->epollFd);
+        close(self->wakeFd);
+        pthread_mutex_destroy(&self->mutex);
+        delete self;
+    }
+    delete scheduler;
+}
+
+/**
+ * Envoie des octets (suivis du délimiteur si demandé) sans bloquer le thread
+ * @param sSocket Descripteur de socket
+ * @param data Données à envoyer
+ * @param taille Taille des données
+ * @param delimiteur true pour ajouter le '\n' final
+ * @return Nombre d'octets envoyés ou -1 en cas d'erreur
+ */
+static CoTask<int> envoyerTout(int sSocket, const char *data, size_t taille, bool delimiteur) {
+    static const char finTrame = '\n';
+    size_t total = taille + (delimiteur ? 1 : 0);
+    size_t envoye = 0;
+    while (envoye < total) {
+        struct iovec iov[2];
+        int nbTampons = 0;
+        if (envoye < taille) {
+            iov[nbTampons++] = {(void *)(data + envoye), taille - envoye};
+        }
+        if (delimiteur) {
+            iov[nbTampons++] = {(void *)&finTrame, 1};
+        }
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = iov;
+        message.msg_iovlen = nbTampons;
+        ssize_t resultat = sendmsg(sSocket, &message, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (resultat < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // Socket plein : attendre qu'il redevienne inscriptible
+            if (co_await CoWait(sSocket, EPOLLOUT) < 0) {
+                co_return -1;
+            }
+            continue;
+        }
+        if (resultat < 0 && errno == EINTR) {
+            continue;
+        }
+        if (resultat <= 0) {
+            co_return -1;
+        }
+        envoye += resultat;
+    }
+    co_return (int)envoye;
+}
+
+// ============================================================================
+// POINTS DE SUSPENSION
+// ============================================================================
+
+/**
+ * Hors ordonnanceur, attend le descripteur avec poll (pas de suspension)
+ */
+bool CoWaitAwaiter::await_ready() {
+    if (currentThread) {
+        return false;
+    }
+    // Les valeurs de EPOLLIN/EPOLLOUT sont celles de POLLIN/POLLOUT
+    struct pollfd attente = {fd, (short)events, 0};
+    int pret;
+    while ((pret = poll(&attente, 1, -1)) < 0 && errno == EINTR) {
+    }
+    result = pret < 0 ? -1 : attente.revents;
+    return true;
+}
+
+/**
+ * Inscrit le descripteur dans l'epoll du thread, l'attendable en donnée
+ * @return false (reprise immédiate, result = -1) si l'inscription échoue
+ */
+bool CoWaitAwaiter::await_suspend(coroutine_handle<> caller) {
+    handle = caller;
+    struct epoll_event event;
+    event.events = events | EPOLLONESHOT;
+    event.data.ptr = this;
+    // Un descripteur déjà inscrit (attente précédente) est seulement réarmé
+    if (epoll_ctl(currentThread->epollFd, EPOLL_CTL_MOD, fd, &event) < 0 &&
+        (errno != ENOENT || epoll_ctl(currentThread->epollFd, EPOLL_CTL_ADD, fd, &event) < 0)) {
+        result = -1;
+        return false;
+    }
+    currentThread->waits.fetch_add(1, memory_order_relaxed);
+    return true;
+}
+
+/**
+ * Hors ordonnanceur, dort sur le thread appelant (pas de suspension)
+ */
+bool CoSleepAwaiter::await_ready() {
+    if (delaiMs <= 0) {
+        return true;
+    }
+    if (currentThread) {
+        return false;
+    }
+    struct timespec delai = {delaiMs / 1000, (delaiMs % 1000) * 1000000L};
+    while (nanosleep(&delai, &delai) < 0 && errno == EINTR) {
+    }
+    return true;
+}
+
+void CoSleepAwaiter::await_suspend(coroutine_handle<> caller) {
+    currentThread->timers.push(CoTimer{maintenantMs() + delaiMs, caller});
+}
+
+bool CoYieldAwaiter::await_ready() {
+    return currentThread == NULL;
+}
+
+void CoYieldAwaiter::await_suspend(coroutine_handle<> caller) {
+    currentThread->ready.push_back(caller);
+}
+
+/**
+ * Indique si le thread appelant est un thread d'ordonnanceur (voir coroutine.h)
+ * @return true dans un thread d'ordonnanceur
+ */
+bool CoScheduled(void) {
+    return currentThread != NULL;
+}
+
+/**
+ * Libère une coroutine lancée arrivée à son terme (voir coroutine.h)
+ * @param handle Coroutine terminée
+ */
+void CoTaskFinished(coroutine_handle<> handle) {
+    if (currentThread) {
+        currentThread->live--;
+        currentThread->finished.fetch_add(1, memory_order_relaxed);
+    }
+    handle.destroy();
+}
+
+// ============================================================================
+// SOCKETS
+// ============================================================================
+
+/**
+ * Extrait la prochaine trame complète sans bloquer le thread (voir coroutine.h)
+ * @param reader Lecteur de trames de la connexion
+ * @param frame Reçoit un pointeur vers la trame dans le tampon du lecteur
+ * @return Taille de la trame ou -1 en cas d'erreur / fermeture
+ */
+CoTask<int> CoReceiveFrame(FrameReader *reader, char **frame) {
+    while (true) {
+        int taille = ReceiveFrame(reader, frame);
+        if (taille != TRAME_INCOMPLETE) {
+            co_return taille;
+        }
+        // Rien à lire : EPOLLHUP ou EPOLLERR feront échouer le prochain recv()
+        if (co_await CoWait(reader->socket, EPOLLIN) < 0) {
+            co_return -1;
+        }
+    }
+}
+
+/**
+ * Envoie un message suivi du délimiteur sans bloquer le thread (voir coroutine.h)
+ * @param sSocket Descripteur de socket
+ * @param data Données à envoyer
+ * @param taille Taille des données
+ * @return Nombre d'octets envoyés ou -1 en cas d'erreur
+ */
+CoTask<int> CoSend(int sSocket, const char *data, int taille) {
+    if (sSocket < 0 || data == NULL || taille <= 0 || taille > TAILLE_MAX) {
+        co_return -1;
+    }
+    co_return co_await envoyerTout(sSocket, data, taille, true);
+}
+
+/**
+ * Envoie les trames capturées sans bloquer le thread (voir coroutine.h)
+ * @param capture Capture terminée
+ * @return Nombre d'octets envoyés, 0 si rien n'a été capturé, -1 en cas d'erreur
+ */
+CoTask<int> CoSendCaptured(const SendCapture *capture) {
+    if (capture == NULL || capture->socket < 0 || capture->erreur) {
+        co_return -1;
+    }
+    if (capture->taille == 0) {
+        co_return 0;
+    }
+    co_return co_await envoyerTout(capture->socket, capture->donnees, capture->taille, false);
+}
+
+// ============================================================================
+// ORDONNANCEUR
+// ============================================================================
+
+/**
+ * Crée l'ordonnanceur et démarre ses threads (voir coroutine.h)
+ * @param nbThreads Nombre de threads
+ * @param onStart Fonction appelée par chaque thread à son démarrage (ou NULL)
+ * @return Ordonnanceur créé ou NULL en cas d'erreur
+ */
+CoScheduler *CoSchedulerCreate(int nbThreads, CoThreadStart onStart) {
+    if (nbThreads <= 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    CoScheduler *scheduler = new CoScheduler;
+    scheduler->onStart = onStart;
+    for (int i = 0; i < nbThreads; i++) {
+        CoThread *self = new CoThread;
+        self->scheduler = scheduler;
+        self->index = i;
+        self->epollFd = epoll_create1(EPOLL_CLOEXEC);
+        self->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        pthread_mutex_init(&self->mutex, NULL);
+        scheduler->threads.push_back(self);
+
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = NULL;
+        if (self->epollFd < 0 || self->wakeFd < 0 ||
+            epoll_ctl(self->epollFd, EPOLL_CTL_ADD, self->wakeFd, &event) < 0) {
+            arreterThreads(scheduler, i);
+            return NULL;
+        }
+    }
+    for (int i = 0; i < nbThreads; i++) {
+        if (pthread_create(&scheduler->threads[i]->thread, NULL, boucleOrdonnanceur,
+                           scheduler->threads[i]) != 0) {
+            arreterThreads(scheduler, i);
+            return NULL;
+        }
+    }
+    return scheduler;
+}
+
+/**
+ * Lance une coroutine sur un thread de l'ordonnanceur (voir coroutine.h)
+ * @param scheduler Ordonnanceur
+ * @param task Coroutine à lancer
+ * @return 0 en cas de succès, -1 si l'ordonnanceur est arrêté
+ */
+int CoSchedulerSpawn(CoScheduler *scheduler, CoTask<void> task) {
+    if (scheduler->stopping.load(memory_order_acquire)) {
+        return -1;
+    }
+    unsigned int index = scheduler->next.fetch_add(1, memory_order_relaxed) % scheduler->threads.size();
+    CoThread *self = scheduler->threads[index];
+
+    pthread_mutex_lock(&self->mutex);
+    if (self->closed) {
+        pthread_mutex_unlock(&self->mutex);
+        return -1;
+    }
+    CoTask<void>::Handle handle = task.release();
+    handle.promise().detached = true;
+    self->inbox.push_back(handle);
+    self->spawned.fetch_add(1, memory_order_relaxed);
+    pthread_mutex_unlock(&self->mutex);
+
+    reveiller(self);
+    return 0;
+}
+
+/**
+ * Attend la fin des coroutines en cours puis libère l'ordonnanceur
+ * @param scheduler Ordonnanceur
+ */
+void CoSchedulerDestroy(CoScheduler *scheduler) {
+    if (scheduler == NULL) {
+        return;
+    }
+    arreterThreads(scheduler, scheduler->threads.size());
+}
+
+/**
+ * Copie les métriques courantes de l'ordonnanceur
+ * @param scheduler Ordonnanceur
+ * @param stats Métriques à remplir
+ */
+void CoSchedulerGetStats(CoScheduler *scheduler, CoSchedulerStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->threads = scheduler->threads.size();
+    for (CoThread *self : scheduler->threads) {
+        // Terminées avant lancées : jamais plus de terminées que de lancées
+        stats->finished += self->finished.load(memory_order_acquire);
+        stats->spawned += self->spawned.load(memory_order_acquire);
+        stats->resumes += self->resumes.load(memory_order_relaxed);
+        stats->waits += self->waits.load(memory_order_relaxed);
+    }
+}
+
+/**
+ * Affiche les métriques de l'ordonnanceur sur une ligne
+ * @param scheduler Ordonnanceur
+ */
+void CoSchedulerReport(CoScheduler *scheduler) {
+    if (scheduler == NULL) {
+        return;
+    }
+    CoSchedulerStats stats;
+    CoSchedulerGetStats(scheduler, &stats);
+    printf("Ordonnanceur de coroutines: %d threads, %llu coroutine(s) en cours, "
+           "%llu lancée(s), %llu reprise(s), %llu attente(s) de descripteur\n",
+           stats.threads, stats.spawned - stats.finished, stats.spawned,
+           stats.resumes, stats.waits);
+}
@@ -0,0 +1,345 @@
+/**
+ * Coroutines C++20 sur la librairie de sockets
+ *
+ * Une session écrite comme une suite d'appels (lire une trame, interroger la
+ * base, répondre) s'exécute en coroutine : chaque attente (socket pas prêt,
+ * minuterie) suspend la coroutine au lieu de bloquer son thread, qui reprend
+ * aussitôt une autre coroutine. Quelques threads suffisent ainsi pour des
+ * milliers de sessions, sans découper leur code en fonctions de rappel.
+ *
+ * - CoTask<T> : coroutine démarrée par co_await (ou CoRunSync,
+ *   CoSchedulerSpawn), dont le résultat revient à l'appelant
+ * - CoScheduler : threads attendant les événements avec leur propre epoll ;
+ *   une coroutine reste sur le thread qui l'a démarrée
+ * - CoWait, CoSleep, CoYield : points de suspension élémentaires
+ * - CoReceiveFrame, CoSend, CoSendCaptured : ReceiveFrame, Send et
+ *   SendCaptured sur un socket non bloquant, sans bloquer le thread
+ *
+ * Hors des threads d'un ordonnanceur, les attentes bloquent le thread
+ * appelant (poll, nanosleep) : le même code s'exécute alors d'une traite
+ * avec CoRunSync. Nécessite -std=c++20.
+ */
+
+#ifndef COROUTINE_H
+#define COROUTINE_H
+
+// ============================================================================
+// INCLUDES SYSTÈME
+// ============================================================================
+#include <coroutine>
+#include <exception>
+#include <utility>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include "socket.h"
+
+template <typename T> class CoTask;
+
+/**
+ * Libère une coroutine lancée par CoSchedulerSpawn arrivée à son terme
+ * (usage interne, appelée depuis sa suspension finale)
+ * @param handle Coroutine terminée
+ */
+void CoTaskFinished(std::coroutine_handle<> handle);
+
+// ============================================================================
+// TÂCHES
+// ============================================================================
+
+/**
+ * Partie commune des promesses : reprise de l'appelant à la fin
+ */
+struct CoPromiseBase {
+    std::coroutine_handle<> continuation; // Coroutine qui attend le résultat
+    bool detached = false;                // Lancée par CoSchedulerSpawn : se libère seule
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            CoPromiseBase &promise = handle.promise();
+            if (promise.continuation) {
+                // Transfert direct à l'appelant, sans remonter la pile
+                return promise.continuation;
+            }
+            if (promise.detached) {
+                CoTaskFinished(handle);
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() noexcept { std::terminate(); }
+};
+
+/**
+ * Promesse d'une coroutine renvoyant une valeur
+ */
+template <typename T>
+struct CoPromise : CoPromiseBase {
+    T value{};
+
+    CoTask<T> get_return_object() noexcept;
+    void return_value(T result) { value = std::move(result); }
+    T result() { return std::move(value); }
+};
+
+/**
+ * Promesse d'une coroutine sans valeur de retour
+ */
+template <>
+struct CoPromise<void> : CoPromiseBase {
+    CoTask<void> get_return_object() noexcept;
+    void return_void() noexcept {}
+    void result() noexcept {}
+};
+
+/**
+ * Coroutine (démarrée seulement quand elle est attendue ou lancée)
+ *
+ * co_await sur une CoTask exécute la coroutine jusqu'à sa première
+ * suspension ; l'appelant reprend quand elle se termine et reçoit sa valeur.
+ */
+template <typename T = void>
+class CoTask {
+public:
+    using promise_type = CoPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    explicit CoTask(Handle handle) noexcept : handle(handle) {}
+    CoTask(CoTask &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    CoTask(const CoTask &) = delete;
+    CoTask &operator=(const CoTask &) = delete;
+    ~CoTask() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+        handle.promise().continuation = caller;
+        return handle;
+    }
+
+    T await_resume() { return handle.promise().result(); }
+
+    /**
+     * Cède la coroutine (qui ne sera plus libérée par la CoTask)
+     * @return Coroutine
+     */
+    Handle release() noexcept { return std::exchange(handle, nullptr); }
+
+    /**
+     * @return Coroutine (toujours propriété de la CoTask)
+     */
+    Handle get() const noexcept { return handle; }
+
+private:
+    Handle handle;
+};
+
+template <typename T>
+CoTask<T> CoPromise<T>::get_return_object() noexcept {
+    return CoTask<T>(CoTask<T>::Handle::from_promise(*this));
+}
+
+inline CoTask<void> CoPromise<void>::get_return_object() noexcept {
+    return CoTask<void>(CoTask<void>::Handle::from_promise(*this));
+}
+
+/**
+ * Exécute une coroutine d'une traite sur le thread appelant, hors
+ * ordonnanceur : ses attentes y sont bloquantes, elle ne se suspend jamais
+ * @param task Coroutine à exécuter
+ * @return Valeur renvoyée par la coroutine
+ */
+template <typename T>
+T CoRunSync(CoTask<T> task) {
+    typename CoTask<T>::Handle handle = task.get();
+    handle.resume();
+    if (!handle.done()) {
+        // Suspendue sans ordonnanceur pour la reprendre
+        fprintf(stderr, "ERREUR: CoRunSync sur une coroutine suspendue\n");
+        abort();
+    }
+    return handle.promise().result();
+}
+
+// ============================================================================
+// POINTS DE SUSPENSION
+// ============================================================================
+
+/**
+ * Attente d'un événement epoll sur un descripteur (voir CoWait)
+ */
+struct CoWaitAwaiter {
+    int fd;                         // Descripteur surveillé
+    uint32_t events;                // Événements attendus (EPOLLIN, EPOLLOUT)
+    int result;                     // Événements reçus, -1 en cas d'erreur
+    std::coroutine_handle<> handle; // Coroutine suspendue
+
+    bool await_ready();
+    bool await_suspend(std::coroutine_handle<> caller);
+    int await_resume() const noexcept { return result; }
+};
+
+/**
+ * Attente d'un délai (voir CoSleep)
+ */
+struct CoSleepAwaiter {
+    int delaiMs;                    // Délai en millisecondes
+
+    bool await_ready();
+    void await_suspend(std::coroutine_handle<> caller);
+    void await_resume() const noexcept {}
+};
+
+/**
+ * Cession du thread aux autres coroutines prêtes (voir CoYield)
+ */
+struct CoYieldAwaiter {
+    bool await_ready();
+    void await_suspend(std::coroutine_handle<> caller);
+    void await_resume() const noexcept {}
+};
+
+/**
+ * Suspend la coroutine jusqu'à ce que le descripteur soit prêt
+ * @param fd Descripteur (socket, pipe, eventfd...)
+ * @param events Événements attendus (EPOLLIN, EPOLLOUT)
+ * @return Attendable renvoyant les événements reçus (EPOLLHUP et EPOLLERR
+ *         compris), ou -1 si le descripteur ne peut pas être surveillé
+ */
+inline CoWaitAwaiter CoWait(int fd, uint32_t events) {
+    return CoWaitAwaiter{fd, events, 0, nullptr};
+}
+
+/**
+ * Suspend la coroutine pendant un délai
+ * @param delaiMs Délai en millisecondes
+ * @return Attendable
+ */
+inline CoSleepAwaiter CoSleep(int delaiMs) {
+    return CoSleepAwaiter{delaiMs};
+}
+
+/**
+ * Laisse passer les autres coroutines prêtes du thread avant de reprendre
+ * @return Attendable
+ */
+inline CoYieldAwaiter CoYield() {
+    return CoYieldAwaiter{};
+}
+
+/**
+ * Indique si le thread appelant est un thread d'ordonnanceur (attentes
+ * suspensives) ou un thread ordinaire (attentes bloquantes)
+ * @return true dans un thread d'ordonnanceur
+ */
+bool CoScheduled(void);
+
+// ============================================================================
+// SOCKETS
+// ============================================================================
+
+/**
+ * Extrait la prochaine trame complète (voir ReceiveFrame), en suspendant la
+ * coroutine tant que le socket non bloquant n'a rien à lire
+ * @param reader Lecteur de trames de la connexion
+ * @param frame Reçoit un pointeur vers la trame dans le tampon du lecteur
+ * @return Taille de la trame (sans le '\n') ou -1 en cas d'erreur / fermeture
+ */
+CoTask<int> CoReceiveFrame(FrameReader *reader, char **frame);
+
+/**
+ * Envoie un message suivi du délimiteur (voir Send), en suspendant la
+ * coroutine tant que le socket est plein
+ * @param sSocket Descripteur de socket
+ * @param data Données à envoyer (valides jusqu'à la fin de l'envoi)
+ * @param taille Taille des données
+ * @return Nombre d'octets envoyés ou -1 en cas d'erreur
+ */
+CoTask<int> CoSend(int sSocket, const char *data, int taille);
+
+/**
+ * Envoie les trames capturées telles quelles (voir SendCaptured), en
+ * suspendant la coroutine tant que le socket est plein
+ * @param capture Capture terminée (valide jusqu'à la fin de l'envoi)
+ * @return Nombre d'octets envoyés, 0 si rien n'a été capturé, -1 en cas d'erreur
+ */
+CoTask<int> CoSendCaptured(const SendCapture *capture);
+
+// ============================================================================
+// ORDONNANCEUR
+// ============================================================================
+
+/**
+ * Fonction appelée par chaque thread de l'ordonnanceur à son démarrage
+ * @param index Rang du thread (0 à nbThreads - 1)
+ */
+typedef void (*CoThreadStart)(int index);
+
+/**
+ * Métriques de l'ordonnanceur
+ */
+typedef struct {
+    int threads;                    // Threads de l'ordonnanceur
+    unsigned long long spawned;     // Coroutines lancées
+    unsigned long long finished;    // Coroutines terminées
+    unsigned long long resumes;     // Reprises de coroutines (changements de contexte)
+    unsigned long long waits;       // Suspensions sur un descripteur
+} CoSchedulerStats;
+
+/**
+ * Ordonnanceur de coroutines (structure opaque, thread-safe)
+ */
+typedef struct CoScheduler CoScheduler;
+
+/**
+ * Crée l'ordonnanceur et démarre ses threads
+ * @param nbThreads Nombre de threads
+ * @param onStart Fonction appelée par chaque thread avant sa première
+ *                coroutine (NULL = aucune)
+ * @return Ordonnanceur créé ou NULL en cas d'erreur
+ */
+CoScheduler *CoSchedulerCreate(int nbThreads, CoThreadStart onStart);
+
+/**
+ * Lance une coroutine sur un thread de l'ordonnanceur (à tour de rôle) ;
+ * elle y reste jusqu'à sa fin, puis est libérée
+ * @param scheduler Ordonnanceur
+ * @param task Coroutine à lancer
+ * @return 0 en cas de succès, -1 si l'ordonnanceur est arrêté
+ */
+int CoSchedulerSpawn(CoScheduler *scheduler, CoTask<void> task);
+
+/**
+ * Refuse les nouvelles coroutines, attend la fin de celles en cours puis
+ * arrête les threads et libère l'ordonnanceur
+ * @param scheduler Ordonnanceur
+ */
+void CoSchedulerDestroy(CoScheduler *scheduler);
+
+/**
+ * Copie les métriques courantes de l'ordonnanceur
+ * @param scheduler Ordonnanceur
+ * @param stats Métriques à remplir
+ */
+void CoSchedulerGetStats(CoScheduler *scheduler, CoSchedulerStats *stats);
+
+/**
+ * Affiche les métriques de l'ordonnanceur sur une ligne
+ * @param scheduler Ordonnanceur
+ */
+void CoSchedulerReport(CoScheduler *scheduler);
+
+#endif // COROUTINE_H
@@ -12,12 +12,44 @@
 #include "socket.h"
 #include <unistd.h>
 #include <arpa/inet.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+// ============================================================================
+// VARIABLES GLOBALES
+// ============================================================================
+static SendBackend backendEnvoi = NULL;   // Backend d'envoi optionnel (io_uring)
+static __thread SendCapture *captureCourante = NULL; // Capture des envois du thread
+static int delaiEnvoiMs = DELAI_ENVOI_DEFAUT_MS; // Attente maximale d'un client qui ne lit plus
+
+// ============================================================================
+// CONSTANTES INTERNES
+// ============================================================================
+#define LOT_IOV 256                        // Tampons transmis par appel à sendmsg
+#define TAILLE_IP 64                       // Adresse recopiée pour une connexion asynchrone
+
 // ============================================================================
 // FONCTIONS DE COMMUNICATION
 // ============================================================================
 
+/**
+ * Horloge monotone en millisecondes (échéances de connexion et d'envoi)
+ * @return Temps écoulé depuis une origine arbitraire
+ */
+static long long maintenantMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
 /**
  * Envoie des données sur un socket avec délimiteur de fin de message
  * @param sSocket Descripteur de socket
@@ -31,26 +63,197 @@ int Send(int sSocket, const char *data, int taille) {
         return -1;
     }
     
-    // Préparation du message avec délimiteur de fin
-    char message[TAILLE_MAX + 1];
-    strncpy(message, data, taille);
-    message[taille] = '\n'; // Délimiteur de fin de message
+    struct iovec iov;
+    iov.iov_base = (void *)data;
+    iov.iov_len = taille;
+    return SendV(sSocket, &iov, 1);
+}
+
+/**
+ * Transmet au backend d'envoi les tampons suivis du délimiteur
+ * @param sSocket Descripteur de socket
+ * @param iov Tampons à envoyer
+ * @param iovcnt Nombre de tampons
+ * @return Résultat du backend, ENVOI_NON_GERE ou -1 en cas d'erreur
+ */
+static int envoyerParBackend(int sSocket, const struct iovec *iov, int iovcnt) {
+    // Le backend attend un seul tableau : tampons puis délimiteur
+    struct iovec pile[LOT_IOV];
+    struct iovec *tableau = pile;
+    if (iovcnt + 1 > LOT_IOV) {
+        tableau = (struct iovec *)malloc((iovcnt + 1) * sizeof(struct iovec));
+        if (tableau == NULL) {
+            return -1;
+        }
+    }
+    memcpy(tableau, iov, iovcnt * sizeof(struct iovec));
+    tableau[iovcnt].iov_base = (void *)"\n";
+    tableau[iovcnt].iov_len = 1;
     
-    // Envoi en plusieurs parties si nécessaire
-    int totalEnvoye = 0;
-    int tailleComplete = taille + 1; // +1 pour le délimiteur '\n'
+    int resultat = backendEnvoi(sSocket, tableau, iovcnt + 1);
+    if (tableau != pile) {
+        free(tableau);
+    }
+    return resultat;
+}
+
+/**
+ * Recopie un message et son délimiteur dans la capture du thread
+ * @param capture Capture active
+ * @param iov Tampons du message
+ * @param iovcnt Nombre de tampons
+ * @return Nombre d'octets capturés (délimiteur compris) ou -1 en cas d'erreur
+ */
+static int capturer(SendCapture *capture, const struct iovec *iov, int iovcnt) {
+    size_t total = 1;
+    for (int i = 0; i < iovcnt; i++) {
+        total += iov[i].iov_len;
+    }
+    if (capture->erreur || total > (size_t)(INT32_MAX - capture->taille)) {
+        capture->erreur = 1;
+        return -1;
+    }
+    if (capture->taille + (int)total > capture->capacite) {
+        int capacite = capture->capacite > 0 ? capture->capacite : TAILLE_MAX;
+        while (capacite < capture->taille + (int)total) {
+            capacite = capacite > INT32_MAX / 2 ? INT32_MAX : capacite * 2;
+        }
+        char *donnees = (char *)realloc(capture->donnees, capacite);
+        if (donnees == NULL) {
+            capture->erreur = 1;
+            return -1;
+        }
+        capture->donnees = donnees;
+        capture->capacite = capacite;
+    }
+    for (int i = 0; i < iovcnt; i++) {
+        memcpy(capture->donnees + capture->taille, iov[i].iov_base, iov[i].iov_len);
+        capture->taille += iov[i].iov_len;
+    }
+    capture->donnees[capture->taille++] = '\n';
+    return (int)total;
+}
+
+/**
+ * Envoie des tampons sur le socket, suivis ou non du délimiteur '\n',
+ * en reprenant après chaque envoi partiel
+ * @param sSocket Descripteur de socket
+ * @param iov Tampons à envoyer, dans l'ordre
+ * @param iovcnt Nombre de tampons
+ * @param delimiter 1 pour ajouter le délimiteur, 0 pour des trames déjà délimitées
+ * @return Nombre d'octets envoyés ou -1 en cas d'erreur
+ */
+static int envoyerTampons(int sSocket, const struct iovec *iov, int iovcnt, int delimiter) {
+    static const char delimiteur = '\n';
+    int indice = 0;          // Premier tampon pas encore entièrement envoyé
+    size_t decalage = 0;     // Octets déjà envoyés de ce tampon
+    int termine = 0;         // Tout est envoyé (délimiteur compris)
+    long totalEnvoye = 0;
+    long long echeance = -1; // Fin de l'attente en cours (-1 : pas d'attente)
     
-    while (totalEnvoye < tailleComplete) {
-        int octetsEnvoyes = send(sSocket, message + totalEnvoye, 
-                                tailleComplete - totalEnvoye, 0);
+    // Envoi par lots de LOT_IOV tampons (la limite IOV_MAX ne s'applique
+    // qu'à un appel) en reprenant après chaque envoi partiel
+    while (!termine) {
+        struct iovec lot[LOT_IOV];
+        int nbLot = 0;
+        for (int i = indice; i < iovcnt && nbLot < LOT_IOV; i++) {
+            size_t debut = (i == indice) ? decalage : 0;
+            if (iov[i].iov_len > debut) {
+                lot[nbLot].iov_base = (char *)iov[i].iov_base + debut;
+                lot[nbLot].iov_len = iov[i].iov_len - debut;
+                nbLot++;
+            }
+        }
+        if (delimiter && nbLot < LOT_IOV) {
+            lot[nbLot].iov_base = (void *)&delimiteur; // Délimiteur de fin de message
+            lot[nbLot].iov_len = 1;
+            nbLot++;
+        }
+        if (nbLot == 0) {
+            break;
+        }
+        
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = lot;
+        message.msg_iovlen = nbLot;
+        ssize_t octetsEnvoyes = sendmsg(sSocket, &message, MSG_NOSIGNAL);
+        if (octetsEnvoyes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // Socket non bloquant plein : attendre qu'il redevienne inscriptible,
+            // au plus delaiEnvoiMs sans progression (client qui ne lit plus)
+            if (echeance < 0 && delaiEnvoiMs >= 0) {
+                echeance = maintenantMs() + delaiEnvoiMs;
+            }
+            int restant = echeance < 0 ? -1 : (int)(echeance - maintenantMs());
+            if (echeance >= 0 && restant <= 0) {
+                errno = ETIMEDOUT;
+                return -1;
+            }
+            struct pollfd pfd = {sSocket, POLLOUT, 0};
+            if (poll(&pfd, 1, restant) < 0 && errno != EINTR) {
+                return -1;
+            }
+            continue;
+        }
+        if (octetsEnvoyes < 0 && errno == EINTR) {
+            continue;
+        }
         if (octetsEnvoyes <= 0) {
             // Erreur de transmission ou connexion fermée
             return -1;
         }
         totalEnvoye += octetsEnvoyes;
+        echeance = -1; // Le client lit : nouveau délai au prochain blocage
+        
+        // Avancer dans les tampons du nombre d'octets effectivement envoyés
+        size_t reste = octetsEnvoyes;
+        while (reste > 0 || (!delimiter && indice == iovcnt)) {
+            if (indice == iovcnt) {
+                termine = 1;
+                break;
+            }
+            size_t disponible = iov[indice].iov_len - decalage;
+            if (reste < disponible) {
+                decalage += reste;
+                reste = 0;
+            } else {
+                reste -= disponible;
+                indice++;
+                decalage = 0;
+            }
+        }
+    }
+    
+    return (int)totalEnvoye;
+}
+
+/**
+ * Envoie plusieurs tampons suivis du délimiteur '\n' sans les recopier
+ * @param sSocket Descripteur de socket
+ * @param iov Tampons à envoyer, dans l'ordre
+ * @param iovcnt Nombre de tampons
+ * @return Nombre d'octets envoyés (délimiteur compris) ou -1 en cas d'erreur
+ */
+int SendV(int sSocket, const struct iovec *iov, int iovcnt) {
+    // Vérification des paramètres d'entrée
+    if (sSocket < 0 || iov == NULL || iovcnt <= 0) {
+        return -1;
     }
     
-    return totalEnvoye;
+    // Envoi capturé par le thread courant : recopié, envoyé plus tard
+    if (captureCourante != NULL && captureCourante->socket == sSocket) {
+        return capturer(captureCourante, iov, iovcnt);
+    }
+    
+    // Socket pris en charge par un backend asynchrone (io_uring)
+    if (backendEnvoi != NULL) {
+        int resultat = envoyerParBackend(sSocket, iov, iovcnt);
+        if (resultat != ENVOI_NON_GERE) {
+            return resultat;
+        }
+    }
+    
+    return envoyerTampons(sSocket, iov, iovcnt, 1);
 }
 
 /**
@@ -77,22 +280,359 @@ int Receive(int sSocket, char *data) {
             return -1;
         }
         
+        // Recherche du délimiteur uniquement dans les octets nouvellement reçus
+        char *delimiteur = (char *)memchr(buffer + totalRecu, '\n', octetsRecus);
         totalRecu += octetsRecus;
-        
-        // Recherche du délimiteur de fin de message '\n'
-        for (int i = 0; i < totalRecu; i++) {
-            if (buffer[i] == '\n') {
-                // Message complet trouvé
-                buffer[i] = '\0'; // Remplacer '\n' par '\0'
-                strcpy(data, buffer);
-                return i; // Retourner la taille du message (sans le '\n')
-            }
+        if (delimiteur != NULL) {
+            // Message complet trouvé
+            int i = delimiteur - buffer;
+            buffer[i] = '\0'; // Remplacer '\n' par '\0'
+            memcpy(data, buffer, i + 1);
+            return i; // Retourner la taille du message (sans le '\n')
         }
     }
     
     // Message trop long pour le buffer
     return -1;
 }
+
+// ============================================================================
+// LECTEUR DE TRAMES
+// ============================================================================
+
+/**
+ * Initialise un lecteur de trames pour un socket
+ * @param reader Lecteur à initialiser
+ * @param sSocket Descripteur de socket
+ */
+void FrameReaderInit(FrameReader *reader, int sSocket) {
+    reader->socket = sSocket;
+    reader->debut = 0;
+    reader->fin = 0;
+    reader->analyse = 0;
+}
+
+/**
+ * Ramène en tête de tampon le début de la trame incomplète : la trame
+ * rendue précédemment n'est plus utilisée
+ * @param reader Lecteur de trames à compacter
+ */
+static void compacterLecteur(FrameReader *reader) {
+    if (reader->debut > 0) {
+        int restant = reader->fin - reader->debut;
+        memmove(reader->buffer, reader->buffer + reader->debut, restant);
+        reader->fin = restant;
+        reader->analyse -= reader->debut;
+        reader->debut = 0;
+    }
+}
+
+/**
+ * Extrait la prochaine trame complète déjà présente dans le tampon
+ * @param reader Lecteur de trames de la connexion
+ * @param frame Reçoit un pointeur vers la trame dans le tampon du lecteur
+ * @return Taille de la trame ou TRAME_INCOMPLETE si aucune n'est complète
+ */
+int NextFrame(FrameReader *reader, char **frame) {
+    // Recherche du délimiteur à partir de la dernière position analysée
+    char *delimiteur = (char *)memchr(reader->buffer + reader->analyse, '\n',
+                                     reader->fin - reader->analyse);
+    if (delimiteur == NULL) {
+        reader->analyse = reader->fin;
+        return TRAME_INCOMPLETE;
+    }
+    
+    // Trame complète : elle est rendue sans copie, en place
+    *delimiteur = '\0';
+    *frame = reader->buffer + reader->debut;
+    int taille = delimiteur - *frame;
+    reader->debut = delimiteur - reader->buffer + 1;
+    reader->analyse = reader->debut;
+    return taille;
+}
+
+/**
+ * Ajoute au lecteur des octets reçus par un autre moyen que recv()
+ * @param reader Lecteur de trames de la connexion
+ * @param data Octets reçus
+ * @param taille Nombre d'octets
+ * @return Nombre d'octets copiés (moins que taille si le tampon est plein)
+ *         ou -1 en cas d'erreur
+ */
+int FrameReaderFeed(FrameReader *reader, const char *data, int taille) {
+    if (reader == NULL || data == NULL || taille < 0) {
+        return -1;
+    }
+    
+    compacterLecteur(reader);
+    int place = TAILLE_LECTEUR - reader->fin;
+    if (taille > place) {
+        taille = place;
+    }
+    memcpy(reader->buffer + reader->fin, data, taille);
+    reader->fin += taille;
+    return taille;
+}
+
+/**
+ * Extrait la prochaine trame complète du lecteur
+ * @param reader Lecteur de trames de la connexion
+ * @param frame Reçoit un pointeur vers la trame dans le tampon du lecteur
+ * @return Taille de la trame, TRAME_INCOMPLETE (non bloquant) ou -1 en cas d'erreur
+ */
+int ReceiveFrame(FrameReader *reader, char **frame) {
+    // Vérification des paramètres d'entrée
+    if (reader == NULL || frame == NULL || reader->socket < 0) {
+        return -1;
+    }
+    
+    while (true) {
+        // Trame déjà complète dans le tampon
+        int taille = NextFrame(reader, frame);
+        if (taille != TRAME_INCOMPLETE) {
+            return taille;
+        }
+        compacterLecteur(reader);
+        
+        // Trame plus grande que le tampon
+        if (reader->fin >= TAILLE_LECTEUR) {
+            return -1;
+        }
+        
+        int octetsRecus = recv(reader->socket, reader->buffer + reader->fin,
+                               TAILLE_LECTEUR - reader->fin, 0);
+        if (octetsRecus < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // Socket non bloquant : plus rien à lire pour l'instant
+            return TRAME_INCOMPLETE;
+        }
+        if (octetsRecus < 0 && errno == EINTR) {
+            continue;
+        }
+        if (octetsRecus <= 0) {
+            // Erreur de réception ou connexion fermée
+            return -1;
+        }
+        reader->fin += octetsRecus;
+    }
+}
+
+/**
+ * Indique si une trame complète est déjà disponible dans le tampon
+ * @param reader Lecteur de trames de la connexion
+ * @return 1 si une trame est disponible sans appel système, 0 sinon
+ */
+int FrameReaderPending(const FrameReader *reader) {
+    if (reader == NULL) {
+        return 0;
+    }
+    return memchr(reader->buffer + reader->analyse, '\n',
+                  reader->fin - reader->analyse) != NULL;
+}
+
+// ============================================================================
+// ÉMETTEUR DE MESSAGES DÉCOUPÉS
+// ============================================================================
+
+static const char marqueSuite = MARQUE_SUITE;
+
+/**
+ * Initialise l'émetteur d'un message découpé en trames
+ * @param writer Émetteur à initialiser
+ * @param sSocket Socket de destination
+ */
+void ChunkWriterInit(ChunkWriter *writer, int sSocket) {
+    if (writer == NULL) {
+        return;
+    }
+    writer->socket = sSocket;
+    writer->erreur = 0;
+    writer->total = 0;
+    
+    // Le premier tampon est réservé à la marque des trames partielles
+    writer->tampons[0].iov_base = (void *)&marqueSuite;
+    writer->tampons[0].iov_len = 1;
+    writer->nbTampons = 1;
+    writer->taille = 1;
+}
+
+/**
+ * Envoie la trame en cours puis en commence une nouvelle
+ * @param writer Émetteur du message
+ * @param partielle 1 pour une trame suivie d'autres (avec marque), 0 sinon
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+static int envoyerTrame(ChunkWriter *writer, int partielle) {
+    int resultat;
+    if (partielle) {
+        resultat = SendV(writer->socket, writer->tampons, writer->nbTampons);
+    } else if (writer->nbTampons > 1) {
+        resultat = SendV(writer->socket, writer->tampons + 1, writer->nbTampons - 1);
+    } else {
+        // Message vide : trame réduite au délimiteur
+        struct iovec vide = {(void *)"", 0};
+        resultat = SendV(writer->socket, &vide, 1);
+    }
+    
+    writer->nbTampons = 1;
+    writer->taille = 1;
+    if (resultat < 0) {
+        writer->erreur = 1;
+        return -1;
+    }
+    writer->total += resultat;
+    return 0;
+}
+
+/**
+ * Ajoute des données au message, en envoyant les trames complètes
+ * @param writer Émetteur du message
+ * @param iov Tampons à ajouter (non recopiés)
+ * @param iovcnt Nombre de tampons
+ * @return 0 en cas de succès, -1 si un envoi a échoué
+ */
+int ChunkWriterAppend(ChunkWriter *writer, const struct iovec *iov, int iovcnt) {
+    if (writer == NULL || iov == NULL || iovcnt < 0 || writer->erreur) {
+        return -1;
+    }
+    
+    // Garder l'ajout entier : commencer une nouvelle trame s'il n'y tient pas
+    size_t tailleAjout = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        tailleAjout += iov[i].iov_len;
+    }
+    if (writer->nbTampons > 1 &&
+        (writer->taille + tailleAjout > TAILLE_TRAME ||
+         writer->nbTampons + iovcnt > TAMPONS_TRAME)) {
+        if (envoyerTrame(writer, 1) < 0) {
+            return -1;
+        }
+    }
+    
+    // Référencer les tampons, en les coupant s'ils dépassent une trame
+    for (int i = 0; i < iovcnt; i++) {
+        const char *donnees = (const char *)iov[i].iov_base;
+        size_t reste = iov[i].iov_len;
+        while (reste > 0) {
+            if (writer->taille == TAILLE_TRAME || writer->nbTampons == TAMPONS_TRAME) {
+                if (envoyerTrame(writer, 1) < 0) {
+                    return -1;
+                }
+            }
+            size_t morceau = TAILLE_TRAME - writer->taille;
+            if (morceau > reste) {
+                morceau = reste;
+            }
+            writer->tampons[writer->nbTampons].iov_base = (void *)donnees;
+            writer->tampons[writer->nbTampons].iov_len = morceau;
+            writer->nbTampons++;
+            writer->taille += morceau;
+            donnees += morceau;
+            reste -= morceau;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Envoie la trame en cours comme trame partielle
+ * @param writer Émetteur du message
+ * @return 0 en cas de succès, -1 si l'envoi a échoué
+ */
+int ChunkWriterFlush(ChunkWriter *writer) {
+    if (writer == NULL || writer->erreur) {
+        return -1;
+    }
+    if (writer->nbTampons == 1) {
+        return 0;
+    }
+    return envoyerTrame(writer, 1);
+}
+
+/**
+ * Envoie la dernière trame du message
+ * @param writer Émetteur du message
+ * @return Nombre total d'octets envoyés ou -1 en cas d'erreur
+ */
+int ChunkWriterFinish(ChunkWriter *writer) {
+    if (writer == NULL || writer->erreur) {
+        return -1;
+    }
+    if (envoyerTrame(writer, 0) < 0) {
+        return -1;
+    }
+    return writer->total;
+}
+// ============================================================================
+// CAPTURE DES ENVOIS
+// ============================================================================
+
+/**
+ * Active la capture des envois du thread courant vers un socket
+ * @param capture Capture à initialiser (une seule active par thread)
+ * @param sSocket Socket dont les envois sont capturés
+ */
+void SendCaptureBegin(SendCapture *capture, int sSocket) {
+    if (capture == NULL) {
+        return;
+    }
+    capture->socket = sSocket;
+    capture->donnees = NULL;
+    capture->taille = 0;
+    capture->capacite = 0;
+    capture->erreur = 0;
+    captureCourante = capture;
+}
+
+/**
+ * Désactive la capture du thread courant (les données capturées sont conservées)
+ * @param capture Capture active
+ */
+void SendCaptureEnd(SendCapture *capture) {
+    if (captureCourante == capture) {
+        captureCourante = NULL;
+    }
+}
+
+/**
+ * Envoie les trames capturées, telles quelles
+ * @param capture Capture terminée
+ * @return Nombre d'octets envoyés ou -1 en cas d'erreur
+ */
+int SendCaptured(const SendCapture *capture) {
+    if (capture == NULL || capture->socket < 0 || capture->erreur) {
+        return -1;
+    }
+    if (capture->taille == 0) {
+        return 0;
+    }
+    
+    struct iovec iov;
+    iov.iov_base = capture->donnees;
+    iov.iov_len = capture->taille;
+    if (backendEnvoi != NULL) {
+        int resultat = backendEnvoi(capture->socket, &iov, 1);
+        if (resultat != ENVOI_NON_GERE) {
+            return resultat;
+        }
+    }
+    return envoyerTampons(capture->socket, &iov, 1, 0);
+}
+
+/**
+ * Libère les données d'une capture
+ * @param capture Capture à libérer
+ */
+void SendCaptureFree(SendCapture *capture) {
+    if (capture == NULL) {
+        return;
+    }
+    SendCaptureEnd(capture);
+    free(capture->donnees);
+    capture->donnees = NULL;
+    capture->taille = 0;
+    capture->capacite = 0;
+}
+
 // ============================================================================
 // FONCTIONS SERVEUR
 // ============================================================================
@@ -103,8 +643,19 @@ int Receive(int sSocket, char *data) {
  * @return Descripteur de socket ou -1 en cas d'erreur
  */
 int ServerSocket(int port) {
-    // Vérification du port
-    if (port <= 0 || port > 65535) {
+    return ServerSocketEx(port, BACKLOG_DEFAUT, 0);
+}
+
+/**
+ * Crée un socket serveur en écoute avec une file d'attente choisie
+ * @param port Port d'écoute du serveur
+ * @param backlog Taille de la file d'attente (limitée par somaxconn)
+ * @param reusePort 1 pour activer SO_REUSEPORT, 0 sinon
+ * @return Descripteur de socket ou -1 en cas d'erreur
+ */
+int ServerSocketEx(int port, int backlog, int reusePort) {
+    // Vérification des paramètres
+    if (port <= 0 || port > 65535 || backlog <= 0) {
         return -1;
     }
     
@@ -114,6 +665,21 @@ int ServerSocket(int port) {
         return -1;
     }
     
+    // Redémarrage possible malgré les connexions en TIME_WAIT (fermetures
+    // à l'initiative du serveur, ex. sessions inactives)
+    int option = 1;
+    if (setsockopt(serverSocket, SOL_SOCKET, SO_REUSEADDR, &option, sizeof(option)) < 0) {
+        closeSocket(serverSocket);
+        return -1;
+    }
+    
+    // Partage du port entre plusieurs sockets d'écoute (avant le bind)
+    if (reusePort &&
+        setsockopt(serverSocket, SOL_SOCKET, SO_REUSEPORT, &option, sizeof(option)) < 0) {
+        closeSocket(serverSocket);
+        return -1;
+    }
+    
     // Configuration de l'adresse serveur
     struct sockaddr_in serverAddress;
     serverAddress.sin_family = AF_INET;
@@ -127,18 +693,74 @@ int ServerSocket(int port) {
         return -1;
     }
     
-    // Mise en écoute du socket (file d'attente de 5 connexions)
-    if (listen(serverSocket, 5) < 0) {
+    // Mise en écoute du socket
+    if (listen(serverSocket, backlog) < 0) {
         closeSocket(serverSocket);
         return -1;
     }
     
     return serverSocket;
 }
+
+/**
+ * Remplit l'adresse d'un socket AF_UNIX
+ * @param adresse Adresse à remplir
+ * @param chemin Chemin du fichier de socket
+ * @return 0 en cas de succès, -1 si le chemin est invalide ou trop long
+ */
+static int adresseUnix(struct sockaddr_un *adresse, const char *chemin) {
+    if (chemin == NULL || chemin[0] == '\0' ||
+        strlen(chemin) >= sizeof(adresse->sun_path)) {
+        return -1;
+    }
+    memset(adresse, 0, sizeof(*adresse));
+    adresse->sun_family = AF_UNIX;
+    strcpy(adresse->sun_path, chemin);
+    return 0;
+}
+
+/**
+ * Crée un socket serveur local (AF_UNIX) en écoute sur un chemin
+ * @param chemin Chemin du fichier de socket
+ * @param backlog Taille de la file d'attente (limitée par somaxconn)
+ * @return Descripteur de socket ou -1 en cas d'erreur
+ */
+int ServerSocketUnix(const char *chemin, int backlog) {
+    struct sockaddr_un serverAddress;
+    if (adresseUnix(&serverAddress, chemin) < 0 || backlog <= 0) {
+        return -1;
+    }
+    
+    int serverSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (serverSocket < 0) {
+        return -1;
+    }
+    
+    // Remplacer le fichier d'un arrêt précédent (jamais un fichier ordinaire)
+    struct stat infos;
+    if (lstat(chemin, &infos) == 0 && S_ISSOCK(infos.st_mode)) {
+        unlink(chemin);
+    }
+    
+    if (bind(serverSocket, (struct sockaddr *)&serverAddress, 
+             sizeof(serverAddress)) < 0) {
+        closeSocket(serverSocket);
+        return -1;
+    }
+    
+    if (listen(serverSocket, backlog) < 0) {
+        closeSocket(serverSocket);
+        unlink(chemin);
+        return -1;
+    }
+    
+    return serverSocket;
+}
 /**
  * Accepte une connexion entrante sur le socket serveur
  * @param socketEcoute Socket serveur en écoute
- * @param ipClient Buffer pour stocker l'IP du client (peut être NULL)
+ * @param ipClient Buffer pour stocker l'IP du client, IP_LOCALE pour un
+ *                 client AF_UNIX (peut être NULL)
  * @return Descripteur de socket client ou -1 en cas d'erreur
  */
 int AcceptConnection(int socketEcoute, char* ipClient) {
@@ -147,8 +769,8 @@ int AcceptConnection(int socketEcoute, char* ipClient) {
         return -1;
     }
     
-    // Structure pour recevoir les informations du client
-    struct sockaddr_in clientAddress;
+    // Structure pour recevoir les informations du client (TCP ou AF_UNIX)
+    struct sockaddr_storage clientAddress;
     socklen_t addressSize = sizeof(clientAddress);
     
     // Attente et acceptation d'une connexion
@@ -160,8 +782,12 @@ int AcceptConnection(int socketEcoute, char* ipClient) {
     
     // Récupération de l'adresse IP du client si demandée
     if (ipClient != NULL) {
-        snprintf(ipClient, INET_ADDRSTRLEN, "%s", 
-                inet_ntoa(clientAddress.sin_addr));
+        if (clientAddress.ss_family == AF_INET) {
+            inet_ntop(AF_INET, &((struct sockaddr_in *)&clientAddress)->sin_addr,
+                      ipClient, INET_ADDRSTRLEN);
+        } else {
+            snprintf(ipClient, INET_ADDRSTRLEN, "%s", IP_LOCALE);
+        }
     }
     
     return clientSocket;
@@ -177,13 +803,25 @@ int AcceptConnection(int socketEcoute, char* ipClient) {
  * @return Descripteur de socket ou -1 en cas d'erreur
  */
 int ClientSocket(const char* ipServeur, int port) {
+    return ClientSocketTimeout(ipServeur, port, -1);
+}
+
+/**
+ * Établit une connexion vers un serveur sans dépasser un délai
+ * @param ipServeur Adresse IP du serveur
+ * @param port Port du serveur
+ * @param delaiMs Délai maximal en millisecondes (-1 = délai du système)
+ * @return Descripteur de socket bloquant ou -1 en cas d'erreur
+ */
+int ClientSocketTimeout(const char* ipServeur, int port, int delaiMs) {
     // Vérification des paramètres d'entrée
     if (ipServeur == NULL || port <= 0 || port > 65535) {
+        errno = EINVAL;
         return -1;
     }
     
-    // Création du socket TCP
-    int clientSocket = socket(AF_INET, SOCK_STREAM, 0);
+    // Création du socket TCP, non bloquant le temps du connect
+    int clientSocket = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
     if (clientSocket < 0) {
         return -1;
     }
@@ -195,6 +833,197 @@ int ClientSocket(const char* ipServeur, int port) {
     serverAddress.sin_port = htons(port);
     
     // Tentative de connexion au serveur
+    if (connect(clientSocket, (struct sockaddr *)&serverAddress, 
+                sizeof(serverAddress)) < 0) {
+        if (errno != EINPROGRESS) {
+            int erreur = errno;
+            closeSocket(clientSocket);
+            errno = erreur;
+            return -1;
+        }
+        
+        // Attendre l'établissement sans dépasser l'échéance
+        long long echeance = delaiMs < 0 ? -1 : maintenantMs() + delaiMs;
+        struct pollfd attente = {clientSocket, POLLOUT, 0};
+        int pret;
+        do {
+            int restant = echeance < 0 ? -1 : (int)(echeance - maintenantMs());
+            if (echeance >= 0 && restant < 0) {
+                restant = 0;
+            }
+            pret = poll(&attente, 1, restant);
+        } while (pret < 0 && errno == EINTR);
+        
+        int erreur = 0;
+        socklen_t taille = sizeof(erreur);
+        if (pret == 0) {
+            erreur = ETIMEDOUT;
+        } else if (pret < 0) {
+            erreur = errno;
+        } else if (getsockopt(clientSocket, SOL_SOCKET, SO_ERROR, &erreur, &taille) < 0) {
+            erreur = errno;
+        }
+        if (erreur != 0) {
+            closeSocket(clientSocket);
+            errno = erreur;
+            return -1;
+        }
+    }
+    
+    // Les fonctions de communication attendent un socket bloquant
+    int flags = fcntl(clientSocket, F_GETFL, 0);
+    if (flags < 0 || fcntl(clientSocket, F_SETFL, flags & ~O_NONBLOCK) < 0) {
+        int erreur = errno;
+        closeSocket(clientSocket);
+        errno = erreur;
+        return -1;
+    }
+    
+    return clientSocket;
+}
+
+/**
+ * Initialise les paramètres de connexion par défaut
+ * @param options Paramètres à initialiser
+ */
+void ConnectOptionsInit(ConnectOptions *options) {
+    options->delaiTentativeMs = 1000;
+    options->delaiTotalMs = 5000;
+    options->tentatives = 5;
+    options->attenteInitialeMs = 100;
+    options->attenteMaxMs = 2000;
+}
+
+/**
+ * Établit une connexion en réessayant avec une attente exponentielle aléatoire
+ * @param ipServeur Adresse IP du serveur
+ * @param port Port du serveur
+ * @param options Paramètres de connexion (NULL = valeurs par défaut)
+ * @return Descripteur de socket ou -1 si toutes les tentatives ont échoué
+ */
+int ClientSocketRetry(const char* ipServeur, int port, const ConnectOptions *options) {
+    ConnectOptions defaut;
+    if (options == NULL) {
+        ConnectOptionsInit(&defaut);
+        options = &defaut;
+    }
+    
+    // Graine propre à l'appel : l'adresse de pile distingue les threads
+    unsigned int graine = (unsigned int)maintenantMs() ^ (unsigned int)getpid() ^
+                          (unsigned int)(uintptr_t)&graine;
+    long long echeance = maintenantMs() + options->delaiTotalMs;
+    int attenteMax = options->attenteInitialeMs;
+    
+    for (int tentative = 1; ; tentative++) {
+        long long restant = echeance - maintenantMs();
+        int delai = options->delaiTentativeMs;
+        if (restant < delai) {
+            delai = restant > 0 ? (int)restant : 0;
+        }
+        int clientSocket = ClientSocketTimeout(ipServeur, port, delai);
+        if (clientSocket >= 0 || errno == EINVAL || tentative >= options->tentatives) {
+            return clientSocket;
+        }
+        
+        // Attente aléatoire entre 0 et attenteMax (« full jitter »)
+        int erreur = errno;
+        int attente = attenteMax > 0 ? (int)(rand_r(&graine) % (attenteMax + 1)) : 0;
+        restant = echeance - maintenantMs();
+        if (restant <= attente) {
+            errno = erreur;
+            return -1;
+        }
+        usleep(attente * 1000);
+        attenteMax = attenteMax * 2 > options->attenteMaxMs ? options->attenteMaxMs
+                                                             : attenteMax * 2;
+    }
+}
+
+/**
+ * Paramètres d'une connexion asynchrone (libérés par son thread)
+ */
+struct ConnexionAsync {
+    char ipServeur[TAILLE_IP];
+    int port;
+    ConnectOptions options;
+    ConnectCallback callback;
+    void *userData;
+};
+
+/**
+ * Thread d'une connexion asynchrone
+ * @param arg Paramètres de la connexion (voir ConnexionAsync)
+ * @return NULL
+ */
+static void *threadConnexion(void *arg) {
+    ConnexionAsync *connexion = (ConnexionAsync *)arg;
+    int clientSocket = ClientSocketRetry(connexion->ipServeur, connexion->port,
+                                         &connexion->options);
+    connexion->callback(clientSocket, clientSocket < 0 ? errno : 0, connexion->userData);
+    free(connexion);
+    return NULL;
+}
+
+/**
+ * Lance une connexion dans un thread détaché qui appellera callback
+ * @param ipServeur Adresse IP du serveur
+ * @param port Port du serveur
+ * @param options Paramètres de connexion (NULL = valeurs par défaut)
+ * @param callback Fonction appelée à la fin de la connexion
+ * @param userData Donnée transmise à callback
+ * @return 0 si la connexion est lancée, -1 en cas d'erreur
+ */
+int ClientSocketAsync(const char* ipServeur, int port, const ConnectOptions *options,
+                      ConnectCallback callback, void *userData) {
+    if (ipServeur == NULL || callback == NULL || strlen(ipServeur) >= TAILLE_IP) {
+        errno = EINVAL;
+        return -1;
+    }
+    
+    ConnexionAsync *connexion = (ConnexionAsync *)malloc(sizeof(ConnexionAsync));
+    if (connexion == NULL) {
+        return -1;
+    }
+    snprintf(connexion->ipServeur, TAILLE_IP, "%s", ipServeur);
+    connexion->port = port;
+    if (options != NULL) {
+        connexion->options = *options;
+    } else {
+        ConnectOptionsInit(&connexion->options);
+    }
+    connexion->callback = callback;
+    connexion->userData = userData;
+    
+    pthread_t thread;
+    pthread_attr_t attributs;
+    pthread_attr_init(&attributs);
+    pthread_attr_setdetachstate(&attributs, PTHREAD_CREATE_DETACHED);
+    int resultat = pthread_create(&thread, &attributs, threadConnexion, connexion);
+    pthread_attr_destroy(&attributs);
+    if (resultat != 0) {
+        free(connexion);
+        errno = resultat;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Établit une connexion vers un serveur local (AF_UNIX)
+ * @param chemin Chemin du fichier de socket du serveur
+ * @return Descripteur de socket ou -1 en cas d'erreur
+ */
+int ClientSocketUnix(const char *chemin) {
+    struct sockaddr_un serverAddress;
+    if (adresseUnix(&serverAddress, chemin) < 0) {
+        return -1;
+    }
+    
+    int clientSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (clientSocket < 0) {
+        return -1;
+    }
+    
     if (connect(clientSocket, (struct sockaddr *)&serverAddress, 
                 sizeof(serverAddress)) < 0) {
         closeSocket(clientSocket);
@@ -222,4 +1051,38 @@ int closeSocket(int sSocket) {
     }
     
     return 0;
-}
\ No newline at end of file
+}
+
+/**
+ * Passe un socket en mode non bloquant
+ * @param sSocket Descripteur de socket
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int SetNonBlocking(int sSocket) {
+    int flags = fcntl(sSocket, F_GETFL, 0);
+    if (flags < 0) {
+        return -1;
+    }
+    
+    if (fcntl(sSocket, F_SETFL, flags | O_NONBLOCK) < 0) {
+        return -1;
+    }
+    
+    return 0;
+}
+
+/**
+ * Installe (ou retire avec NULL) le backend d'envoi utilisé par Send()
+ * @param backend Fonction d'envoi du backend
+ */
+void SetSendBackend(SendBackend backend) {
+    backendEnvoi = backend;
+}
+
+/**
+ * Fixe l'attente maximale d'un envoi bloqué par un client qui ne lit plus
+ * @param delaiMs Délai sans progression (ms, -1 pour attendre indéfiniment)
+ */
+void SetSendTimeout(int delaiMs) {
+    delaiEnvoiMs = delaiMs;
+}
@@ -18,12 +18,109 @@
 // INCLUDES SYSTÈME
 // ============================================================================
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 
 // ============================================================================
 // CONSTANTES
 // ============================================================================
 #define TAILLE_MAX 1024        // Taille maximale des messages
+#define TAILLE_LECTEUR (4 * TAILLE_MAX) // Taille du tampon d'un lecteur de trames
+#define TRAME_INCOMPLETE (-2)  // Socket non bloquant : pas encore de trame complète
+#define ENVOI_NON_GERE (-2)    // Le backend d'envoi ne gère pas ce socket
+#define BACKLOG_DEFAUT SOMAXCONN // File d'attente des connexions par défaut
+#define IP_LOCALE "local"      // Adresse rapportée pour un client AF_UNIX
+#define MARQUE_SUITE '+'       // Début d'une trame partielle : le message continue
+#define TAILLE_TRAME (TAILLE_MAX - 1) // Contenu maximal d'une trame découpée
+#define TAMPONS_TRAME 256      // Tampons référencés par une trame découpée
+#define DELAI_ENVOI_DEFAUT_MS 10000 // Attente maximale d'un envoi bloqué (client qui ne lit plus)
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Lecteur de trames associé à une connexion
+ *
+ * Conserve entre deux appels les octets reçus après le délimiteur '\n',
+ * de sorte que plusieurs commandes envoyées d'un bloc ne soient pas perdues.
+ * La recherche du délimiteur reprend là où elle s'était arrêtée.
+ */
+typedef struct {
+    int socket;                   // Socket associé au lecteur
+    int debut;                    // Début des données non consommées
+    int fin;                      // Fin des données valides dans le tampon
+    int analyse;                  // Position de reprise de la recherche du '\n'
+    char buffer[TAILLE_LECTEUR];  // Tampon de réception
+} FrameReader;
+
+/**
+ * Émetteur d'un message découpé en trames
+ *
+ * Le message est envoyé en trames d'au plus TAILLE_TRAME octets, lisibles
+ * par Receive() : toutes sauf la dernière commencent par MARQUE_SUITE et le
+ * destinataire reconstitue le message en concaténant leurs contenus. Un
+ * message court part en une seule trame, identique à celle de Send().
+ * Les tampons ajoutés ne sont pas recopiés : ils doivent rester valides
+ * jusqu'à ChunkWriterFinish().
+ */
+typedef struct {
+    int socket;                   // Socket de destination
+    int taille;                   // Octets de la trame en cours (marque comprise)
+    int nbTampons;                // Tampons de la trame en cours (marque comprise)
+    int erreur;                   // Un envoi a échoué : le message est abandonné
+    int total;                    // Octets envoyés sur le socket
+    struct iovec tampons[TAMPONS_TRAME]; // Marque puis contenu de la trame
+} ChunkWriter;
+
+/**
+ * Capture des envois d'un thread
+ *
+ * Tant qu'une capture est active pour le thread courant, les messages qu'il
+ * envoie sur le socket capturé (Send, SendV, ChunkWriter) sont recopiés dans
+ * le tampon, délimiteurs et marques compris, au lieu de partir sur le réseau.
+ * SendCaptured() transmet ensuite ces trames telles quelles, d'un bloc : un
+ * serveur peut ainsi calculer plusieurs réponses en parallèle et les rendre
+ * dans l'ordre des requêtes.
+ */
+typedef struct {
+    int socket;                   // Socket dont les envois sont capturés
+    char *donnees;                // Trames capturées (allouées)
+    int taille;                   // Octets capturés
+    int capacite;                 // Taille allouée
+    int erreur;                   // Capture incomplète (mémoire insuffisante)
+} SendCapture;
+
+/**
+ * Backend d'envoi optionnel (ex. io_uring) consulté par Send()
+ * Reçoit le message et son délimiteur sous forme de vecteur d'E/S.
+ * Renvoie le nombre d'octets pris en charge, -1 en cas d'erreur, ou
+ * ENVOI_NON_GERE si le socket n'appartient pas au backend.
+ */
+typedef int (*SendBackend)(int sSocket, const struct iovec *iov, int iovcnt);
+
+/**
+ * Paramètres d'une connexion client avec échéance et nouvelles tentatives
+ *
+ * Chaque tentative est limitée à delaiTentativeMs ; entre deux tentatives,
+ * l'attente double (à partir de attenteInitialeMs, plafonnée à attenteMaxMs)
+ * et sa durée réelle est tirée au hasard entre 0 et cette valeur, pour que
+ * des clients refusés ensemble ne reviennent pas tous au même instant.
+ * Le tout ne dépasse jamais delaiTotalMs.
+ */
+typedef struct {
+    int delaiTentativeMs;         // Durée maximale d'une tentative de connect
+    int delaiTotalMs;             // Échéance globale (tentatives et attentes)
+    int tentatives;               // Nombre maximal de tentatives
+    int attenteInitialeMs;        // Attente maximale avant la 2e tentative
+    int attenteMaxMs;             // Plafond de l'attente exponentielle
+} ConnectOptions;
+
+/**
+ * Fonction appelée à la fin d'une connexion asynchrone (depuis un thread
+ * de la librairie) avec le socket connecté, ou -1 et le code errno
+ */
+typedef void (*ConnectCallback)(int sSocket, int erreur, void *userData);
 
 // ============================================================================
 // FONCTIONS SERVEUR
@@ -36,10 +133,32 @@
  */
 int ServerSocket(int port);
 
+/**
+ * Crée un socket serveur en écoute avec une file d'attente choisie.
+ * Avec SO_REUSEPORT, plusieurs sockets peuvent écouter sur le même port :
+ * le noyau répartit alors les nouvelles connexions entre eux.
+ * @param port Port d'écoute du serveur
+ * @param backlog Taille de la file d'attente (limitée par somaxconn)
+ * @param reusePort 1 pour activer SO_REUSEPORT, 0 sinon
+ * @return Descripteur de socket ou -1 en cas d'erreur
+ */
+int ServerSocketEx(int port, int backlog, int reusePort);
+
+/**
+ * Crée un socket serveur local (AF_UNIX) en écoute sur un chemin.
+ * Les clients du même hôte évitent ainsi la pile TCP/IP. Un ancien
+ * fichier de socket laissé au même chemin est remplacé.
+ * @param chemin Chemin du fichier de socket
+ * @param backlog Taille de la file d'attente (limitée par somaxconn)
+ * @return Descripteur de socket ou -1 en cas d'erreur
+ */
+int ServerSocketUnix(const char *chemin, int backlog);
+
 /**
  * Accepte une connexion entrante sur le socket serveur
  * @param socketEcoute Socket serveur en écoute
- * @param ipClient Buffer pour stocker l'IP du client (peut être NULL)
+ * @param ipClient Buffer pour stocker l'IP du client, IP_LOCALE pour un
+ *                 client AF_UNIX (peut être NULL)
  * @return Descripteur de socket client ou -1 en cas d'erreur
  */
 int AcceptConnection(int socketEcoute, char* ipClient);
@@ -56,6 +175,53 @@ int AcceptConnection(int socketEcoute, char* ipClient);
  */
 int ClientSocket(const char* ipServeur, int port);
 
+/**
+ * Établit une connexion vers un serveur sans dépasser un délai
+ * (connect non bloquant ; le socket renvoyé est bloquant)
+ * @param ipServeur Adresse IP du serveur
+ * @param port Port du serveur
+ * @param delaiMs Délai maximal en millisecondes (-1 = délai du système)
+ * @return Descripteur de socket ou -1 en cas d'erreur (errno = ETIMEDOUT
+ *         si le délai est dépassé)
+ */
+int ClientSocketTimeout(const char* ipServeur, int port, int delaiMs);
+
+/**
+ * Initialise les paramètres de connexion par défaut (1 s par tentative,
+ * 5 tentatives, attente de 100 ms à 2 s, échéance globale de 5 s)
+ * @param options Paramètres à initialiser
+ */
+void ConnectOptionsInit(ConnectOptions *options);
+
+/**
+ * Établit une connexion en réessayant avec une attente exponentielle aléatoire
+ * @param ipServeur Adresse IP du serveur
+ * @param port Port du serveur
+ * @param options Paramètres de connexion (NULL = valeurs par défaut)
+ * @return Descripteur de socket ou -1 si toutes les tentatives ont échoué
+ */
+int ClientSocketRetry(const char* ipServeur, int port, const ConnectOptions *options);
+
+/**
+ * Établit une connexion (comme ClientSocketRetry) dans un thread dédié,
+ * sans bloquer l'appelant, puis appelle callback depuis ce thread
+ * @param ipServeur Adresse IP du serveur
+ * @param port Port du serveur
+ * @param options Paramètres de connexion (NULL = valeurs par défaut)
+ * @param callback Fonction appelée une seule fois à la fin de la connexion
+ * @param userData Donnée transmise à callback
+ * @return 0 si la connexion est lancée, -1 en cas d'erreur (callback non appelé)
+ */
+int ClientSocketAsync(const char* ipServeur, int port, const ConnectOptions *options,
+                      ConnectCallback callback, void *userData);
+
+/**
+ * Établit une connexion vers un serveur local (AF_UNIX)
+ * @param chemin Chemin du fichier de socket du serveur
+ * @return Descripteur de socket ou -1 en cas d'erreur
+ */
+int ClientSocketUnix(const char *chemin);
+
 // ============================================================================
 // FONCTIONS DE COMMUNICATION
 // ============================================================================
@@ -69,6 +235,16 @@ int ClientSocket(const char* ipServeur, int port);
  */
 int Send(int sSocket, const char *data, int taille);
 
+/**
+ * Envoie plusieurs tampons suivis du délimiteur '\n' en une seule trame,
+ * sans les recopier (sendmsg). Les tampons peuvent contenir des octets nuls.
+ * @param sSocket Descripteur de socket
+ * @param iov Tampons à envoyer, dans l'ordre
+ * @param iovcnt Nombre de tampons (non limité par IOV_MAX)
+ * @return Nombre d'octets envoyés (délimiteur compris) ou -1 en cas d'erreur
+ */
+int SendV(int sSocket, const struct iovec *iov, int iovcnt);
+
 /**
  * Reçoit des données depuis un socket
  * @param sSocket Descripteur de socket
@@ -77,6 +253,117 @@ int Send(int sSocket, const char *data, int taille);
  */
 int Receive(int sSocket, char *data);
 
+/**
+ * Initialise un lecteur de trames pour un socket
+ * @param reader Lecteur à initialiser
+ * @param sSocket Descripteur de socket
+ */
+void FrameReaderInit(FrameReader *reader, int sSocket);
+
+/**
+ * Extrait la prochaine trame complète, en appelant recv() seulement si
+ * aucune trame n'est déjà présente dans le tampon
+ * @param reader Lecteur de trames de la connexion
+ * @param frame Reçoit un pointeur vers la trame (terminée par '\0') dans le
+ *              tampon du lecteur, valide jusqu'au prochain appel
+ * @return Taille de la trame (sans le '\n'), TRAME_INCOMPLETE si le socket est
+ *         non bloquant et qu'aucune trame complète n'est disponible, ou -1
+ *         en cas d'erreur / connexion fermée
+ */
+int ReceiveFrame(FrameReader *reader, char **frame);
+
+/**
+ * Extrait la prochaine trame complète déjà présente dans le tampon, sans
+ * appel système (pour un lecteur alimenté par FrameReaderFeed)
+ * @param reader Lecteur de trames de la connexion
+ * @param frame Reçoit un pointeur vers la trame dans le tampon du lecteur
+ * @return Taille de la trame ou TRAME_INCOMPLETE si aucune n'est complète
+ */
+int NextFrame(FrameReader *reader, char **frame);
+
+/**
+ * Ajoute au lecteur des octets reçus par un autre moyen que recv()
+ * (invalide la dernière trame rendue)
+ * @param reader Lecteur de trames de la connexion
+ * @param data Octets reçus
+ * @param taille Nombre d'octets
+ * @return Nombre d'octets copiés (moins que taille si le tampon est plein)
+ *         ou -1 en cas d'erreur
+ */
+int FrameReaderFeed(FrameReader *reader, const char *data, int taille);
+
+/**
+ * Indique si une trame complète est déjà disponible dans le tampon
+ * @param reader Lecteur de trames de la connexion
+ * @return 1 si une trame est disponible sans appel système, 0 sinon
+ */
+int FrameReaderPending(const FrameReader *reader);
+
+/**
+ * Initialise l'émetteur d'un message découpé en trames
+ * @param writer Émetteur à initialiser
+ * @param sSocket Socket de destination
+ */
+void ChunkWriterInit(ChunkWriter *writer, int sSocket);
+
+/**
+ * Ajoute des données au message. Elles ne sont coupées entre deux trames
+ * que si elles ne tiennent pas dans une trame vide.
+ * @param writer Émetteur du message
+ * @param iov Tampons à ajouter (non recopiés)
+ * @param iovcnt Nombre de tampons
+ * @return 0 en cas de succès, -1 si un envoi a échoué
+ */
+int ChunkWriterAppend(ChunkWriter *writer, const struct iovec *iov, int iovcnt);
+
+/**
+ * Envoie la trame en cours, même incomplète, comme trame partielle : les
+ * tampons déjà ajoutés peuvent ensuite être réutilisés (message produit au
+ * fil de l'eau dans un tampon fixe)
+ * @param writer Émetteur du message
+ * @return 0 en cas de succès, -1 si l'envoi a échoué
+ */
+int ChunkWriterFlush(ChunkWriter *writer);
+
+/**
+ * Envoie la dernière trame du message
+ * @param writer Émetteur du message
+ * @return Nombre total d'octets envoyés ou -1 en cas d'erreur
+ */
+int ChunkWriterFinish(ChunkWriter *writer);
+
+// ============================================================================
+// CAPTURE DES ENVOIS
+// ============================================================================
+
+/**
+ * Active la capture des envois du thread courant vers un socket
+ * (les envois vers d'autres sockets partent normalement)
+ * @param capture Capture à initialiser (une seule active par thread)
+ * @param sSocket Socket dont les envois sont capturés
+ */
+void SendCaptureBegin(SendCapture *capture, int sSocket);
+
+/**
+ * Désactive la capture du thread courant (les données capturées sont conservées)
+ * @param capture Capture active
+ */
+void SendCaptureEnd(SendCapture *capture);
+
+/**
+ * Envoie les trames capturées telles quelles (par le backend d'envoi s'il
+ * gère le socket)
+ * @param capture Capture terminée
+ * @return Nombre d'octets envoyés, 0 si rien n'a été capturé, -1 en cas d'erreur
+ */
+int SendCaptured(const SendCapture *capture);
+
+/**
+ * Libère les données d'une capture (et la désactive si besoin)
+ * @param capture Capture à libérer
+ */
+void SendCaptureFree(SendCapture *capture);
+
 // ============================================================================
 // FONCTIONS UTILITAIRES
 // ============================================================================
@@ -88,4 +375,25 @@ int Receive(int sSocket, char *data);
  */
 int closeSocket(int sSocket);
 
+/**
+ * Passe un socket en mode non bloquant
+ * @param sSocket Descripteur de socket
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int SetNonBlocking(int sSocket);
+
+/**
+ * Installe (ou retire avec NULL) le backend d'envoi utilisé par Send()
+ * @param backend Fonction d'envoi du backend
+ */
+void SetSendBackend(SendBackend backend);
+
+/**
+ * Fixe l'attente maximale d'un envoi bloqué par un client qui ne lit plus
+ * (DELAI_ENVOI_DEFAUT_MS par défaut) : au-delà, l'envoi échoue avec ETIMEDOUT
+ * et la réponse est tronquée, l'appelant doit fermer la connexion
+ * @param delaiMs Délai sans progression (ms, -1 pour attendre indéfiniment)
+ */
+void SetSendTimeout(int delaiMs);
+
 #endif // SOCKET_H
\ No newline at end of file
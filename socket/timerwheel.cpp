@@ -0,0 +1,425 @@
+/**
+ * Implémentation de la roue de minuteries hiérarchique
+ *
+ * ROUE_NIVEAUX niveaux de ROUE_CASES cases : le niveau n couvre des
+ * échéances jusqu'à 64^(n+1) tics. Quand le niveau 0 fait un tour complet,
+ * la case suivante du niveau 1 est redistribuée dans le niveau 0 (et ainsi
+ * de suite), ce qui évite tout parcours des minuteries non expirées.
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "timerwheel.h"
+#include <sys/socket.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <time.h>
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+#define ROUE_BITS 6                         // Bits d'index par niveau
+#define ROUE_CASES (1 << ROUE_BITS)         // Cases par niveau
+#define ROUE_MASQUE (ROUE_CASES - 1)
+#define ROUE_NIVEAUX 4                      // Portée : 64^4 tics
+#define ROUE_PORTEE (1ULL << (ROUE_BITS * ROUE_NIVEAUX))
+#define MONITEUR_RESOLUTION_MS 100          // Tic du moniteur d'inactivité
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Roue de minuteries : chaque case est une liste circulaire dont la tête
+ * est une minuterie sentinelle
+ */
+struct TimerWheel {
+    int resolutionMs;               // Durée d'un tic
+    long long origineMs;            // Instant du tic 0
+    unsigned long long courant;     // Dernier tic traité
+    int nbMinuteries;               // Minuteries programmées
+    TimerEntry cases[ROUE_NIVEAUX][ROUE_CASES];
+};
+
+/**
+ * Moniteur d'inactivité : la roue n'est manipulée que sous verrou
+ */
+struct IdleMonitor {
+    TimerWheel *roue;               // Une minuterie par connexion surveillée
+    pthread_mutex_t verrou;         // Protège la roue
+    pthread_t thread;               // Thread qui fait avancer la roue
+    int arret;                      // Demande d'arrêt du thread
+    long long delaiMs;              // Inactivité tolérée
+    long long maintenant;           // Horloge mise à jour à chaque tic
+    IdleCallback onIdle;            // Notification avant fermeture
+    void *userData;                 // Donnée transmise à onIdle
+};
+
+// ============================================================================
+// ROUE DE MINUTERIES
+// ============================================================================
+
+/**
+ * Horloge monotone utilisée par la roue
+ * @return Temps écoulé en millisecondes depuis une origine arbitraire
+ */
+long long TimerWheelNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * Crée une roue de minuteries
+ * @param resolutionMs Durée d'un tic en millisecondes
+ * @return Roue créée ou NULL en cas d'erreur
+ */
+TimerWheel *TimerWheelCreate(int resolutionMs) {
+    if (resolutionMs <= 0) {
+        return NULL;
+    }
+    TimerWheel *wheel = (TimerWheel *)malloc(sizeof(TimerWheel));
+    if (wheel == NULL) {
+        return NULL;
+    }
+    wheel->resolutionMs = resolutionMs;
+    wheel->origineMs = TimerWheelNow();
+    wheel->courant = 0;
+    wheel->nbMinuteries = 0;
+    for (int niveau = 0; niveau < ROUE_NIVEAUX; niveau++) {
+        for (int i = 0; i < ROUE_CASES; i++) {
+            TimerEntry *tete = &wheel->cases[niveau][i];
+            tete->precedent = tete;
+            tete->suivant = tete;
+        }
+    }
+    return wheel;
+}
+
+/**
+ * Libère la roue (les minuteries encore programmées sont abandonnées)
+ * @param wheel Roue de minuteries
+ */
+void TimerWheelDestroy(TimerWheel *wheel) {
+    free(wheel);
+}
+
+/**
+ * Initialise une minuterie inactive
+ * @param entry Minuterie à initialiser
+ * @param data Donnée transmise à l'expiration
+ */
+void TimerEntryInit(TimerEntry *entry, void *data) {
+    if (entry == NULL) {
+        return;
+    }
+    entry->precedent = NULL;
+    entry->suivant = NULL;
+    entry->echeance = 0;
+    entry->data = data;
+}
+
+/**
+ * Retire une minuterie de sa case
+ * @param entry Minuterie programmée
+ */
+static void detacher(TimerEntry *entry) {
+    entry->precedent->suivant = entry->suivant;
+    entry->suivant->precedent = entry->precedent;
+    entry->precedent = NULL;
+    entry->suivant = NULL;
+}
+
+/**
+ * Range une minuterie dans la case correspondant à son échéance
+ * (échéance supérieure ou égale au tic courant)
+ * @param wheel Roue de minuteries
+ * @param entry Minuterie à ranger
+ */
+static void ranger(TimerWheel *wheel, TimerEntry *entry) {
+    unsigned long long delta = entry->echeance - wheel->courant;
+    if (delta >= ROUE_PORTEE) {
+        // Au-delà de la portée : expiration au plus tard possible
+        entry->echeance = wheel->courant + ROUE_PORTEE - 1;
+        delta = ROUE_PORTEE - 1;
+    }
+
+    // Niveau le plus fin dont la portée couvre l'échéance
+    int niveau = 0;
+    while (niveau < ROUE_NIVEAUX - 1 && delta >= (1ULL << (ROUE_BITS * (niveau + 1)))) {
+        niveau++;
+    }
+    int index = (entry->echeance >> (ROUE_BITS * niveau)) & ROUE_MASQUE;
+
+    // Insertion en fin de liste circulaire
+    TimerEntry *tete = &wheel->cases[niveau][index];
+    entry->suivant = tete;
+    entry->precedent = tete->precedent;
+    tete->precedent->suivant = entry;
+    tete->precedent = entry;
+}
+
+/**
+ * Redistribue la case courante d'un niveau dans les niveaux inférieurs
+ * @param wheel Roue de minuteries
+ * @param niveau Niveau à redistribuer (au moins 1)
+ * @return Index de la case redistribuée
+ */
+static int redistribuer(TimerWheel *wheel, int niveau) {
+    int index = (wheel->courant >> (ROUE_BITS * niveau)) & ROUE_MASQUE;
+    TimerEntry *tete = &wheel->cases[niveau][index];
+
+    // Détacher toute la liste avant de la ranger à nouveau
+    TimerEntry *entry = tete->suivant;
+    tete->precedent->suivant = NULL;
+    tete->suivant = tete;
+    tete->precedent = tete;
+    while (entry != tete && entry != NULL) {
+        TimerEntry *suivant = entry->suivant;
+        ranger(wheel, entry);
+        entry = suivant;
+    }
+    return index;
+}
+
+/**
+ * Programme (ou reprogramme) une minuterie
+ * @param wheel Roue de minuteries
+ * @param entry Minuterie à programmer
+ * @param delaiMs Délai avant expiration en millisecondes (au moins un tic)
+ */
+void TimerWheelSchedule(TimerWheel *wheel, TimerEntry *entry, long long delaiMs) {
+    if (wheel == NULL || entry == NULL) {
+        return;
+    }
+    TimerWheelCancel(wheel, entry);
+
+    // Échéance arrondie au tic supérieur, jamais dans le tic déjà traité
+    long long ecoule = TimerWheelNow() - wheel->origineMs;
+    if (delaiMs < 0) {
+        delaiMs = 0;
+    }
+    unsigned long long echeance =
+        (ecoule + delaiMs + wheel->resolutionMs - 1) / wheel->resolutionMs;
+    if (echeance <= wheel->courant) {
+        echeance = wheel->courant + 1;
+    }
+    entry->echeance = echeance;
+    ranger(wheel, entry);
+    wheel->nbMinuteries++;
+}
+
+/**
+ * Annule une minuterie (sans effet si elle n'est pas programmée)
+ * @param wheel Roue de minuteries
+ * @param entry Minuterie à annuler
+ */
+void TimerWheelCancel(TimerWheel *wheel, TimerEntry *entry) {
+    if (wheel == NULL || entry == NULL || entry->suivant == NULL) {
+        return;
+    }
+    detacher(entry);
+    wheel->nbMinuteries--;
+}
+
+/**
+ * Fait avancer la roue jusqu'à l'instant donné et expire les minuteries
+ * @param wheel Roue de minuteries
+ * @param maintenantMs Instant courant (voir TimerWheelNow)
+ * @param callback Fonction appelée pour chaque minuterie expirée
+ * @param userData Donnée transmise à callback
+ * @return Nombre de minuteries expirées
+ */
+int TimerWheelAdvance(TimerWheel *wheel, long long maintenantMs,
+                      TimerCallback callback, void *userData) {
+    if (wheel == NULL || maintenantMs < wheel->origineMs) {
+        return 0;
+    }
+
+    unsigned long long cible = (maintenantMs - wheel->origineMs) / wheel->resolutionMs;
+    int nbExpirees = 0;
+    while (wheel->courant < cible) {
+        wheel->courant++;
+
+        // Tour complet d'un niveau : redistribuer la case suivante du niveau supérieur
+        if ((wheel->courant & ROUE_MASQUE) == 0) {
+            for (int niveau = 1; niveau < ROUE_NIVEAUX; niveau++) {
+                if (redistribuer(wheel, niveau) != 0) {
+                    break;
+                }
+            }
+        }
+
+        // Expirer la case courante (une minuterie reprogrammée part plus loin)
+        TimerEntry *tete = &wheel->cases[0][wheel->courant & ROUE_MASQUE];
+        while (tete->suivant != tete) {
+            TimerEntry *entry = tete->suivant;
+            detacher(entry);
+            wheel->nbMinuteries--;
+            nbExpirees++;
+            if (callback != NULL) {
+                callback(entry, userData);
+            }
+        }
+    }
+    return nbExpirees;
+}
+
+/**
+ * Nombre de minuteries programmées
+ * @param wheel Roue de minuteries
+ * @return Nombre de minuteries en attente d'expiration
+ */
+int TimerWheelCount(const TimerWheel *wheel) {
+    return wheel != NULL ? wheel->nbMinuteries : 0;
+}
+
+// ============================================================================
+// MONITEUR D'INACTIVITÉ
+// ============================================================================
+
+/**
+ * Expiration de la minuterie d'une connexion (sous le verrou du moniteur) :
+ * la minuterie n'est pas déplacée à chaque activité, elle est reprogrammée
+ * ici si la connexion a été active depuis
+ * @param entry Minuterie de la connexion
+ * @param userData Moniteur d'inactivité
+ */
+static void expirerConnexion(TimerEntry *entry, void *userData) {
+    IdleMonitor *monitor = (IdleMonitor *)userData;
+    IdleConnection *connection = (IdleConnection *)entry->data;
+
+    long long derniere = __atomic_load_n(&connection->derniereActivite, __ATOMIC_RELAXED);
+    long long reste = derniere + monitor->delaiMs - monitor->maintenant;
+    if (reste > 0) {
+        TimerWheelSchedule(monitor->roue, entry, reste);
+        return;
+    }
+
+    // Inactive : le shutdown réveille le thread qui attend sur le socket,
+    // qui ferme alors la connexion par le chemin habituel
+    if (monitor->onIdle != NULL) {
+        monitor->onIdle(connection->socket, monitor->userData);
+    }
+    shutdown(connection->socket, SHUT_RDWR);
+}
+
+/**
+ * Thread du moniteur : fait avancer la roue à chaque tic
+ * @param arg Moniteur d'inactivité
+ * @return NULL
+ */
+static void *threadMoniteur(void *arg) {
+    IdleMonitor *monitor = (IdleMonitor *)arg;
+
+    while (!__atomic_load_n(&monitor->arret, __ATOMIC_ACQUIRE)) {
+        usleep(MONITEUR_RESOLUTION_MS * 1000);
+
+        long long maintenant = TimerWheelNow();
+        __atomic_store_n(&monitor->maintenant, maintenant, __ATOMIC_RELAXED);
+        pthread_mutex_lock(&monitor->verrou);
+        TimerWheelAdvance(monitor->roue, maintenant, expirerConnexion, monitor);
+        pthread_mutex_unlock(&monitor->verrou);
+    }
+    return NULL;
+}
+
+/**
+ * Crée le moniteur et démarre son thread
+ * @param delaiSecondes Inactivité tolérée avant fermeture (en secondes)
+ * @param onIdle Fonction appelée avant chaque fermeture (peut être NULL)
+ * @param userData Donnée transmise à onIdle
+ * @return Moniteur créé ou NULL en cas d'erreur
+ */
+IdleMonitor *IdleMonitorCreate(int delaiSecondes, IdleCallback onIdle, void *userData) {
+    if (delaiSecondes <= 0) {
+        return NULL;
+    }
+    IdleMonitor *monitor = (IdleMonitor *)malloc(sizeof(IdleMonitor));
+    if (monitor == NULL) {
+        return NULL;
+    }
+    monitor->roue = TimerWheelCreate(MONITEUR_RESOLUTION_MS);
+    if (monitor->roue == NULL) {
+        free(monitor);
+        return NULL;
+    }
+    pthread_mutex_init(&monitor->verrou, NULL);
+    monitor->arret = 0;
+    monitor->delaiMs = (long long)delaiSecondes * 1000;
+    monitor->maintenant = TimerWheelNow();
+    monitor->onIdle = onIdle;
+    monitor->userData = userData;
+
+    if (pthread_create(&monitor->thread, NULL, threadMoniteur, monitor) != 0) {
+        pthread_mutex_destroy(&monitor->verrou);
+        TimerWheelDestroy(monitor->roue);
+        free(monitor);
+        return NULL;
+    }
+    return monitor;
+}
+
+/**
+ * Arrête le thread du moniteur et le libère
+ * @param monitor Moniteur d'inactivité
+ */
+void IdleMonitorDestroy(IdleMonitor *monitor) {
+    if (monitor == NULL) {
+        return;
+    }
+    __atomic_store_n(&monitor->arret, 1, __ATOMIC_RELEASE);
+    pthread_join(monitor->thread, NULL);
+    pthread_mutex_destroy(&monitor->verrou);
+    TimerWheelDestroy(monitor->roue);
+    free(monitor);
+}
+
+/**
+ * Commence la surveillance d'une connexion
+ * @param monitor Moniteur d'inactivité
+ * @param connection Connexion à surveiller (valide jusqu'à IdleMonitorRemove)
+ * @param sSocket Socket de la connexion
+ */
+void IdleMonitorAdd(IdleMonitor *monitor, IdleConnection *connection, int sSocket) {
+    if (monitor == NULL || connection == NULL) {
+        return;
+    }
+    TimerEntryInit(&connection->timer, connection);
+    connection->socket = sSocket;
+    connection->derniereActivite = __atomic_load_n(&monitor->maintenant, __ATOMIC_RELAXED);
+
+    pthread_mutex_lock(&monitor->verrou);
+    TimerWheelSchedule(monitor->roue, &connection->timer, monitor->delaiMs);
+    pthread_mutex_unlock(&monitor->verrou);
+}
+
+/**
+ * Signale une activité sur la connexion (sans verrou ni appel système)
+ * @param monitor Moniteur d'inactivité
+ * @param connection Connexion surveillée
+ */
+void IdleMonitorTouch(IdleMonitor *monitor, IdleConnection *connection) {
+    if (monitor == NULL || connection == NULL) {
+        return;
+    }
+    __atomic_store_n(&connection->derniereActivite,
+                     __atomic_load_n(&monitor->maintenant, __ATOMIC_RELAXED),
+                     __ATOMIC_RELAXED);
+}
+
+/**
+ * Arrête la surveillance d'une connexion, avant la fermeture de son socket
+ * @param monitor Moniteur d'inactivité
+ * @param connection Connexion surveillée
+ */
+void IdleMonitorRemove(IdleMonitor *monitor, IdleConnection *connection) {
+    if (monitor == NULL || connection == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&monitor->verrou);
+    TimerWheelCancel(monitor->roue, &connection->timer);
+    pthread_mutex_unlock(&monitor->verrou);
+}
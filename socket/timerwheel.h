@@ -0,0 +1,165 @@
+/**
+ * Roue de minuteries hiérarchique et surveillance des connexions inactives
+ *
+ * La roue range chaque minuterie dans une case selon son échéance :
+ * l'ajout, l'annulation et l'expiration coûtent O(1), sans parcourir les
+ * minuteries à chaque tic. Les niveaux supérieurs (cases plus larges) sont
+ * redistribués vers les niveaux inférieurs au fil du temps.
+ *
+ * Le moniteur d'inactivité s'appuie sur la roue : un seul thread ferme
+ * (shutdown) les connexions restées inactives plus longtemps que le délai.
+ * Les threads de traitement signalent l'activité sans prendre de verrou.
+ */
+
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Minuterie de la roue, à intégrer dans la structure qu'elle surveille
+ */
+typedef struct TimerEntry {
+    struct TimerEntry *precedent;   // Minuterie précédente de la case
+    struct TimerEntry *suivant;     // Minuterie suivante (NULL si inactive)
+    unsigned long long echeance;    // Tic d'expiration
+    void *data;                     // Donnée transmise à l'expiration
+} TimerEntry;
+
+/**
+ * Roue de minuteries (structure opaque, non thread-safe)
+ */
+typedef struct TimerWheel TimerWheel;
+
+/**
+ * Fonction appelée pour chaque minuterie expirée (peut la reprogrammer)
+ */
+typedef void (*TimerCallback)(TimerEntry *entry, void *userData);
+
+/**
+ * Connexion surveillée par le moniteur d'inactivité
+ */
+typedef struct {
+    TimerEntry timer;               // Minuterie de la connexion (moniteur)
+    int socket;                     // Socket fermé en cas d'inactivité
+    long long derniereActivite;     // Dernière activité (ms, horloge du moniteur)
+} IdleConnection;
+
+/**
+ * Moniteur d'inactivité (structure opaque, thread-safe)
+ */
+typedef struct IdleMonitor IdleMonitor;
+
+/**
+ * Fonction appelée avant la fermeture d'une connexion inactive
+ * (par le thread du moniteur, sous son verrou : ne doit pas rappeler le moniteur)
+ */
+typedef void (*IdleCallback)(int sSocket, void *userData);
+
+// ============================================================================
+// ROUE DE MINUTERIES
+// ============================================================================
+
+/**
+ * Horloge monotone utilisée par la roue
+ * @return Temps écoulé en millisecondes depuis une origine arbitraire
+ */
+long long TimerWheelNow(void);
+
+/**
+ * Crée une roue de minuteries
+ * @param resolutionMs Durée d'un tic en millisecondes
+ * @return Roue créée ou NULL en cas d'erreur
+ */
+TimerWheel *TimerWheelCreate(int resolutionMs);
+
+/**
+ * Libère la roue (les minuteries encore programmées sont abandonnées)
+ * @param wheel Roue de minuteries
+ */
+void TimerWheelDestroy(TimerWheel *wheel);
+
+/**
+ * Initialise une minuterie inactive
+ * @param entry Minuterie à initialiser
+ * @param data Donnée transmise à l'expiration
+ */
+void TimerEntryInit(TimerEntry *entry, void *data);
+
+/**
+ * Programme (ou reprogramme) une minuterie
+ * @param wheel Roue de minuteries
+ * @param entry Minuterie à programmer
+ * @param delaiMs Délai avant expiration en millisecondes (au moins un tic)
+ */
+void TimerWheelSchedule(TimerWheel *wheel, TimerEntry *entry, long long delaiMs);
+
+/**
+ * Annule une minuterie (sans effet si elle n'est pas programmée)
+ * @param wheel Roue de minuteries
+ * @param entry Minuterie à annuler
+ */
+void TimerWheelCancel(TimerWheel *wheel, TimerEntry *entry);
+
+/**
+ * Fait avancer la roue jusqu'à l'instant donné et expire les minuteries
+ * @param wheel Roue de minuteries
+ * @param maintenantMs Instant courant (voir TimerWheelNow)
+ * @param callback Fonction appelée pour chaque minuterie expirée
+ * @param userData Donnée transmise à callback
+ * @return Nombre de minuteries expirées
+ */
+int TimerWheelAdvance(TimerWheel *wheel, long long maintenantMs,
+                      TimerCallback callback, void *userData);
+
+/**
+ * Nombre de minuteries programmées
+ * @param wheel Roue de minuteries
+ * @return Nombre de minuteries en attente d'expiration
+ */
+int TimerWheelCount(const TimerWheel *wheel);
+
+// ============================================================================
+// MONITEUR D'INACTIVITÉ
+// ============================================================================
+
+/**
+ * Crée le moniteur et démarre son thread
+ * @param delaiSecondes Inactivité tolérée avant fermeture (en secondes)
+ * @param onIdle Fonction appelée avant chaque fermeture (peut être NULL)
+ * @param userData Donnée transmise à onIdle
+ * @return Moniteur créé ou NULL en cas d'erreur
+ */
+IdleMonitor *IdleMonitorCreate(int delaiSecondes, IdleCallback onIdle, void *userData);
+
+/**
+ * Arrête le thread du moniteur et le libère
+ * @param monitor Moniteur d'inactivité
+ */
+void IdleMonitorDestroy(IdleMonitor *monitor);
+
+/**
+ * Commence la surveillance d'une connexion
+ * @param monitor Moniteur d'inactivité
+ * @param connection Connexion à surveiller (valide jusqu'à IdleMonitorRemove)
+ * @param sSocket Socket de la connexion
+ */
+void IdleMonitorAdd(IdleMonitor *monitor, IdleConnection *connection, int sSocket);
+
+/**
+ * Signale une activité sur la connexion (sans verrou ni appel système)
+ * @param monitor Moniteur d'inactivité
+ * @param connection Connexion surveillée
+ */
+void IdleMonitorTouch(IdleMonitor *monitor, IdleConnection *connection);
+
+/**
+ * Arrête la surveillance d'une connexion, avant la fermeture de son socket
+ * @param monitor Moniteur d'inactivité
+ * @param connection Connexion surveillée
+ */
+void IdleMonitorRemove(IdleMonitor *monitor, IdleConnection *connection);
+
+#endif // TIMERWHEEL_H
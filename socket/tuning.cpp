@@ -0,0 +1,176 @@
+/**
+ * Implémentation des profils de réglage des sockets
+ *
+ * Chaque option est décrite une seule fois (niveau, option système, champ du
+ * profil, portée) : l'application et le rapport parcourent la même table.
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "tuning.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// TABLE DES OPTIONS
+// ============================================================================
+
+/**
+ * Description d'une option de socket réglable
+ */
+struct OptionSocket {
+    const char *nom;                // Nom de l'option (configuration et rapport)
+    int niveau;                     // Niveau setsockopt (SOL_SOCKET, IPPROTO_TCP)
+    int option;                     // Option setsockopt
+    size_t champ;                   // Décalage du champ dans SocketProfile
+    bool ecouteSeule;               // Option réservée au socket d'écoute
+    bool tcpSeule;                  // Option ignorée sur un socket AF_UNIX
+};
+
+static const OptionSocket options[] = {
+    {"NODELAY",      IPPROTO_TCP, TCP_NODELAY,      offsetof(SocketProfile, noDelay),     false, true},
+    {"DEFER_ACCEPT", IPPROTO_TCP, TCP_DEFER_ACCEPT, offsetof(SocketProfile, deferAccept), true,  true},
+    {"FASTOPEN",     IPPROTO_TCP, TCP_FASTOPEN,     offsetof(SocketProfile, fastOpen),    true,  true},
+    {"BUSY_POLL",    SOL_SOCKET,  SO_BUSY_POLL,     offsetof(SocketProfile, busyPoll),    false, true},
+    {"RCVBUF",       SOL_SOCKET,  SO_RCVBUF,        offsetof(SocketProfile, rcvBuf),      false, false},
+    {"SNDBUF",       SOL_SOCKET,  SO_SNDBUF,        offsetof(SocketProfile, sndBuf),      false, false},
+    {"KEEPALIVE",    SOL_SOCKET,  SO_KEEPALIVE,     offsetof(SocketProfile, keepAlive),   false, true},
+    {"KEEPIDLE",     IPPROTO_TCP, TCP_KEEPIDLE,     offsetof(SocketProfile, keepIdle),    false, true},
+    {"KEEPINTVL",    IPPROTO_TCP, TCP_KEEPINTVL,    offsetof(SocketProfile, keepIntvl),   false, true},
+    {"KEEPCNT",      IPPROTO_TCP, TCP_KEEPCNT,      offsetof(SocketProfile, keepCnt),     false, true},
+};
+
+#define NB_OPTIONS ((int)(sizeof(options) / sizeof(options[0])))
+
+static int *champProfil(SocketProfile *profile, const OptionSocket *option) {
+    return (int *)((char *)profile + option->champ);
+}
+
+static int valeurProfil(const SocketProfile *profile, const OptionSocket *option) {
+    return *(const int *)((const char *)profile + option->champ);
+}
+
+// ============================================================================
+// PROFILS
+// ============================================================================
+
+int SocketProfileInit(SocketProfile *profile, const char *nom) {
+    memset(profile, 0, sizeof(SocketProfile));
+    for (int i = 0; i < NB_OPTIONS; i++) {
+        *champProfil(profile, &options[i]) = OPTION_INCHANGEE;
+    }
+    snprintf(profile->nom, sizeof(profile->nom), "%s", "defaut");
+    if (nom == NULL || strcmp(nom, "defaut") == 0) {
+        return 0;
+    }
+
+    if (strcmp(nom, "latence") == 0) {
+        // Réponse immédiate aux petites requêtes : pas de Nagle, pas de
+        // réveil avant la première commande, sondage actif de la carte
+        profile->noDelay = 1;
+        profile->deferAccept = 5;
+        profile->busyPoll = 50;
+        profile->keepAlive = 1;
+        profile->keepIdle = 60;
+        profile->keepIntvl = 10;
+        profile->keepCnt = 5;
+    } else if (strcmp(nom, "debit") == 0) {
+        // Grosses réponses (SEARCH) : tampons larges, reconnexions en 0-RTT
+        profile->noDelay = 1;
+        profile->fastOpen = 256;
+        profile->rcvBuf = 1 << 20;
+        profile->sndBuf = 1 << 20;
+        profile->keepAlive = 1;
+    } else {
+        return -1;
+    }
+    snprintf(profile->nom, sizeof(profile->nom), "%s", nom);
+    return 0;
+}
+
+int SocketProfileSet(SocketProfile *profile, const char *option, int valeur) {
+    for (int i = 0; i < NB_OPTIONS; i++) {
+        if (strcmp(options[i].nom, option) == 0) {
+            *champProfil(profile, &options[i]) = valeur;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// ============================================================================
+// APPLICATION
+// ============================================================================
+
+/**
+ * Indique si le socket appartient à la pile TCP/IP
+ */
+static bool estSocketTcp(int sSocket) {
+    int domaine = 0;
+    socklen_t taille = sizeof(domaine);
+    if (getsockopt(sSocket, SOL_SOCKET, SO_DOMAIN, &domaine, &taille) < 0) {
+        return true;
+    }
+    return domaine == AF_INET || domaine == AF_INET6;
+}
+
+/**
+ * Applique les options du profil qui concernent le socket
+ * @param sSocket Socket à régler
+ * @param profile Profil à appliquer
+ * @param ecoute true pour un socket d'écoute
+ * @return 0 en cas de succès, -1 si une option a été refusée
+ */
+static int appliquerProfil(int sSocket, const SocketProfile *profile, bool ecoute) {
+    bool tcp = estSocketTcp(sSocket);
+    int resultat = 0;
+    for (int i = 0; i < NB_OPTIONS; i++) {
+        const OptionSocket *option = &options[i];
+        int valeur = valeurProfil(profile, option);
+        if (valeur == OPTION_INCHANGEE || (option->ecouteSeule && !ecoute) ||
+            (option->tcpSeule && !tcp)) {
+            continue;
+        }
+        if (setsockopt(sSocket, option->niveau, option->option, &valeur, sizeof(valeur)) < 0) {
+            fprintf(stderr, "ATTENTION: Option %s=%d refusée (socket %d): %s\n",
+                    option->nom, valeur, sSocket, strerror(errno));
+            resultat = -1;
+        }
+    }
+    return resultat;
+}
+
+int SocketTuneListener(int sSocket, const SocketProfile *profile) {
+    return appliquerProfil(sSocket, profile, true);
+}
+
+int SocketTuneConnection(int sSocket, const SocketProfile *profile) {
+    return appliquerProfil(sSocket, profile, false);
+}
+
+void SocketTuningReport(int sSocket, const char *libelle) {
+    bool tcp = estSocketTcp(sSocket);
+    char ligne[512];
+    int longueur = snprintf(ligne, sizeof(ligne), "%s:", libelle);
+    for (int i = 0; i < NB_OPTIONS && longueur < (int)sizeof(ligne); i++) {
+        const OptionSocket *option = &options[i];
+        if (option->tcpSeule && !tcp) {
+            continue;
+        }
+        int valeur = 0;
+        socklen_t taille = sizeof(valeur);
+        if (getsockopt(sSocket, option->niveau, option->option, &valeur, &taille) < 0) {
+            longueur += snprintf(ligne + longueur, sizeof(ligne) - longueur, " %s=?", option->nom);
+        } else {
+            longueur += snprintf(ligne + longueur, sizeof(ligne) - longueur, " %s=%d",
+                                 option->nom, valeur);
+        }
+    }
+    printf("%s\n", ligne);
+}
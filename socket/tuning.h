@@ -0,0 +1,95 @@
+/**
+ * Profils de réglage des sockets (options TCP et tampons)
+ *
+ * Un profil regroupe les options appliquées aux sockets d'écoute et aux
+ * connexions acceptées. Des profils nommés sont prédéfinis ; chaque option
+ * peut ensuite être modifiée individuellement (par exemple depuis la
+ * configuration du serveur). Les options TCP sont ignorées sur un socket
+ * AF_UNIX, qui ne reçoit que les tailles de tampons.
+ */
+
+#ifndef TUNING_H
+#define TUNING_H
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+#define OPTION_INCHANGEE -1         // Option laissée à la valeur du système
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Profil de réglage (OPTION_INCHANGEE = valeur du système conservée)
+ */
+typedef struct {
+    char nom[32];                   // Nom du profil de départ
+    int noDelay;                    // TCP_NODELAY : désactive l'algorithme de Nagle (0/1)
+    int deferAccept;                // TCP_DEFER_ACCEPT : attente des données en secondes (écoute)
+    int fastOpen;                   // TCP_FASTOPEN : file des connexions TFO (écoute)
+    int busyPoll;                   // SO_BUSY_POLL : attente active en microsecondes
+    int rcvBuf;                     // SO_RCVBUF : tampon de réception en octets
+    int sndBuf;                     // SO_SNDBUF : tampon d'émission en octets
+    int keepAlive;                  // SO_KEEPALIVE : sondes de connexion (0/1)
+    int keepIdle;                   // TCP_KEEPIDLE : inactivité avant la première sonde (s)
+    int keepIntvl;                  // TCP_KEEPINTVL : intervalle entre deux sondes (s)
+    int keepCnt;                    // TCP_KEEPCNT : sondes sans réponse avant fermeture
+} SocketProfile;
+
+// ============================================================================
+// PROFILS
+// ============================================================================
+
+/**
+ * Initialise un profil prédéfini :
+ * - "defaut"  : aucune option modifiée
+ * - "latence" : requêtes courtes (Nagle désactivé, accept différé, busy poll)
+ * - "debit"   : grosses réponses (tampons de 1 Mo, TCP Fast Open)
+ * @param profile Profil à initialiser
+ * @param nom Nom du profil
+ * @return 0 en cas de succès, -1 si le nom est inconnu (profil "defaut")
+ */
+int SocketProfileInit(SocketProfile *profile, const char *nom);
+
+/**
+ * Modifie une option du profil
+ * @param profile Profil à modifier
+ * @param option Nom de l'option (NODELAY, DEFER_ACCEPT, FASTOPEN, BUSY_POLL,
+ *               RCVBUF, SNDBUF, KEEPALIVE, KEEPIDLE, KEEPINTVL, KEEPCNT)
+ * @param valeur Nouvelle valeur (OPTION_INCHANGEE pour ne pas l'appliquer)
+ * @return 0 en cas de succès, -1 si l'option est inconnue
+ */
+int SocketProfileSet(SocketProfile *profile, const char *option, int valeur);
+
+// ============================================================================
+// APPLICATION
+// ============================================================================
+
+/**
+ * Applique toutes les options du profil à un socket d'écoute
+ * (les connexions acceptées en héritent sous Linux)
+ * @param sSocket Socket d'écoute
+ * @param profile Profil à appliquer
+ * @return 0 en cas de succès, -1 si une option a été refusée (signalée sur stderr)
+ */
+int SocketTuneListener(int sSocket, const SocketProfile *profile);
+
+/**
+ * Applique les options propres à chaque connexion à un socket accepté
+ * (sans TCP_DEFER_ACCEPT ni TCP_FASTOPEN, réservées à l'écoute)
+ * @param sSocket Socket de la connexion
+ * @param profile Profil à appliquer
+ * @return 0 en cas de succès, -1 si une option a été refusée (signalée sur stderr)
+ */
+int SocketTuneConnection(int sSocket, const SocketProfile *profile);
+
+/**
+ * Affiche les valeurs effectives des options d'un socket (lues auprès du
+ * noyau, qui peut arrondir ou plafonner les valeurs demandées)
+ * @param sSocket Socket à inspecter
+ * @param libelle Libellé affiché en tête de ligne
+ */
+void SocketTuningReport(int sSocket, const char *libelle);
+
+#endif // TUNING_H
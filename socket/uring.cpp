@@ -0,0 +1,810 @@
+/**
+ * Implémentation du backend io_uring de la librairie de sockets
+ *
+ * La boucle tourne sur un seul thread, propriétaire de l'anneau io_uring.
+ * Les autres threads ne touchent jamais l'anneau : leurs Send() ajoutent
+ * les octets au tampon de sortie de la connexion et réveillent la boucle
+ * (eventfd) qui soumet tous les envois en attente en un seul appel.
+ * Un client qui ne lit plus ses réponses ne peut pas faire grossir son
+ * tampon de sortie sans limite : au-delà de URING_MAX_SORTIE octets en
+ * attente, ou après une erreur d'envoi, la connexion est coupée.
+ */
+
+// ============================================================================
+// INCLUDES
+// ============================================================================
+#include "uring.h"
+#include "socket.h"
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <sys/utsname.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+#define URING_ENTREES 4096          // Taille de la file de soumission
+#define URING_NB_TAMPONS 1024       // Tampons fournis au noyau (puissance de 2)
+#define URING_TAILLE_TAMPON 4096    // Taille de chaque tampon de réception
+#define URING_GROUPE_TAMPONS 1      // Identifiant du groupe de tampons
+#define URING_MAX_ECOUTES 4         // Sockets d'écoute par boucle (TCP, AF_UNIX...)
+#define URING_MAX_SORTIE (16 * TAILLE_LECTEUR) // Octets en attente d'envoi par connexion
+
+// Type d'opération codé dans les bits de poids faible de user_data
+#define OP_ACCEPT 1ULL
+#define OP_RECV 2ULL
+#define OP_SEND 3ULL
+#define OP_REVEIL 4ULL
+#define OP_ANNULATION 5ULL
+#define OP_MASQUE 7ULL
+#define OP_DECALAGE 3               // user_data d'un accept : index de l'écoute << 3
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Connexion acceptée par la boucle
+ * Les champs marqués (verrou) sont protégés par server->verrou, les autres
+ * ne sont manipulés que par le thread de la boucle.
+ */
+struct UringConnection {
+    int socket;                     // Socket du client
+    void *contexte;                 // Contexte rendu par onOpen
+    UringServer *server;            // Boucle propriétaire
+    std::string sortie;             // Octets en attente d'envoi (verrou)
+    bool aEnvoyer;                  // Présente dans la liste des envois (verrou)
+    bool fermeture;                 // Fermeture demandée par UringClose (verrou)
+    bool aFermer;                   // Présente dans la liste des fermetures (verrou)
+    bool envoiCoupe;                // Sortie saturée ou erreur d'envoi : plus d'envoi (verrou)
+    std::string enVol;              // Octets confiés au noyau
+    size_t envoye;                  // Octets de enVol déjà envoyés
+    bool envoiEnCours;              // Un envoi est soumis au noyau
+    bool recvArme;                  // Le recv multishot est actif
+    bool fermeNotifie;              // onClose a déjà été appelé
+};
+
+/**
+ * Boucle d'événements io_uring
+ */
+struct UringServer {
+    int ringFd;                     // Descripteur de l'instance io_uring
+    int socketsEcoute[URING_MAX_ECOUTES]; // Sockets serveur en écoute
+    int nbEcoutes;                  // Nombre de sockets d'écoute
+    int reveilFd;                   // eventfd de réveil de la boucle
+    UringHandlers handlers;         // Fonctions de l'application
+
+    // File de soumission (partagée avec le noyau)
+    unsigned *sqHead;
+    unsigned *sqTail;
+    unsigned *sqMask;
+    unsigned *sqArray;
+    unsigned sqEntrees;
+    struct io_uring_sqe *sqes;
+    unsigned sqLocal;               // Prochaine position libre (non publiée)
+    unsigned aSoumettre;            // Entrées préparées et pas encore soumises
+
+    // File de complétion (partagée avec le noyau)
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned *cqMask;
+    struct io_uring_cqe *cqes;
+
+    // Zones projetées en mémoire
+    void *sqPtr;
+    size_t sqTaille;
+    void *cqPtr;
+    size_t cqTaille;
+    size_t sqesTaille;
+
+    // Tampons de réception fournis au noyau
+    struct io_uring_buf_ring *anneau;
+    size_t anneauTaille;
+    char *tampons;
+
+    uint64_t valeurReveil;          // Valeur lue sur l'eventfd
+    volatile bool arret;            // Arrêt demandé
+
+    // État partagé avec les autres threads
+    pthread_mutex_t verrou;
+    std::vector<UringConnection *> envois;      // Connexions ayant des octets à envoyer
+    std::vector<UringConnection *> fermetures;  // Connexions à fermer
+    bool reveilEnAttente;           // Un réveil est déjà signalé
+};
+
+// ============================================================================
+// VARIABLES GLOBALES
+// ============================================================================
+
+// Connexions des boucles io_uring indexées par descripteur (pour Send)
+static std::vector<UringConnection *> registre;
+static pthread_mutex_t registreVerrou = PTHREAD_MUTEX_INITIALIZER;
+
+// ============================================================================
+// APPELS SYSTÈME ET ACCÈS AUX FILES
+// ============================================================================
+
+static int uringSetup(unsigned entrees, struct io_uring_params *params) {
+    return (int)syscall(__NR_io_uring_setup, entrees, params);
+}
+
+static int uringEnter(int ringFd, unsigned aSoumettre, unsigned minCompletions, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, ringFd, aSoumettre, minCompletions, flags, NULL, 0);
+}
+
+static int uringRegister(int ringFd, unsigned operation, void *arg, unsigned nbArgs) {
+    return (int)syscall(__NR_io_uring_register, ringFd, operation, arg, nbArgs);
+}
+
+static inline unsigned chargerAcquire(const unsigned *p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void stockerRelease(unsigned *p, unsigned valeur) {
+    __atomic_store_n(p, valeur, __ATOMIC_RELEASE);
+}
+
+/**
+ * Soumet au noyau les entrées préparées et attend éventuellement des complétions
+ * @param server Boucle io_uring
+ * @param attendre Nombre minimal de complétions à attendre
+ * @return Nombre d'entrées soumises ou -1 en cas d'erreur
+ */
+static int soumettre(UringServer *server, unsigned attendre) {
+    stockerRelease(server->sqTail, server->sqLocal);
+    int soumis = uringEnter(server->ringFd, server->aSoumettre, attendre,
+                            attendre > 0 ? IORING_ENTER_GETEVENTS : 0);
+    if (soumis < 0) {
+        return errno == EINTR ? 0 : -1;
+    }
+    server->aSoumettre -= soumis;
+    return soumis;
+}
+
+/**
+ * Réserve une entrée dans la file de soumission
+ * @param server Boucle io_uring
+ * @return Entrée remise à zéro ou NULL si la file ne peut pas être vidée
+ */
+static struct io_uring_sqe *prendreSqe(UringServer *server) {
+    while (server->sqLocal - chargerAcquire(server->sqHead) >= server->sqEntrees) {
+        if (soumettre(server, 0) <= 0) {
+            return NULL;
+        }
+    }
+
+    unsigned index = server->sqLocal & *server->sqMask;
+    struct io_uring_sqe *sqe = &server->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    server->sqArray[index] = index;
+    server->sqLocal++;
+    server->aSoumettre++;
+    return sqe;
+}
+
+/**
+ * Rend un tampon de réception au noyau
+ * @param server Boucle io_uring
+ * @param identifiant Identifiant du tampon
+ */
+static void rendreTampon(UringServer *server, unsigned short identifiant) {
+    // Accès direct aux entrées : en C++, le tableau flexible de
+    // io_uring_buf_ring n'est pas placé au début de la structure.
+    // La queue de l'anneau recouvre le champ resv de la première entrée.
+    struct io_uring_buf *entrees = (struct io_uring_buf *)server->anneau;
+    unsigned short *queue = &entrees[0].resv;
+    unsigned short position = *queue;
+    struct io_uring_buf *tampon = &entrees[position & (URING_NB_TAMPONS - 1)];
+    tampon->addr = (uint64_t)(uintptr_t)(server->tampons + (size_t)identifiant * URING_TAILLE_TAMPON);
+    tampon->len = URING_TAILLE_TAMPON;
+    tampon->bid = identifiant;
+    __atomic_store_n(queue, (unsigned short)(position + 1), __ATOMIC_RELEASE);
+}
+
+// ============================================================================
+// PRÉPARATION DES OPÉRATIONS
+// ============================================================================
+
+static void armerAccept(UringServer *server, int index) {
+    struct io_uring_sqe *sqe = prendreSqe(server);
+    if (sqe == NULL) {
+        fprintf(stderr, "ERREUR: io_uring plein (accept)\n");
+        return;
+    }
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = server->socketsEcoute[index];
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = ((uint64_t)index << OP_DECALAGE) | OP_ACCEPT;
+}
+
+static void armerRecv(UringServer *server, UringConnection *connexion) {
+    struct io_uring_sqe *sqe = prendreSqe(server);
+    if (sqe == NULL) {
+        fprintf(stderr, "ERREUR: io_uring plein (recv)\n");
+        connexion->recvArme = false;
+        return;
+    }
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = connexion->socket;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_GROUPE_TAMPONS;
+    sqe->user_data = (uint64_t)(uintptr_t)connexion | OP_RECV;
+    connexion->recvArme = true;
+}
+
+static void armerReveil(UringServer *server) {
+    struct io_uring_sqe *sqe = prendreSqe(server);
+    if (sqe == NULL) {
+        fprintf(stderr, "ERREUR: io_uring plein (réveil)\n");
+        return;
+    }
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = server->reveilFd;
+    sqe->addr = (uint64_t)(uintptr_t)&server->valeurReveil;
+    sqe->len = sizeof(server->valeurReveil);
+    sqe->user_data = OP_REVEIL;
+}
+
+static void annulerRecv(UringServer *server, UringConnection *connexion) {
+    struct io_uring_sqe *sqe = prendreSqe(server);
+    if (sqe == NULL) {
+        fprintf(stderr, "ERREUR: io_uring plein (annulation)\n");
+        return;
+    }
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->addr = (uint64_t)(uintptr_t)connexion | OP_RECV;
+    sqe->user_data = OP_ANNULATION;
+}
+
+static void soumettreEnvoi(UringServer *server, UringConnection *connexion) {
+    struct io_uring_sqe *sqe = prendreSqe(server);
+    if (sqe == NULL) {
+        fprintf(stderr, "ERREUR: io_uring plein (send)\n");
+        connexion->enVol.clear();
+        connexion->envoye = 0;
+        connexion->envoiEnCours = false;
+        return;
+    }
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = connexion->socket;
+    sqe->addr = (uint64_t)(uintptr_t)(connexion->enVol.data() + connexion->envoye);
+    sqe->len = connexion->enVol.size() - connexion->envoye;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = (uint64_t)(uintptr_t)connexion | OP_SEND;
+    connexion->envoiEnCours = true;
+}
+
+// ============================================================================
+// GESTION DES CONNEXIONS
+// ============================================================================
+
+/**
+ * Réveille la boucle si elle ne l'est pas déjà (appelé sans le verrou)
+ * @param server Boucle io_uring
+ * @param necessaire Résultat du test fait sous verrou
+ */
+static void reveiller(UringServer *server, bool necessaire) {
+    if (necessaire) {
+        uint64_t un = 1;
+        if (write(server->reveilFd, &un, sizeof(un)) < 0) {
+            perror("ERREUR: write(eventfd)");
+        }
+    }
+}
+
+/**
+ * Ferme et libère une connexion dès qu'aucune opération n'est en cours
+ * @param server Boucle io_uring
+ * @param connexion Connexion à examiner
+ */
+static void finaliser(UringServer *server, UringConnection *connexion) {
+    pthread_mutex_lock(&server->verrou);
+    bool terminee = connexion->fermeture && !connexion->aFermer && !connexion->aEnvoyer &&
+                    connexion->sortie.empty();
+    pthread_mutex_unlock(&server->verrou);
+
+    if (terminee && !connexion->recvArme && !connexion->envoiEnCours) {
+        close(connexion->socket);
+        delete connexion;
+    }
+}
+
+/**
+ * Signale une seule fois la fin de connexion à l'application
+ * @param server Boucle io_uring
+ * @param connexion Connexion terminée
+ */
+static void notifierFermeture(UringServer *server, UringConnection *connexion) {
+    if (!connexion->fermeNotifie) {
+        connexion->fermeNotifie = true;
+        server->handlers.onClose(connexion->contexte);
+    }
+}
+
+/**
+ * Enregistre une connexion acceptée et arme sa réception
+ * @param server Boucle io_uring
+ * @param clientSocket Socket du client
+ */
+static void nouvelleConnexion(UringServer *server, int clientSocket) {
+    char ipClient[INET_ADDRSTRLEN] = {0};
+    struct sockaddr_storage adresse;
+    socklen_t tailleAdresse = sizeof(adresse);
+    if (getpeername(clientSocket, (struct sockaddr *)&adresse, &tailleAdresse) == 0) {
+        if (adresse.ss_family == AF_INET) {
+            inet_ntop(AF_INET, &((struct sockaddr_in *)&adresse)->sin_addr,
+                      ipClient, sizeof(ipClient));
+        } else if (adresse.ss_family == AF_UNIX) {
+            snprintf(ipClient, sizeof(ipClient), "%s", IP_LOCALE);
+        }
+    }
+
+    UringConnection *connexion = new UringConnection();
+    connexion->socket = clientSocket;
+    connexion->server = server;
+    connexion->contexte = server->handlers.onOpen(clientSocket, ipClient, server->handlers.userData);
+
+    pthread_mutex_lock(&registreVerrou);
+    if ((size_t)clientSocket >= registre.size()) {
+        registre.resize(clientSocket + 1, NULL);
+    }
+    registre[clientSocket] = connexion;
+    pthread_mutex_unlock(&registreVerrou);
+
+    armerRecv(server, connexion);
+}
+
+/**
+ * Backend d'envoi installé dans la librairie : ajoute le message au tampon
+ * de sortie de la connexion, la boucle se charge de le soumettre
+ */
+static int uringEnvoi(int sSocket, const struct iovec *iov, int iovcnt) {
+    pthread_mutex_lock(&registreVerrou);
+    UringConnection *connexion = NULL;
+    if (sSocket >= 0 && (size_t)sSocket < registre.size()) {
+        connexion = registre[sSocket];
+    }
+    if (connexion == NULL) {
+        pthread_mutex_unlock(&registreVerrou);
+        return ENVOI_NON_GERE;
+    }
+
+    UringServer *server = connexion->server;
+    pthread_mutex_lock(&server->verrou);
+    pthread_mutex_unlock(&registreVerrou);
+
+    // Client qui ne lit plus : les réponses ne s'accumulent pas en mémoire.
+    // La connexion est coupée (le socket n'est pas encore fermé : il est
+    // dans le registre) ; la boucle la ferme quand sa réception se termine
+    if (!connexion->envoiCoupe && connexion->sortie.size() >= URING_MAX_SORTIE) {
+        connexion->envoiCoupe = true;
+        connexion->sortie.clear();
+        shutdown(connexion->socket, SHUT_RDWR);
+        fprintf(stderr, "ERREUR: sortie io_uring saturée, connexion %d coupée\n", sSocket);
+    }
+    if (connexion->envoiCoupe) {
+        pthread_mutex_unlock(&server->verrou);
+        errno = ENOBUFS;
+        return -1;
+    }
+
+    int total = 0;
+    for (int i = 0; i < iovcnt; i++) {
+        connexion->sortie.append((const char *)iov[i].iov_base, iov[i].iov_len);
+        total += iov[i].iov_len;
+    }
+    bool reveil = false;
+    if (!connexion->aEnvoyer) {
+        connexion->aEnvoyer = true;
+        server->envois.push_back(connexion);
+        reveil = !server->reveilEnAttente;
+        server->reveilEnAttente = true;
+    }
+    pthread_mutex_unlock(&server->verrou);
+
+    reveiller(server, reveil);
+    return total;
+}
+
+/**
+ * Soumet les envois et fermetures demandés par les autres threads
+ * @param server Boucle io_uring
+ */
+static void traiterDemandes(UringServer *server) {
+    std::vector<UringConnection *> envois;
+    std::vector<UringConnection *> demarres;
+    std::vector<UringConnection *> fermetures;
+
+    pthread_mutex_lock(&server->verrou);
+    envois.swap(server->envois);
+    fermetures.swap(server->fermetures);
+    server->reveilEnAttente = false;
+    for (UringConnection *connexion : envois) {
+        connexion->aEnvoyer = false;
+        if (!connexion->envoiEnCours && !connexion->sortie.empty()) {
+            connexion->enVol.swap(connexion->sortie);
+            connexion->envoye = 0;
+            demarres.push_back(connexion);
+        }
+    }
+    pthread_mutex_unlock(&server->verrou);
+
+    // Tous les envois sont préparés ici et partent au prochain io_uring_enter
+    for (UringConnection *connexion : demarres) {
+        soumettreEnvoi(server, connexion);
+    }
+    for (UringConnection *connexion : envois) {
+        finaliser(server, connexion);
+    }
+    for (UringConnection *connexion : fermetures) {
+        pthread_mutex_lock(&server->verrou);
+        connexion->aFermer = false;
+        pthread_mutex_unlock(&server->verrou);
+        if (connexion->recvArme) {
+            annulerRecv(server, connexion);
+        } else {
+            finaliser(server, connexion);
+        }
+    }
+}
+
+/**
+ * Traite une complétion de la file
+ * @param server Boucle io_uring
+ * @param cqe Complétion à traiter
+ */
+static void traiterCompletion(UringServer *server, const struct io_uring_cqe *cqe) {
+    uint64_t operation = cqe->user_data & OP_MASQUE;
+    UringConnection *connexion = (UringConnection *)(uintptr_t)(cqe->user_data & ~OP_MASQUE);
+    bool encore = (cqe->flags & IORING_CQE_F_MORE) != 0;
+
+    if (operation == OP_ACCEPT) {
+        if (cqe->res >= 0) {
+            nouvelleConnexion(server, cqe->res);
+        } else {
+            fprintf(stderr, "ERREUR: accept io_uring: %s\n", strerror(-cqe->res));
+        }
+        if (!encore && !server->arret) {
+            armerAccept(server, (int)(cqe->user_data >> OP_DECALAGE));
+        }
+    }
+    else if (operation == OP_RECV) {
+        if (cqe->res > 0) {
+            unsigned short identifiant = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+            if (!connexion->fermeNotifie) {
+                server->handlers.onData(connexion->contexte,
+                                        server->tampons + (size_t)identifiant * URING_TAILLE_TAMPON,
+                                        cqe->res);
+            }
+            rendreTampon(server, identifiant);
+        }
+        if (!encore) {
+            connexion->recvArme = false;
+            if (cqe->res > 0 || cqe->res == -ENOBUFS) {
+                // Multishot interrompu (plus de tampons libres) : réarmer
+                pthread_mutex_lock(&server->verrou);
+                bool fermeture = connexion->fermeture;
+                pthread_mutex_unlock(&server->verrou);
+                if (!fermeture) {
+                    armerRecv(server, connexion);
+                    return;
+                }
+            }
+            // Connexion fermée par le client, en erreur ou annulée
+            notifierFermeture(server, connexion);
+            finaliser(server, connexion);
+        }
+    }
+    else if (operation == OP_SEND) {
+        if (cqe->res < 0) {
+            // Erreur d'envoi : continuer après les octets perdus décalerait
+            // les réponses suivantes, la connexion est fermée
+            pthread_mutex_lock(&server->verrou);
+            connexion->envoiCoupe = true;
+            connexion->sortie.clear();
+            pthread_mutex_unlock(&server->verrou);
+            connexion->enVol.clear();
+            connexion->envoye = 0;
+            connexion->envoiEnCours = false;
+            fprintf(stderr, "ERREUR: send io_uring: %s\n", strerror(-cqe->res));
+            shutdown(connexion->socket, SHUT_RDWR);
+            notifierFermeture(server, connexion);
+            finaliser(server, connexion);
+            return;
+        }
+        connexion->envoye += cqe->res;
+
+        if (connexion->envoye < connexion->enVol.size()) {
+            // Envoi partiel : soumettre la suite
+            soumettreEnvoi(server, connexion);
+            return;
+        }
+
+        connexion->enVol.clear();
+        connexion->envoye = 0;
+        pthread_mutex_lock(&server->verrou);
+        connexion->enVol.swap(connexion->sortie);
+        pthread_mutex_unlock(&server->verrou);
+        connexion->envoiEnCours = false;
+        if (!connexion->enVol.empty()) {
+            soumettreEnvoi(server, connexion);
+        } else {
+            finaliser(server, connexion);
+        }
+    }
+    else if (operation == OP_REVEIL) {
+        traiterDemandes(server);
+        if (!server->arret) {
+            armerReveil(server);
+        }
+    }
+}
+
+// ============================================================================
+// FONCTIONS PUBLIQUES
+// ============================================================================
+
+/**
+ * Indique si le noyau supporte io_uring avec accept/recv multishot
+ * @return 1 si le backend est utilisable, 0 sinon
+ */
+int UringSupported(void) {
+    // recv multishot et tampons fournis en anneau : noyau 6.0 minimum
+    struct utsname systeme;
+    int majeur = 0, mineur = 0;
+    if (uname(&systeme) < 0 || sscanf(systeme.release, "%d.%d", &majeur, &mineur) != 2 ||
+        majeur < 6) {
+        return 0;
+    }
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int ringFd = uringSetup(2, &params);
+    if (ringFd < 0) {
+        return 0;
+    }
+    close(ringFd);
+    return 1;
+}
+
+/**
+ * Crée une boucle io_uring pour un socket serveur en écoute
+ * @param socketEcoute Socket serveur (voir ServerSocket)
+ * @param handlers Fonctions appelées par la boucle
+ * @return Boucle créée ou NULL en cas d'erreur (io_uring indisponible)
+ */
+UringServer *UringServerCreate(int socketEcoute, const UringHandlers *handlers) {
+    if (socketEcoute < 0 || handlers == NULL) {
+        return NULL;
+    }
+
+    UringServer *server = new UringServer();
+    server->socketsEcoute[0] = socketEcoute;
+    server->nbEcoutes = 1;
+    server->handlers = *handlers;
+    server->reveilFd = -1;
+    pthread_mutex_init(&server->verrou, NULL);
+
+    // Création de l'instance et projection des files
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    server->ringFd = uringSetup(URING_ENTREES, &params);
+    if (server->ringFd < 0) {
+        delete server;
+        return NULL;
+    }
+
+    server->sqTaille = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    server->cqTaille = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool projectionUnique = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (projectionUnique && server->cqTaille > server->sqTaille) {
+        server->sqTaille = server->cqTaille;
+    }
+
+    server->sqPtr = mmap(NULL, server->sqTaille, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, server->ringFd, IORING_OFF_SQ_RING);
+    server->cqPtr = projectionUnique ? server->sqPtr :
+                    mmap(NULL, server->cqTaille, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, server->ringFd, IORING_OFF_CQ_RING);
+    server->sqesTaille = params.sq_entries * sizeof(struct io_uring_sqe);
+    server->sqes = (struct io_uring_sqe *)mmap(NULL, server->sqesTaille, PROT_READ | PROT_WRITE,
+                                               MAP_SHARED | MAP_POPULATE, server->ringFd,
+                                               IORING_OFF_SQES);
+    if (server->sqPtr == MAP_FAILED || server->cqPtr == MAP_FAILED || server->sqes == MAP_FAILED) {
+        UringServerDestroy(server);
+        return NULL;
+    }
+
+    char *sq = (char *)server->sqPtr;
+    server->sqHead = (unsigned *)(sq + params.sq_off.head);
+    server->sqTail = (unsigned *)(sq + params.sq_off.tail);
+    server->sqMask = (unsigned *)(sq + params.sq_off.ring_mask);
+    server->sqArray = (unsigned *)(sq + params.sq_off.array);
+    server->sqEntrees = params.sq_entries;
+    server->sqLocal = *server->sqTail;
+
+    char *cq = (char *)server->cqPtr;
+    server->cqHead = (unsigned *)(cq + params.cq_off.head);
+    server->cqTail = (unsigned *)(cq + params.cq_off.tail);
+    server->cqMask = (unsigned *)(cq + params.cq_off.ring_mask);
+    server->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+    // Anneau de tampons fournis au noyau pour les réceptions
+    server->anneauTaille = URING_NB_TAMPONS * sizeof(struct io_uring_buf);
+    server->anneau = (struct io_uring_buf_ring *)mmap(NULL, server->anneauTaille,
+                                                      PROT_READ | PROT_WRITE,
+                                                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    server->tampons = (char *)malloc((size_t)URING_NB_TAMPONS * URING_TAILLE_TAMPON);
+    if (server->anneau == MAP_FAILED || server->tampons == NULL) {
+        UringServerDestroy(server);
+        return NULL;
+    }
+
+    // Anneau vide (queue à 0) avant son enregistrement auprès du noyau
+    memset(server->anneau, 0, server->anneauTaille);
+
+    struct io_uring_buf_reg enregistrement;
+    memset(&enregistrement, 0, sizeof(enregistrement));
+    enregistrement.ring_addr = (uint64_t)(uintptr_t)server->anneau;
+    enregistrement.ring_entries = URING_NB_TAMPONS;
+    enregistrement.bgid = URING_GROUPE_TAMPONS;
+    if (uringRegister(server->ringFd, IORING_REGISTER_PBUF_RING, &enregistrement, 1) < 0) {
+        UringServerDestroy(server);
+        return NULL;
+    }
+    for (int i = 0; i < URING_NB_TAMPONS; i++) {
+        rendreTampon(server, (unsigned short)i);
+    }
+
+    // Réveil de la boucle par les autres threads
+    server->reveilFd = eventfd(0, EFD_CLOEXEC);
+    if (server->reveilFd < 0) {
+        UringServerDestroy(server);
+        return NULL;
+    }
+
+    SetSendBackend(uringEnvoi);
+    return server;
+}
+
+/**
+ * Ajoute un socket d'écoute supplémentaire à la boucle (avant son exécution)
+ * @param server Boucle io_uring
+ * @param socketEcoute Socket serveur en écoute (TCP ou AF_UNIX)
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int UringServerAddListener(UringServer *server, int socketEcoute) {
+    if (server == NULL || socketEcoute < 0 || server->nbEcoutes >= URING_MAX_ECOUTES) {
+        return -1;
+    }
+    server->socketsEcoute[server->nbEcoutes++] = socketEcoute;
+    return 0;
+}
+
+/**
+ * Exécute la boucle d'événements jusqu'à UringServerStop()
+ * @param server Boucle io_uring
+ * @return 0 en cas d'arrêt normal, -1 en cas d'erreur
+ */
+int UringServerRun(UringServer *server) {
+    if (server == NULL) {
+        return -1;
+    }
+
+    for (int i = 0; i < server->nbEcoutes; i++) {
+        armerAccept(server, i);
+    }
+    armerReveil(server);
+
+    while (!server->arret) {
+        // Un seul appel système soumet tout et attend la prochaine complétion
+        if (soumettre(server, 1) < 0) {
+            perror("ERREUR: io_uring_enter");
+            return -1;
+        }
+
+        unsigned tete = *server->cqHead;
+        unsigned queue = chargerAcquire(server->cqTail);
+        while (tete != queue) {
+            traiterCompletion(server, &server->cqes[tete & *server->cqMask]);
+            tete++;
+            // Libérer l'entrée au fur et à mesure : le traitement peut soumettre
+            stockerRelease(server->cqHead, tete);
+            queue = chargerAcquire(server->cqTail);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Demande l'arrêt de la boucle (peut être appelé depuis un autre thread)
+ * @param server Boucle io_uring
+ */
+void UringServerStop(UringServer *server) {
+    if (server == NULL) {
+        return;
+    }
+    server->arret = true;
+    reveiller(server, true);
+}
+
+/**
+ * Ferme une connexion de la boucle
+ * @param server Boucle io_uring
+ * @param sSocket Socket de la connexion
+ */
+void UringClose(UringServer *server, int sSocket) {
+    if (server == NULL || sSocket < 0) {
+        return;
+    }
+
+    // Retirer la connexion du registre : Send() ne la trouvera plus
+    pthread_mutex_lock(&registreVerrou);
+    UringConnection *connexion = NULL;
+    if ((size_t)sSocket < registre.size()) {
+        connexion = registre[sSocket];
+        registre[sSocket] = NULL;
+    }
+    pthread_mutex_lock(&server->verrou);
+    pthread_mutex_unlock(&registreVerrou);
+
+    bool reveil = false;
+    if (connexion != NULL && !connexion->fermeture) {
+        connexion->fermeture = true;
+        connexion->aFermer = true;
+        server->fermetures.push_back(connexion);
+        reveil = !server->reveilEnAttente;
+        server->reveilEnAttente = true;
+    }
+    pthread_mutex_unlock(&server->verrou);
+
+    reveiller(server, reveil);
+}
+
+/**
+ * Libère la boucle et ses ressources (après la fin de UringServerRun)
+ * @param server Boucle io_uring
+ */
+void UringServerDestroy(UringServer *server) {
+    if (server == NULL) {
+        return;
+    }
+
+    SetSendBackend(NULL);
+    if (server->reveilFd >= 0) {
+        close(server->reveilFd);
+    }
+    if (server->tampons != NULL) {
+        free(server->tampons);
+    }
+    if (server->anneau != NULL && server->anneau != MAP_FAILED) {
+        munmap(server->anneau, server->anneauTaille);
+    }
+    if (server->sqes != NULL && server->sqes != MAP_FAILED) {
+        munmap(server->sqes, server->sqesTaille);
+    }
+    if (server->cqPtr != NULL && server->cqPtr != MAP_FAILED && server->cqPtr != server->sqPtr) {
+        munmap(server->cqPtr, server->cqTaille);
+    }
+    if (server->sqPtr != NULL && server->sqPtr != MAP_FAILED) {
+        munmap(server->sqPtr, server->sqTaille);
+    }
+    if (server->ringFd >= 0) {
+        close(server->ringFd);
+    }
+    pthread_mutex_destroy(&server->verrou);
+    delete server;
+}
@@ -0,0 +1,97 @@
+/**
+ * Backend io_uring de la librairie de sockets
+ *
+ * Boucle d'événements optionnelle qui remplace les appels bloquants
+ * accept()/recv()/send() par des opérations io_uring :
+ * - accept multishot : une seule soumission pour toutes les connexions
+ * - recv multishot avec tampons fournis : le noyau choisit le tampon
+ * - envois groupés : les Send() des threads sont soumis en un seul appel
+ *
+ * Une fois la boucle créée, Send() sur un socket accepté par la boucle
+ * passe automatiquement par io_uring (voir SetSendBackend dans socket.h).
+ * Send() échoue et la connexion est coupée si le client laisse s'accumuler
+ * trop de réponses non lues, ou après une erreur d'envoi.
+ * Utilise directement les appels système (pas de dépendance à liburing).
+ */
+
+#ifndef URING_H
+#define URING_H
+
+// ============================================================================
+// STRUCTURES
+// ============================================================================
+
+/**
+ * Boucle d'événements io_uring (structure opaque)
+ */
+typedef struct UringServer UringServer;
+
+/**
+ * Fonctions appelées par la boucle (toujours depuis le thread de la boucle)
+ */
+typedef struct {
+    // Nouvelle connexion : renvoie le contexte associé à la connexion
+    void *(*onOpen)(int sSocket, const char *ipClient, void *userData);
+    // Octets reçus sur la connexion (valides pendant l'appel seulement)
+    void (*onData)(void *contexte, const char *data, int taille);
+    // Connexion fermée par le client ou en erreur (appelé une seule fois)
+    void (*onClose)(void *contexte);
+    void *userData;                 // Donnée transmise à onOpen
+} UringHandlers;
+
+// ============================================================================
+// FONCTIONS
+// ============================================================================
+
+/**
+ * Indique si le noyau supporte io_uring avec accept/recv multishot
+ * @return 1 si le backend est utilisable, 0 sinon
+ */
+int UringSupported(void);
+
+/**
+ * Crée une boucle io_uring pour un socket serveur en écoute
+ * @param socketEcoute Socket serveur (voir ServerSocket)
+ * @param handlers Fonctions appelées par la boucle
+ * @return Boucle créée ou NULL en cas d'erreur (io_uring indisponible)
+ */
+UringServer *UringServerCreate(int socketEcoute, const UringHandlers *handlers);
+
+/**
+ * Ajoute un socket d'écoute supplémentaire à la boucle (avant son exécution),
+ * par exemple un socket AF_UNIX (voir ServerSocketUnix)
+ * @param server Boucle io_uring
+ * @param socketEcoute Socket serveur en écoute
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int UringServerAddListener(UringServer *server, int socketEcoute);
+
+/**
+ * Exécute la boucle d'événements jusqu'à UringServerStop()
+ * @param server Boucle io_uring
+ * @return 0 en cas d'arrêt normal, -1 en cas d'erreur
+ */
+int UringServerRun(UringServer *server);
+
+/**
+ * Demande l'arrêt de la boucle (peut être appelé depuis un autre thread)
+ * @param server Boucle io_uring
+ */
+void UringServerStop(UringServer *server);
+
+/**
+ * Ferme une connexion de la boucle : les envois en cours sont terminés,
+ * puis le socket est fermé par la boucle (peut être appelé depuis un
+ * autre thread, au plus une fois par connexion)
+ * @param server Boucle io_uring
+ * @param sSocket Socket de la connexion
+ */
+void UringClose(UringServer *server, int sSocket);
+
+/**
+ * Libère la boucle et ses ressources (après la fin de UringServerRun)
+ * @param server Boucle io_uring
+ */
+void UringServerDestroy(UringServer *server);
+
+#endif // URING_H
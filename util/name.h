@@ -28,6 +28,9 @@ const char* BOOK_CONSULTATION = "BOOK_CONSULTATION;";
 const char* BOOK_OK = "BOOK_OK";
 const char* BOOK_FAIL = "BOOK_FAIL;";
 
+// Serveur surchargé : BUSY;délai avant de réessayer (ms)
+const char* BUSY = "BUSY;";
+
 // Messages d'erreur
 const char* FORMAT = "FORMAT";
 const char* UNKNOWN_CMD = "UNKNOWN_CMD";